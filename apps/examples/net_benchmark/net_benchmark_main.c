@@ -0,0 +1,523 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file net_benchmark_main.c
+/// @brief Loopback TCP/UDP throughput and latency benchmark
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NB_ADDR           "127.0.0.1"
+#define NB_PORT_TCP       5101
+#define NB_PORT_RR        5102
+#define NB_PORT_UDP       5103
+#define NB_PORT_CONN      5104
+
+#define NB_CHUNK_SIZE     1024	/* write size of the TCP throughput test */
+#define NB_RR_MSGLEN      64	/* request and response size */
+#define NB_UDP_MSGLEN     64
+#define NB_UDP_TIMEOUT_MS 500	/* receiver gives up after this much silence */
+#define NB_ACCEPT_TIMEOUT 5		/* seconds, so a failed client does not hang the peer */
+
+#define NB_STACK_SIZE     4096
+
+/* Stack settings printed with every result so runs can be compared */
+
+#ifndef CONFIG_NET_TCP_WND
+#define CONFIG_NET_TCP_WND 0
+#endif
+#ifndef CONFIG_NET_MEMP_NUM_TCP_SEG
+#define CONFIG_NET_MEMP_NUM_TCP_SEG 0
+#endif
+#ifndef CONFIG_NET_PBUF_POOL_SIZE
+#define CONFIG_NET_PBUF_POOL_SIZE 0
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct nb_peer {
+	int fd;						/* listening or bound socket */
+	int count;					/* what the peer should expect */
+	int result;					/* what the peer actually got */
+	uint32_t usec;				/* time the peer spent on it */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static char g_buf[NB_CHUNK_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(void)
+{
+	printf("Usage: net_benchmark [all|tcp|rr|udp|conn]\n\n");
+	printf("\ttcp : TCP bulk throughput\n");
+	printf("\trr  : TCP request/response latency percentiles\n");
+	printf("\tudp : UDP packets per second\n");
+	printf("\tconn: TCP connection setup rate\n");
+	printf("Results are printed as lines starting with \"NETBENCH\"\n");
+}
+
+static uint32_t nb_now_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* One line per test: fixed prefix, then key=value pairs */
+
+static void nb_report(const char *test, const char *fmt, ...)
+{
+	va_list ap;
+
+	printf("NETBENCH test=%s tcp_wnd=%d tcp_seg=%d pbuf_pool=%d ", test, CONFIG_NET_TCP_WND, CONFIG_NET_MEMP_NUM_TCP_SEG, CONFIG_NET_PBUF_POOL_SIZE);
+	va_start(ap, fmt);
+	vprintf(fmt, ap);
+	va_end(ap);
+	printf("\n");
+}
+
+static void nb_addr(struct sockaddr_in *addr, int port)
+{
+	memset(addr, 0, sizeof(*addr));
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+	addr->sin_addr.s_addr = inet_addr(NB_ADDR);
+}
+
+static int nb_listen(int port)
+{
+	struct sockaddr_in addr;
+	struct timeval tv;
+	int opt = 1;
+	int fd;
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) {
+		printf("socket fail %d\n", errno);
+		return -1;
+	}
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+	tv.tv_sec = NB_ACCEPT_TIMEOUT;
+	tv.tv_usec = 0;
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+	nb_addr(&addr, port);
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 4) < 0) {
+		printf("bind/listen fail %d\n", errno);
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+static int nb_connect(int port)
+{
+	struct sockaddr_in addr;
+	int fd;
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) {
+		return -1;
+	}
+	nb_addr(&addr, port);
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+static void nb_nodelay(int fd)
+{
+	int opt = 1;
+
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+}
+
+/* Read exactly len bytes, returns len or what was read before EOF/error */
+
+static int nb_recv_all(int fd, char *buf, int len)
+{
+	int done = 0;
+	int ret;
+
+	while (done < len) {
+		ret = recv(fd, buf + done, len - done, 0);
+		if (ret <= 0) {
+			break;
+		}
+		done += ret;
+	}
+	return done;
+}
+
+static int nb_start_peer(pthread_t *tid, pthread_startroutine_t entry, struct nb_peer *peer)
+{
+	pthread_attr_t attr;
+	int ret;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, NB_STACK_SIZE);
+	ret = pthread_create(tid, &attr, entry, peer);
+	pthread_attr_destroy(&attr);
+	if (ret != 0) {
+		printf("pthread_create fail %d\n", ret);
+		return -1;
+	}
+	return 0;
+}
+
+static int nb_cmp_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/****************************************************************************
+ * TCP bulk throughput
+ ****************************************************************************/
+
+static void *nb_tcp_sink(void *arg)
+{
+	struct nb_peer *peer = (struct nb_peer *)arg;
+	uint32_t start;
+	int fd;
+	int ret;
+
+	fd = accept(peer->fd, NULL, NULL);
+	if (fd < 0) {
+		return NULL;
+	}
+	start = nb_now_usec();
+	while ((ret = recv(fd, g_buf, sizeof(g_buf), 0)) > 0) {
+		peer->result += ret;
+	}
+	peer->usec = nb_now_usec() - start;
+	close(fd);
+	return NULL;
+}
+
+static void nb_tcp_bulk(void)
+{
+	struct nb_peer peer = { -1, CONFIG_EXAMPLES_NET_BENCHMARK_TCP_BYTES, 0, 0 };
+	pthread_t tid;
+	int sent = 0;
+	int fd;
+	int ret;
+
+	peer.fd = nb_listen(NB_PORT_TCP);
+	if (peer.fd < 0 || nb_start_peer(&tid, nb_tcp_sink, &peer) < 0) {
+		goto out;
+	}
+
+	/* g_buf is shared with the sink, its contents are never checked */
+	fd = nb_connect(NB_PORT_TCP);
+	if (fd >= 0) {
+		while (sent < peer.count) {
+			ret = send(fd, g_buf, peer.count - sent < NB_CHUNK_SIZE ? peer.count - sent : NB_CHUNK_SIZE, 0);
+			if (ret <= 0) {
+				break;
+			}
+			sent += ret;
+		}
+		close(fd);
+	} else {
+		printf("connect fail %d\n", errno);
+	}
+	pthread_join(tid, NULL);
+
+	nb_report("tcp_bulk", "bytes=%d usec=%u kbps=%u", peer.result, peer.usec, peer.usec ? (uint32_t)((uint64_t)peer.result * 8000 / peer.usec) : 0);
+out:
+	if (peer.fd >= 0) {
+		close(peer.fd);
+	}
+}
+
+/****************************************************************************
+ * TCP request/response latency
+ ****************************************************************************/
+
+static void *nb_rr_echo(void *arg)
+{
+	struct nb_peer *peer = (struct nb_peer *)arg;
+	char msg[NB_RR_MSGLEN];
+	int fd;
+
+	fd = accept(peer->fd, NULL, NULL);
+	if (fd < 0) {
+		return NULL;
+	}
+	nb_nodelay(fd);
+	while (nb_recv_all(fd, msg, sizeof(msg)) == sizeof(msg)) {
+		if (send(fd, msg, sizeof(msg), 0) != sizeof(msg)) {
+			break;
+		}
+		peer->result++;
+	}
+	close(fd);
+	return NULL;
+}
+
+static void nb_tcp_rr(void)
+{
+	struct nb_peer peer = { -1, CONFIG_EXAMPLES_NET_BENCHMARK_RR_COUNT, 0, 0 };
+	char msg[NB_RR_MSGLEN];
+	uint32_t *samples;
+	uint32_t first;
+	uint32_t start;
+	uint32_t now;
+	pthread_t tid;
+	int nsamples = 0;
+	int fd = -1;
+
+	if (peer.count <= 0) {
+		return;
+	}
+	samples = (uint32_t *)malloc(peer.count * sizeof(uint32_t));
+	if (samples == NULL) {
+		printf("malloc fail\n");
+		return;
+	}
+	memset(msg, 'r', sizeof(msg));
+
+	peer.fd = nb_listen(NB_PORT_RR);
+	if (peer.fd < 0 || nb_start_peer(&tid, nb_rr_echo, &peer) < 0) {
+		goto out;
+	}
+
+	fd = nb_connect(NB_PORT_RR);
+	if (fd < 0) {
+		printf("connect fail %d\n", errno);
+	} else {
+		nb_nodelay(fd);
+		/* One sample per round trip, each starting where the last one ended */
+		first = start = nb_now_usec();
+		for (nsamples = 0; nsamples < peer.count; nsamples++) {
+			if (send(fd, msg, sizeof(msg), 0) != sizeof(msg) || nb_recv_all(fd, msg, sizeof(msg)) != sizeof(msg)) {
+				break;
+			}
+			now = nb_now_usec();
+			samples[nsamples] = now - start;
+			start = now;
+		}
+		close(fd);
+	}
+	pthread_join(tid, NULL);
+
+	if (nsamples > 0) {
+		qsort(samples, nsamples, sizeof(uint32_t), nb_cmp_u32);
+		nb_report("tcp_rr", "samples=%d p50_usec=%u p90_usec=%u p99_usec=%u max_usec=%u mean_usec=%u", nsamples, samples[nsamples * 50 / 100], samples[nsamples * 90 / 100], samples[nsamples * 99 / 100], samples[nsamples - 1], (start - first) / nsamples);
+	} else {
+		nb_report("tcp_rr", "samples=0");
+	}
+out:
+	if (peer.fd >= 0) {
+		close(peer.fd);
+	}
+	free(samples);
+}
+
+/****************************************************************************
+ * UDP packet rate
+ ****************************************************************************/
+
+static void *nb_udp_sink(void *arg)
+{
+	struct nb_peer *peer = (struct nb_peer *)arg;
+	char msg[NB_UDP_MSGLEN];
+	uint32_t start = 0;
+	uint32_t last = 0;
+
+	while (peer->result < peer->count) {
+		if (recv(peer->fd, msg, sizeof(msg), 0) <= 0) {
+			/* SO_RCVTIMEO expired, the rest was dropped */
+			break;
+		}
+		last = nb_now_usec();
+		if (peer->result++ == 0) {
+			start = last;
+		}
+	}
+	peer->usec = last - start;
+	return NULL;
+}
+
+static void nb_udp_pps(void)
+{
+	struct nb_peer peer = { -1, CONFIG_EXAMPLES_NET_BENCHMARK_UDP_COUNT, 0, 0 };
+	struct sockaddr_in addr;
+	struct timeval tv;
+	char msg[NB_UDP_MSGLEN];
+	uint32_t start;
+	uint32_t usec;
+	pthread_t tid;
+	int sent = 0;
+	int fd = -1;
+	int i;
+
+	memset(msg, 'u', sizeof(msg));
+	nb_addr(&addr, NB_PORT_UDP);
+	peer.fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (peer.fd < 0 || bind(peer.fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printf("udp bind fail %d\n", errno);
+		goto out;
+	}
+	tv.tv_sec = 0;
+	tv.tv_usec = NB_UDP_TIMEOUT_MS * 1000;
+	setsockopt(peer.fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0 || nb_start_peer(&tid, nb_udp_sink, &peer) < 0) {
+		goto out;
+	}
+
+	start = nb_now_usec();
+	for (i = 0; i < peer.count; i++) {
+		if (sendto(fd, msg, sizeof(msg), 0, (struct sockaddr *)&addr, sizeof(addr)) == sizeof(msg)) {
+			sent++;
+		}
+	}
+	usec = nb_now_usec() - start;
+	pthread_join(tid, NULL);
+
+	nb_report("udp_pps", "sent=%d received=%d tx_usec=%u rx_usec=%u tx_pps=%u rx_pps=%u", sent, peer.result, usec, peer.usec, usec ? (uint32_t)((uint64_t)sent * 1000000 / usec) : 0, peer.usec ? (uint32_t)((uint64_t)peer.result * 1000000 / peer.usec) : 0);
+out:
+	if (fd >= 0) {
+		close(fd);
+	}
+	if (peer.fd >= 0) {
+		close(peer.fd);
+	}
+}
+
+/****************************************************************************
+ * TCP connection rate
+ ****************************************************************************/
+
+static void *nb_conn_acceptor(void *arg)
+{
+	struct nb_peer *peer = (struct nb_peer *)arg;
+	int fd;
+
+	while (peer->result < peer->count) {
+		fd = accept(peer->fd, NULL, NULL);
+		if (fd < 0) {
+			break;
+		}
+		close(fd);
+		peer->result++;
+	}
+	return NULL;
+}
+
+static void nb_conn_rate(void)
+{
+	struct nb_peer peer = { -1, CONFIG_EXAMPLES_NET_BENCHMARK_CONN_COUNT, 0, 0 };
+	uint32_t start;
+	uint32_t usec;
+	pthread_t tid;
+	int done = 0;
+	int fd;
+
+	peer.fd = nb_listen(NB_PORT_CONN);
+	if (peer.fd < 0 || nb_start_peer(&tid, nb_conn_acceptor, &peer) < 0) {
+		goto out;
+	}
+
+	start = nb_now_usec();
+	for (done = 0; done < peer.count; done++) {
+		fd = nb_connect(NB_PORT_CONN);
+		if (fd < 0) {
+			printf("connect fail %d after %d connections\n", errno, done);
+			break;
+		}
+		close(fd);
+	}
+	usec = nb_now_usec() - start;
+	pthread_join(tid, NULL);
+
+	nb_report("tcp_conn", "connections=%d usec=%u conn_per_sec=%u", done, usec, usec ? (uint32_t)((uint64_t)done * 1000000 / usec) : 0);
+out:
+	if (peer.fd >= 0) {
+		close(peer.fd);
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int net_benchmark_main(int argc, char *argv[])
+#endif
+{
+	const char *test = argc > 1 ? argv[1] : "all";
+	int all = !strcmp(test, "all");
+	int found = all;
+
+	if (all || !strcmp(test, "tcp")) {
+		nb_tcp_bulk();
+		found = 1;
+	}
+	if (all || !strcmp(test, "rr")) {
+		nb_tcp_rr();
+		found = 1;
+	}
+	if (all || !strcmp(test, "udp")) {
+		nb_udp_pps();
+		found = 1;
+	}
+	if (all || !strcmp(test, "conn")) {
+		nb_conn_rate();
+		found = 1;
+	}
+	if (!found) {
+		show_usage();
+		return -1;
+	}
+	return 0;
+}
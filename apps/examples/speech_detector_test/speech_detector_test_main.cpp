@@ -128,9 +128,6 @@ public:
 		if (fp != NULL) {
 			fwrite(result, sizeof(unsigned char), size << 1, fp);
 		}
-
-		auto sd = media::voice::SpeechDetector::instance();
-		sd->detectEndPoint(sdata, size >> 1);
 	}
 private:
 	FILE *fp;
@@ -194,6 +191,16 @@ bool run()
 		printf("#### [MR] setObserver failed.\n");
 	}
 
+	/* Detect the end point on the recorder thread, as soon as each period is captured */
+	mret = mr.addPeriodListener([sd](unsigned char *data, size_t size) {
+		sd->detectEndPoint((short *)data, size >> 1);
+	});
+	if (mret == media::RECORDER_OK) {
+		printf("#### [MR] addPeriodListener succeeded.\n");
+	} else {
+		printf("#### [MR] addPeriodListener failed.\n");
+	}
+
 	printf("###################################\n");
 	printf("#### Wait for wakeup triggered ####\n");
 	printf("###################################\n");
@@ -934,6 +934,68 @@ errout:
 	mq_unlink("mqsetattr");	
 }
 
+#ifdef CONFIG_MQ_SPSC
+#define TEST_SPSC_NMSGS 4
+
+static void tc_mqueue_mq_spsc(void)
+{
+	mqd_t mqdes;
+	struct mq_attr attr;
+	struct mq_attr mq_stat;
+	char msg_buffer[TEST_MSGLEN];
+	int prio;
+	int i;
+	int ret_chk;
+
+	attr.mq_maxmsg  = TEST_SPSC_NMSGS;
+	attr.mq_msgsize = TEST_MSGLEN;
+	attr.mq_flags   = 0;
+
+	mqdes = mq_open("mqspsc", O_CREAT | O_RDWR | O_NONBLOCK | O_SPSC, 0666, &attr);
+	TC_ASSERT_NEQ("mq_open", mqdes, (mqd_t)ERROR);
+
+	/* Fill the ring with messages of increasing priority */
+
+	for (i = 0; i < TEST_SPSC_NMSGS; i++) {
+		snprintf(msg_buffer, TEST_MSGLEN, "spsc message %d", i);
+		ret_chk = mq_send(mqdes, msg_buffer, TEST_MSGLEN, i);
+		TC_ASSERT_EQ_CLEANUP("mq_send", ret_chk, OK, goto errout);
+	}
+
+	ret_chk = mq_send(mqdes, msg_buffer, TEST_MSGLEN, 0);
+	TC_ASSERT_EQ_CLEANUP("mq_send", ret_chk, ERROR, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mq_send", errno, EAGAIN, goto errout);
+
+	ret_chk = mq_getattr(mqdes, &mq_stat);
+	TC_ASSERT_EQ_CLEANUP("mq_getattr", ret_chk, OK, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mq_getattr", mq_stat.mq_curmsgs, TEST_SPSC_NMSGS, goto errout);
+
+	/* Messages come out in FIFO order, not by priority */
+
+	for (i = 0; i < TEST_SPSC_NMSGS; i++) {
+		char expected[TEST_MSGLEN];
+
+		snprintf(expected, TEST_MSGLEN, "spsc message %d", i);
+		ret_chk = mq_receive(mqdes, msg_buffer, TEST_MSGLEN, &prio);
+		TC_ASSERT_EQ_CLEANUP("mq_receive", ret_chk, TEST_MSGLEN, goto errout);
+		TC_ASSERT_EQ_CLEANUP("mq_receive", prio, i, goto errout);
+		TC_ASSERT_EQ_CLEANUP("mq_receive", strcmp(msg_buffer, expected), 0, goto errout);
+	}
+
+	ret_chk = mq_receive(mqdes, msg_buffer, TEST_MSGLEN, &prio);
+	TC_ASSERT_EQ_CLEANUP("mq_receive", ret_chk, ERROR, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mq_receive", errno, EAGAIN, goto errout);
+
+	mq_close(mqdes);
+	mq_unlink("mqspsc");
+	TC_SUCCESS_RESULT();
+	return;
+
+errout:
+	mq_close(mqdes);
+	mq_unlink("mqspsc");
+}
+#endif
 
 /****************************************************************************
  * Name: mqueue
@@ -948,6 +1010,9 @@ int mqueue_main(void)
 
 	tc_mqueue_mq_getattr();
 	tc_mqueue_mq_setattr();
+#ifdef CONFIG_MQ_SPSC
+	tc_mqueue_mq_spsc();
+#endif
 
 	return 0;
 }
@@ -94,6 +94,12 @@ int tc_network_main(int argc, char *argv[])
 #ifdef CONFIG_TC_NET_SELECT
 	net_select_main();
 #endif
+#ifdef CONFIG_TC_NET_EPOLL
+	net_epoll_main();
+#endif
+#ifdef CONFIG_TC_NET_MMSG
+	net_mmsg_main();
+#endif
 #ifdef CONFIG_TC_NET_INET
 	net_inet_main();
 #endif
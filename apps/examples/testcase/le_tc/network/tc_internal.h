@@ -82,6 +82,12 @@ int net_shutdown_main(void);
 #ifdef CONFIG_TC_NET_SELECT
 int net_select_main(void);
 #endif
+#ifdef CONFIG_TC_NET_EPOLL
+int net_epoll_main(void);
+#endif
+#ifdef CONFIG_TC_NET_MMSG
+int net_mmsg_main(void);
+#endif
 #ifdef CONFIG_TC_NET_DHCPC
 int net_dhcpc_main(void);
 #endif
@@ -0,0 +1,261 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tc_net_epoll.c
+/// @brief Test Case Example for epoll_create(), epoll_ctl() and epoll_wait() API
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+
+#include "tc_internal.h"
+
+#define EPOLL_PORTNUM 5017
+#define EPOLL_MSG "epoll"
+
+static int g_rx_fd = -1;
+static int g_tx_fd = -1;
+static struct sockaddr_in g_rx_addr;
+
+static int epoll_send(void)
+{
+	return sendto(g_tx_fd, EPOLL_MSG, sizeof(EPOLL_MSG), 0, (struct sockaddr *)&g_rx_addr, sizeof(g_rx_addr));
+}
+
+static int epoll_drain(void)
+{
+	char buf[16];
+
+	return recv(g_rx_fd, buf, sizeof(buf), 0);
+}
+
+/**
+* @testcase		tc_net_epoll_create_n
+* @brief		epoll_create() rejects a non-positive size
+* @scenario		call epoll_create() with size 0
+* @apicovered		epoll_create()
+* @precondition		none
+* @postcondition	none
+*/
+static void tc_net_epoll_create_n(void)
+{
+	int epfd = epoll_create(0);
+
+	TC_ASSERT_EQ_CLEANUP("epoll_create", epfd, -1, close(epfd))
+	TC_SUCCESS_RESULT()
+}
+
+/**
+* @testcase		tc_net_epoll_ctl_n
+* @brief		epoll_ctl() rejects bad descriptors and duplicate registrations
+* @scenario		register an invalid fd, register the socket twice, remove it twice
+* @apicovered		epoll_ctl()
+* @precondition		the udp sockets are open
+* @postcondition	none
+*/
+static void tc_net_epoll_ctl_n(void)
+{
+	struct epoll_event ev;
+	int epfd;
+	int ret;
+
+	epfd = epoll_create(1);
+	TC_ASSERT_GEQ("epoll_create", epfd, 0)
+
+	ev.events = EPOLLIN;
+	ev.data.fd = g_rx_fd;
+	ret = epoll_ctl(epfd, EPOLL_CTL_ADD, -1, &ev);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, -1, close(epfd))
+	ret = epoll_ctl(-1, EPOLL_CTL_ADD, g_rx_fd, &ev);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, -1, close(epfd))
+	ret = epoll_ctl(epfd, EPOLL_CTL_MOD, g_rx_fd, &ev);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, -1, close(epfd))
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_ADD, g_rx_fd, &ev);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, 0, close(epfd))
+	ret = epoll_ctl(epfd, EPOLL_CTL_ADD, g_rx_fd, &ev);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, -1, close(epfd))
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", errno, EEXIST, close(epfd))
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_DEL, g_rx_fd, NULL);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, 0, close(epfd))
+	ret = epoll_ctl(epfd, EPOLL_CTL_DEL, g_rx_fd, NULL);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, -1, close(epfd))
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", errno, ENOENT, close(epfd))
+
+	close(epfd);
+	TC_SUCCESS_RESULT()
+}
+
+/**
+* @testcase		tc_net_epoll_wait_level_p
+* @brief		a level-triggered socket is reported until its data is read
+* @scenario		send a datagram, wait twice, read it, wait again
+* @apicovered		epoll_ctl(), epoll_wait()
+* @precondition		the udp sockets are open
+* @postcondition	none
+*/
+static void tc_net_epoll_wait_level_p(void)
+{
+	struct epoll_event ev;
+	struct epoll_event out[2];
+	int epfd;
+	int ret;
+
+	epfd = epoll_create(1);
+	TC_ASSERT_GEQ("epoll_create", epfd, 0)
+
+	ev.events = EPOLLIN;
+	ev.data.fd = g_rx_fd;
+	ret = epoll_ctl(epfd, EPOLL_CTL_ADD, g_rx_fd, &ev);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, 0, close(epfd))
+
+	ret = epoll_wait(epfd, out, 2, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 0, close(epfd))
+
+	ret = epoll_send();
+	TC_ASSERT_GT_CLEANUP("sendto", ret, 0, close(epfd))
+
+	ret = epoll_wait(epfd, out, 2, 1000);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(epfd))
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", out[0].data.fd, g_rx_fd, close(epfd))
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", out[0].events, EPOLLIN, close(epfd))
+
+	ret = epoll_wait(epfd, out, 2, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(epfd))
+
+	ret = epoll_drain();
+	TC_ASSERT_GT_CLEANUP("recv", ret, 0, close(epfd))
+
+	ret = epoll_wait(epfd, out, 2, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 0, close(epfd))
+
+	close(epfd);
+	TC_SUCCESS_RESULT()
+}
+
+/**
+* @testcase		tc_net_epoll_wait_edge_p
+* @brief		an edge-triggered socket is reported once per new datagram
+* @scenario		send a datagram, wait twice without reading, send another one
+* @apicovered		epoll_ctl(), epoll_wait()
+* @precondition		the udp sockets are open
+* @postcondition	none
+*/
+static void tc_net_epoll_wait_edge_p(void)
+{
+	struct epoll_event ev;
+	struct epoll_event out[2];
+	int epfd;
+	int ret;
+
+	epfd = epoll_create(1);
+	TC_ASSERT_GEQ("epoll_create", epfd, 0)
+
+	ev.events = EPOLLIN | EPOLLET;
+	ev.data.u32 = 0x1234;
+	ret = epoll_ctl(epfd, EPOLL_CTL_ADD, g_rx_fd, &ev);
+	TC_ASSERT_EQ_CLEANUP("epoll_ctl", ret, 0, close(epfd))
+
+	ret = epoll_send();
+	TC_ASSERT_GT_CLEANUP("sendto", ret, 0, close(epfd))
+
+	ret = epoll_wait(epfd, out, 2, 1000);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(epfd))
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", out[0].data.u32, 0x1234, close(epfd))
+
+	ret = epoll_wait(epfd, out, 2, 0);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 0, close(epfd))
+
+	ret = epoll_send();
+	TC_ASSERT_GT_CLEANUP("sendto", ret, 0, close(epfd))
+
+	ret = epoll_wait(epfd, out, 2, 1000);
+	TC_ASSERT_EQ_CLEANUP("epoll_wait", ret, 1, close(epfd))
+
+	epoll_drain();
+	epoll_drain();
+	close(epfd);
+	TC_SUCCESS_RESULT()
+}
+
+/**
+* @testcase		tc_net_epoll_wait_n
+* @brief		epoll_wait() fails on a closed epoll descriptor
+* @scenario		close the descriptor and wait on it
+* @apicovered		epoll_wait()
+* @precondition		none
+* @postcondition	none
+*/
+static void tc_net_epoll_wait_n(void)
+{
+	struct epoll_event out;
+	int epfd;
+	int ret;
+
+	epfd = epoll_create(1);
+	TC_ASSERT_GEQ("epoll_create", epfd, 0)
+	close(epfd);
+
+	ret = epoll_wait(epfd, &out, 1, 0);
+	TC_ASSERT_EQ("epoll_wait", ret, -1)
+	TC_SUCCESS_RESULT()
+}
+
+/****************************************************************************
+ * Name: epoll()
+ ****************************************************************************/
+int net_epoll_main(void)
+{
+	g_rx_fd = socket(AF_INET, SOCK_DGRAM, 0);
+	g_tx_fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (g_rx_fd < 0 || g_tx_fd < 0) {
+		printf("socket fail %s:%d\n", __FUNCTION__, __LINE__);
+		goto out;
+	}
+
+	memset(&g_rx_addr, 0, sizeof(g_rx_addr));
+	g_rx_addr.sin_family = AF_INET;
+	g_rx_addr.sin_port = htons(EPOLL_PORTNUM);
+	g_rx_addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+	if (bind(g_rx_fd, (struct sockaddr *)&g_rx_addr, sizeof(g_rx_addr)) < 0) {
+		printf("bind fail %s:%d\n", __FUNCTION__, __LINE__);
+		goto out;
+	}
+
+	tc_net_epoll_create_n();
+	tc_net_epoll_ctl_n();
+	tc_net_epoll_wait_level_p();
+	tc_net_epoll_wait_edge_p();
+	tc_net_epoll_wait_n();
+
+out:
+	if (g_rx_fd >= 0) {
+		close(g_rx_fd);
+	}
+	if (g_tx_fd >= 0) {
+		close(g_tx_fd);
+	}
+	return 0;
+}
@@ -0,0 +1,228 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+
+/// @file tc_net_mmsg.c
+/// @brief Test Case Example for recvmmsg() and sendmmsg() API
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "tc_internal.h"
+
+#define MMSG_PORTNUM 5018
+#define MMSG_COUNT 4
+#define MMSG_LEN 16
+
+static int g_rx_fd = -1;
+static int g_tx_fd = -1;
+static struct sockaddr_in g_rx_addr;
+
+/**
+* @testcase		tc_net_sendmmsg_recvmmsg_p
+* @brief		several datagrams go out in one sendmmsg() and come back in one recvmmsg()
+* @scenario		send MMSG_COUNT datagrams of different lengths, receive them all, check lengths and payloads
+* @apicovered		sendmmsg(), recvmmsg()
+* @precondition		the udp sockets are open
+* @postcondition	none
+*/
+static void tc_net_sendmmsg_recvmmsg_p(void)
+{
+	struct mmsghdr tx[MMSG_COUNT];
+	struct mmsghdr rx[MMSG_COUNT];
+	struct iovec txiov[MMSG_COUNT];
+	struct iovec rxiov[MMSG_COUNT];
+	char txbuf[MMSG_COUNT][MMSG_LEN];
+	char rxbuf[MMSG_COUNT][MMSG_LEN];
+	int ret;
+	int i;
+
+	memset(tx, 0, sizeof(tx));
+	memset(rx, 0, sizeof(rx));
+	for (i = 0; i < MMSG_COUNT; i++) {
+		memset(txbuf[i], 'a' + i, MMSG_LEN);
+		txiov[i].iov_base = txbuf[i];
+		txiov[i].iov_len = i + 1;
+		tx[i].msg_hdr.msg_name = &g_rx_addr;
+		tx[i].msg_hdr.msg_namelen = sizeof(g_rx_addr);
+		tx[i].msg_hdr.msg_iov = &txiov[i];
+		tx[i].msg_hdr.msg_iovlen = 1;
+
+		rxiov[i].iov_base = rxbuf[i];
+		rxiov[i].iov_len = MMSG_LEN;
+		rx[i].msg_hdr.msg_iov = &rxiov[i];
+		rx[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	ret = sendmmsg(g_tx_fd, tx, MMSG_COUNT, 0);
+	TC_ASSERT_EQ("sendmmsg", ret, MMSG_COUNT)
+	for (i = 0; i < MMSG_COUNT; i++) {
+		TC_ASSERT_EQ("sendmmsg", tx[i].msg_len, i + 1)
+	}
+
+	ret = recvmmsg(g_rx_fd, rx, MMSG_COUNT, 0, NULL);
+	TC_ASSERT_EQ("recvmmsg", ret, MMSG_COUNT)
+	for (i = 0; i < MMSG_COUNT; i++) {
+		TC_ASSERT_EQ("recvmmsg", rx[i].msg_len, i + 1)
+		TC_ASSERT_EQ("recvmmsg", rxbuf[i][0], 'a' + i)
+	}
+	TC_SUCCESS_RESULT()
+}
+
+/**
+* @testcase		tc_net_recvmmsg_waitforone_p
+* @brief		with MSG_WAITFORONE, recvmmsg() returns the datagrams already queued
+* @scenario		send two datagrams, ask for MMSG_COUNT with MSG_WAITFORONE
+* @apicovered		recvmmsg()
+* @precondition		the udp sockets are open
+* @postcondition	none
+*/
+static void tc_net_recvmmsg_waitforone_p(void)
+{
+	struct mmsghdr rx[MMSG_COUNT];
+	struct iovec rxiov[MMSG_COUNT];
+	char rxbuf[MMSG_COUNT][MMSG_LEN];
+	int ret;
+	int i;
+
+	memset(rx, 0, sizeof(rx));
+	for (i = 0; i < MMSG_COUNT; i++) {
+		rxiov[i].iov_base = rxbuf[i];
+		rxiov[i].iov_len = MMSG_LEN;
+		rx[i].msg_hdr.msg_iov = &rxiov[i];
+		rx[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	for (i = 0; i < 2; i++) {
+		ret = sendto(g_tx_fd, "mmsg", 4, 0, (struct sockaddr *)&g_rx_addr, sizeof(g_rx_addr));
+		TC_ASSERT_EQ("sendto", ret, 4)
+	}
+
+	ret = recvmmsg(g_rx_fd, rx, MMSG_COUNT, MSG_WAITFORONE, NULL);
+	TC_ASSERT_EQ("recvmmsg", ret, 2)
+	TC_ASSERT_EQ("recvmmsg", rx[1].msg_len, 4)
+	TC_SUCCESS_RESULT()
+}
+
+/**
+* @testcase		tc_net_recvmmsg_trunc_p
+* @brief		a datagram larger than the buffers is truncated and flagged
+* @scenario		send MMSG_LEN bytes, receive into a 4 byte buffer
+* @apicovered		recvmmsg()
+* @precondition		the udp sockets are open
+* @postcondition	none
+*/
+static void tc_net_recvmmsg_trunc_p(void)
+{
+	struct mmsghdr rx;
+	struct iovec rxiov;
+	char txbuf[MMSG_LEN];
+	char rxbuf[4];
+	int ret;
+
+	memset(txbuf, 'x', sizeof(txbuf));
+	ret = sendto(g_tx_fd, txbuf, sizeof(txbuf), 0, (struct sockaddr *)&g_rx_addr, sizeof(g_rx_addr));
+	TC_ASSERT_EQ("sendto", ret, sizeof(txbuf))
+
+	memset(&rx, 0, sizeof(rx));
+	rxiov.iov_base = rxbuf;
+	rxiov.iov_len = sizeof(rxbuf);
+	rx.msg_hdr.msg_iov = &rxiov;
+	rx.msg_hdr.msg_iovlen = 1;
+
+	ret = recvmmsg(g_rx_fd, &rx, 1, 0, NULL);
+	TC_ASSERT_EQ("recvmmsg", ret, 1)
+	TC_ASSERT_EQ("recvmmsg", rx.msg_len, sizeof(rxbuf))
+	TC_ASSERT_EQ("recvmmsg", rx.msg_hdr.msg_flags & MSG_TRUNC, MSG_TRUNC)
+	TC_SUCCESS_RESULT()
+}
+
+/**
+* @testcase		tc_net_mmsg_n
+* @brief		recvmmsg() and sendmmsg() reject bad arguments
+* @scenario		call both with an invalid socket, a NULL vector, and recvmmsg() with nothing queued
+* @apicovered		recvmmsg(), sendmmsg()
+* @precondition		the udp sockets are open
+* @postcondition	none
+*/
+static void tc_net_mmsg_n(void)
+{
+	struct mmsghdr rx;
+	struct iovec rxiov;
+	char rxbuf[MMSG_LEN];
+	int ret;
+
+	ret = sendmmsg(-1, NULL, 1, 0);
+	TC_ASSERT_EQ("sendmmsg", ret, -1)
+	ret = sendmmsg(g_tx_fd, NULL, 1, 0);
+	TC_ASSERT_EQ("sendmmsg", ret, -1)
+	ret = recvmmsg(-1, NULL, 1, 0, NULL);
+	TC_ASSERT_EQ("recvmmsg", ret, -1)
+
+	memset(&rx, 0, sizeof(rx));
+	rxiov.iov_base = rxbuf;
+	rxiov.iov_len = sizeof(rxbuf);
+	rx.msg_hdr.msg_iov = &rxiov;
+	rx.msg_hdr.msg_iovlen = 1;
+	ret = recvmmsg(g_rx_fd, &rx, 1, MSG_DONTWAIT, NULL);
+	TC_ASSERT_EQ("recvmmsg", ret, -1)
+	TC_ASSERT_EQ("recvmmsg", errno, EWOULDBLOCK)
+	TC_SUCCESS_RESULT()
+}
+
+/****************************************************************************
+ * Name: mmsg()
+ ****************************************************************************/
+int net_mmsg_main(void)
+{
+	g_rx_fd = socket(AF_INET, SOCK_DGRAM, 0);
+	g_tx_fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (g_rx_fd < 0 || g_tx_fd < 0) {
+		printf("socket fail %s:%d\n", __FUNCTION__, __LINE__);
+		goto out;
+	}
+
+	memset(&g_rx_addr, 0, sizeof(g_rx_addr));
+	g_rx_addr.sin_family = AF_INET;
+	g_rx_addr.sin_port = htons(MMSG_PORTNUM);
+	g_rx_addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+	if (bind(g_rx_fd, (struct sockaddr *)&g_rx_addr, sizeof(g_rx_addr)) < 0) {
+		printf("bind fail %s:%d\n", __FUNCTION__, __LINE__);
+		goto out;
+	}
+
+	tc_net_sendmmsg_recvmmsg_p();
+	tc_net_recvmmsg_waitforone_p();
+	tc_net_recvmmsg_trunc_p();
+	tc_net_mmsg_n();
+
+out:
+	if (g_rx_fd >= 0) {
+		close(g_rx_fd);
+	}
+	if (g_tx_fd >= 0) {
+		close(g_tx_fd);
+	}
+	return 0;
+}
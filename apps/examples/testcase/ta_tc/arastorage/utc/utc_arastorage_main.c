@@ -37,12 +37,23 @@
 
 #define RELATION_NAME1  "rel1"
 #define RELATION_NAME2  "rel2"
+#define RELATION_NAME3  "rel3"
 #define INDEX_BPLUS     "bplustree"
 #define INDEX_INLINE    "inline"
 #define QUERY_LENGTH    128
 
 #define DATA_SET_NUM    10
 #define DATA_SET_MULTIPLIER 80
+#define LARGE_TUPLE_NUM 1100
+#define INDEX_TUPLE_NUM 1000
+#define SCAN_TUPLE_NUM  20
+#define SCAN_APPEND_NUM 5
+#define INDEX_RANGE_MIN 100
+#define INDEX_RANGE_MAX 120
+/* Below DB_TUPLES_LIMIT with the insertion after the build, so nothing is flushed */
+#define BULK_TUPLE_NUM  900
+#define BULK_RUN_KEY    7
+#define BULK_RUN_NUM    100
 
 /****************************************************************************
  *  Global Variables
@@ -103,6 +114,10 @@ static void cleanup(void)
 	memset(query, 0, QUERY_LENGTH);
 	snprintf(query, QUERY_LENGTH, "REMOVE RELATION %s;", RELATION_NAME2);
 	db_exec(query);
+
+	memset(query, 0, QUERY_LENGTH);
+	snprintf(query, QUERY_LENGTH, "REMOVE RELATION %s;", RELATION_NAME3);
+	db_exec(query);
 }
 
 /**
@@ -371,6 +386,683 @@ static void utc_arastorage_db_exec_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @testcase         utc_arastorage_db_query_scan_p
+* @brief            Query a relation with a sequential scan
+* @scenario         Select on an attribute without index, so that all tuples are read
+*                   through the scan buffer, and check the number of matched tuples
+* @apicovered       db_query, cursor_get_count
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_query_scan_p(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	tuple_id_t count;
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, fruit FROM %s WHERE date = %ld;", RELATION_NAME1, g_arastorage_data_set[0].long_value);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+
+	count = cursor_get_count(g_cursor);
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", count, DATA_SET_MULTIPLIER, db_cursor_free(g_cursor));
+
+	res = db_cursor_free(g_cursor);
+	TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+	g_cursor = NULL;
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_query_stream_p
+* @brief            Query a relation through a streaming cursor
+* @scenario         Select on an attribute without index, read the matched tuples
+*                   one by one and check their values and number
+* @apicovered       db_query_stream, cursor_move_first, cursor_move_next, cursor_move_prev,
+*                   cursor_get_int_value, cursor_get_string_value
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_query_stream_p(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	unsigned char *fruit;
+	tuple_id_t count;
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, fruit FROM %s WHERE date = %ld;", RELATION_NAME1, g_arastorage_data_set[0].long_value);
+	g_cursor = db_query_stream(query);
+	TC_ASSERT_NEQ("db_query_stream", g_cursor, NULL);
+
+	count = 0;
+	res = cursor_move_first(g_cursor);
+	while (DB_SUCCESS(res)) {
+		TC_ASSERT_EQ_CLEANUP("cursor_get_int_value", cursor_get_int_value(g_cursor, 0) % DATA_SET_NUM, 0, db_cursor_free(g_cursor));
+		fruit = cursor_get_string_value(g_cursor, 1);
+		TC_ASSERT_NEQ_CLEANUP("cursor_get_string_value", fruit, NULL, db_cursor_free(g_cursor));
+		TC_ASSERT_EQ_CLEANUP("cursor_get_string_value", strcmp((char *)fruit, g_arastorage_data_set[0].string_value), 0, db_cursor_free(g_cursor));
+		count++;
+		res = cursor_move_next(g_cursor);
+	}
+	TC_ASSERT_EQ_CLEANUP("cursor_move_next", count, DATA_SET_MULTIPLIER, db_cursor_free(g_cursor));
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), DATA_SET_MULTIPLIER, db_cursor_free(g_cursor));
+
+	/* A streaming cursor does not move backward. */
+	res = cursor_move_prev(g_cursor);
+	TC_ASSERT_EQ_CLEANUP("cursor_move_prev", DB_ERROR(res), true, db_cursor_free(g_cursor));
+
+	res = db_cursor_free(g_cursor);
+	TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+	g_cursor = NULL;
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_query_stream_n
+* @brief            Query a relation through a streaming cursor with invalid argument
+* @scenario         Stream NULL, an aggregation and a sentence with parameter
+* @apicovered       db_query_stream
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_query_stream_n(void)
+{
+	char query[QUERY_LENGTH];
+
+	g_cursor = db_query_stream(NULL);
+	TC_ASSERT_EQ("db_query_stream", g_cursor, NULL);
+
+	snprintf(query, QUERY_LENGTH, "SELECT COUNT(id) FROM %s;", RELATION_NAME1);
+	g_cursor = db_query_stream(query);
+	TC_ASSERT_EQ("db_query_stream", g_cursor, NULL);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id > ?;", RELATION_NAME1);
+	g_cursor = db_query_stream(query);
+	TC_ASSERT_EQ("db_query_stream", g_cursor, NULL);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_explain_p
+* @brief            Describe the access path chosen for queries
+* @scenario         Explain a point query on the inline indexed id, a query on the
+*                   attribute without index and a query whose B+tree range covers
+*                   every tuple, and check which access path is chosen
+* @apicovered       db_explain
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_explain_p(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	char plan[QUERY_LENGTH];
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id = 5;", RELATION_NAME1);
+	res = db_explain(query, plan, QUERY_LENGTH);
+	TC_ASSERT_EQ("db_explain", DB_SUCCESS(res), true);
+	TC_ASSERT_NEQ("db_explain", strstr(plan, "inline index scan on id"), NULL);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE date = %ld;", RELATION_NAME1, g_arastorage_data_set[0].long_value);
+	res = db_explain(query, plan, QUERY_LENGTH);
+	TC_ASSERT_EQ("db_explain", DB_SUCCESS(res), true);
+	TC_ASSERT_NEQ("db_explain", strstr(plan, "sequential scan"), NULL);
+
+	/* Reading every tuple through the B+tree costs more than a scan */
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE value > 0;", RELATION_NAME1);
+	res = db_explain(query, plan, QUERY_LENGTH);
+	TC_ASSERT_EQ("db_explain", DB_SUCCESS(res), true);
+	TC_ASSERT_EQ("db_explain", strstr(plan, "bplustree"), NULL);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_explain_n
+* @brief            Describe queries with invalid argument
+* @scenario         Explain NULL, a query with parameter, a query on non-existent
+*                   relation and a query with a too small buffer
+* @apicovered       db_explain
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_explain_n(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	char plan[QUERY_LENGTH];
+
+	res = db_explain(NULL, plan, QUERY_LENGTH);
+	TC_ASSERT_EQ("db_explain", DB_ERROR(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id > ?;", RELATION_NAME1);
+	res = db_explain(query, plan, QUERY_LENGTH);
+	TC_ASSERT_EQ("db_explain", DB_ERROR(res), true);
+
+	res = db_explain("SELECT id FROM BAD_RELATION;", plan, QUERY_LENGTH);
+	TC_ASSERT_EQ("db_explain", DB_ERROR(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s;", RELATION_NAME1);
+	res = db_explain(query, plan, 4);
+	TC_ASSERT_EQ("db_explain", DB_ERROR(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_get_buffer_pool_stats_p
+* @brief            Get the statistics of the index buffer pool
+* @scenario         Query the B+tree index twice and check that its pages were
+*                   read into the pool and then found in it
+* @apicovered       db_get_buffer_pool_stats
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_get_buffer_pool_stats_p(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	db_buffer_pool_stats_t before;
+	db_buffer_pool_stats_t after;
+	int i;
+
+	res = db_get_buffer_pool_stats(&before);
+	TC_ASSERT_EQ("db_get_buffer_pool_stats", DB_SUCCESS(res), true);
+	TC_ASSERT_GT("db_get_buffer_pool_stats", before.pages, 0);
+
+	for (i = 0; i < 2; i++) {
+		snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE value = 1000;", RELATION_NAME1);
+		g_cursor = db_query(query);
+		TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+		res = db_cursor_free(g_cursor);
+		TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+		g_cursor = NULL;
+	}
+
+	res = db_get_buffer_pool_stats(&after);
+	TC_ASSERT_EQ("db_get_buffer_pool_stats", DB_SUCCESS(res), true);
+	TC_ASSERT_GT("db_get_buffer_pool_stats", after.hits, before.hits);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_get_buffer_pool_stats_n
+* @brief            Get the statistics of the index buffer pool with invalid argument
+* @scenario         Pass NULL instead of the statistics
+* @apicovered       db_get_buffer_pool_stats
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_get_buffer_pool_stats_n(void)
+{
+	db_result_t res;
+
+	res = db_get_buffer_pool_stats(NULL);
+	TC_ASSERT_EQ("db_get_buffer_pool_stats", DB_ERROR(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_prepare_p
+* @brief            Execute prepared statements with bound parameters
+* @scenario         Prepare INSERT and SELECT once, execute them with new parameters
+*                   and check the number of selected tuples
+* @apicovered       db_prepare, db_bind_long, db_stmt_exec, db_stmt_query, db_finalize
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_prepare_p(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	char query[QUERY_LENGTH];
+	tuple_id_t count;
+	int i;
+
+	snprintf(query, QUERY_LENGTH, "INSERT (?, ?) INTO %s;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	for (i = 0; i < DATA_SET_NUM; i++) {
+		res = db_bind_long(stmt, 0, DATA_SET_NUM * 100 + i);
+		TC_ASSERT_EQ_CLEANUP("db_bind_long", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_bind_long(stmt, 1, g_arastorage_data_set[i].long_value);
+		TC_ASSERT_EQ_CLEANUP("db_bind_long", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_stmt_exec(stmt);
+		TC_ASSERT_EQ_CLEANUP("db_stmt_exec", DB_SUCCESS(res), true, db_finalize(stmt));
+	}
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, date FROM %s WHERE id >= ?;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	for (i = 0; i < DATA_SET_NUM; i++) {
+		res = db_bind_long(stmt, 0, DATA_SET_NUM * 100 + i);
+		TC_ASSERT_EQ_CLEANUP("db_bind_long", DB_SUCCESS(res), true, db_finalize(stmt));
+
+		g_cursor = db_stmt_query(stmt);
+		TC_ASSERT_NEQ_CLEANUP("db_stmt_query", g_cursor, NULL, db_finalize(stmt));
+
+		count = cursor_get_count(g_cursor);
+		db_cursor_free(g_cursor);
+		g_cursor = NULL;
+		TC_ASSERT_EQ_CLEANUP("cursor_get_count", count, DATA_SET_NUM - i, db_finalize(stmt));
+	}
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_prepare_n
+* @brief            Prepare and execute statements with invalid argument
+* @scenario         Prepare NULL, bind an invalid parameter, execute an unbound statement
+*                   and query a sentence with parameter without preparing it
+* @apicovered       db_prepare, db_bind_long, db_bind_string, db_stmt_exec, db_query, db_finalize
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_prepare_n(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	char query[QUERY_LENGTH];
+
+	stmt = db_prepare(NULL);
+	TC_ASSERT_EQ("db_prepare", stmt, NULL);
+
+	res = db_finalize(NULL);
+	TC_ASSERT_EQ("db_finalize", DB_ERROR(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id > ?;", RELATION_NAME2);
+	g_cursor = db_query(query);
+	TC_ASSERT_EQ("db_query", g_cursor, NULL);
+
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	res = db_stmt_exec(stmt);
+	TC_ASSERT_EQ_CLEANUP("db_stmt_exec", DB_ERROR(res), true, db_finalize(stmt));
+
+	res = db_bind_long(stmt, 1, 0);
+	TC_ASSERT_EQ_CLEANUP("db_bind_long", DB_ERROR(res), true, db_finalize(stmt));
+
+	res = db_bind_string(stmt, 0, "apple");
+	TC_ASSERT_EQ_CLEANUP("db_bind_string", DB_ERROR(res), true, db_finalize(stmt));
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_bulk_insert_p
+* @brief            Insert tuples in a bulk insertion
+* @scenario         Insert tuples between BEGIN and COMMIT in descending key order
+*                   and select them through the index on the key
+* @apicovered       db_exec, db_query
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_bulk_insert_p(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	tuple_id_t count;
+	int i;
+
+	snprintf(query, QUERY_LENGTH, "BEGIN %s;", RELATION_NAME2);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	for (i = 0; i < DATA_SET_NUM; i++) {
+		snprintf(query, QUERY_LENGTH, "INSERT (%d, %d) INTO %s;", DATA_SET_NUM * 200 + i,
+				 20000 + DATA_SET_NUM - i, RELATION_NAME2);
+		res = db_exec(query);
+		TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+	}
+
+	snprintf(query, QUERY_LENGTH, "COMMIT %s;", RELATION_NAME2);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, date FROM %s WHERE date > 20000;", RELATION_NAME2);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+
+	count = cursor_get_count(g_cursor);
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+	TC_ASSERT_EQ("cursor_get_count", count, DATA_SET_NUM);
+
+	TC_SUCCESS_RESULT();
+}
+
+static void cleanup_large_relation(void)
+{
+	char query[QUERY_LENGTH];
+
+	if (g_cursor != NULL) {
+		db_cursor_free(g_cursor);
+		g_cursor = NULL;
+	}
+
+	snprintf(query, QUERY_LENGTH, "REMOVE RELATION %s;", RELATION_NAME3);
+	db_exec(query);
+}
+
+/**
+* @testcase         utc_arastorage_db_query_large_p
+* @brief            Query a relation with more than 1000 tuples
+* @scenario         Insert LARGE_TUPLE_NUM tuples, select them with db_query and
+*                   db_query_stream, then remove the relation
+* @apicovered       db_exec, db_query, db_query_stream, cursor_move_to
+* @precondition     utc_arastorage_db_init_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_query_large_p(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	tuple_id_t count;
+	int i;
+
+	snprintf(query, QUERY_LENGTH, "CREATE RELATION %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE ATTRIBUTE %s DOMAIN int IN %s;", g_attribute_set[0], RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+
+	for (i = 0; i < LARGE_TUPLE_NUM; i++) {
+		snprintf(query, QUERY_LENGTH, "INSERT (%d) INTO %s;", i, RELATION_NAME3);
+		res = db_exec(query);
+		TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+	}
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id >= %d;", RELATION_NAME3, LARGE_TUPLE_NUM / 2);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ_CLEANUP("db_query", g_cursor, NULL, cleanup_large_relation());
+
+	count = cursor_get_count(g_cursor);
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", count, LARGE_TUPLE_NUM / 2, cleanup_large_relation());
+
+	/* The last tuple lies beyond the first 1000 tuples of the relation */
+	res = cursor_move_to(g_cursor, count - 1);
+	TC_ASSERT_EQ_CLEANUP("cursor_move_to", DB_SUCCESS(res), true, cleanup_large_relation());
+	TC_ASSERT_EQ_CLEANUP("cursor_get_int_value", cursor_get_int_value(g_cursor, 0), LARGE_TUPLE_NUM - 1, cleanup_large_relation());
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+
+	g_cursor = db_query_stream(query);
+	TC_ASSERT_NEQ_CLEANUP("db_query_stream", g_cursor, NULL, cleanup_large_relation());
+
+	count = 0;
+	res = cursor_move_first(g_cursor);
+	while (DB_SUCCESS(res)) {
+		count++;
+		res = cursor_move_next(g_cursor);
+	}
+	TC_ASSERT_EQ_CLEANUP("cursor_move_next", count, LARGE_TUPLE_NUM / 2, cleanup_large_relation());
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+
+	snprintf(query, QUERY_LENGTH, "REMOVE RELATION %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_query_scan_append_p
+* @brief            Scan a relation again after appending to it
+* @scenario         Select all SCAN_TUPLE_NUM tuples so that they are held in the scan
+*                   buffer, append SCAN_APPEND_NUM tuples and select them all again
+* @apicovered       db_exec, db_query, cursor_move_last
+* @precondition     utc_arastorage_db_init_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_query_scan_append_p(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	int i;
+
+	snprintf(query, QUERY_LENGTH, "CREATE RELATION %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE ATTRIBUTE %s DOMAIN int IN %s;", g_attribute_set[0], RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+
+	for (i = 0; i < SCAN_TUPLE_NUM + SCAN_APPEND_NUM; i++) {
+		if (i == SCAN_TUPLE_NUM) {
+			snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id >= 0;", RELATION_NAME3);
+			g_cursor = db_query(query);
+			TC_ASSERT_NEQ_CLEANUP("db_query", g_cursor, NULL, cleanup_large_relation());
+			TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), SCAN_TUPLE_NUM, cleanup_large_relation());
+			db_cursor_free(g_cursor);
+			g_cursor = NULL;
+		}
+		snprintf(query, QUERY_LENGTH, "INSERT (%d) INTO %s;", i, RELATION_NAME3);
+		res = db_exec(query);
+		TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+	}
+
+	/* The appended tuples are read from the tuple file, not from the scan buffer */
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id >= 0;", RELATION_NAME3);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ_CLEANUP("db_query", g_cursor, NULL, cleanup_large_relation());
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), SCAN_TUPLE_NUM + SCAN_APPEND_NUM, cleanup_large_relation());
+	res = cursor_move_last(g_cursor);
+	TC_ASSERT_EQ_CLEANUP("cursor_move_last", DB_SUCCESS(res), true, cleanup_large_relation());
+	TC_ASSERT_EQ_CLEANUP("cursor_get_int_value", cursor_get_int_value(g_cursor, 0), SCAN_TUPLE_NUM + SCAN_APPEND_NUM - 1, cleanup_large_relation());
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+
+	snprintf(query, QUERY_LENGTH, "REMOVE RELATION %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_bulk_build_p
+* @brief            Build an empty B+tree index in a bulk insertion
+* @scenario         Insert BULK_TUPLE_NUM tuples into an empty relation with a
+*                   B+tree index between BEGIN and COMMIT, the first BULK_RUN_NUM
+*                   of them with the same key so that they span several buckets.
+*                   Select the run and a range through the index, insert one
+*                   more tuple and select it again.
+* @apicovered       db_exec, db_explain, db_query
+* @precondition     utc_arastorage_db_init_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_bulk_build_p(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	char plan[QUERY_LENGTH];
+	int i;
+
+	snprintf(query, QUERY_LENGTH, "CREATE RELATION %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE ATTRIBUTE %s DOMAIN int IN %s;", g_attribute_set[0], RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+
+	snprintf(query, QUERY_LENGTH, "CREATE INDEX %s.%s TYPE %s;", RELATION_NAME3, g_attribute_set[0], INDEX_BPLUS);
+	res = db_exec(query);
+	TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+
+	snprintf(query, QUERY_LENGTH, "BEGIN %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+
+	/* Descending order, so that the keys are sorted on COMMIT */
+	for (i = BULK_TUPLE_NUM - 1; i >= 0; i--) {
+		snprintf(query, QUERY_LENGTH, "INSERT (%d) INTO %s;", (i < BULK_RUN_NUM) ? BULK_RUN_KEY : i, RELATION_NAME3);
+		res = db_exec(query);
+		TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+	}
+
+	snprintf(query, QUERY_LENGTH, "COMMIT %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id = %d;", RELATION_NAME3, BULK_RUN_KEY);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ_CLEANUP("db_query", g_cursor, NULL, cleanup_large_relation());
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), BULK_RUN_NUM, cleanup_large_relation());
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id >= %d AND id < %d;", RELATION_NAME3, INDEX_RANGE_MIN + BULK_RUN_NUM, INDEX_RANGE_MAX + BULK_RUN_NUM);
+	res = db_explain(query, plan, QUERY_LENGTH);
+	TC_ASSERT_EQ_CLEANUP("db_explain", DB_SUCCESS(res), true, cleanup_large_relation());
+	TC_ASSERT_NEQ_CLEANUP("db_explain", strstr(plan, "bplustree index scan on id"), NULL, cleanup_large_relation());
+
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ_CLEANUP("db_query", g_cursor, NULL, cleanup_large_relation());
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), INDEX_RANGE_MAX - INDEX_RANGE_MIN, cleanup_large_relation());
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+
+	/* The built tree takes further insertions */
+	snprintf(query, QUERY_LENGTH, "INSERT (%d) INTO %s;", BULK_RUN_KEY, RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id = %d;", RELATION_NAME3, BULK_RUN_KEY);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ_CLEANUP("db_query", g_cursor, NULL, cleanup_large_relation());
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), BULK_RUN_NUM + 1, cleanup_large_relation());
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+
+	snprintf(query, QUERY_LENGTH, "REMOVE RELATION %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_query_stream_index_p
+* @brief            Query a B+tree indexed range through a streaming cursor
+* @scenario         Insert INDEX_TUPLE_NUM tuples into a relation with a B+tree
+*                   index, check that a narrow range query uses the index and
+*                   stream it, checking the values and the number of tuples
+* @apicovered       db_exec, db_explain, db_query_stream, cursor_move_first,
+*                   cursor_move_next, cursor_get_int_value
+* @precondition     utc_arastorage_db_init_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_query_stream_index_p(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	char plan[QUERY_LENGTH];
+	tuple_id_t count;
+	int value;
+	int i;
+
+	snprintf(query, QUERY_LENGTH, "CREATE RELATION %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE ATTRIBUTE %s DOMAIN int IN %s;", g_attribute_set[0], RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+
+	snprintf(query, QUERY_LENGTH, "CREATE INDEX %s.%s TYPE %s;", RELATION_NAME3, g_attribute_set[0], INDEX_BPLUS);
+	res = db_exec(query);
+	TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+
+	for (i = 0; i < INDEX_TUPLE_NUM; i++) {
+		snprintf(query, QUERY_LENGTH, "INSERT (%d) INTO %s;", i, RELATION_NAME3);
+		res = db_exec(query);
+		TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, cleanup_large_relation());
+	}
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id >= %d AND id < %d;", RELATION_NAME3, INDEX_RANGE_MIN, INDEX_RANGE_MAX);
+	res = db_explain(query, plan, QUERY_LENGTH);
+	TC_ASSERT_EQ_CLEANUP("db_explain", DB_SUCCESS(res), true, cleanup_large_relation());
+	TC_ASSERT_NEQ_CLEANUP("db_explain", strstr(plan, "bplustree index scan on id"), NULL, cleanup_large_relation());
+
+	g_cursor = db_query_stream(query);
+	TC_ASSERT_NEQ_CLEANUP("db_query_stream", g_cursor, NULL, cleanup_large_relation());
+
+	count = 0;
+	res = cursor_move_first(g_cursor);
+	while (DB_SUCCESS(res)) {
+		value = cursor_get_int_value(g_cursor, 0);
+		TC_ASSERT_EQ_CLEANUP("cursor_get_int_value", (value >= INDEX_RANGE_MIN && value < INDEX_RANGE_MAX), true, cleanup_large_relation());
+		count++;
+		res = cursor_move_next(g_cursor);
+	}
+	TC_ASSERT_EQ_CLEANUP("cursor_move_next", count, INDEX_RANGE_MAX - INDEX_RANGE_MIN, cleanup_large_relation());
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+
+	/* The index is not left locked by the streaming cursor */
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ_CLEANUP("db_query", g_cursor, NULL, cleanup_large_relation());
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), INDEX_RANGE_MAX - INDEX_RANGE_MIN, cleanup_large_relation());
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+
+	snprintf(query, QUERY_LENGTH, "REMOVE RELATION %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_bulk_insert_n
+* @brief            Begin and commit a bulk insertion with invalid argument
+* @scenario         Commit without BEGIN and begin without a valid relation
+* @apicovered       db_exec
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_bulk_insert_n(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+
+	snprintf(query, QUERY_LENGTH, "COMMIT %s;", RELATION_NAME2);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_ERROR(res), true);
+
+	res = db_exec("BEGIN;");
+	TC_ASSERT_EQ("db_exec", DB_ERROR(res), true);
+
+	res = db_exec("BEGIN invalid_rel;");
+	TC_ASSERT_EQ("db_exec", DB_ERROR(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
 /**
 * @testcase         utc_arastorage_db_query_p
 * @brief            Query a database
@@ -1526,6 +2218,16 @@ int utc_arastorage_main(int argc, char *argv[])
 	/* Positive TCs */
 	utc_arastorage_db_init_p();
 	utc_arastorage_db_exec_p();
+	utc_arastorage_db_query_scan_p();
+	utc_arastorage_db_query_stream_p();
+	utc_arastorage_db_explain_p();
+	utc_arastorage_db_get_buffer_pool_stats_p();
+	utc_arastorage_db_prepare_p();
+	utc_arastorage_db_bulk_insert_p();
+	utc_arastorage_db_query_large_p();
+	utc_arastorage_db_query_scan_append_p();
+	utc_arastorage_db_query_stream_index_p();
+	utc_arastorage_db_bulk_build_p();
 	utc_arastorage_db_query_p();
 	utc_arastorage_db_get_result_message_p();
 	utc_arastorage_db_print_header_p();
@@ -1557,6 +2259,11 @@ int utc_arastorage_main(int argc, char *argv[])
 	/* Negative TCs */
 	utc_arastorage_db_exec_n();
 	utc_arastorage_db_query_n();
+	utc_arastorage_db_query_stream_n();
+	utc_arastorage_db_explain_n();
+	utc_arastorage_db_get_buffer_pool_stats_n();
+	utc_arastorage_db_prepare_n();
+	utc_arastorage_db_bulk_insert_n();
 	utc_arastorage_db_get_result_message_n();
 	utc_arastorage_db_print_header_n();
 	utc_arastorage_db_print_tuple_n();
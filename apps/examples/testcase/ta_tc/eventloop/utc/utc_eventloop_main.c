@@ -38,6 +38,7 @@
 
 #define EL_SEND_COUNT 5
 #define EL_WIFI_ON_COUNT 3
+#define EL_TIMER_COUNT 100	/* more than the initial timer table holds, so it grows */
 
 static int el_timer_flag;
 static int el_thread_safe_flag;
@@ -193,10 +194,19 @@ static void utc_eventloop_add_timer_p(void)
 static void utc_eventloop_delete_timer_n(void)
 {
 	int ret;
+	el_timer_t *timer;
 
 	ret = eventloop_delete_timer(NULL);
 	TC_ASSERT_EQ("eventloop_delete_timer", ret, EVENTLOOP_INVALID_PARAM);
 
+	/* Try to delete a timer which already expired and was released */
+	timer = eventloop_add_timer(0, false, (timeout_callback)timer_cb, EL_TIMER_DATA);
+	TC_ASSERT_NEQ("eventloop_add_timer", timer, NULL);
+	ret = eventloop_loop_run();
+	TC_ASSERT_EQ("eventloop_loop_run", ret, OK);
+	ret = eventloop_delete_timer(timer);
+	TC_ASSERT_EQ("eventloop_delete_timer", ret, EVENTLOOP_INVALID_HANDLE);
+
 	TC_SUCCESS_RESULT();
 }
 
@@ -304,6 +314,29 @@ static void wifi_off_callback(void *cb_data, void *event_data)
 	}
 }
 
+static void utc_eventloop_add_timer_many_p(void)
+{
+	int ret;
+	int idx;
+	el_timer_t *timers[EL_TIMER_COUNT];
+
+	/* Add timers expiring in mixed order and delete every other one of them */
+	el_timer_flag = 0;
+	for (idx = 0; idx < EL_TIMER_COUNT; idx++) {
+		timers[idx] = eventloop_add_timer((EL_TIMER_COUNT - idx) * 10 % 70, false, (timeout_callback)timer_cb, EL_TIMER_DATA);
+		TC_ASSERT_NEQ("eventloop_add_timer", timers[idx], NULL);
+	}
+	for (idx = 0; idx < EL_TIMER_COUNT; idx += 2) {
+		ret = eventloop_delete_timer(timers[idx]);
+		TC_ASSERT_EQ("eventloop_delete_timer", ret, OK);
+	}
+	ret = eventloop_loop_run();
+	TC_ASSERT_EQ("eventloop_loop_run", ret, OK);
+	TC_ASSERT_EQ("eventloop_add_timer", el_timer_flag, EL_TIMER_COUNT / 2);
+
+	TC_SUCCESS_RESULT();
+}
+
 static void utc_eventloop_add_event_handler_n(void)
 {
 	el_event_t *event_handle;
@@ -469,6 +502,7 @@ int utc_eventloop_main(int argc, char *argv[])
 
 	utc_eventloop_delete_timer_n();
 	utc_eventloop_delete_timer_p();
+	utc_eventloop_add_timer_many_p();
 
 	utc_eventloop_add_timer_async_n();
 	utc_eventloop_add_timer_async_p();
@@ -55,6 +55,9 @@ int utc_media_bufferoutputdatasource_main(void);
 #ifdef CONFIG_MEDIA_VOICE_SPEECH_DETECTOR
 int utc_media_SpeechDetector_main(void);
 #endif
+#ifdef CONFIG_MEDIA_STREAM_BUFFER_LOCKFREE
+int utc_media_StreamBuffer_main(void);
+#endif
 #endif
 
 extern "C"
@@ -91,6 +94,9 @@ int utc_media_main(int argc, char *argv[])
 #ifdef CONFIG_MEDIA_VOICE_SPEECH_DETECTOR
 	utc_media_SpeechDetector_main();
 #endif
+#ifdef CONFIG_MEDIA_STREAM_BUFFER_LOCKFREE
+	utc_media_StreamBuffer_main();
+#endif
 #endif
 
 	(void)testcase_state_handler(TC_END, "Media UTC");
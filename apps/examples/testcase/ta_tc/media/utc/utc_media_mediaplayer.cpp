@@ -16,6 +16,7 @@
  *
  ****************************************************************************/
 
+#include <tinyara/config.h>
 #include <memory>
 #include <string.h>
 #include <media/MediaPlayer.h>
@@ -641,6 +642,86 @@ static void utc_media_MediaPlayer_isPlaying_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+static void utc_media_MediaPlayer_setStreamGain_p(void)
+{
+	media::MediaPlayer mp;
+	std::unique_ptr<media::stream::FileInputDataSource> source = std::move(std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(dummyfilepath)));
+	mp.create();
+
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setStreamGain", mp.setStreamGain(media::PLAYER_MAX_STREAM_GAIN / 2), media::PLAYER_OK, mp.destroy());
+
+	mp.setDataSource(std::move(source));
+	mp.prepare();
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setStreamGain", mp.setStreamGain(0), media::PLAYER_OK, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setStreamGain", mp.setStreamGain(media::PLAYER_MAX_STREAM_GAIN), media::PLAYER_OK, goto cleanup);
+
+	TC_SUCCESS_RESULT();
+cleanup:
+	mp.unprepare();
+	mp.destroy();
+}
+#endif
+
+static void utc_media_MediaPlayer_setStreamGain_n(void)
+{
+	media::MediaPlayer mp;
+
+	TC_ASSERT_EQ("utc_media_MediaPlayer_setStreamGain", mp.setStreamGain(media::PLAYER_MAX_STREAM_GAIN), media::PLAYER_ERROR_NOT_ALIVE);
+	mp.create();
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setStreamGain", mp.setStreamGain(media::PLAYER_MAX_STREAM_GAIN + 1), media::PLAYER_ERROR_INVALID_PARAMETER, mp.destroy());
+#ifndef CONFIG_MEDIA_AUDIO_MIXER
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setStreamGain", mp.setStreamGain(media::PLAYER_MAX_STREAM_GAIN), media::PLAYER_ERROR_DEVICE_NOT_SUPPORTED, mp.destroy());
+#endif
+	mp.destroy();
+
+	TC_SUCCESS_RESULT();
+}
+
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+static void utc_media_MediaPlayer_setDucking_p(void)
+{
+	media::MediaPlayer mp1, mp2;
+	std::unique_ptr<media::stream::FileInputDataSource> source1 = std::move(std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(dummyfilepath)));
+	std::unique_ptr<media::stream::FileInputDataSource> source2 = std::move(std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(dummyfilepath)));
+	mp1.create();
+	mp2.create();
+
+	/* Both players keep playing, the second one ducks the first */
+	mp1.setDataSource(std::move(source1));
+	mp2.setDataSource(std::move(source2));
+	mp1.prepare();
+	mp2.prepare();
+	mp1.start();
+	mp2.start();
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setDucking", mp1.isPlaying(), true, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setDucking", mp2.isPlaying(), true, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setDucking", mp2.setDucking(true), media::PLAYER_OK, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setDucking", mp2.setDucking(false), media::PLAYER_OK, goto cleanup);
+
+	TC_SUCCESS_RESULT();
+cleanup:
+	mp2.unprepare();
+	mp1.unprepare();
+	mp2.destroy();
+	mp1.destroy();
+}
+#endif
+
+static void utc_media_MediaPlayer_setDucking_n(void)
+{
+	media::MediaPlayer mp;
+
+	TC_ASSERT_EQ("utc_media_MediaPlayer_setDucking", mp.setDucking(true), media::PLAYER_ERROR_NOT_ALIVE);
+#ifndef CONFIG_MEDIA_AUDIO_MIXER
+	mp.create();
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setDucking", mp.setDucking(true), media::PLAYER_ERROR_DEVICE_NOT_SUPPORTED, mp.destroy());
+	mp.destroy();
+#endif
+
+	TC_SUCCESS_RESULT();
+}
+
 static void utc_media_MediaPlayer_operator_equal_p(void)
 {
 	media::MediaPlayer mp;
@@ -705,6 +786,16 @@ int utc_media_MediaPlayer_main(void)
 	utc_media_MediaPlayer_isPlaying_p();
 	utc_media_MediaPlayer_isPlaying_n();
 
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	utc_media_MediaPlayer_setStreamGain_p();
+#endif
+	utc_media_MediaPlayer_setStreamGain_n();
+
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	utc_media_MediaPlayer_setDucking_p();
+#endif
+	utc_media_MediaPlayer_setDucking_n();
+
 	utc_media_MediaPlayer_operator_equal_p();
 	utc_media_MediaPlayer_operator_equal_n();
 
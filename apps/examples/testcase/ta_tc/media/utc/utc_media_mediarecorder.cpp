@@ -706,6 +706,61 @@ static void utc_media_MediaRecorder_isRecording_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+static void utc_media_MediaRecorder_addPeriodListener_p(void)
+{
+	MediaRecorder mr;
+	size_t first = 0;
+	size_t second = 0;
+	auto dataSource = unique_ptr<FileOutputDataSource>(new FileOutputDataSource(channels, sampleRate, pcmFormat, filePath));
+	auto observer = std::make_shared<RecorderTest>();
+	mr.create();
+	mr.setObserver(observer);
+	mr.setDataSource(std::move(dataSource));
+	mr.setDuration(RECORD_DURATION);
+
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaRecorder_addPeriodListener", mr.addPeriodListener([&first](unsigned char *data, size_t size) {
+		first += size;
+	}), RECORDER_OK, mr.destroy());
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaRecorder_addPeriodListener", mr.addPeriodListener([&second](unsigned char *data, size_t size) {
+		second += size;
+	}), RECORDER_OK, mr.destroy());
+
+	mr.prepare();
+	mr.start();
+	sleep(RECORD_DURATION + 1);
+	mr.stop();
+	mr.unprepare();
+	mr.clearPeriodListeners();
+	mr.destroy();
+
+	/* Every listener sees every captured byte */
+	TC_ASSERT_EQ("utc_media_MediaRecorder_addPeriodListener", first, (size_t)(channels * sampleRate * RECORD_DURATION * 2));
+	TC_ASSERT_EQ("utc_media_MediaRecorder_addPeriodListener", second, first);
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_MediaRecorder_addPeriodListener_n(void)
+{
+	/* addPeriodListener before create */
+	{
+		MediaRecorder mr;
+
+		TC_ASSERT_EQ("utc_media_MediaRecorder_addPeriodListener", mr.addPeriodListener([](unsigned char *data, size_t size) {}), RECORDER_ERROR_NOT_ALIVE);
+	}
+
+	/* addPeriodListener with an empty function */
+	{
+		MediaRecorder mr;
+		mr.create();
+
+		TC_ASSERT_EQ_CLEANUP("utc_media_MediaRecorder_addPeriodListener", mr.addPeriodListener(nullptr), RECORDER_ERROR_INVALID_PARAM, mr.destroy());
+
+		mr.destroy();
+	}
+
+	TC_SUCCESS_RESULT();
+}
+
 static void utc_media_MediaRecorder_operator_equal_p(void)
 {
 	MediaRecorder mr;
@@ -768,6 +823,9 @@ int utc_media_mediarecorder_main(void)
 	utc_media_MediaRecorder_isRecording_p();
 	utc_media_MediaRecorder_isRecording_n();
 
+	utc_media_MediaRecorder_addPeriodListener_p();
+	utc_media_MediaRecorder_addPeriodListener_n();
+
 	utc_media_MediaRecorder_operator_equal_p();
 	utc_media_MediaRecorder_operator_equal_n();
 	return 0;
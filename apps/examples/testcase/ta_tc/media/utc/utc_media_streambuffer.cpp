@@ -0,0 +1,150 @@
+/* ****************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <tinyara/config.h>
+#include <thread>
+#include "StreamBuffer.h"
+#include "StreamBufferReader.h"
+#include "StreamBufferWriter.h"
+#include "tc_common.h"
+
+using namespace media::stream;
+
+#define STREAM_BUFFER_SIZE 4096
+#define STREAM_TOTAL_BYTES (256 * 1024)
+#define STREAM_CHUNK_MAX 1500
+
+static unsigned char g_writeBuf[STREAM_CHUNK_MAX];
+static unsigned char g_readBuf[STREAM_CHUNK_MAX];
+
+/* The n-th byte of the stream, so that lost, repeated or reordered data shows */
+static unsigned char stream_byte(size_t n)
+{
+	return (unsigned char)((n * 31) ^ (n >> 8));
+}
+
+/* Chunk sizes vary so that both sides wrap around the ring at different places */
+static size_t stream_chunk(size_t n)
+{
+	return 1 + (n * 7919) % STREAM_CHUNK_MAX;
+}
+
+static void stream_producer(std::shared_ptr<StreamBuffer> stream, bool inPlace)
+{
+	StreamBufferWriter writer(stream);
+	size_t sent = 0;
+	size_t n = 0;
+
+	while (sent < STREAM_TOTAL_BYTES) {
+		size_t size = stream_chunk(n++);
+		if (size > STREAM_TOTAL_BYTES - sent) {
+			size = STREAM_TOTAL_BYTES - sent;
+		}
+
+		if (inPlace) {
+			unsigned char *region;
+			size = writer.reserve(&region, size);
+			if (size == 0) {
+				stream->waitForSpace(1);
+				continue;
+			}
+			for (size_t i = 0; i < size; i++) {
+				region[i] = stream_byte(sent + i);
+			}
+			writer.commit(size);
+		} else {
+			for (size_t i = 0; i < size; i++) {
+				g_writeBuf[i] = stream_byte(sent + i);
+			}
+			size = writer.write(g_writeBuf, size);
+		}
+		sent += size;
+	}
+
+	writer.setEndOfStream();
+}
+
+/* One producer and one consumer move data through a lock-free stream buffer */
+static bool stream_lockfree_transfer(size_t threshold, bool inPlace)
+{
+	auto stream = StreamBuffer::Builder()
+					  .setBufferSize(STREAM_BUFFER_SIZE)
+					  .setThreshold(threshold)
+					  .setLockFree(true)
+					  .build();
+	TC_ASSERT_EQ_RETURN("StreamBuffer::Builder::build", (stream != nullptr), true, false);
+
+	StreamBufferReader reader(stream);
+	std::thread producer(stream_producer, stream, inPlace);
+	size_t received = 0;
+	size_t mismatch = 0;
+	size_t n = 0;
+	size_t size;
+
+	do {
+		size = reader.read(g_readBuf, stream_chunk(n++));
+		for (size_t i = 0; i < size; i++) {
+			if (g_readBuf[i] != stream_byte(received + i)) {
+				mismatch++;
+			}
+		}
+		received += size;
+	} while (size > 0);
+
+	producer.join();
+
+	TC_ASSERT_EQ_RETURN("StreamBufferReader::read", received, STREAM_TOTAL_BYTES, false);
+	TC_ASSERT_EQ_RETURN("StreamBufferReader::read", mismatch, 0, false);
+	TC_ASSERT_EQ_RETURN("StreamBuffer::sizeOfData", stream->sizeOfData(), 0, false);
+	return true;
+}
+
+static void utc_media_StreamBuffer_lockfree_write_p(void)
+{
+	if (!stream_lockfree_transfer(1, false)) {
+		return;
+	}
+	if (!stream_lockfree_transfer(STREAM_BUFFER_SIZE / 2, false)) {
+		return;
+	}
+	if (!stream_lockfree_transfer(STREAM_BUFFER_SIZE, false)) {
+		return;
+	}
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_StreamBuffer_lockfree_reserve_commit_p(void)
+{
+	if (!stream_lockfree_transfer(1, true)) {
+		return;
+	}
+	if (!stream_lockfree_transfer(STREAM_BUFFER_SIZE / 2, true)) {
+		return;
+	}
+	if (!stream_lockfree_transfer(STREAM_BUFFER_SIZE, true)) {
+		return;
+	}
+	TC_SUCCESS_RESULT();
+}
+
+int utc_media_StreamBuffer_main(void)
+{
+	utc_media_StreamBuffer_lockfree_write_p();
+	utc_media_StreamBuffer_lockfree_reserve_commit_p();
+	return 0;
+}
@@ -15,6 +15,7 @@
  * language governing permissions and limitations under the License.
  *
  ****************************************************************************/
+#include <errno.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
@@ -209,8 +210,180 @@ static void utc_messaging_multicast_p(void)
 	TC_SUCCESS_RESULT();
 }
 
+#ifdef CONFIG_MESSAGING_SHM
+static void utc_messaging_shm_alloc_free_n(void)
+{
+	int ret;
+	char buf[4];
+
+	TC_ASSERT_EQ("messaging_shm_alloc", messaging_shm_alloc(0), NULL);
+
+	ret = messaging_shm_free(NULL);
+	TC_ASSERT_EQ("messaging_shm_free", ret, ERROR);
+
+	ret = messaging_shm_free(buf);
+	TC_ASSERT_EQ("messaging_shm_free", ret, ERROR);
+
+	TC_SUCCESS_RESULT();
+}
+
+#define TC_SHM_PORT "shm_port"
+#define TC_SHM_LARGE_PORT "shm_large_port"
+#define TC_SHM_BUFLEN 64
+
+static int tc_shm_len;
+static sem_t shm_ready_sem;
+static sem_t shm_recv_sem;
+
+static void shm_recv_callback(msg_reply_type_t msg_type, msg_recv_buf_t *recv_data, void *cb_data)
+{
+	if (recv_data != NULL && strncmp(recv_data->buf, TC_MULTI_MSG, strlen(TC_MULTI_MSG) + 1) == 0) {
+		tc_shm_len = recv_data->buflen;
+	}
+	sem_post(&shm_recv_sem);
+}
+
+/* The port to receive on is given as the first argument, TC_SHM_PORT by default. */
+static int shm_recv_nonblock(int argc, FAR char *argv[])
+{
+	int ret;
+	const char *port_name;
+	msg_callback_info_t cb_info;
+	msg_recv_buf_t shm_data;
+
+	port_name = (argc > 1) ? argv[1] : TC_SHM_PORT;
+
+	cb_info.cb_func = shm_recv_callback;
+	cb_info.cb_data = NULL;
+
+	/* The receive buffer is larger than the message, so buflen must be updated. */
+	shm_data.buflen = TC_SHM_BUFLEN;
+	shm_data.buf = (char *)malloc(shm_data.buflen);
+	if (shm_data.buf == NULL) {
+		sem_post(&shm_ready_sem);
+		return ERROR;
+	}
+
+	ret = messaging_recv_nonblock(port_name, &shm_data, &cb_info);
+	sem_post(&shm_ready_sem);
+	if (ret != OK) {
+		free(shm_data.buf);
+		return ERROR;
+	}
+
+	/* Wait not to finish this task, because of receiving data through the callback. */
+	sleep(3);
+
+	free(shm_data.buf);
+	messaging_cleanup(port_name);
+	return OK;
+}
+
+static void utc_messaging_shm_send_recv_p(void)
+{
+	int ret;
+	int recv_pid;
+	msg_send_data_t shm_data;
+
+	tc_shm_len = 0;
+	sem_init(&shm_ready_sem, 0, 0);
+	sem_init(&shm_recv_sem, 0, 0);
+
+	recv_pid = task_create("shm_recv", TASK_PRIO, STACKSIZE, shm_recv_nonblock, NULL);
+	TC_ASSERT_GEQ_CLEANUP("messaging_multicast", recv_pid, 0, goto cleanup);
+	sem_wait(&shm_ready_sem);
+
+	/* A buffer from messaging_shm_alloc is always sent through the shared buffer path. */
+	shm_data.priority = MSG_PRIO;
+	shm_data.msglen = strlen(TC_MULTI_MSG) + 1;
+	shm_data.msg = messaging_shm_alloc(shm_data.msglen);
+	TC_ASSERT_NEQ_CLEANUP("messaging_shm_alloc", shm_data.msg, NULL, goto cleanup);
+	strncpy(shm_data.msg, TC_MULTI_MSG, strlen(TC_MULTI_MSG) + 1);
+
+	ret = messaging_multicast(TC_SHM_PORT, &shm_data);
+	messaging_shm_free(shm_data.msg);
+	TC_ASSERT_EQ_CLEANUP("messaging_multicast", ret, 1, goto cleanup);
+
+	ret = sem_wait(&shm_recv_sem);
+	TC_ASSERT_EQ_CLEANUP("messaging_multicast", ret, OK, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("messaging_multicast", tc_shm_len, shm_data.msglen, goto cleanup);
+
+	sem_destroy(&shm_ready_sem);
+	sem_destroy(&shm_recv_sem);
+	TC_SUCCESS_RESULT();
+	return;
+cleanup:
+	sem_destroy(&shm_ready_sem);
+	sem_destroy(&shm_recv_sem);
+}
+
+static void utc_messaging_shm_send_large_n(void)
+{
+	int ret;
+	int err;
+	int recv_pid;
+	msg_send_data_t shm_data;
+	char *recv_argv[2] = { TC_SHM_LARGE_PORT, NULL };
+
+	tc_shm_len = 0;
+	sem_init(&shm_ready_sem, 0, 0);
+	sem_init(&shm_recv_sem, 0, 0);
+
+	recv_pid = task_create("shm_recv", TASK_PRIO, STACKSIZE, shm_recv_nonblock, recv_argv);
+	TC_ASSERT_GEQ_CLEANUP("messaging_multicast", recv_pid, 0, goto cleanup);
+	sem_wait(&shm_ready_sem);
+
+	/* The message does not fit in the receive buffer, so it must be refused, not truncated. */
+	shm_data.priority = MSG_PRIO;
+	shm_data.msglen = TC_SHM_BUFLEN * 2;
+	shm_data.msg = messaging_shm_alloc(shm_data.msglen);
+	TC_ASSERT_NEQ_CLEANUP("messaging_shm_alloc", shm_data.msg, NULL, goto cleanup);
+	memset(shm_data.msg, 'l', shm_data.msglen);
+
+	ret = messaging_multicast(TC_SHM_LARGE_PORT, &shm_data);
+	err = errno;
+	messaging_shm_free(shm_data.msg);
+	TC_ASSERT_EQ_CLEANUP("messaging_multicast", ret, ERROR, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("messaging_multicast", err, EMSGSIZE, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("messaging_multicast", tc_shm_len, 0, goto cleanup);
+
+	sem_destroy(&shm_ready_sem);
+	sem_destroy(&shm_recv_sem);
+	TC_SUCCESS_RESULT();
+	return;
+cleanup:
+	sem_destroy(&shm_ready_sem);
+	sem_destroy(&shm_recv_sem);
+}
+
+static void utc_messaging_shm_alloc_free_p(void)
+{
+	int ret;
+	char *buf;
+
+	buf = (char *)messaging_shm_alloc(strlen(TC_MULTI_MSG) + 1);
+	TC_ASSERT_NEQ("messaging_shm_alloc", buf, NULL);
+	strncpy(buf, TC_MULTI_MSG, strlen(TC_MULTI_MSG) + 1);
+
+	ret = messaging_shm_free(buf);
+	TC_ASSERT_EQ("messaging_shm_free", ret, OK);
+
+	/* The buffer was returned to the pool, so it cannot be freed again. */
+	ret = messaging_shm_free(buf);
+	TC_ASSERT_EQ("messaging_shm_free", ret, ERROR);
+
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 void utc_messaging_multicast_main(void)
 {
 	utc_messaging_multicast_n();
 	utc_messaging_multicast_p();
+#ifdef CONFIG_MESSAGING_SHM
+	utc_messaging_shm_alloc_free_n();
+	utc_messaging_shm_alloc_free_p();
+	utc_messaging_shm_send_recv_p();
+	utc_messaging_shm_send_large_n();
+#endif
 }
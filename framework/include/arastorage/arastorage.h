@@ -172,6 +172,9 @@ typedef struct _db_handle_s db_handle_t;
 struct _db_cursor_s;
 typedef struct _db_cursor_s db_cursor_t;
 
+struct _db_stmt_s;
+typedef struct _db_stmt_s db_stmt_t;
+
 typedef int db_storage_id_t;
 
 typedef uint32_t cursor_row_t;
@@ -180,6 +183,19 @@ typedef uint32_t tuple_id_t;
 
 typedef uint8_t attribute_id_t;
 
+/**
+ * @brief Statistics of the page buffer pool shared by the B+tree indexes
+ */
+struct db_buffer_pool_stats_s {
+	unsigned long hits;			/* pages found in the pool */
+	unsigned long misses;		/* pages read from storage */
+	unsigned long evictions;	/* pages replaced to make room for others */
+	unsigned long writebacks;	/* dirty pages written to storage */
+	unsigned int pages;			/* number of pages in the pool */
+	unsigned int page_size;		/* size of a page in bytes */
+};
+typedef struct db_buffer_pool_stats_s db_buffer_pool_stats_t;
+
 /****************************************************************************
 * Public Variables
 ****************************************************************************/
@@ -232,6 +248,123 @@ db_result_t db_exec(char *format);
 */
 db_cursor_t *db_query(char *format);
 
+/**
+* @brief process query of arastorage without materializing its result
+*
+* @details @b #include <arastorage/arastorage.h>
+*  Unlike db_query(), the matching tuples are read one at a time while the
+*  cursor is moved with cursor_move_first() and cursor_move_next(), so the
+*  memory used does not depend on the number of tuples, while db_query()
+*  keeps one bit for each tuple of the relation. The cursor only moves forward,
+*  cursor_get_count() returns the number of rows read so far and
+*  cursor_move_next() fails after the last row. Only SELECT without
+*  aggregation is supported.
+* @param[in] format query sentence
+* @return On success, a pointer to db_cursor_t is returned. On failure, a NULL is returned.
+* @since TizenRT v3.0
+*/
+db_cursor_t *db_query_stream(char *format);
+
+/**
+* @brief describe how arastorage would process a query
+*
+* @details @b #include <arastorage/arastorage.h>
+*  The query is planned but not executed. A line naming the relation, the
+*  chosen access path (a sequential scan, or a range scan on an index with
+*  the range searched), the estimated number of tuples read and the cost
+*  compared to a sequential scan is written to buf. Only SELECT without
+*  assignment is supported.
+* @param[in] format query sentence
+* @param[out] buf buffer to store the plan description
+* @param[in] len size of buf
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_explain(char *format, char *buf, size_t len);
+
+/**
+* @brief get the statistics of the index buffer pool
+*
+* @details @b #include <arastorage/arastorage.h>
+*  The B+tree indexes of all relations share a pool of
+*  CONFIG_ARASTORAGE_BUFFER_POOL_SIZE bytes. The hit rate
+*  hits / (hits + misses) helps to size it: a low rate with many
+*  evictions means that the pool is too small for the indexes in use.
+*  The statistics are reset by db_init().
+* @param[out] stats statistics of the buffer pool
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_get_buffer_pool_stats(db_buffer_pool_stats_t *stats);
+
+/**
+* @brief parse a query sentence once into a prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* The sentence may contain '?' in place of the values of INSERT and of the
+* numbers compared in a WHERE condition. The parameters are numbered from 0
+* in the order they appear, and must all be bound before execution.
+* @param[in] format query sentence
+* @return On success, a pointer to db_stmt_t is returned. On failure, a NULL is returned.
+* @since TizenRT v3.0
+*/
+db_stmt_t *db_prepare(char *format);
+
+/**
+* @brief bind a number to a parameter of a prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to prepared statement
+* @param[in] index index of parameter
+* @param[in] value value of parameter
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_bind_long(db_stmt_t *stmt, int index, long value);
+
+/**
+* @brief bind a string to a value parameter of a prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* The string is copied, so it does not need to stay valid after this call.
+* @param[in] stmt a pointer to prepared statement
+* @param[in] index index of parameter
+* @param[in] value value of parameter
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_bind_string(db_stmt_t *stmt, int index, char *value);
+
+/**
+* @brief execute a prepared statement which creates, inserts or removes
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to prepared statement
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_stmt_exec(db_stmt_t *stmt);
+
+/**
+* @brief process a prepared query
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to prepared statement
+* @return On success, a pointer to db_cursor_t is returned. On failure, a NULL is returned.
+* @since TizenRT v3.0
+*/
+db_cursor_t *db_stmt_query(db_stmt_t *stmt);
+
+/**
+* @brief free a prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to prepared statement
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v3.0
+*/
+db_result_t db_finalize(db_stmt_t *stmt);
+
 /**
 * @brief free allocated cursor data, it should be called before application terminated
 *
@@ -59,6 +59,13 @@ typedef enum player_error_e player_error_t;
 const int PLAYER_OK = PLAYER_ERROR_NONE;
 typedef int player_result_t;
 
+/**
+ * @brief maximum gain of setStreamGain, it keeps the samples unchanged
+ * @details @b #include <media/MediaPlayer.h>
+ * @since TizenRT v3.0
+ */
+const uint8_t PLAYER_MAX_STREAM_GAIN = 100;
+
 class MediaPlayerImpl;
 
 /**
@@ -227,6 +234,32 @@ public:
 	 * @since TizenRT v2.1 PRE
 	 */
 	bool isPlaying();
+
+	/**
+	 * @brief Set the gain of the player in the software mixer
+	 * @details @b #include <media/MediaPlayer.h>
+	 * This function is a synchronous API
+	 * Scales the samples of this player before they are mixed with other players.
+	 * The volume set by setVolume() applies to the mixed output of all players.
+	 * @param[in] gain Gain in percent, from 0 to PLAYER_MAX_STREAM_GAIN
+	 * @return The result of the setStreamGain operation,
+	 * PLAYER_ERROR_DEVICE_NOT_SUPPORTED if the software mixer is not enabled
+	 * @since TizenRT v3.0
+	 */
+	player_result_t setStreamGain(uint8_t gain);
+
+	/**
+	 * @brief Set whether the player ducks other players
+	 * @details @b #include <media/MediaPlayer.h>
+	 * This function is a synchronous API
+	 * While a ducking player is playing, the other players are attenuated,
+	 * e.g. so that a notification sound can be heard over music.
+	 * @param[in] enable true to duck other players
+	 * @return The result of the setDucking operation,
+	 * PLAYER_ERROR_DEVICE_NOT_SUPPORTED if the software mixer is not enabled
+	 * @since TizenRT v3.0
+	 */
+	player_result_t setDucking(bool enable);
 private:
 	std::shared_ptr<MediaPlayerImpl> mPMpImpl;
 	uint64_t mId;
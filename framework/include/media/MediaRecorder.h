@@ -31,6 +31,7 @@
 #define __MEDIA_MEDIARECORDER_H
 
 #include <memory>
+#include <functional>
 #include <media/OutputDataSource.h>
 #include <media/MediaRecorderObserverInterface.h>
 
@@ -61,6 +62,14 @@ typedef enum recorder_error_e recorder_error_t;
 const int RECORDER_OK = RECORDER_ERROR_NONE;
 typedef int recorder_result_t;
 
+/**
+ * @brief Function called with every captured period
+ * @details @b #include <media/MediaRecorder.h>
+ * The first argument points to the period in the data source format, the second is its size in bytes.
+ * @since TizenRT v3.0
+ */
+typedef std::function<void(unsigned char *, size_t)> recorder_period_listener_t;
+
 /**
  * @class 
  * @brief This class implements the MediaRecorder capability agent.
@@ -223,6 +232,29 @@ public:
 	 */
 	recorder_result_t setFileSize(int byte);
 
+	/**
+	 * @brief Add a listener called with every captured period
+	 * @details @b #include <media/MediaRecorder.h>
+	 * This function is a synchronous API
+	 * Listeners run on the recorder thread in the order they were added, right after a period
+	 * is read from the device and before it is written to the data source. The buffer is reused
+	 * for the next period, so a listener must not keep it and should return quickly.
+	 * The period size is set by CONFIG_AUDIO_STREAM_IN_PERIOD_SIZE.
+	 * @param[in] listener The function to be called
+	 * @return The result of adding the listener
+	 * @since TizenRT v3.0
+	 */
+	recorder_result_t addPeriodListener(recorder_period_listener_t listener);
+
+	/**
+	 * @brief Remove all listeners added by addPeriodListener
+	 * @details @b #include <media/MediaRecorder.h>
+	 * This function is a synchronous API
+	 * @return The result of removing the listeners
+	 * @since TizenRT v3.0
+	 */
+	recorder_result_t clearPeriodListeners();
+
 	/**
 	 * @brief MediaRecorder operator==
 	 * @details @b #include <media/MediaRecorder.h>
@@ -28,6 +28,8 @@
 #ifndef __MESSAGING_H__
 #define __MESSAGING_H__
 
+#include <tinyara/config.h>
+
 /**
  * @brief These configs are used internally for getting receivers information before send.
  * @details MSG_READ_YET : There are more than CONFIG_MESSAGING_RECV_LIST_SIZE receivers, messaging f/w tries to read information again.\n
@@ -203,6 +205,31 @@ int messaging_recv_nonblock(const char *port_name, msg_recv_buf_t *recv_buf, msg
  */
 int messaging_cleanup(const char *port_name);
 
+#ifdef CONFIG_MESSAGING_SHM
+/**
+ * @brief Allocate the shared buffer for sending a message without copy.
+ * @details @b #include <messaging/messaging.h>\n
+ * If the returned buffer is passed as msg of send_data, only the descriptor is sent,\n
+ * and all receivers read the message from this buffer.\n
+ * Do not modify the buffer after sending it. Free it right after the send API returns,\n
+ * and allocate a new one for the next message.\n
+ * As for other messages, sending fails with errno EMSGSIZE if the message is larger than the receive buffer.
+ * @param[in] size The size of buffer
+ * @return On success, the pointer of allocated buffer is returned. On failure, NULL is returned.
+ * @since TizenRT v3.0
+ */
+void *messaging_shm_alloc(int size);
+/**
+ * @brief Free the shared buffer which was allocated by messaging_shm_alloc.
+ * @details @b #include <messaging/messaging.h>\n
+ * The memory is returned to the pool after all receivers read the message.
+ * @param[in] buf The buffer which was allocated by messaging_shm_alloc
+ * @return On success, OK is returned. On failure, ERROR is returned.
+ * @since TizenRT v3.0
+ */
+int messaging_shm_free(void *buf);
+#endif
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -378,6 +378,17 @@ int pcm_drain(struct pcm *pcm);
  */
 int pcm_prepare(struct pcm *pcm);
 
+/**
+ * @brief Starts a PCM, preparing it first if needed. Does nothing if it is running.
+ *
+ * @details @b #include <tinyalsa/tinyalsa.h>
+ * A playback PCM needs at least one queued buffer, e.g. from pcm_mmap_commit().
+ * @param[in] pcm A PCM handle.
+ * @return On success, 0 returned. On failure, a negative number returned.
+ * @since TizenRT v3.0
+ */
+int pcm_start(struct pcm *pcm);
+
 /**
  * @brief Determines the number of bits occupied by a @ref pcm_format.
  *
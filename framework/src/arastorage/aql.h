@@ -91,12 +91,18 @@
 #define AQL_TYPE_SELECT                    (AQL_OP_TYPE_QUERY | 0x00000009)
 #define AQL_TYPE_REMOVE_TUPLES             (AQL_OP_TYPE_QUERY | 0x0000000A)
 
+#define AQL_TYPE_BEGIN                     (AQL_OP_TYPE_EXEC | 0x0000000B)
+#define AQL_TYPE_COMMIT                    (AQL_OP_TYPE_EXEC | 0x0000000C)
+
 #define AQL_TYPE_MASK                      (AQL_OP_TYPE_MASK | AQL_DATA_TYPE_MASK)
 
 #define AQL_FLAG_AGGREGATE              1
 #define AQL_FLAG_SELECT_ALL             2
 #define AQL_FLAG_ASSIGN                 4
 
+#define AQL_PARAM_VALUE                 1
+#define AQL_PARAM_CONDITION             2
+
 #define AQL_CLEAR(adt)                  aql_clear(adt)
 #define AQL_SET_TYPE(adt, type)  (((adt))->optype = (type))
 #define AQL_GET_OP_TYPE(optype)  ((optype) & (AQL_OP_TYPE_MASK))
@@ -126,6 +132,8 @@
 #define AQL_SET_CONDITION(adt, cond)    ((adt)->lvm_instance = (cond))
 #define AQL_ADD_VALUE(adt, domain, value)                               \
 	aql_add_value((adt), (domain), (value))
+#define AQL_ADD_PARAM(adt, type)        aql_add_param((adt), (type))
+#define AQL_PARAM_COUNT(adt)            ((adt)->param_count)
 
 /****************************************************************************
 * Public Type Definitions
@@ -194,6 +202,10 @@ enum token_e {
 	ATTRIBUTE,
 	BPLUSTREE,					/* 48 */
 
+	PARAM,
+	BEGIN,
+	COMMIT,
+
 	INTEGER_VALUE = 251,
 	FLOAT_VALUE = 252,
 	STRING_VALUE = 253,
@@ -233,6 +245,18 @@ struct aql_attribute_s {
 };
 typedef struct aql_attribute_s aql_attribute_t;
 
+/*
+ * A '?' placeholder of a prepared statement. It stands either for a value
+ * of an INSERT, in which case pos is the index in the value array, or for
+ * a constant of the WHERE condition, in which case pos is the position of
+ * the placeholder operand in the LVM code.
+ */
+struct aql_param_s {
+	uint8_t type;
+	int pos;
+};
+typedef struct aql_param_s aql_param_t;
+
 struct aql_adt_s {
 	char relations[AQL_RELATION_LIMIT][RELATION_NAME_LENGTH + 1];
 	aql_attribute_t attributes[AQL_ATTRIBUTE_LIMIT];
@@ -245,9 +269,20 @@ struct aql_adt_s {
 	uint32_t optype;
 	uint8_t flags;
 	void *lvm_instance;
+	aql_param_t params[AQL_PARAM_LIMIT];
+	uint8_t param_count;
 };
 typedef struct aql_adt_s aql_adt_t;
 
+/*
+ * A prepared statement keeps the parse result and the compiled condition
+ * of a query, so that it can be executed many times with new parameters.
+ */
+struct _db_stmt_s {
+	aql_adt_t adt;
+	uint32_t bound;				/* bitmap of the bound parameters */
+};
+
 /****************************************************************************
 * Global Function Prototypes
 ****************************************************************************/
@@ -260,5 +295,9 @@ void aql_add_relation(aql_adt_t *adt, char *rel);
 aql_status_t aql_parse(aql_adt_t *adt, char *query_string);
 db_result_t aql_add_attribute(aql_adt_t *adt, char *name, domain_t domain, unsigned element_size, int processed_only);
 db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value);
+db_result_t aql_add_param(aql_adt_t *adt, uint8_t type);
+void aql_release(aql_adt_t *adt);
+db_result_t aql_init_handle(db_handle_t **handle);
+db_result_t aql_deinit_handle(db_handle_t **handle);
 
 #endif							/* !AQL_H */
@@ -84,6 +84,7 @@ void aql_clear(aql_adt_t *adt)
 	adt->relation_count = 0;
 	adt->attribute_count = 0;
 	adt->value_count = 0;
+	adt->param_count = 0;
 	adt->flags = 0;
 	memset(adt->aggregators, 0, sizeof(adt->aggregators));
 }
@@ -160,3 +161,52 @@ db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value_ptr)
 
 	return DB_OK;
 }
+
+db_result_t aql_add_param(aql_adt_t *adt, uint8_t type)
+{
+	aql_param_t *param;
+
+	if (adt->param_count == AQL_PARAM_LIMIT) {
+		return DB_LIMIT_ERROR;
+	}
+
+	param = &adt->params[adt->param_count];
+	param->type = type;
+	param->pos = -1;
+
+	if (type == AQL_PARAM_VALUE) {
+		/* Reserve a value which is filled in when the parameter is bound. */
+		if (adt->value_count == AQL_ATTRIBUTE_LIMIT) {
+			return DB_LIMIT_ERROR;
+		}
+		param->pos = adt->value_count;
+		adt->values[adt->value_count].domain = DOMAIN_UNSPECIFIED;
+		VALUE_STRING(&adt->values[adt->value_count]) = NULL;
+		adt->value_count++;
+	}
+
+	adt->param_count++;
+
+	return DB_OK;
+}
+
+/*
+ * Release the memory owned by a parse result: the copies of the string
+ * values and the compiled condition.
+ */
+void aql_release(aql_adt_t *adt)
+{
+	int i;
+
+	for (i = 0; i < adt->value_count; i++) {
+		if (adt->values[i].domain == DOMAIN_STRING && VALUE_STRING(&adt->values[i]) != NULL) {
+			free(VALUE_STRING(&adt->values[i]));
+			VALUE_STRING(&adt->values[i]) = NULL;
+		}
+	}
+
+	if (adt->lvm_instance != NULL) {
+		free(adt->lvm_instance);
+		adt->lvm_instance = NULL;
+	}
+}
@@ -68,6 +68,7 @@
 #include "relation.h"
 #include "result.h"
 #include "aql.h"
+#include "lvm.h"
 
 /****************************************************************************
 * Private Functions
@@ -146,30 +147,23 @@ relation_t *aql_get_relation(aql_adt_t *adt)
 	return relation_load(adt->relations[first_rel_arg]);
 }
 
-db_result_t db_exec(char *format)
+static db_result_t aql_exec(aql_adt_t *adt)
 {
 	db_result_t res;
-	aql_adt_t adt;
 	relation_t *rel = NULL;
 	aql_attribute_t *attr;
 	attribute_t *relattr = NULL;
 	uint32_t optype;
-	res = aql_get_parse_result(format, &adt);
-
-	if (DB_ERROR(res)) {
-		DB_LOG_E("DB : Parsing Error in db_create : %d\n", res);
-		return DB_PARSING_ERROR;
-	}
 
-	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(adt));
 	if (optype == AQL_OP_TYPE_QUERY) {
 		DB_LOG_E("DB : AQL OP TYPE Error \n");
 		return DB_ARGUMENT_ERROR;
 	}
 
-	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt));
 	if (optype != AQL_TYPE_CREATE_RELATION) {
-		rel = aql_get_relation(&adt);
+		rel = aql_get_relation(adt);
 		if (rel == NULL) {
 			DB_LOG_E("DB : get relation Failed\n");
 			return DB_RELATIONAL_ERROR;
@@ -180,39 +174,35 @@ db_result_t db_exec(char *format)
 
 	switch (optype) {
 	case AQL_TYPE_CREATE_ATTRIBUTE:
-		attr = &(adt.attributes[0]);
+		attr = &(adt->attributes[0]);
 		if (relation_attribute_add(rel, DB_STORAGE, attr->name, attr->domain, attr->element_size) != NULL) {
 			res = DB_OK;
 		}
 		break;
 	case AQL_TYPE_CREATE_INDEX:
-		relattr = relation_attribute_get(rel, adt.attributes[0].name);
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
 		if (relattr == NULL) {
 			res = DB_NAME_ERROR;
 			break;
 		}
-		res = index_create(AQL_GET_INDEX_TYPE(&adt), rel, relattr);
+		res = index_create(AQL_GET_INDEX_TYPE(adt), rel, relattr);
 		break;
 	case AQL_TYPE_CREATE_RELATION:
-		if (relation_create(adt.relations[0], DB_STORAGE) != NULL) {
+		if (relation_create(adt->relations[0], DB_STORAGE) != NULL) {
 			res = DB_OK;
 		}
 		break;
 	case AQL_TYPE_INSERT:
-		if (relation_cardinality(rel) < DB_TUPLE_LIMIT) {
-			res = relation_insert(rel, adt.values);
-			if (DB_SUCCESS(res)) {
-				res = DB_OK;
-			}
-		} else {
-			res = DB_LIMIT_ERROR;
+		res = relation_insert(rel, adt->values);
+		if (DB_SUCCESS(res)) {
+			res = DB_OK;
 		}
 		break;
 	case AQL_TYPE_REMOVE_ATTRIBUTE:
-		res = relation_attribute_remove(rel, adt.attributes[0].name);
+		res = relation_attribute_remove(rel, adt->attributes[0].name);
 		break;
 	case AQL_TYPE_REMOVE_INDEX:
-		relattr = relation_attribute_get(rel, adt.attributes[0].name);
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
 		if (relattr != NULL) {
 			index_load(rel, relattr);
 			if (relattr->index != NULL) {
@@ -227,6 +217,12 @@ db_result_t db_exec(char *format)
 	case AQL_TYPE_REMOVE_RELATION:
 		res = relation_remove(rel, 1);
 		break;
+	case AQL_TYPE_BEGIN:
+		res = relation_bulk_begin(rel);
+		break;
+	case AQL_TYPE_COMMIT:
+		res = relation_bulk_commit(rel);
+		break;
 	default:
 		break;
 	}
@@ -236,9 +232,27 @@ db_result_t db_exec(char *format)
 	return res;
 }
 
-db_cursor_t *db_query(char *format)
+db_result_t db_exec(char *format)
 {
+	db_result_t res;
 	aql_adt_t adt;
+
+	res = aql_get_parse_result(format, &adt);
+	if (DB_ERROR(res)) {
+		DB_LOG_E("DB : Parsing Error in db_create : %d\n", res);
+		return DB_PARSING_ERROR;
+	}
+
+	if (AQL_PARAM_COUNT(&adt) > 0) {
+		DB_LOG_E("DB : Parameters are only allowed in prepared statements\n");
+		return DB_ARGUMENT_ERROR;
+	}
+
+	return aql_exec(&adt);
+}
+
+static db_cursor_t *aql_query(aql_adt_t *adt)
+{
 	relation_t *rel;
 	uint32_t optype;
 	db_handle_t *handler;
@@ -248,11 +262,7 @@ db_cursor_t *db_query(char *format)
 	handler = NULL;
 	cursor = NULL;
 
-	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
-		DB_LOG_E("DB : Parsing Error in db_create : %d\n");
-		return NULL;
-	}
-	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(adt));
 	if (optype != AQL_OP_TYPE_QUERY) {
 		DB_LOG_E("DB : AQL OP TYPE Error \n");
 		return NULL;
@@ -263,19 +273,19 @@ db_cursor_t *db_query(char *format)
 	}
 #endif
 
-	rel = aql_get_relation(&adt);
+	rel = aql_get_relation(adt);
 	if (rel == NULL) {
 		return NULL;
 	}
 
-	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt));
 	switch (optype) {
 	case AQL_TYPE_REMOVE_TUPLES:
 		/* Overwrite the attribute array with a full copy of the original
 		   relation's attributes. */
-		adt.attribute_count = 0;
+		adt->attribute_count = 0;
 		for (attr_ptr = list_head(rel->attributes); attr_ptr != NULL; attr_ptr = attr_ptr->next) {
-			AQL_ADD_ATTRIBUTE(&adt, attr_ptr->name, DOMAIN_UNSPECIFIED, 0);
+			AQL_ADD_ATTRIBUTE(adt, attr_ptr->name, DOMAIN_UNSPECIFIED, 0);
 		}
 	/* FALLTHROUGH */
 	case AQL_TYPE_SELECT:
@@ -283,7 +293,7 @@ db_cursor_t *db_query(char *format)
 			DB_LOG_E("DB: Init handle failed\n");
 			goto errout;
 		}
-		if (DB_ERROR(relation_select(&handler, rel, &adt))) {
+		if (DB_ERROR(relation_select(&handler, rel, adt))) {
 			DB_LOG_E("DB: Failed relation_select\n");
 			goto errout;
 		}
@@ -304,6 +314,10 @@ db_cursor_t *db_query(char *format)
 			relation_release(rel);
 		}
 	}
+	if (handler != NULL) {
+		/* The condition belongs to the parse result. */
+		handler->lvm_instance = NULL;
+	}
 	aql_deinit_handle(&handler);
 
 	return cursor;
@@ -313,7 +327,325 @@ errout:
 		relation_release(rel);
 	}
 
+	if (handler != NULL) {
+		handler->lvm_instance = NULL;
+	}
 	aql_deinit_handle(&handler);
 
 	return NULL;
 }
+
+db_cursor_t *db_query(char *format)
+{
+	aql_adt_t adt;
+	db_cursor_t *cursor;
+
+	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
+		DB_LOG_E("DB : Parsing Error in db_create : %d\n");
+		return NULL;
+	}
+
+	if (AQL_PARAM_COUNT(&adt) > 0) {
+		DB_LOG_E("DB : Parameters are only allowed in prepared statements\n");
+		cursor = NULL;
+	} else {
+		cursor = aql_query(&adt);
+	}
+
+	if (adt.lvm_instance != NULL) {
+		free(adt.lvm_instance);
+	}
+
+	return cursor;
+}
+
+db_cursor_t *db_query_stream(char *format)
+{
+	db_result_t res;
+	aql_adt_t adt;
+	relation_t *rel;
+	db_handle_t *handler;
+	db_cursor_t *cursor;
+
+	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
+		DB_LOG_E("DB : Parsing Error in db_query_stream\n");
+		return NULL;
+	}
+
+	handler = NULL;
+	rel = NULL;
+
+	if (AQL_PARAM_COUNT(&adt) > 0) {
+		DB_LOG_E("DB : Parameters are only allowed in prepared statements\n");
+		goto errout;
+	}
+
+	/* Aggregations and assignments produce their result only after
+	   reading every tuple, so only plain selections are streamed. */
+	if (AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt)) != AQL_TYPE_SELECT || (AQL_GET_FLAGS(&adt) & (AQL_FLAG_AGGREGATE | AQL_FLAG_ASSIGN))) {
+		DB_LOG_E("DB : Only SELECT without aggregation can be streamed\n");
+		goto errout;
+	}
+#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+	if (DB_SUCCESS(storage_flush_insert_buffer())) {
+		DB_LOG_D("DB : flush insert buffer!!\n");
+	}
+#endif
+
+	rel = aql_get_relation(&adt);
+	if (rel == NULL) {
+		goto errout;
+	}
+
+	if (DB_ERROR(aql_init_handle(&handler))) {
+		DB_LOG_E("DB: Init handle failed\n");
+		goto errout;
+	}
+
+	/* From here, the handle owns the relation and the condition. */
+	handler->rel = rel;
+	handler->lvm_instance = adt.lvm_instance;
+	rel = NULL;
+
+	res = relation_select(&handler, handler->rel, &adt);
+	adt.lvm_instance = NULL;
+	if (DB_ERROR(res)) {
+		DB_LOG_E("DB: Failed relation_select\n");
+		goto errout;
+	}
+
+	/* The cursor takes the handle and reads the tuples on demand. */
+	cursor = relation_stream_result(handler);
+	if (cursor == NULL) {
+		DB_LOG_E("DB: Failed to open streaming cursor\n");
+		goto errout;
+	}
+
+	return cursor;
+
+errout:
+	if (rel != NULL) {
+		relation_release(rel);
+	}
+	if (handler != NULL) {
+		aql_deinit_handle(&handler);
+	}
+	if (adt.lvm_instance != NULL) {
+		free(adt.lvm_instance);
+	}
+
+	return NULL;
+}
+
+db_result_t db_explain(char *format, char *buf, size_t len)
+{
+	db_result_t res;
+	aql_adt_t adt;
+	relation_t *rel;
+	db_handle_t *handler;
+
+	if (buf == NULL || len == 0) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
+		DB_LOG_E("DB : Parsing Error in db_explain\n");
+		return DB_ARGUMENT_ERROR;
+	}
+
+	handler = NULL;
+	rel = NULL;
+	res = DB_ARGUMENT_ERROR;
+
+	if (AQL_PARAM_COUNT(&adt) > 0) {
+		DB_LOG_E("DB : Parameters are only allowed in prepared statements\n");
+		goto errout;
+	}
+
+	/* Planning an assignment would already create its result relation. */
+	if (AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt)) != AQL_TYPE_SELECT || (AQL_GET_FLAGS(&adt) & AQL_FLAG_ASSIGN)) {
+		DB_LOG_E("DB : Only SELECT without assignment can be explained\n");
+		goto errout;
+	}
+#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+	if (DB_SUCCESS(storage_flush_insert_buffer())) {
+		DB_LOG_D("DB : flush insert buffer!!\n");
+	}
+#endif
+
+	rel = aql_get_relation(&adt);
+	if (rel == NULL) {
+		res = DB_RELATIONAL_ERROR;
+		goto errout;
+	}
+
+	res = aql_init_handle(&handler);
+	if (DB_ERROR(res)) {
+		DB_LOG_E("DB: Init handle failed\n");
+		goto errout;
+	}
+
+	handler->rel = rel;
+	handler->lvm_instance = adt.lvm_instance;
+	rel = NULL;
+
+	res = relation_select(&handler, handler->rel, &adt);
+	adt.lvm_instance = NULL;
+	if (DB_ERROR(res)) {
+		DB_LOG_E("DB: Failed relation_select\n");
+		goto errout;
+	}
+
+	res = relation_explain(handler, buf, len);
+
+errout:
+	if (rel != NULL) {
+		relation_release(rel);
+	}
+	if (handler != NULL) {
+		aql_deinit_handle(&handler);
+	}
+	if (adt.lvm_instance != NULL) {
+		free(adt.lvm_instance);
+	}
+
+	return res;
+}
+
+db_stmt_t *db_prepare(char *format)
+{
+	db_stmt_t *stmt;
+
+	stmt = (db_stmt_t *)malloc(sizeof(db_stmt_t));
+	if (stmt == NULL) {
+		DB_LOG_E("DB: Failed to malloc statement\n");
+		return NULL;
+	}
+	memset(stmt, 0, sizeof(db_stmt_t));
+
+	if (DB_ERROR(aql_get_parse_result(format, &stmt->adt))) {
+		DB_LOG_E("DB : Parsing Error in db_prepare\n");
+		free(stmt);
+		return NULL;
+	}
+
+	return stmt;
+}
+
+static aql_param_t *aql_get_param(db_stmt_t *stmt, int index)
+{
+	if (stmt == NULL || index < 0 || index >= AQL_PARAM_COUNT(&stmt->adt)) {
+		return NULL;
+	}
+	return &stmt->adt.params[index];
+}
+
+static void aql_clear_value(attribute_value_t *value)
+{
+	if (value->domain == DOMAIN_STRING && VALUE_STRING(value) != NULL) {
+		free(VALUE_STRING(value));
+	}
+	VALUE_STRING(value) = NULL;
+	value->domain = DOMAIN_UNSPECIFIED;
+}
+
+db_result_t db_bind_long(db_stmt_t *stmt, int index, long value)
+{
+	aql_param_t *param;
+	attribute_value_t *attr_value;
+
+	param = aql_get_param(stmt, index);
+	if (param == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	if (param->type == AQL_PARAM_VALUE) {
+		attr_value = &stmt->adt.values[param->pos];
+		aql_clear_value(attr_value);
+		attr_value->domain = DOMAIN_INT;
+		VALUE_LONG(attr_value) = value;
+	} else if (LVM_ERROR(lvm_bind_long(stmt->adt.lvm_instance, param->pos, value))) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	stmt->bound |= (1u << index);
+	return DB_OK;
+}
+
+db_result_t db_bind_string(db_stmt_t *stmt, int index, char *value)
+{
+	aql_param_t *param;
+	attribute_value_t *attr_value;
+	unsigned char *str;
+	int str_size;
+
+	param = aql_get_param(stmt, index);
+	if (param == NULL || value == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	/* Conditions are evaluated on numbers only. */
+	if (param->type != AQL_PARAM_VALUE) {
+		return DB_TYPE_ERROR;
+	}
+
+	str_size = strlen(value);
+	if (str_size >= DB_MAX_ELEMENT_SIZE) {
+		return DB_LIMIT_ERROR;
+	}
+	str = (unsigned char *)malloc(sizeof(char) * str_size + 1);
+	if (str == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	memcpy(str, value, str_size);
+	str[str_size] = '\0';
+
+	attr_value = &stmt->adt.values[param->pos];
+	aql_clear_value(attr_value);
+	attr_value->domain = DOMAIN_STRING;
+	VALUE_STRING(attr_value) = str;
+
+	stmt->bound |= (1u << index);
+	return DB_OK;
+}
+
+static bool aql_is_bound(db_stmt_t *stmt)
+{
+	uint32_t all;
+
+	all = (1u << AQL_PARAM_COUNT(&stmt->adt)) - 1;
+	if ((stmt->bound & all) != all) {
+		DB_LOG_E("DB: Not all parameters of the statement are bound\n");
+		return false;
+	}
+	return true;
+}
+
+db_result_t db_stmt_exec(db_stmt_t *stmt)
+{
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+	if (!aql_is_bound(stmt)) {
+		return DB_ARGUMENT_ERROR;
+	}
+	return aql_exec(&stmt->adt);
+}
+
+db_cursor_t *db_stmt_query(db_stmt_t *stmt)
+{
+	if (stmt == NULL || !aql_is_bound(stmt)) {
+		return NULL;
+	}
+	return aql_query(&stmt->adt);
+}
+
+db_result_t db_finalize(db_stmt_t *stmt)
+{
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+	aql_release(&stmt->adt);
+	free(stmt);
+	return DB_OK;
+}
@@ -261,6 +261,11 @@ PARSER(values)
 	case INTEGER_VALUE:
 		AQL_ADD_VALUE(adt, DOMAIN_INT, VALUE);
 		break;
+	case PARAM:
+		if (DB_ERROR(AQL_ADD_PARAM(adt, AQL_PARAM_VALUE))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -298,6 +303,11 @@ PARSER(operand)
 			RETURN(SYNTAX_ERROR);
 		}
 		break;
+	case PARAM:
+		if (DB_ERROR(AQL_ADD_PARAM(adt, AQL_PARAM_CONDITION)) || LVM_ERROR(lvm_set_param(p, AQL_PARAM_COUNT(adt) - 1))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -589,6 +599,28 @@ PARSER(insert)
 	RETURN(STATUS_OK);
 }
 
+PARSER(begin)
+{
+	AQL_SET_TYPE(adt, AQL_TYPE_BEGIN);
+
+	CONSUME(IDENTIFIER);
+	DB_LOG_V("begin bulk insertion: %s\n", VALUE);
+	AQL_ADD_RELATION(adt, VALUE);
+
+	RETURN(STATUS_OK);
+}
+
+PARSER(commit)
+{
+	AQL_SET_TYPE(adt, AQL_TYPE_COMMIT);
+
+	CONSUME(IDENTIFIER);
+	DB_LOG_V("commit bulk insertion: %s\n", VALUE);
+	AQL_ADD_RELATION(adt, VALUE);
+
+	RETURN(STATUS_OK);
+}
+
 PARSER(remove_attribute)
 {
 	AQL_SET_TYPE(adt, AQL_TYPE_REMOVE_ATTRIBUTE);
@@ -847,6 +879,27 @@ PARSER(create)
 	RETURN(STATUS_OK);
 }
 
+/* Locate the placeholders of the condition in the final LVM code. */
+static aql_status_t resolve_params(aql_adt_t *adt)
+{
+	int i;
+
+	for (i = 0; i < AQL_PARAM_COUNT(adt); i++) {
+		if (adt->params[i].type != AQL_PARAM_CONDITION) {
+			continue;
+		}
+		if (adt->lvm_instance == NULL) {
+			return SYNTAX_ERROR;
+		}
+		adt->params[i].pos = lvm_find_param(adt->lvm_instance, i);
+		if (adt->params[i].pos < 0) {
+			return SYNTAX_ERROR;
+		}
+	}
+
+	return STATUS_OK;
+}
+
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
@@ -908,6 +961,12 @@ aql_status_t aql_parse(aql_adt_t *adt, char *input_string)
 		case SELECT:
 			result = parse_select(adt, &lex);
 			break;
+		case BEGIN:
+			result = parse_begin(adt, &lex);
+			break;
+		case COMMIT:
+			result = parse_commit(adt, &lex);
+			break;
 		case REMAIN:
 			result = parse_remain(adt, &lex);
 
@@ -923,6 +982,10 @@ aql_status_t aql_parse(aql_adt_t *adt, char *input_string)
 		}
 	}
 
+	if (!AQL_ERROR(result) && AQL_PARAM_COUNT(adt) > 0) {
+		result = resolve_params(adt);
+	}
+
 	if (AQL_ERROR(result)) {
 		DB_LOG_E("Error in function %s, line %d: input \"%s\"\n", error_function, error_line, error_message);
 	}
@@ -65,6 +65,7 @@
 #include "db_debug.h"
 #include "result.h"
 #include "aql.h"
+#include "buffer_pool.h"
 #include <arastorage/arastorage.h>
 
 /****************************************************************************
@@ -81,11 +82,21 @@ db_result_t db_init(void)
 	if (res != DB_OK) {
 		return res;
 	}
+	res = buffer_pool_init();
+	if (res != DB_OK) {
+		return res;
+	}
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 	res = storage_write_buffer_init();
 	if (res != DB_OK) {
 		return res;
 	}
+#endif
+#ifdef CONFIG_ARASTORAGE_ENABLE_READ_BUFFER
+	res = storage_read_buffer_init();
+	if (res != DB_OK) {
+		return res;
+	}
 #endif
 	return res;
 }
@@ -94,9 +105,22 @@ db_result_t db_deinit()
 {
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 	storage_write_buffer_deinit();
+#endif
+#ifdef CONFIG_ARASTORAGE_ENABLE_READ_BUFFER
+	storage_read_buffer_deinit();
 #endif
 	relation_deinit();
 	index_deinit();
+	buffer_pool_deinit();
+	return DB_OK;
+}
+
+db_result_t db_get_buffer_pool_stats(db_buffer_pool_stats_t *stats)
+{
+	if (stats == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+	buffer_pool_get_stats(stats);
 	return DB_OK;
 }
 
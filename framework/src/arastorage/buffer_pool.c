@@ -0,0 +1,395 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "buffer_pool.h"
+#include "db_debug.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define BUFFER_PAGE_VALID               0x01
+#define BUFFER_PAGE_DIRTY               0x02
+#define BUFFER_PAGE_REFERENCED          0x04
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/*
+ * A page of the pool caches a fixed-size block of a storage file. The pool
+ * is shared by all open indexes, so a page is identified by the storage it
+ * was read from and its offset in that storage.
+ */
+struct buffer_page_s {
+	db_storage_id_t storage;
+	unsigned long offset;
+	unsigned size;
+	uint8_t pins;
+	uint8_t flags;
+	unsigned char *data;
+};
+
+struct buffer_pool_s {
+	struct buffer_page_s *pages;
+	unsigned char *memory;
+	int hand;					/* Position of the CLOCK hand */
+	pthread_mutex_t lock;
+	db_buffer_pool_stats_t stats;
+};
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+static struct buffer_pool_s g_buffer_pool;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static struct buffer_page_s *buffer_pool_lookup(db_storage_id_t storage, unsigned long offset)
+{
+	struct buffer_page_s *page;
+	int i;
+
+	for (i = 0; i < BUFFER_POOL_PAGES; i++) {
+		page = &g_buffer_pool.pages[i];
+		if ((page->flags & BUFFER_PAGE_VALID) && page->storage == storage && page->offset == offset) {
+			return page;
+		}
+	}
+	return NULL;
+}
+
+static db_result_t buffer_pool_write_back(struct buffer_page_s *page)
+{
+	if (DB_ERROR(storage_write_to(page->storage, page->data, page->offset, page->size))) {
+		DB_LOG_E("DB: Failed to write back page at offset %lu\n", page->offset);
+		return DB_STORAGE_ERROR;
+	}
+	page->flags &= ~BUFFER_PAGE_DIRTY;
+	g_buffer_pool.stats.writebacks++;
+	return DB_OK;
+}
+
+/*
+ * Find a page to replace with the CLOCK algorithm. A referenced page gets
+ * a second chance and pinned pages are skipped, so the hand goes around
+ * the pool at most twice.
+ */
+static struct buffer_page_s *buffer_pool_victim(void)
+{
+	struct buffer_page_s *page;
+	int i;
+
+	for (i = 0; i < 2 * BUFFER_POOL_PAGES; i++) {
+		page = &g_buffer_pool.pages[g_buffer_pool.hand];
+		g_buffer_pool.hand = (g_buffer_pool.hand + 1) % BUFFER_POOL_PAGES;
+
+		if (!(page->flags & BUFFER_PAGE_VALID)) {
+			return page;
+		}
+		if (page->pins > 0) {
+			continue;
+		}
+		if (page->flags & BUFFER_PAGE_REFERENCED) {
+			page->flags &= ~BUFFER_PAGE_REFERENCED;
+			continue;
+		}
+		if ((page->flags & BUFFER_PAGE_DIRTY) && DB_ERROR(buffer_pool_write_back(page))) {
+			continue;
+		}
+		page->flags = 0;
+		g_buffer_pool.stats.evictions++;
+		return page;
+	}
+
+	DB_LOG_E("DB: No page available in the buffer pool, all pages are pinned\n");
+	return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+db_result_t buffer_pool_init(void)
+{
+	int i;
+
+	if (g_buffer_pool.pages != NULL) {
+		return DB_OK;
+	}
+
+	g_buffer_pool.pages = (struct buffer_page_s *)malloc(sizeof(struct buffer_page_s) * BUFFER_POOL_PAGES);
+	if (g_buffer_pool.pages == NULL) {
+		DB_LOG_E("DB: Failed to allocate the buffer pool\n");
+		return DB_ALLOCATION_ERROR;
+	}
+	g_buffer_pool.memory = (unsigned char *)malloc(BUFFER_POOL_PAGE_SIZE * BUFFER_POOL_PAGES);
+	if (g_buffer_pool.memory == NULL) {
+		DB_LOG_E("DB: Failed to allocate the buffer pool\n");
+		free(g_buffer_pool.pages);
+		g_buffer_pool.pages = NULL;
+		return DB_ALLOCATION_ERROR;
+	}
+
+	memset(g_buffer_pool.pages, 0, sizeof(struct buffer_page_s) * BUFFER_POOL_PAGES);
+	for (i = 0; i < BUFFER_POOL_PAGES; i++) {
+		g_buffer_pool.pages[i].data = g_buffer_pool.memory + i * BUFFER_POOL_PAGE_SIZE;
+	}
+	g_buffer_pool.hand = 0;
+	memset(&g_buffer_pool.stats, 0, sizeof(g_buffer_pool.stats));
+	g_buffer_pool.stats.pages = BUFFER_POOL_PAGES;
+	g_buffer_pool.stats.page_size = BUFFER_POOL_PAGE_SIZE;
+	pthread_mutex_init(&g_buffer_pool.lock, NULL);
+
+	return DB_OK;
+}
+
+void buffer_pool_deinit(void)
+{
+	int i;
+
+	if (g_buffer_pool.pages == NULL) {
+		return;
+	}
+
+	/* Indexes flush their pages when they are released, so only the pages
+	   of indexes which are still open can be dirty here. */
+	pthread_mutex_lock(&g_buffer_pool.lock);
+	for (i = 0; i < BUFFER_POOL_PAGES; i++) {
+		if ((g_buffer_pool.pages[i].flags & (BUFFER_PAGE_VALID | BUFFER_PAGE_DIRTY)) == (BUFFER_PAGE_VALID | BUFFER_PAGE_DIRTY)) {
+			buffer_pool_write_back(&g_buffer_pool.pages[i]);
+		}
+	}
+	DB_LOG_D("DB: Buffer pool hits %lu, misses %lu, evictions %lu, write-backs %lu\n", g_buffer_pool.stats.hits, g_buffer_pool.stats.misses, g_buffer_pool.stats.evictions, g_buffer_pool.stats.writebacks);
+	free(g_buffer_pool.memory);
+	free(g_buffer_pool.pages);
+	g_buffer_pool.memory = NULL;
+	g_buffer_pool.pages = NULL;
+	pthread_mutex_unlock(&g_buffer_pool.lock);
+	pthread_mutex_destroy(&g_buffer_pool.lock);
+}
+
+/*
+ * Return the page at the offset of the storage, reading it if it is not in
+ * the pool. The page stays in the pool until it is unpinned as many times
+ * as it was pinned.
+ */
+void *buffer_pool_pin(db_storage_id_t storage, unsigned long offset, unsigned size)
+{
+	struct buffer_page_s *page;
+
+	if (g_buffer_pool.pages == NULL || size > BUFFER_POOL_PAGE_SIZE) {
+		return NULL;
+	}
+
+	pthread_mutex_lock(&g_buffer_pool.lock);
+	page = buffer_pool_lookup(storage, offset);
+	if (page != NULL) {
+		g_buffer_pool.stats.hits++;
+	} else {
+		page = buffer_pool_victim();
+		if (page == NULL) {
+			pthread_mutex_unlock(&g_buffer_pool.lock);
+			return NULL;
+		}
+		if (DB_ERROR(storage_read_from(storage, page->data, offset, size))) {
+			DB_LOG_E("DB: Failed to read page at offset %lu\n", offset);
+			pthread_mutex_unlock(&g_buffer_pool.lock);
+			return NULL;
+		}
+		page->storage = storage;
+		page->offset = offset;
+		page->size = size;
+		page->pins = 0;
+		page->flags = BUFFER_PAGE_VALID;
+		g_buffer_pool.stats.misses++;
+	}
+	page->pins++;
+	page->flags |= BUFFER_PAGE_REFERENCED;
+	pthread_mutex_unlock(&g_buffer_pool.lock);
+
+	return page->data;
+}
+
+/*
+ * Replace the content of the page at the offset of the storage without
+ * reading it first. The page is dirty afterwards and keeps its pins.
+ */
+db_result_t buffer_pool_put(db_storage_id_t storage, unsigned long offset, void *data, unsigned size)
+{
+	struct buffer_page_s *page;
+
+	if (g_buffer_pool.pages == NULL || size > BUFFER_POOL_PAGE_SIZE) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	pthread_mutex_lock(&g_buffer_pool.lock);
+	page = buffer_pool_lookup(storage, offset);
+	if (page == NULL) {
+		page = buffer_pool_victim();
+		if (page == NULL) {
+			pthread_mutex_unlock(&g_buffer_pool.lock);
+			return DB_LIMIT_ERROR;
+		}
+		page->storage = storage;
+		page->offset = offset;
+		page->pins = 0;
+	}
+	page->size = size;
+	memmove(page->data, data, size);
+	page->flags |= BUFFER_PAGE_VALID | BUFFER_PAGE_DIRTY | BUFFER_PAGE_REFERENCED;
+	pthread_mutex_unlock(&g_buffer_pool.lock);
+
+	return DB_OK;
+}
+
+db_result_t buffer_pool_dirty(db_storage_id_t storage, unsigned long offset)
+{
+	struct buffer_page_s *page;
+
+	if (g_buffer_pool.pages == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	pthread_mutex_lock(&g_buffer_pool.lock);
+	page = buffer_pool_lookup(storage, offset);
+	if (page != NULL) {
+		page->flags |= BUFFER_PAGE_DIRTY;
+	}
+	pthread_mutex_unlock(&g_buffer_pool.lock);
+
+	return page != NULL ? DB_OK : DB_ARGUMENT_ERROR;
+}
+
+db_result_t buffer_pool_unpin(db_storage_id_t storage, unsigned long offset)
+{
+	struct buffer_page_s *page;
+
+	if (g_buffer_pool.pages == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	pthread_mutex_lock(&g_buffer_pool.lock);
+	page = buffer_pool_lookup(storage, offset);
+	if (page == NULL || page->pins == 0) {
+		pthread_mutex_unlock(&g_buffer_pool.lock);
+		DB_LOG_E("DB: Unpinned a page which is not pinned at offset %lu\n", offset);
+		return DB_ARGUMENT_ERROR;
+	}
+	page->pins--;
+	pthread_mutex_unlock(&g_buffer_pool.lock);
+
+	return DB_OK;
+}
+
+/*
+ * Drop the page at the offset of the storage without writing it back, for
+ * pages whose content is no longer used.
+ */
+db_result_t buffer_pool_discard(db_storage_id_t storage, unsigned long offset)
+{
+	struct buffer_page_s *page;
+
+	if (g_buffer_pool.pages == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	pthread_mutex_lock(&g_buffer_pool.lock);
+	page = buffer_pool_lookup(storage, offset);
+	if (page != NULL) {
+		page->pins = 0;
+		page->flags = 0;
+	}
+	pthread_mutex_unlock(&g_buffer_pool.lock);
+
+	return page != NULL ? DB_OK : DB_ARGUMENT_ERROR;
+}
+
+/* Write back the dirty pages of the storage. */
+db_result_t buffer_pool_flush(db_storage_id_t storage)
+{
+	struct buffer_page_s *page;
+	db_result_t result;
+	int i;
+
+	if (g_buffer_pool.pages == NULL) {
+		return DB_OK;
+	}
+
+	result = DB_OK;
+	pthread_mutex_lock(&g_buffer_pool.lock);
+	for (i = 0; i < BUFFER_POOL_PAGES; i++) {
+		page = &g_buffer_pool.pages[i];
+		if ((page->flags & (BUFFER_PAGE_VALID | BUFFER_PAGE_DIRTY)) == (BUFFER_PAGE_VALID | BUFFER_PAGE_DIRTY) && page->storage == storage) {
+			if (DB_ERROR(buffer_pool_write_back(page))) {
+				result = DB_STORAGE_ERROR;
+			}
+		}
+	}
+	pthread_mutex_unlock(&g_buffer_pool.lock);
+
+	return result;
+}
+
+/*
+ * Write back and drop the pages of the storage before it is closed, since
+ * its id may be reused for another file.
+ */
+db_result_t buffer_pool_release(db_storage_id_t storage)
+{
+	struct buffer_page_s *page;
+	db_result_t result;
+	int i;
+
+	result = buffer_pool_flush(storage);
+	if (g_buffer_pool.pages == NULL) {
+		return result;
+	}
+
+	pthread_mutex_lock(&g_buffer_pool.lock);
+	for (i = 0; i < BUFFER_POOL_PAGES; i++) {
+		page = &g_buffer_pool.pages[i];
+		if ((page->flags & BUFFER_PAGE_VALID) && page->storage == storage) {
+			if (page->pins > 0) {
+				DB_LOG_E("DB: Released a storage with a pinned page at offset %lu\n", page->offset);
+			}
+			page->pins = 0;
+			page->flags = 0;
+		}
+	}
+	pthread_mutex_unlock(&g_buffer_pool.lock);
+
+	return result;
+}
+
+void buffer_pool_get_stats(db_buffer_pool_stats_t *stats)
+{
+	if (g_buffer_pool.pages == NULL) {
+		memset(stats, 0, sizeof(*stats));
+		return;
+	}
+	pthread_mutex_lock(&g_buffer_pool.lock);
+	memcpy(stats, &g_buffer_pool.stats, sizeof(*stats));
+	pthread_mutex_unlock(&g_buffer_pool.lock);
+}
@@ -0,0 +1,52 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+#ifndef __BUFFER_POOL_H__
+#define __BUFFER_POOL_H__
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <sys/types.h>
+#include <arastorage/arastorage.h>
+#include "storage.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define BUFFER_POOL_PAGE_SIZE           CONFIG_ARASTORAGE_BUFFER_POOL_PAGE_SIZE
+#define BUFFER_POOL_PAGES               (CONFIG_ARASTORAGE_BUFFER_POOL_SIZE / CONFIG_ARASTORAGE_BUFFER_POOL_PAGE_SIZE)
+
+#if BUFFER_POOL_PAGES < 1
+#error "CONFIG_ARASTORAGE_BUFFER_POOL_SIZE must be at least CONFIG_ARASTORAGE_BUFFER_POOL_PAGE_SIZE"
+#endif
+
+/****************************************************************************
+* Global Function Prototypes
+****************************************************************************/
+db_result_t buffer_pool_init(void);
+void buffer_pool_deinit(void);
+void *buffer_pool_pin(db_storage_id_t, unsigned long, unsigned);
+db_result_t buffer_pool_put(db_storage_id_t, unsigned long, void *, unsigned);
+db_result_t buffer_pool_dirty(db_storage_id_t, unsigned long);
+db_result_t buffer_pool_unpin(db_storage_id_t, unsigned long);
+db_result_t buffer_pool_discard(db_storage_id_t, unsigned long);
+db_result_t buffer_pool_flush(db_storage_id_t);
+db_result_t buffer_pool_release(db_storage_id_t);
+void buffer_pool_get_stats(db_buffer_pool_stats_t *);
+
+#endif							/* __BUFFER_POOL_H__ */
@@ -28,6 +28,7 @@
 #include "db_debug.h"
 #include "storage.h"
 #include "relation.h"
+#include "aql.h"
 
 /****************************************************************************
 * Public Functions
@@ -36,12 +37,22 @@
 /* Update current cursor id and storage id. */
 db_result_t cursor_move_to(db_cursor_t *cursor, tuple_id_t row_id)
 {
+	if (cursor != NULL && IS_STREAM_CURSOR(cursor)) {
+		/* Rows of a streaming cursor are not kept, so it can only stay
+		   on the current row. */
+		if (row_id != cursor->current_cursor_row || IS_INVALID_CURSOR_ROW(cursor)) {
+			DB_LOG_E("streaming cursor only moves forward\n");
+			return DB_CURSOR_ERROR;
+		}
+		return DB_OK;
+	}
+
 	if (IS_EMPTY_CURSOR(cursor)) {
 		DB_LOG_E("Empty Cursor\n");
 		return DB_CURSOR_ERROR;
 	}
 
-	if (row_id >= DB_CURSOR_RESULT_ENTRY || row_id >= cursor->cursor_rows) {
+	if (row_id >= cursor->cursor_rows) {
 		DB_LOG_E("invalid row id\n");
 		return DB_CURSOR_ERROR;
 	}
@@ -70,6 +81,10 @@ db_result_t cursor_move_to(db_cursor_t *cursor, tuple_id_t row_id)
 /* Search the first set tuple id and update storage id corresponding it. */
 db_result_t cursor_move_first(db_cursor_t *cursor)
 {
+	if (cursor != NULL && IS_STREAM_CURSOR(cursor) && cursor->cursor_rows == 0) {
+		return cursor_move_next(cursor);
+	}
+
 	return cursor_move_to(cursor, 0);
 }
 
@@ -86,10 +101,22 @@ db_result_t cursor_move_last(db_cursor_t *cursor)
 /* Search next set tuple id and update storage id corresponding it. */
 db_result_t cursor_move_next(db_cursor_t *cursor)
 {
+	db_result_t res;
+
 	if (!cursor) {
 		return DB_CURSOR_ERROR;
 	}
 
+	if (IS_STREAM_CURSOR(cursor)) {
+		/* Fetch the next matching tuple. Like a cursor which is moved
+		   past its last row, fail at the end of the relation. */
+		res = relation_stream_next(cursor);
+		if (res == DB_GOT_ROW) {
+			return DB_OK;
+		}
+		return DB_ERROR(res) ? res : DB_CURSOR_ERROR;
+	}
+
 	return cursor_move_to(cursor, cursor->current_cursor_row + 1);
 }
 
@@ -124,6 +151,10 @@ bool cursor_is_first_row(db_cursor_t *cursor)
 	if (cursor->current_cursor_row != 0) {
 		return false;
 	}
+	if (IS_STREAM_CURSOR(cursor)) {
+		return cursor->cursor_rows > 0;
+	}
+
 	//check whether pointing storage row id is true
 	for (i = 0; i < cursor->total_rows; i++) {
 		index = GET_INDEX(i);
@@ -145,6 +176,10 @@ bool cursor_is_last_row(db_cursor_t *cursor)
 	if (cursor == NULL) {
 		return false;
 	}
+	/* The end of a streaming cursor is only known after moving past it. */
+	if (IS_STREAM_CURSOR(cursor)) {
+		return false;
+	}
 	//check whether pointing cursor id is correct
 	if (cursor->current_cursor_row != cursor->cursor_rows - 1) {
 		return false;
@@ -173,7 +208,7 @@ db_result_t cursor_data_add(db_cursor_t *cursor, tuple_id_t tuple_id)
 		return DB_CURSOR_ERROR;
 	}
 
-	if (tuple_id >= DB_CURSOR_RESULT_ENTRY || tuple_id >= cursor->total_rows) {
+	if (tuple_id >= cursor->total_rows) {
 		DB_LOG_E("invalid tuple id error\n");
 		return DB_CURSOR_ERROR;
 	}
@@ -257,6 +292,19 @@ db_result_t cursor_get_value_storage(attribute_value_t *value, db_cursor_t *curs
 		return DB_CURSOR_ERROR;
 	}
 
+	memcpy(attr.name, cursor->attr_map[col].name, sizeof(attr.name));
+	attr.domain = cursor->attr_map[col].domain;
+	attr.element_size = cursor->attr_map[col].data_size;
+
+	if (IS_STREAM_CURSOR(cursor)) {
+		/* The current row of a streaming cursor is already in memory. */
+		if (IS_INVALID_CURSOR_ROW(cursor)) {
+			DB_LOG_E("invalid storage row id\n");
+			return DB_CURSOR_ERROR;
+		}
+		return db_phy_to_value(value, &attr, cursor->row + cursor->attr_map[col].offset);
+	}
+
 	if (IS_INVALID_STORAGE_ROW(cursor)) {
 		DB_LOG_E("invalid storage row id\n");
 		return DB_CURSOR_ERROR;
@@ -264,10 +312,6 @@ db_result_t cursor_get_value_storage(attribute_value_t *value, db_cursor_t *curs
 
 	buf = cursor->tuple;
 
-	memcpy(attr.name, cursor->attr_map[col].name, sizeof(attr.name));
-	attr.domain = cursor->attr_map[col].domain;
-	attr.element_size = cursor->attr_map[col].data_size;
-
 	if (cursor->attr_map[col].valuetype == AGGREGATE_VALUE) {
 		/* If the type of value is aggregate value, we don't need to read storage.
 		 Because aggregate result is already calculated and stored in buffer. */
@@ -405,12 +449,17 @@ void cursor_clean_data(db_cursor_t *cursor)
 	cursor->current_storage_row = -1;
 	cursor->cursor_rows = 0;
 	cursor->total_rows = 0;
+	cursor->stream_tuples = 0;
 	cursor->attribute_count = 0;
 	cursor->storage_row_length = 0;
 	if (cursor->row_arr != NULL) {
 		free(cursor->row_arr);
 	}
 	cursor->row_arr = NULL;
+	if (cursor->row != NULL) {
+		free(cursor->row);
+	}
+	cursor->row = NULL;
 }
 
 db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel)
@@ -422,11 +471,8 @@ db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel)
 
 	cursor_clean_data(*cursor);
 
+	/* One bit for each tuple of the relation */
 	arr_size = GET_CURSOR_DATA_ARR_SIZE(rel->cardinality);
-	if (arr_size > DB_CURSOR_LIMIT) {
-		return DB_CURSOR_ERROR;
-	}
-
 	(*cursor)->row_arr = (uint32_t *)malloc(sizeof(uint32_t) * arr_size);
 	if ((*cursor)->row_arr == NULL) {
 		return DB_CURSOR_ERROR;
@@ -441,15 +487,47 @@ db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel)
 	return DB_OK;
 }
 
+/*
+ * Initialize a cursor which reads the tuples of rel on demand. Only the
+ * current row is kept in memory, whatever the number of matching tuples.
+ */
+db_result_t cursor_stream_init(db_cursor_t **cursor, relation_t *rel)
+{
+	if (*cursor == NULL) {
+		return DB_CURSOR_ERROR;
+	}
+
+	cursor_clean_data(*cursor);
+
+	(*cursor)->row = (unsigned char *)malloc(sizeof(char) * rel->row_length + 1);
+	if ((*cursor)->row == NULL) {
+		return DB_CURSOR_ERROR;
+	}
+
+	(*cursor)->storage_row_length = rel->row_length;
+	memcpy((*cursor)->name, rel->tuple_filename, sizeof(rel->tuple_filename));
+	memcpy((*cursor)->rel_name, rel->name, sizeof(rel->name));
+
+	return DB_OK;
+}
+
 db_result_t cursor_deinit(db_cursor_t *cursor)
 {
 	if (cursor == NULL) {
 		return DB_CURSOR_ERROR;
 	}
+	if (cursor->handle != NULL) {
+		/* Release the relation and the condition of a streaming cursor. */
+		aql_deinit_handle(&cursor->handle);
+	}
 	if (cursor->row_arr) {
 		free(cursor->row_arr);
 		cursor->row_arr = NULL;
 	}
+	if (cursor->row) {
+		free(cursor->row);
+		cursor->row = NULL;
+	}
 	free(cursor);
 	return DB_OK;
 }
@@ -127,6 +127,11 @@
 #define AQL_ATTRIBUTE_LIMIT             9
 #endif							/* AQL_ATTRIBUTE_LIMIT */
 
+/* The maximum number of parameters in a single prepared statement. */
+#ifndef AQL_PARAM_LIMIT
+#define AQL_PARAM_LIMIT                 AQL_ATTRIBUTE_LIMIT
+#endif							/* AQL_PARAM_LIMIT */
+
 /*----------------------------------------------------------------------------*/
 
 /*
@@ -163,21 +168,6 @@
 #define CONFIG_MOUNT_POINT "/mnt/"
 #endif
 
-/* The maximum number of tuples in a relation. */
-#ifndef DB_TUPLE_LIMIT
-#define DB_TUPLE_LIMIT          1000
-#endif							/* DB_TUPLE_LIMIT */
-
-/* The number of int array in a cursor. */
-#ifndef DB_CURSOR_LIMIT
-#define DB_CURSOR_LIMIT          ((DB_TUPLE_LIMIT / (sizeof(uint32_t)*8)) + 1)
-#endif							/* DB_CURSOR_LIMIT */
-
-/* The maximum number of tuples in a cursor. */
-#ifndef DB_CURSOR_RESULT_ENTRY
-#define DB_CURSOR_RESULT_ENTRY          ((DB_CURSOR_LIMIT) * (sizeof(uint32_t)*8))
-#endif							/* DB_CURSOR_RESULT_ENTRY */
-
 /* The name of the intermediate "result" relation file, which is used
    for presenting the result of a query to a user. */
 #ifndef RESULT_RELATION
@@ -216,19 +206,26 @@
 #define DB_INDEX_COST                   64
 #endif							/* DB_INDEX_COST */
 
+/* The relative costs used to choose between a sequential scan and an index
+   scan: reading a tuple during a sequential scan, reading a tuple by its
+   id, and reading a page of an external index. */
+#ifndef DB_COST_SEQUENTIAL_ROW
+#define DB_COST_SEQUENTIAL_ROW          1
+#endif							/* DB_COST_SEQUENTIAL_ROW */
+
+#ifndef DB_COST_RANDOM_ROW
+#define DB_COST_RANDOM_ROW              8
+#endif							/* DB_COST_RANDOM_ROW */
+
+#ifndef DB_COST_INDEX_PAGE
+#define DB_COST_INDEX_PAGE              16
+#endif							/* DB_COST_INDEX_PAGE */
+
 /* The maximum number of Maxheap indexes. */
 #ifndef DB_HEAP_INDEX_LIMIT
 #define DB_HEAP_INDEX_LIMIT             1
 #endif							/* DB_HEAP_INDEX_LIMIT */
 
-/* The maximum number of buckets cached in the MaxHeap index. */
-#ifndef DB_HEAP_CACHE_LIMIT
-#define DB_HEAP_CACHE_LIMIT             6
-#endif							/* DB_HEAP_CACHE_LIMIT */
-
-#ifndef DB_TREE_CACHE_LIMIT
-#define DB_TREE_CACHE_LIMIT             10
-#endif
 
 #ifdef DB_WIP
 #undef DB_WIP						/* DB WORK IN PROGRESS */
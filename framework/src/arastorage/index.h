@@ -108,9 +108,28 @@ struct index_iterator_s {
 	attribute_value_t max_value;
 	tuple_id_t next_item_no;
 	tuple_id_t found_items;
+	/* Position of the iteration, maintained by the index implementation */
+	void *page;
+	tuple_id_t page_id;
+	tuple_id_t start;
+	tuple_id_t end;
 };
 typedef struct index_iterator_s index_iterator_t;
 
+/* A key and the tuple holding it, passed to index_build() in key order */
+struct index_key_s {
+	attribute_value_t value;
+	tuple_id_t tuple_id;
+};
+typedef struct index_key_s index_key_t;
+
+/* Expected cost of looking up a range of keys in an index */
+struct index_estimate_s {
+	tuple_id_t rows;			/* tuples in the range */
+	tuple_id_t pages;			/* index pages or rows read to find them */
+};
+typedef struct index_estimate_s index_estimate_t;
+
 struct index_api_s {
 	index_type_t type;
 	uint8_t flags;
@@ -121,6 +140,8 @@ struct index_api_s {
 	db_result_t(*insert)(index_t *, attribute_value_t *, tuple_id_t);
 	db_result_t(*delete)(index_t *, attribute_value_t *);
 	tuple_id_t(*get_next)(index_iterator_t *, uint8_t);
+	db_result_t(*estimate)(index_t *, attribute_value_t *, attribute_value_t *, index_estimate_t *);
+	db_result_t(*build)(index_t *, index_key_t *, tuple_id_t);
 };
 
 typedef struct index_api_s index_api_t;
@@ -143,6 +164,8 @@ db_result_t index_insert(index_t *, attribute_value_t *, tuple_id_t);
 db_result_t index_delete(index_t *, attribute_value_t *);
 db_result_t index_get_iterator(index_iterator_t *, index_t *, attribute_value_t *, attribute_value_t *);
 tuple_id_t index_get_next(index_iterator_t *, uint8_t);
+db_result_t index_estimate(index_t *, attribute_value_t *, attribute_value_t *, index_estimate_t *);
+db_result_t index_build(index_t *, index_key_t *, tuple_id_t);
 int index_exists(attribute_t *);
 db_result_t index_deinit(void);
 #endif							/* !INDEX_H */
@@ -63,6 +63,7 @@
 #include "storage.h"
 #include "random.h"
 #include "rw_locks.h"
+#include "buffer_pool.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -75,14 +76,13 @@
 #define LEAF_NODES      pow(BRANCH_FACTOR, NODE_DEPTH)
 #define EMPTY_NODE(node)        (node)->val[BRANCH_FACTOR-1] == 0
 #define KEY_MAX INT_MAX
+/* Fixed point unit of the position of a key in the tree, see estimate() */
+#define ESTIMATE_SCALE (1UL << 16)
 #define ROW_XOR 0xf6U
-#define NODE_STATE_VALID 1
-#define NODE_STATE_LOCK 2
-#define NODE_STATE_DIRTY 4
 #define ROOT_NODE_PARENT 255
+/* Pairs per bucket built by build(), the rest is left for later inserts */
+#define BUCKET_BUILD_FILL       (BUCKET_SIZE - BUCKET_SIZE / 4)
 
-/* The total number of states possible of a node */
-#define NODE_STATES 255
 #define CONFIG_VACUUM_THRESHOLD 40
 
 #ifdef CONFIG_ARASTORAGE_ENABLE_VACUUM
@@ -92,37 +92,10 @@
 #define max(a, b) ({ __typeof__(a) _a = (a);  __typeof__(b) _b = (b); _a > _b ? _a : _b; })
 #define min(a, b) ({ __typeof__(a) _a = (a);  __typeof__(b) _b = (b); _a < _b ? _a : _b; })
 
-#define SET_NODE_STATE(node, type) \
-	do { \
-		node->node_state |= type; \
-	} while (0)
-
-#define UNSET_NODE_STATE(node, type) \
-	do { \
-		node->node_state &= ((type) ^ NODE_STATES); \
-	} while (0)
-
-#define REMOVE_ENTRY(node) \
-	do { \
-		node->prev->next = node->next; \
-		node->next->prev = node->prev; \
-	} while (0)
-
-#define PLACE_AT_HEAD(node, cache_type) \
-	do { \
-		cache_type->in_cache.head->next->prev = node; \
-		node->next = cache_type->in_cache.head->next; \
-		node->prev = cache_type->in_cache.head; \
-		cache_type->in_cache.head->next = node; \
-	} while (0)
-
-#define PLACE_AT_TAIL(node, cache_type) \
-	do { \
-		cache_type->in_cache.tail->prev->next = node; \
-		node->next = cache_type->in_cache.tail; \
-		node->prev = cache_type->in_cache.tail->prev; \
-		cache_type->in_cache.tail->prev = node; \
-	} while (0)
+/* The offsets of nodes and buckets in their storage files, which identify
+   their pages in the buffer pool. */
+#define NODE_OFFSET(id)         (base_offset + (unsigned long)(id) * sizeof(tree_node_t))
+#define BUCKET_OFFSET(id)       ((unsigned long)(id) * sizeof(bucket_t))
 
 /****************************************************************************
  * Private Types
@@ -147,44 +120,11 @@ struct bucket_s {
 };
 typedef struct bucket_s bucket_t;
 
-struct qnode_s {
-	struct qnode_s *next;
-	struct qnode_s *prev;
-	uint8_t id;
-	uint8_t pos;
-	uint8_t node_state;
-};
-
-typedef struct qnode_s qnode_t;
-struct queue_s {
-	qnode_t *head;
-	qnode_t *tail;
-};
-typedef struct queue_s queue_t;
-
-/* A Bucket Cache Entry */
-struct bucket_cache_s {
-	bucket_t bucket;
-};
-
-/* A Tree Cache Entry */
-struct tree_cache_s {
-	tree_node_t node;
-};
-
-/* Bucket Cache Structure */
-typedef struct {
-	struct bucket_cache_s cache_t[DB_HEAP_CACHE_LIMIT];
-	queue_t in_cache;
-	uint8_t num;
-} bucket_cache_t;
-
-/* Tree Cache Structure */
-typedef struct {
-	struct tree_cache_s cache_t[DB_TREE_CACHE_LIMIT];
-	queue_t in_cache;
-	uint8_t num;
-} tree_cache_t;
+/* Nodes and buckets are cached in buffer pool pages, one per page.
+ * Fails to compile if CONFIG_ARASTORAGE_BUFFER_POOL_PAGE_SIZE is too small.
+ */
+typedef char bplustree_node_fits_page[(sizeof(tree_node_t) <= BUFFER_POOL_PAGE_SIZE) ? 1 : -1];
+typedef char bplustree_bucket_fits_page[(sizeof(bucket_t) <= BUFFER_POOL_PAGE_SIZE) ? 1 : -1];
 
 typedef enum {
 	NODE = 0,
@@ -240,10 +180,8 @@ struct tree_s {
 	uint16_t inserted;			/*  Count of total number of tuples inserted  */
 	uint16_t deleted;			/*    Count of total number of tuples deleted  */
 	uint8_t levels;				/*  The depth of the bplus-tree including the buckets  */
-	tree_cache_t *node_cache;	/*  Structure to maintain node cache  */
-	bucket_cache_t *buck_cache;	/*   Structure to maintain bucket cache  */
-	pthread_mutex_t node_cache_lock;	/*  Maintains concurrency control over Node Cache  */
-	pthread_mutex_t buck_cache_lock;	/*  Maintains concurrency control over Bucket Cache  */
+	void *reserved_cache[2];	/*  Unused since nodes and buckets are cached in the buffer pool,  */
+	pthread_mutex_t reserved_lock[2];	/*  kept so that trees stored on flash keep their layout  */
 	pthread_mutex_t bucket_lock;	/*  Maintains serialisability over in RAM Tree Structure  */
 	struct rw_lock_s tree_lock;	/*  A Reader Writer Lock used to maintain consistency in tree structure */
 };
@@ -259,13 +197,11 @@ static int base_offset = 0;
  ****************************************************************************/
 static int transform_key(int);
 static tree_node_t *tree_read(tree_t *, int);
-static int tree_write(tree_t *, int, tree_node_t *);
 static tree_result_t tree_insert(tree_t *, int);
 static pair_t *tree_find(tree_t *, int key);
 tree_result_t insert_item_btree(tree_t *, int, int);
 
 static bucket_t *bucket_read(tree_t *, int);
-static int bucket_write(tree_t *, int, bucket_t *);
 static bsplit_status_t bucket_split(tree_t *, int, int, pair_t *);
 static cache_result_t cache_bucket_append(tree_t *, int, pair_t *);
 static cache_result_t cache_write_bucket(tree_t *, int, bucket_t *);
@@ -282,6 +218,9 @@ static db_result_t release(index_t *);
 static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
 static db_result_t delete(index_t *, attribute_value_t *);
 static tuple_id_t get_next(index_iterator_t *, uint8_t);
+static db_result_t estimate(index_t *, attribute_value_t *, attribute_value_t *, index_estimate_t *);
+static int estimate_position(tree_t *, int, bool, uint32_t *);
+static db_result_t build(index_t *, index_key_t *, tuple_id_t);
 
 #ifdef DB_WIP
 static db_result_t vacuum(tree_t *, relation_t *);
@@ -302,7 +241,9 @@ index_api_t index_bplustree = {
 	release,
 	insert,
 	delete,
-	get_next
+	get_next,
+	estimate,
+	build
 };
 
 /****************************************************************************
@@ -335,8 +276,8 @@ void* bptree_malloc(size_t size)
  *              bplus-tree both in memory and on flash.
  *              The tree_filename, bucket_filename and tree structure are
  *              saved the flash and also in the index_t structure in RAM,
- *              The cache for both node and buckets is present in RAM and
- *              is de-allocated when the index exits in the release function
+ *              Nodes and buckets are cached in the buffer pool shared by
+ *              all indexes, and written back when the index is released
  *
  ****************************************************************************/
 static db_result_t create(index_t *index)
@@ -350,7 +291,6 @@ static db_result_t create(index_t *index)
 	size_t buck_size = 0;
 	int offset = 0;
 	db_result_t result;
-	uint8_t success = 0;
 	int curtime;
 
 	curtime = time(NULL);
@@ -437,87 +377,11 @@ static db_result_t create(index_t *index)
 	/* Initialize the tree metadata. */
 	memset(&tree->lock_buckets, 0, sizeof(tree->lock_buckets));
 
-	/* Allocating node cache and initialising it */
-	tree->node_cache = bptree_malloc(sizeof(tree_cache_t));
-	if (tree->node_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->node_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->node_cache->in_cache.tail = end;
-				tree->node_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE NODE CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		storage_remove(tree_filename);
-		storage_remove(bucket_filename);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->node_cache->in_cache.head);
-			}
-			free(tree->node_cache);
-		}
-		free(tree);
-		return result;
-	}
-
-	/* Allocating bucket cache and initialising it */
-	tree->buck_cache = bptree_malloc(sizeof(bucket_cache_t));
-	success = 0;
-	if (tree->buck_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->buck_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->buck_cache->in_cache.tail = end;
-				tree->buck_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE BUCKET CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		free(tree->node_cache->in_cache.tail);
-		free(tree->node_cache->in_cache.head);
-		free(tree->node_cache);
-		storage_remove(tree_filename);
-		storage_remove(bucket_filename);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->buck_cache->in_cache.head);
-			}
-			free(tree->buck_cache);
-		}
-		free(tree);
-		return result;
-	}
-
 	tree->inserted = 0;
 	tree->deleted = 0;
 
 	/* Initialising Locks for concurrency control */
-	pthread_mutex_init(&(tree->node_cache_lock), NULL);
 	pthread_mutex_init(&(tree->bucket_lock), NULL);
-	pthread_mutex_init(&(tree->buck_cache_lock), NULL);
 	rw_init(&(tree->tree_lock));
 
 	tree->off_nodes = tree->off_buckets = 0;
@@ -562,8 +426,6 @@ static db_result_t load(index_t *index)
 	tree_t *tree;
 	db_storage_id_t fd;
 	char bucket_file[DB_MAX_FILENAME_LENGTH];
-	db_result_t result;
-	uint8_t success = 0;
 
 	index->opaque_data = tree = bptree_malloc(sizeof(tree_t));
 	if (tree == NULL) {
@@ -592,75 +454,6 @@ static db_result_t load(index_t *index)
 	}
 	storage_close(fd);
 
-	tree->node_cache = bptree_malloc(sizeof(tree_cache_t));
-	if (tree->node_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->node_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->node_cache->in_cache.tail = end;
-				tree->node_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE NODE CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->node_cache->in_cache.head);
-			}
-			free(tree->node_cache);
-		}
-		free(tree);
-		return result;
-	}
-
-	/* Allocating bucket cache and initialising it  */
-	tree->buck_cache = bptree_malloc(sizeof(bucket_cache_t));
-	success = 0;
-	if (tree->buck_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->buck_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->buck_cache->in_cache.tail = end;
-				tree->buck_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
-		DB_LOG_E("FAILED TO ALLOCATE BUCKET CACHE\n");
-		result = DB_ALLOCATION_ERROR;
-		free(tree->node_cache->in_cache.tail);
-		free(tree->node_cache->in_cache.head);
-		free(tree->node_cache);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->buck_cache->in_cache.head);
-			}
-			free(tree->buck_cache);
-		}
-		free(tree);
-		return result;
-	}
-
 	base_offset = sizeof(tree_t) + sizeof(bucket_file);
 	tree->tree_storage = storage_open(index->descriptor_file, O_RDWR);
 	tree->bucket_storage = storage_open(bucket_file, O_RDWR);
@@ -674,52 +467,19 @@ static db_result_t load(index_t *index)
 static db_result_t release(index_t *index)
 {
 	tree_t *tree;
-	qnode_t *tmp_node;
 
 	tree = index->opaque_data;
 	if (tree == NULL) {
 		return DB_ALLOCATION_ERROR;
 	}
-	if (tree->node_cache == NULL || tree->buck_cache == NULL) {
-		return DB_ALLOCATION_ERROR;
-	}
-	if ((tree->node_cache->in_cache.tail == NULL) || (tree->node_cache->in_cache.head == NULL)) {
-		return DB_ALLOCATION_ERROR;
-	}
-	if ((tree->buck_cache->in_cache.tail == NULL) || (tree->buck_cache->in_cache.head == NULL)) {
-		return DB_ALLOCATION_ERROR;
-	}
 	storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
-	/* Bucket Cache being flushed */
-	tmp_node = tree->buck_cache->in_cache.head->next;
-	free(tmp_node->prev);
-	while (tmp_node != tree->buck_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			bucket_write(tree, tmp_node->id, &(tree->buck_cache->cache_t[tmp_node->pos].bucket));
-		}
-		tmp_node = tmp_node->next;
-		if (tmp_node->prev) {
-			free(tmp_node->prev);
-		}
-	}
-	free(tree->buck_cache->in_cache.tail);
-	tmp_node = tree->node_cache->in_cache.head->next;
-	free(tmp_node->prev);
-	while (tmp_node != tree->node_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			tree_write(tree, tmp_node->id, &(tree->node_cache->cache_t[tmp_node->pos].node));
-		}
-		tmp_node = tmp_node->next;
-		if (tmp_node->prev) {
-			free(tmp_node->prev);
-		}
-	}
-	free(tree->node_cache->in_cache.tail);
+
+	/* Write back the cached buckets and nodes */
+	buffer_pool_release(tree->bucket_storage);
+	buffer_pool_release(tree->tree_storage);
 	storage_close(tree->bucket_storage);
 	storage_close(tree->tree_storage);
 
-	free(tree->node_cache);
-	free(tree->buck_cache);
 	free(tree);
 	return DB_OK;
 }
@@ -757,27 +517,9 @@ static db_result_t insert(index_t *index, attribute_value_t *key, tuple_id_t val
 	 *	and write back is preferred.
 	 ***************************************************************************************/
 #ifdef DB_WIP
-	qnode_t *tmp_node;
 	storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
-
-	/* Bucket Cache being flushed */
-
-	tmp_node = tree->buck_cache->in_cache.head->next;
-	while (tmp_node != tree->buck_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			bucket_write(tree, tmp_node->id, &(tree->buck_cache->cache_t[tmp_node->pos].bucket));
-			UNSET_NODE_STATE(tmp_node, NODE_STATE_DIRTY);
-		}
-		tmp_node = tmp_node->next;
-	}
-	tmp_node = tree->node_cache->in_cache.head->next;
-	while (tmp_node != tree->node_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			tree_write(tree, tmp_node->id, &(tree->node_cache->cache_t[tmp_node->pos].node));
-			UNSET_NODE_STATE(tmp_node, NODE_STATE_DIRTY);
-		}
-		tmp_node = tmp_node->next;
-	}
+	buffer_pool_flush(tree->bucket_storage);
+	buffer_pool_flush(tree->tree_storage);
 #endif
 	return DB_OK;
 }
@@ -814,148 +556,395 @@ static uint16_t next_bucket(tree_t *tree, bucket_t *bucket)
  * Name: get_next
  *
  * Description: Returns the tuple id of the next valid tuple for the case of
- *              select and remove queries
+ *              select and remove queries. The iteration starts in the
+ *              bucket which holds the lower bound of the range and follows
+ *              the chain of buckets in increasing order of keys until it
+ *              reaches a bucket whose keys are all above the upper bound.
+ *              The position is kept in the iterator, so that several
+ *              iterations may be in progress at the same time.
  *
  ****************************************************************************/
 static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition)
 {
-
-	/* This cache holds a pointer to a bucket in the main cache and other
-	 * information required to iterate over the bucket
-	 */
-	struct iteration_cache {
-		index_iterator_t *index_iterator;
-		uint16_t bucket_id;
-		bucket_t *bucket;
-		tuple_id_t found_items;
-		uint8_t start;
-		uint8_t end;
-	};
 	int i;
-	static struct iteration_cache cache;
 	int key_max;
 	int key_min;
 	tree_t *tree;
+	bucket_t *bucket;
+	pair_t *path;
+	tuple_id_t tuple_id;
+
 	key_min = *(int *)&iterator->min_value;
 	key_max = *(int *)&iterator->max_value;
 	tree = (tree_t *)iterator->index->opaque_data;
 
-	/* To initialize the iterator_cache */
-	if (iterator->next_item_no == 0) {	/* removed the condition of iterator inequality */
-		if (iterator->found_items == 0) {
-			rw_lock_write(&(tree->tree_lock));
-			pair_t *path = tree_find(tree, key_min);
-			if (path == NULL) {
-				return INVALID_TUPLE;
-			}
-			uint16_t bucket_id = path[tree->levels].key;
-			free(path);
-			/* TODO
-			 * Absent of non-cast return handling, should be taken care in the definition
-			 */
-			cache.bucket = bucket_read(tree, bucket_id);
-			cache.bucket_id = bucket_id;
-			cache.start = 0;
-			cache.end = cache.bucket->next_free_slot;
+	/* To initialize the iteration in the first bucket of the range */
+	if (iterator->next_item_no == 0 && iterator->found_items == 0) {
+		rw_lock_write(&(tree->tree_lock));
+		path = tree_find(tree, key_min);
+		if (path == NULL) {
+			rw_unlock_write(&(tree->tree_lock));
+			return INVALID_TUPLE;
 		}
-	}
-
-	/* Iterate over the key-value pairs in the bucket and find the ones which satisfy the condition */
-	for (i = cache.start; i < cache.end; i++) {
-		if ((key_min <= cache.bucket->pairs[i].key) && (cache.bucket->pairs[i].key <= key_max)) {
-			iterator->found_items++;
-			iterator->next_item_no = iterator->found_items;
-
-			/* matched condition is FALSE when the query is for remove tuples */
-			if (matched_condition == FALSE) {
-				tuple_id_t tmp = cache.bucket->pairs[i].value;
-				if (cache.end > (i + 1)) {
-					cache.bucket->pairs[i] = cache.bucket->pairs[cache.end - 1];
-
-					/* Start Bucket chaining */
-					int iter = 0;
-					uint16_t new_min = cache.bucket->info[1];
-					uint16_t new_max = cache.bucket->info[2];
-					for (; iter < cache.bucket->next_free_slot - 1; iter++) {
-						new_min = min(cache.bucket->pairs[iter].key, new_min);
-						new_max = max(cache.bucket->pairs[iter].key, new_max);
+		iterator->page_id = path[tree->levels].key;
+		free(path);
+		/* TODO
+		 * Absent of non-cast return handling, should be taken care in the definition
+		 */
+		iterator->page = bucket_read(tree, iterator->page_id);
+		iterator->start = 0;
+		iterator->end = ((bucket_t *)iterator->page)->next_free_slot;
+	}
+
+	for (;;) {
+		bucket = (bucket_t *)iterator->page;
+
+		/* Iterate over the key-value pairs in the bucket and find the ones which satisfy the condition */
+		for (i = iterator->start; i < iterator->end; i++) {
+			if ((key_min <= bucket->pairs[i].key) && (bucket->pairs[i].key <= key_max)) {
+				iterator->found_items++;
+				iterator->next_item_no = iterator->found_items;
+				tuple_id = bucket->pairs[i].value;
+
+				/* matched condition is FALSE when the query is for remove tuples */
+				if (matched_condition == FALSE) {
+					if (iterator->end > (i + 1)) {
+						bucket->pairs[i] = bucket->pairs[iterator->end - 1];
+
+						/* Start Bucket chaining */
+						int iter = 0;
+						uint16_t new_min = bucket->info[1];
+						uint16_t new_max = bucket->info[2];
+						for (; iter < bucket->next_free_slot - 1; iter++) {
+							new_min = min(bucket->pairs[iter].key, new_min);
+							new_max = max(bucket->pairs[iter].key, new_max);
+						}
+						bucket->info[1] = new_min;
+						bucket->info[2] = new_max;
+						/* End of Bucket chaining */
 					}
-					cache.bucket->info[1] = new_min;
-					cache.bucket->info[2] = new_max;
-					/* End of Bucket chaining */
-				}
 
-				cache.bucket->next_free_slot--;
-				tree->deleted++;
-				cache.end--;
-				cache.start = i;
-				return tmp;
-			} else {
-				cache.start = i + 1;
+					bucket->next_free_slot--;
+					tree->deleted++;
+					iterator->end--;
+					iterator->start = i;
+				} else {
+					iterator->start = i + 1;
+				}
+				return tuple_id;
 			}
-			return cache.bucket->pairs[i].value;
 		}
-	}
 
-	/* case when delete query comes */
-	if (matched_condition == FALSE) {
-		modify_cache(tree, cache.bucket_id, BUCKET, INVALIDATE);
-		cache_write_bucket(tree, cache.bucket_id, cache.bucket);
+		/* case when delete query comes */
+		if (matched_condition == FALSE) {
+			modify_cache(tree, iterator->page_id, BUCKET, DIRTY);
+			modify_cache(tree, iterator->page_id, BUCKET, UNLOCK);
 #ifdef DB_WIP
-		if ((int)((double)(tree->deleted) * 100 / tree->inserted) >= VACUUM_THRESHOLD) {
-			vacuum(tree, iterator->index->rel);
-		}
+			if ((int)((double)(tree->deleted) * 100 / tree->inserted) >= VACUUM_THRESHOLD) {
+				vacuum(tree, iterator->index->rel);
+			}
 #endif
-	} else {
-		modify_cache(tree, cache.bucket_id, BUCKET, UNLOCK);
-	}
-	pthread_mutex_lock(&(tree->bucket_lock));
-	tree->lock_buckets[cache.bucket_id] = 0;
-	cache.bucket_id = next_bucket(tree, cache.bucket);
-	if (cache.bucket_id == (uint16_t)-1) {
-		if (iterator->found_items == 0) {
-			iterator->next_item_no = 0;
 		} else {
-			iterator->next_item_no = 1;
+			modify_cache(tree, iterator->page_id, BUCKET, UNLOCK);
 		}
-		pthread_mutex_unlock(&(tree->bucket_lock));
-		rw_unlock_write(&(tree->tree_lock));
-		return INVALID_TUPLE;
-	}
-	while (tree->lock_buckets[cache.bucket_id] == 1) {
-		pthread_mutex_unlock(&(tree->bucket_lock));
-		DB_LOG_D("BUCKET ALREADY LOCKED IN GET NEXT SPINNING\n");
 		pthread_mutex_lock(&(tree->bucket_lock));
-	}
+		tree->lock_buckets[iterator->page_id] = 0;
+		iterator->page_id = next_bucket(tree, bucket);
+		if (iterator->page_id == (uint16_t)-1) {
+			break;
+		}
+		while (tree->lock_buckets[iterator->page_id] == 1) {
+			pthread_mutex_unlock(&(tree->bucket_lock));
+			DB_LOG_D("BUCKET ALREADY LOCKED IN GET NEXT SPINNING\n");
+			pthread_mutex_lock(&(tree->bucket_lock));
+		}
 
-	/* TODO
-	 * Absent of non-cast return handling, should be taken care in the definition
-	 */
-	cache.bucket = bucket_read(tree, cache.bucket_id);
-	if (cache.bucket->info[1] > key_max) {
-		modify_cache(tree, cache.bucket_id, BUCKET, UNLOCK);
-		if (iterator->found_items == 0) {
-			iterator->next_item_no = 0;
-		} else {
-			iterator->next_item_no = 1;
+		/* TODO
+		 * Absent of non-cast return handling, should be taken care in the definition
+		 */
+		bucket = bucket_read(tree, iterator->page_id);
+		if (bucket->info[1] > key_max) {
+			/* The buckets are chained in increasing order of keys, so
+			   none of the remaining ones can be in the range. */
+			modify_cache(tree, iterator->page_id, BUCKET, UNLOCK);
+			break;
 		}
+
+		tree->lock_buckets[iterator->page_id] = 1;
 		pthread_mutex_unlock(&(tree->bucket_lock));
-		rw_unlock_write(&(tree->tree_lock));
-		return INVALID_TUPLE;
 
+		iterator->page = bucket;
+		iterator->start = 0;
+		iterator->end = bucket->next_free_slot;
+		iterator->next_item_no = 1;
 	}
 
-	tree->lock_buckets[cache.bucket_id] = 1;
+	/* The end of the range is reached. */
+	if (iterator->found_items == 0) {
+		iterator->next_item_no = 0;
+	} else {
+		iterator->next_item_no = 1;
+	}
 	pthread_mutex_unlock(&(tree->bucket_lock));
+	rw_unlock_write(&(tree->tree_lock));
+	return INVALID_TUPLE;
+}
+
+/****************************************************************************
+ * Name: estimate_position
+ *
+ * Description: Finds where a key falls in the tree as a fraction of
+ *              ESTIMATE_SCALE. The tree is descended the same way as
+ *              tree_find() and every node is assumed to split its share evenly
+ *              over its children, so the result has the resolution of one
+ *              bucket. With 'upper' set the end of the bucket is returned
+ *              instead of its start.
+ *
+ ****************************************************************************/
+static int estimate_position(tree_t *tree, int key, bool upper, uint32_t *position)
+{
+	tree_node_t *node;
+	uint32_t width;
+	int nkeys;
+	int id;
+	int next;
+	int j;
+	bool leaf;
+
+	*position = 0;
+	width = ESTIMATE_SCALE;
+	id = tree->root;
+	do {
+		node = tree_read(tree, id);
+		if (node == NULL) {
+			return -1;
+		}
+		nkeys = node->val[BRANCH_FACTOR - 1];
+		for (j = 0; j < nkeys && node->val[j] <= key; j++) {
+		}
+		width /= nkeys + 1;
+		*position += j * width;
+		leaf = node->is_leaf;
+		next = node->id[j];
+		modify_cache(tree, id, NODE, UNLOCK);
+		id = next;
+	} while (!leaf);
+
+	if (upper) {
+		*position += width;
+	}
+	return 0;
+}
+
+/****************************************************************************
+ * Name: estimate
+ *
+ * Description: Estimates the number of tuples in a range of keys and the
+ *              number of pages read to find them. The buckets which cover
+ *              the range are located down to the leaf level, and the keys
+ *              are assumed to be spread evenly over the buckets.
+ *
+ ****************************************************************************/
+static db_result_t estimate(index_t *index, attribute_value_t *min_value, attribute_value_t *max_value, index_estimate_t *estimate)
+{
+	tree_t *tree;
+	uint32_t first;
+	uint32_t last;
+	tuple_id_t count;
+	tuple_id_t buckets;
 
-	cache.start = 0;
-	cache.end = cache.bucket->next_free_slot;
+	tree = (tree_t *)index->opaque_data;
+
+	rw_lock_read(&(tree->tree_lock));
+	if (estimate_position(tree, transform_key(db_value_to_long(min_value)), false, &first) < 0 || estimate_position(tree, transform_key(db_value_to_long(max_value)), true, &last) < 0) {
+		rw_unlock_read(&(tree->tree_lock));
+		return DB_INDEX_ERROR;
+	}
+	count = tree->inserted - tree->deleted;
+	buckets = tree->off_buckets;
+	rw_unlock_read(&(tree->tree_lock));
 
-	iterator->next_item_no = 1;
-	return get_next(iterator, matched_condition);
+	estimate->rows = (tuple_id_t)(((uint64_t)count * (last - first)) / ESTIMATE_SCALE);
+	buckets = (tuple_id_t)(((uint64_t)buckets * (last - first)) / ESTIMATE_SCALE);
+	estimate->pages = (tree->levels - 1) + max(buckets, (tuple_id_t)1);
+
+	return DB_OK;
 }
 
+/****************************************************************************
+ * Name: build_bucket_end
+ *
+ * Description: Helper function for build. Returns the index of the first
+ *              key after the bucket starting at start. Buckets take
+ *              BUCKET_BUILD_FILL keys, and up to BUCKET_SIZE so that a run
+ *              of equal keys is not split between two buckets.
+ *
+ ****************************************************************************/
+static tuple_id_t build_bucket_end(index_key_t *keys, tuple_id_t nkeys, tuple_id_t start)
+{
+	tuple_id_t end;
+
+	end = min(start + BUCKET_BUILD_FILL, nkeys);
+	while (end < nkeys && end - start < BUCKET_SIZE && db_value_to_long(&keys[end].value) == db_value_to_long(&keys[end - 1].value)) {
+		end++;
+	}
+	return end;
+}
+
+/****************************************************************************
+ * Name: build
+ *
+ * Description: Builds the tree bottom-up from keys sorted in increasing
+ *              order, instead of inserting them one at a time. The buckets
+ *              are filled and chained from left to right, then each level
+ *              of nodes is made of the separators of the level below, until
+ *              a single root is left. Every bucket and node is written once.
+ *              As in a tree grown by insertions, the last child of the
+ *              rightmost leaf is the bucket for KEY_MAX.
+ *              Only an empty tree is built, otherwise DB_IMPLEMENTATION_ERROR
+ *              is returned and the keys are inserted one by one.
+ *
+ ****************************************************************************/
+static db_result_t build(index_t *index, index_key_t *keys, tuple_id_t nkeys)
+{
+	tree_t *tree;
+	bucket_t *bucket;
+	bucket_t new_bucket;
+	tree_node_t node;
+	int *ids;
+	int *seps;
+	int nbuckets;
+	int nnodes;
+	int count;
+	int groups;
+	int first;
+	int last;
+	int g;
+	int i;
+	long key;
+	tuple_id_t start;
+	tuple_id_t end;
+	uint16_t is_leaf;
+
+	tree = (tree_t *)index->opaque_data;
 
+#ifdef CONFIG_ARASTORAGE_ENABLE_FLUSHING
+	if (nkeys >= DB_TUPLES_LIMIT) {
+		return DB_IMPLEMENTATION_ERROR;
+	}
+#endif
+	/* KEY_MAX belongs to the last bucket of the tree, see tree_insert */
+	for (start = 0; start < nkeys; start++) {
+		key = db_value_to_long(&keys[start].value);
+		if (key >= KEY_MAX || key < INT_MIN) {
+			return DB_IMPLEMENTATION_ERROR;
+		}
+	}
+
+	/* Count the buckets and nodes, and give up before writing anything */
+	nbuckets = 0;
+	for (start = 0; start < nkeys; start = build_bucket_end(keys, nkeys, start)) {
+		nbuckets++;
+	}
+	nnodes = 0;
+	for (count = nbuckets + 1; count > 1; count = (count + BRANCH_FACTOR - 1) / BRANCH_FACTOR) {
+		nnodes += (count + BRANCH_FACTOR - 1) / BRANCH_FACTOR;
+	}
+	if (nbuckets == 0 || nbuckets > CONFIG_BUCKETS_LIMIT - 1 || nnodes > CONFIG_NODE_LIMIT) {
+		return DB_IMPLEMENTATION_ERROR;
+	}
+
+	ids = (int *)malloc(sizeof(int) * (nbuckets + 1));
+	seps = (int *)malloc(sizeof(int) * (nbuckets + 1));
+	if (ids == NULL || seps == NULL) {
+		free(ids);
+		free(seps);
+		return DB_ALLOCATION_ERROR;
+	}
+
+	rw_lock_write(&(tree->tree_lock));
+	bucket = bucket_read(tree, 0);
+	if (bucket == NULL) {
+		rw_unlock_write(&(tree->tree_lock));
+		free(ids);
+		free(seps);
+		return DB_INDEX_ERROR;
+	}
+	count = bucket->next_free_slot;
+	modify_cache(tree, 0, BUCKET, UNLOCK);
+	if (tree->levels != 2 || tree->off_buckets != 1 || count != 0) {
+		rw_unlock_write(&(tree->tree_lock));
+		free(ids);
+		free(seps);
+		return DB_IMPLEMENTATION_ERROR;
+	}
+
+	/* The buckets, chained in increasing order of keys */
+	for (i = 0, start = 0; i < nbuckets; i++, start = end) {
+		end = build_bucket_end(keys, nkeys, start);
+		memset(&new_bucket, 0, sizeof(bucket_t));
+		for (count = 0; count < end - start; count++) {
+			new_bucket.pairs[count].key = (int)db_value_to_long(&keys[start + count].value);
+			new_bucket.pairs[count].value = keys[start + count].tuple_id;
+		}
+		new_bucket.next_free_slot = end - start;
+		new_bucket.info[0] = (i == nbuckets - 1) ? CONFIG_BUCKETS_LIMIT - 1 : i + 1;
+		new_bucket.info[1] = new_bucket.pairs[0].key;
+		new_bucket.info[2] = new_bucket.pairs[new_bucket.next_free_slot - 1].key;
+		cache_write_bucket(tree, i, &new_bucket);
+
+		/* A run of equal keys longer than a bucket goes on in the next
+		   one. Its separator is above the key, so that lookups start in
+		   the first bucket of the run and follow the chain. */
+		ids[i] = i;
+		seps[i] = new_bucket.pairs[0].key;
+		if (start > 0 && db_value_to_long(&keys[start].value) == db_value_to_long(&keys[start - 1].value)) {
+			seps[i]++;
+		}
+	}
+	ids[nbuckets] = CONFIG_BUCKETS_LIMIT - 1;
+	seps[nbuckets] = KEY_MAX;
+	tree->off_buckets = nbuckets;
+
+	/* The nodes, level by level. seps[i] separates ids[i] from ids[i - 1],
+	   and the first separator of a node moves up to its parent. */
+	tree->off_nodes = 0;
+	tree->levels = 1;
+	is_leaf = 1;
+	count = nbuckets + 1;
+	do {
+		groups = (count + BRANCH_FACTOR - 1) / BRANCH_FACTOR;
+		for (g = 0; g < groups; g++) {
+			first = count * g / groups;
+			last = count * (g + 1) / groups;
+			memset(&node, 0, sizeof(tree_node_t));
+			for (i = first; i < last; i++) {
+				node.id[i - first] = ids[i];
+				if (i > first) {
+					node.val[i - first - 1] = seps[i];
+				}
+			}
+			node.val[BRANCH_FACTOR - 1] = last - first - 1;
+			node.is_leaf = is_leaf;
+			cache_write_node(tree, tree->off_nodes, &node);
+
+			ids[g] = tree->off_nodes++;
+			seps[g] = seps[first];
+		}
+		count = groups;
+		is_leaf = 0;
+		tree->levels++;
+	} while (count > 1);
+	tree->root = ids[0];
+	tree->inserted += nkeys;
+
+	rw_unlock_write(&(tree->tree_lock));
+	free(ids);
+	free(seps);
+
+	DB_LOG_D("DB: Built a bplus-tree index of %d keys in %d buckets and %d nodes\n", nkeys, nbuckets, nnodes);
+	return DB_OK;
+}
 
 #ifdef DB_WIP
 /****************************************************************************
@@ -1050,44 +1039,27 @@ static db_result_t vacuum(tree_t *tree, relation_t *rel)
  ****************************************************************************/
 static cache_result_t modify_cache(tree_t *tree, int id, cache_type_t cache, op_type_t op)
 {
-	qnode_t *temp;
-	qnode_t *end;
+	db_storage_id_t storage;
+	unsigned long offset;
+	db_result_t result;
+
 	if (cache == NODE) {
-		pthread_mutex_lock(&(tree->node_cache_lock));
-		temp = tree->node_cache->in_cache.tail->prev;
-		end = tree->node_cache->in_cache.head;
+		storage = tree->tree_storage;
+		offset = NODE_OFFSET(id);
 	} else {
-		pthread_mutex_lock(&(tree->buck_cache_lock));
-		temp = tree->buck_cache->in_cache.tail->prev;
-		end = tree->buck_cache->in_cache.head;
-	}
-	while (temp != end) {
-		if ((temp->id == id) && (temp->node_state & NODE_STATE_VALID)) {
-			if (op == UNLOCK) {
-				UNSET_NODE_STATE(temp, NODE_STATE_LOCK);
-			} else if (op == DIRTY) {
-				SET_NODE_STATE(temp, NODE_STATE_DIRTY);
-			} else {
-				UNSET_NODE_STATE(temp, NODE_STATE_VALID | NODE_STATE_DIRTY | NODE_STATE_LOCK);
-				REMOVE_ENTRY(temp);
-				if (cache == NODE) {
-					PLACE_AT_HEAD(temp, tree->node_cache);
-				} else {
-					PLACE_AT_HEAD(temp, tree->buck_cache);
-				}
-			}
-			break;
-		}
-		temp = temp->prev;
+		storage = tree->bucket_storage;
+		offset = BUCKET_OFFSET(id);
 	}
 
-	if (cache == NODE) {
-		pthread_mutex_unlock(&(tree->node_cache_lock));
+	if (op == UNLOCK) {
+		result = buffer_pool_unpin(storage, offset);
+	} else if (op == DIRTY) {
+		result = buffer_pool_dirty(storage, offset);
 	} else {
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
+		result = buffer_pool_discard(storage, offset);
 	}
 
-	if (temp == end) {
+	if (DB_ERROR(result)) {
 		DB_LOG_E("PANIC CACHE OPERATION FOR A NON EXISTENT ENTRY\n");
 		return CACHE_NOT_EXIST;
 	}
@@ -1104,50 +1076,11 @@ static cache_result_t modify_cache(tree_t *tree, int id, cache_type_t cache, op_
  ****************************************************************************/
 static cache_result_t cache_write_node(tree_t *tree, int id, tree_node_t *node)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
-
-	qnode_t *new_node = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-	if (new_node == NULL) {
-		DB_LOG_E("Failed allocation of node\n");
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-		return CACHE_ALLOCATION_ERROR;
-	}
-
-	if (tree->node_cache->num < DB_TREE_CACHE_LIMIT) {
-		new_node->pos = tree->node_cache->num++;
-	} else {
-		qnode_t *iter_node;
-		iter_node = tree->node_cache->in_cache.head->next;
-		while ((iter_node->node_state & NODE_STATE_LOCK) && iter_node != tree->node_cache->in_cache.tail) {
-			iter_node = iter_node->next;
-		}
-		if (iter_node == tree->node_cache->in_cache.tail) {
-			free(new_node);
-			DB_LOG_E("NO SLOT AVAIABLE IN CACHE\n");
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return CACHE_FULL;
-		}
-		if ((iter_node->node_state & NODE_STATE_DIRTY) && (iter_node->node_state & NODE_STATE_DIRTY)) {
-			tree_write(tree, iter_node->id, &(tree->node_cache->cache_t[iter_node->pos].node));
-		}
-		new_node->pos = iter_node->pos;
-		/* iter_node is the node which has to be evicted from cache.
-		 * It is removed the queue maintaining the LRU status.
-		 */
-		REMOVE_ENTRY(iter_node);
-		free(iter_node);
+	if (DB_ERROR(buffer_pool_put(tree->tree_storage, NODE_OFFSET(id), node, sizeof(tree_node_t)))) {
+		DB_LOG_E("NO SLOT AVAIABLE IN CACHE\n");
+		return CACHE_FULL;
 	}
 
-	PLACE_AT_TAIL(new_node, tree->node_cache);
-	new_node->id = id;
-	UNSET_NODE_STATE(new_node, NODE_STATE_LOCK);
-	SET_NODE_STATE(new_node, NODE_STATE_VALID);
-	SET_NODE_STATE(new_node, NODE_STATE_DIRTY);
-
-	memcpy(&(tree->node_cache->cache_t[new_node->pos].node), node, sizeof(tree_node_t));
-
-	pthread_mutex_unlock(&(tree->node_cache_lock));
-
 	return CACHE_OK;
 }
 
@@ -1160,25 +1093,11 @@ static cache_result_t cache_write_node(tree_t *tree, int id, tree_node_t *node)
  ****************************************************************************/
 static cache_result_t cache_replace_node(tree_t *tree, int id, tree_node_t *node)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
-
-	qnode_t *replace_node;
-	replace_node = tree->node_cache->in_cache.head->next;
-
-	while ((replace_node->id != id) && (replace_node != tree->node_cache->in_cache.tail)) {
-		replace_node = replace_node->next;
-	}
-	if (replace_node == tree->node_cache->in_cache.tail || !(replace_node->node_state & NODE_STATE_LOCK)) {
+	/* The node was read by the caller, so it is still in the pool */
+	if (DB_ERROR(buffer_pool_put(tree->tree_storage, NODE_OFFSET(id), node, sizeof(tree_node_t))) || DB_ERROR(buffer_pool_unpin(tree->tree_storage, NODE_OFFSET(id)))) {
 		DB_LOG_E("PANIC REPLACE FOR NON_EXISTENT OR NON_LOCKED ENTRY\n");
-		pthread_mutex_unlock(&(tree->node_cache_lock));
 		return CACHE_NOT_EXIST;
 	}
-	UNSET_NODE_STATE(replace_node, NODE_STATE_LOCK);
-	SET_NODE_STATE(replace_node, NODE_STATE_VALID | NODE_STATE_DIRTY);
-
-	memcpy(&(tree->node_cache->cache_t[replace_node->pos].node), node, sizeof(tree_node_t));
-
-	pthread_mutex_unlock(&(tree->node_cache_lock));
 
 	return CACHE_OK;
 }
@@ -1192,45 +1111,11 @@ static cache_result_t cache_replace_node(tree_t *tree, int id, tree_node_t *node
  ****************************************************************************/
 static cache_result_t cache_write_bucket(tree_t *tree, int id, bucket_t *bucket)
 {
-	pthread_mutex_lock(&(tree->buck_cache_lock));
-
-	qnode_t *new_node = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-	if (new_node == NULL) {
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
-		return CACHE_ALLOCATION_ERROR;
+	if (DB_ERROR(buffer_pool_put(tree->bucket_storage, BUCKET_OFFSET(id), bucket, sizeof(bucket_t)))) {
+		DB_LOG_E("NO SLOT AVAILABLE IN CACHE bucket\n");
+		return CACHE_FULL;
 	}
 
-	if (tree->buck_cache->num < DB_HEAP_CACHE_LIMIT) {
-		new_node->pos = tree->buck_cache->num++;
-	} else {
-		qnode_t *iter_node;
-		iter_node = tree->buck_cache->in_cache.head->next;
-		while ((iter_node->node_state & NODE_STATE_LOCK) && (iter_node != tree->buck_cache->in_cache.tail)) {
-			iter_node = iter_node->next;
-		}
-		if (iter_node == tree->buck_cache->in_cache.tail) {
-			free(new_node);
-			DB_LOG_E("NO SLOT AVAILABLE IN CACHE bucket\n");
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return CACHE_FULL;
-		}
-
-		if ((iter_node->node_state & NODE_STATE_DIRTY) && (iter_node->node_state & NODE_STATE_VALID)) {
-			bucket_write(tree, iter_node->id, &(tree->buck_cache->cache_t[iter_node->pos].bucket));
-		}
-		new_node->pos = iter_node->pos;
-		REMOVE_ENTRY(iter_node);
-		free(iter_node);
-	}
-	PLACE_AT_TAIL(new_node, tree->buck_cache);
-	new_node->id = id;
-	UNSET_NODE_STATE(new_node, NODE_STATE_LOCK);
-	SET_NODE_STATE(new_node, NODE_STATE_DIRTY | NODE_STATE_VALID);
-
-	memcpy(&(tree->buck_cache->cache_t[new_node->pos].bucket), bucket, sizeof(bucket_t));
-
-	pthread_mutex_unlock(&(tree->buck_cache_lock));
-
 	return CACHE_OK;
 }
 
@@ -1250,110 +1135,21 @@ static int transform_key(int key)
 /****************************************************************************
  * Name: tree_read
  *
- * Description: Fetches nodes from the flash and suitably evicts the nodes
- *              from cache, in case the cache is full
+ * Description: Fetches nodes from the buffer pool, which reads them from
+ *              flash and evicts other pages when it is full
  *
  ****************************************************************************/
 static tree_node_t *tree_read(tree_t *tree, int bucket_id)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
-
-	bool found = false;
-	qnode_t *iter = (tree->node_cache->in_cache.tail)->prev;
-
-	while (iter != (tree->node_cache->in_cache.head)) {
-		if (bucket_id == iter->id && (iter->node_state & NODE_STATE_VALID)) {
-			found = true;
-			break;
-		}
-		iter = iter->prev;
-	}
-	if (found) {
-		/* Case when node is found in the cache */
-		if (iter->node_state & NODE_STATE_LOCK) {
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return NULL;
-		}
-		SET_NODE_STATE(iter, NODE_STATE_LOCK);
-		REMOVE_ENTRY(iter);
-		PLACE_AT_TAIL(iter, tree->node_cache);
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-		return &(tree->node_cache->cache_t[iter->pos].node);
-	} else {
-		qnode_t *new_node = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (new_node == NULL) {
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return NULL;
-		}
-		if (tree->node_cache->num < DB_TREE_CACHE_LIMIT) {
-			new_node->pos = tree->node_cache->num++;
-		} else {
-			/* Case when the least recently used node needs to be evicted to make place for new node */
-			qnode_t *replace_node = tree->node_cache->in_cache.head->next;
-			while ((replace_node->node_state & NODE_STATE_LOCK) && replace_node != tree->node_cache->in_cache.tail) {
-				replace_node = replace_node->next;
-			}
-			if (replace_node == tree->node_cache->in_cache.tail) {
-				free(new_node);
-				pthread_mutex_unlock(&(tree->node_cache_lock));
-				return NULL;
-			}
-			if ((replace_node->node_state & NODE_STATE_DIRTY) && (replace_node->node_state & NODE_STATE_VALID)) {
-				tree_write(tree, replace_node->id, &(tree->node_cache->cache_t[replace_node->pos].node));
-			}
-			new_node->pos = replace_node->pos;
-			REMOVE_ENTRY(replace_node);
-			free(replace_node);
-		}
-		/* Adjusting the pointers */
-		PLACE_AT_TAIL(new_node, tree->node_cache);
-		new_node->id = bucket_id;
-		SET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID | NODE_STATE_DIRTY);
-
-		/* Reading from flash */
-		if (DB_ERROR(storage_read_from(tree->tree_storage, &(tree->node_cache->cache_t[new_node->pos].node), base_offset + (unsigned long)bucket_id * sizeof(tree_node_t), sizeof(tree_node_t)))) {
-			DB_LOG_E("PANIC TREE READ FAILED AT NODE ID %d\n", new_node->id);
-			UNSET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID);
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return NULL;
-		}
-
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-
-		return &(tree->node_cache->cache_t[new_node->pos].node);
-	}
-}
+	tree_node_t *node;
 
-/****************************************************************************
- * Name: tree_write
- *
- * Description: Routine to issue a flash write of node in the tree.
- *              Required while evicting dirty cache entries
- *
- ****************************************************************************/
-static int tree_write(tree_t *tree, int offset, tree_node_t *node)
-{
-	if (DB_ERROR(storage_write_to(tree->tree_storage, node, base_offset + (unsigned long)offset * sizeof(*node), sizeof(*node)))) {
-		DB_LOG_E("TREE WRITE FAILED AT NODE ID %d\n", offset);
-		return 0;
+	node = (tree_node_t *)buffer_pool_pin(tree->tree_storage, NODE_OFFSET(bucket_id), sizeof(tree_node_t));
+	if (node == NULL) {
+		DB_LOG_E("PANIC TREE READ FAILED AT NODE ID %d\n", bucket_id);
+		return NULL;
 	}
-	return 1;
-}
 
-/****************************************************************************
- * Name: bucket_write
- *
- * Description: Routine to issue a flash write of bucket in the tree.
- *              Required while evicting dirty cache entries
- *
- ****************************************************************************/
-static int bucket_write(tree_t *tree, int pos, bucket_t *bucket)
-{
-	if (DB_ERROR(storage_write_to(tree->bucket_storage, bucket, (unsigned long)pos * sizeof(bucket_t), sizeof(bucket_t)))) {
-		DB_LOG_E("BUCKET WRITE FAILED AT BUCKET ID %d\n", pos);
-		return 0;
-	}
-	return 1;
+	return node;
 }
 
 /****************************************************************************
@@ -1522,80 +1318,20 @@ void tree_print(tree_t *tree, int id)
 /****************************************************************************
  * Name: bucket_read
  *
- * Description: Reads buckets from the cache and fetches them from flash
- *              when the entry does not exist in cache.
- *              Also evicts the suitable entries from cache when cache is full
+ * Description: Fetches buckets from the buffer pool, which reads them from
+ *              flash and evicts other pages when it is full
  *
  ****************************************************************************/
 static bucket_t *bucket_read(tree_t *tree, int bucket_id)
 {
-	pthread_mutex_lock(&(tree->buck_cache_lock));
-
-	bool found = false;
-	qnode_t *iter = (tree->buck_cache->in_cache.tail)->prev;
+	bucket_t *bucket;
 
-	while (iter != (tree->buck_cache->in_cache.head)) {
-		if (bucket_id == iter->id && (iter->node_state & NODE_STATE_VALID)) {
-			found = true;
-			break;
-		}
-		iter = iter->prev;
+	bucket = (bucket_t *)buffer_pool_pin(tree->bucket_storage, BUCKET_OFFSET(bucket_id), sizeof(bucket_t));
+	if (bucket == NULL) {
+		DB_LOG_E("PANIC BUCKET READ FAILED AT ID %d\n", bucket_id);
 	}
-	if (found) {
-		/* If the bucket is found in the cache */
-		if (iter->node_state & NODE_STATE_LOCK) {
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return NULL;
-		}
-		SET_NODE_STATE(iter, NODE_STATE_LOCK);
-		REMOVE_ENTRY(iter);
-		PLACE_AT_TAIL(iter, tree->buck_cache);
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
-		return &(tree->buck_cache->cache_t[iter->pos].bucket);
-	} else {
-		/* Bucket has to be read from flash into the cache */
-		qnode_t *new_node = (qnode_t *)bptree_malloc(sizeof(qnode_t));
-		if (new_node == NULL) {
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return NULL;
-		}
-		if (tree->buck_cache->num < DB_HEAP_CACHE_LIMIT) {
-			new_node->pos = tree->buck_cache->num++;
-		} else {
-			/* Cache doesn't have enough space and the least recently used bucket needs to be evicted */
-			qnode_t *replace_node = tree->buck_cache->in_cache.head->next;
-			while ((replace_node->node_state & NODE_STATE_LOCK) && (replace_node != tree->buck_cache->in_cache.tail)) {
-				replace_node = replace_node->next;
-			}
-			if (replace_node == tree->buck_cache->in_cache.tail) {
-				free(new_node);
-				pthread_mutex_unlock(&(tree->buck_cache_lock));
-				return NULL;
-			}
-			if ((replace_node->node_state & NODE_STATE_DIRTY) && (replace_node->node_state & NODE_STATE_VALID)) {
-				bucket_write(tree, replace_node->id, &(tree->buck_cache->cache_t[replace_node->pos].bucket));
-			}
-			new_node->pos = replace_node->pos;
-			REMOVE_ENTRY(replace_node);
-			free(replace_node);
-		}
 
-		/* Adjust the pointers */
-		PLACE_AT_TAIL(new_node, tree->buck_cache);
-		new_node->id = bucket_id;
-		SET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID);
-		UNSET_NODE_STATE(new_node, NODE_STATE_DIRTY);
-
-		/* Read from flash */
-		if (DB_ERROR(storage_read_from(tree->bucket_storage, (void *)&(tree->buck_cache->cache_t[new_node->pos].bucket), (unsigned long)bucket_id * sizeof(bucket_t), sizeof(bucket_t)))) {
-			DB_LOG_E("PANIC BUCKET READ FAILED AT ID %d\n", bucket_id);
-			UNSET_NODE_STATE(new_node, (NODE_STATE_LOCK | NODE_STATE_VALID));
-			pthread_mutex_unlock(&(tree->buck_cache_lock));
-			return NULL;
-		}
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
-		return &(tree->buck_cache->cache_t[new_node->pos].bucket);
-	}
+	return bucket;
 }
 
 /****************************************************************************
@@ -1832,8 +1568,9 @@ static bsplit_status_t bucket_split(tree_t *tree, int key, int value, pair_t *pa
 		b2.info[2] = b2.pairs[b2.next_free_slot - 1].key;
 		/* End of Bucket chaining */
 
-		modify_cache(tree, bucket_id, BUCKET, INVALIDATE);
-		cache_write_bucket(tree, bucket_id, &b1);
+		memcpy(bucket, &b1, sizeof(bucket_t));
+		modify_cache(tree, bucket_id, BUCKET, DIRTY);
+		modify_cache(tree, bucket_id, BUCKET, UNLOCK);
 		cache_write_bucket(tree, b_id, &b2);
 	} else {
 		tree->off_buckets--;
@@ -2120,7 +1857,9 @@ static void tree_node_update_keys(tree_t *tree, pair_t *path, int rm_val, int le
 		}
 	}
 
-	if (level > 0 && !bFound) {
+	if (bFound) {
+		modify_cache(tree, node_id, NODE, DIRTY);
+	} else if (level > 0) {
 		tree_node_update_keys(tree, path, rm_val, level-1, range_min);
 	}
 
@@ -2150,6 +1889,7 @@ static void bucket_update_keys(tree_t *tree, pair_t *path, int bucket_id, int rm
 			first_bucket = bucket_read(tree, bucket_id);
 			n->val[i] = first_bucket->info[1];
 			modify_cache(tree, bucket_id, BUCKET, UNLOCK);
+			modify_cache(tree, node_id, NODE, DIRTY);
 			bLeaf = true;
 			DB_LOG_D("bucket_update_keys, value %d , node_id %d\n", rm_val, node_id);
 			break;
@@ -2204,7 +1944,9 @@ static int bucket_request_sibling(tree_t *tree, pair_t *path, bucket_t *bucket)
 
 				n->val[index - 1] = share_key;
 
+				modify_cache(tree, node_id, NODE, DIRTY);
 				modify_cache(tree, node_id, NODE, UNLOCK);
+				modify_cache(tree, n->id[index - 1], BUCKET, DIRTY);
 				modify_cache(tree, n->id[index - 1], BUCKET, UNLOCK);
 				return 0;
 			}
@@ -2230,7 +1972,9 @@ static int bucket_request_sibling(tree_t *tree, pair_t *path, bucket_t *bucket)
 
 				n->val[index] = right_bucket->info[1];
 
+				modify_cache(tree, node_id, NODE, DIRTY);
 				modify_cache(tree, node_id, NODE, UNLOCK);
+				modify_cache(tree, n->id[index + 1], BUCKET, DIRTY);
 				modify_cache(tree, n->id[index + 1], BUCKET, UNLOCK);
 				return 0;
 			}
@@ -2251,6 +1995,7 @@ static void bucket_update_next(tree_t *tree, int bucket_id, int next_id)
 	if (bucket) {
 		bucket->info[0] = next_id;
 		DB_LOG_D("set bucket %d next id %d\n", bucket_id, next_id);
+		modify_cache(tree, bucket_id, BUCKET, DIRTY);
 	}
 	modify_cache(tree, bucket_id, BUCKET, UNLOCK);
 }
@@ -2334,6 +2079,9 @@ static int tree_rebuild_node(tree_t *tree, pair_t *path, int level)
 			pn->val[index - 1] = lsbn->val[sb_key_num - 1];			
 			lsbn->val[BRANCH_FACTOR - 1] = sb_key_num - 1;
 
+			modify_cache(tree, node_id, NODE, DIRTY);
+			modify_cache(tree, pnode_id, NODE, DIRTY);
+			modify_cache(tree, lsb_id, NODE, DIRTY);
 			modify_cache(tree, node_id, NODE, UNLOCK);
 			modify_cache(tree, pnode_id, NODE, UNLOCK);
 			modify_cache(tree, lsb_id, NODE, UNLOCK);
@@ -2364,6 +2112,9 @@ static int tree_rebuild_node(tree_t *tree, pair_t *path, int level)
 			}
 			rsbn->val[BRANCH_FACTOR - 1] = sb_key_num - 1;
 
+			modify_cache(tree, node_id, NODE, DIRTY);
+			modify_cache(tree, pnode_id, NODE, DIRTY);
+			modify_cache(tree, rsb_id, NODE, DIRTY);
 			modify_cache(tree, node_id, NODE, UNLOCK);
 			modify_cache(tree, pnode_id, NODE, UNLOCK);
 			modify_cache(tree, rsb_id, NODE, UNLOCK);
@@ -2390,6 +2141,7 @@ static int tree_rebuild_node(tree_t *tree, pair_t *path, int level)
 			}
 			lsbn->id[sb_key_num + key_num] = n->id[key_num];
 			lsbn->val[BRANCH_FACTOR - 1] = sb_key_num + key_num;
+			modify_cache(tree, lsb_id, NODE, DIRTY);
 		} else {
 			key_num++;
 			for (i = sb_key_num; i >= 0 ; i--) {
@@ -2402,6 +2154,7 @@ static int tree_rebuild_node(tree_t *tree, pair_t *path, int level)
 			}
 			rsbn->val[key_num-1] = pn->val[index];
 			rsbn->val[BRANCH_FACTOR - 1] = sb_key_num + key_num;
+			modify_cache(tree, rsb_id, NODE, DIRTY);
 		}
 
 		//release current node
@@ -2424,6 +2177,7 @@ static int tree_rebuild_node(tree_t *tree, pair_t *path, int level)
 				pn->id[i] = pn->id[i + 1];
 			}
 			pn->val[BRANCH_FACTOR - 1] = pn->val[BRANCH_FACTOR - 1] - 1;
+			modify_cache(tree, pnode_id, NODE, DIRTY);
 
 			if ((pnode_id != tree->root) && pn->val[BRANCH_FACTOR - 1] < BRANCH_FACTOR / 2) {
 				tree_rebuild_node(tree, path, level-1);
@@ -2478,6 +2232,7 @@ static int bucket_merge_sibling(tree_t *tree, pair_t *path, bucket_t *bucket, in
 			
 			//update bucket list
 			modify_cache(tree, path[tree->levels].key, BUCKET, INVALIDATE);
+			modify_cache(tree, sibling_id, BUCKET, DIRTY);
 			modify_cache(tree, sibling_id, BUCKET, UNLOCK);
 
 			//update parent tree node
@@ -2488,6 +2243,7 @@ static int bucket_merge_sibling(tree_t *tree, pair_t *path, bucket_t *bucket, in
 				n->id[i] = n->id[i + 1];
 			}
 			n->val[BRANCH_FACTOR - 1] = (--key_num);
+			modify_cache(tree, node_id, NODE, DIRTY);
 			modify_cache(tree, node_id, NODE, UNLOCK);
 
 			bucket_update_keys(tree, path, sibling_id, rm_val);
@@ -2513,6 +2269,7 @@ static int bucket_merge_sibling(tree_t *tree, pair_t *path, bucket_t *bucket, in
 			}
 			//update bucket list
 			modify_cache(tree, path[tree->levels].key, BUCKET, INVALIDATE);
+			modify_cache(tree, sibling_id, BUCKET, DIRTY);
 			modify_cache(tree, sibling_id, BUCKET, UNLOCK);
 
 			//update parent tree node
@@ -2522,6 +2279,7 @@ static int bucket_merge_sibling(tree_t *tree, pair_t *path, bucket_t *bucket, in
 				n->id[i] = n->id[i + 1];
 			}
 			n->val[BRANCH_FACTOR - 1] = (--key_num);
+			modify_cache(tree, node_id, NODE, DIRTY);
 			modify_cache(tree, node_id, NODE, UNLOCK);
 
 			bucket_update_keys(tree, path, sibling_id, rm_val);
@@ -2563,6 +2321,7 @@ static db_result_t delete_item_btree(index_t *index, int value)
 	tmp_bucket = bucket_read(tree, bucket_id);
 	bucket_remove_pair(tmp_bucket, value, &rm_value, 0);
 	free(rm_value);
+	modify_cache(tree, bucket_id, BUCKET, DIRTY);
 	modify_cache(tree, bucket_id, BUCKET, UNLOCK);
 	tree->inserted--;
 
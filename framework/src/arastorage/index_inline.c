@@ -75,6 +75,7 @@ static db_result_t null_op(index_t *);
 static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
 static db_result_t delete(index_t *, attribute_value_t *);
 static tuple_id_t get_next(index_iterator_t *, uint8_t);
+static db_result_t estimate(index_t *, attribute_value_t *, attribute_value_t *, index_estimate_t *);
 
 /****************************************************************************
 * Private Types
@@ -103,7 +104,9 @@ index_api_t index_inline = {
 	null_op,
 	insert,
 	delete,
-	get_next
+	get_next,
+	estimate,
+	NULL
 };
 
 /****************************************************************************
@@ -213,26 +216,82 @@ static db_result_t delete(index_t *index, attribute_value_t *value)
 
 static tuple_id_t get_next(index_iterator_t *iterator, uint8_t inverse_condition)
 {
-	static tuple_id_t cached_start;
-	static tuple_id_t cached_end;
-
 	if (iterator->next_item_no == 0) {
 		/*
 		 * We conduct the actual index search when the caller attempts to
 		 * access the first item in the iteration. The first and last tuple
-		 * id:s of the result get cached for subsequent iterations.
+		 * id:s of the result get cached in the iterator for subsequent
+		 * iterations.
 		 */
-		if (DB_ERROR(range_search(iterator, &cached_start, &cached_end))) {
-			cached_start = 0;
-			cached_end = 0;
+		if (DB_ERROR(range_search(iterator, &iterator->start, &iterator->end))) {
+			iterator->start = 0;
+			iterator->end = 0;
 			return INVALID_TUPLE;
 		}
-		DB_LOG_D("DB: Cached the tuple range (%ld,%ld)\n", (long)cached_start, (long)cached_end);
+		DB_LOG_D("DB: Cached the tuple range (%ld,%ld)\n", (long)iterator->start, (long)iterator->end);
 		++iterator->next_item_no;
-		return cached_start;
-	} else if (cached_start + iterator->next_item_no <= cached_end) {
-		return cached_start + iterator->next_item_no++;
+		return iterator->start;
+	} else if (iterator->start + iterator->next_item_no <= iterator->end) {
+		return iterator->start + iterator->next_item_no++;
 	}
 
 	return INVALID_TUPLE;
 }
+
+/*
+ * The tuples are sorted on the indexed attribute, so the number of tuples
+ * in a range is interpolated between the values of the first and the last
+ * tuple. Finding the range takes two binary searches over the tuples.
+ */
+static db_result_t estimate(index_t *index, attribute_value_t *min_value, attribute_value_t *max_value, index_estimate_t *estimate)
+{
+	tuple_id_t cardinality;
+	tuple_id_t tuple_id;
+	attribute_value_t *value;
+	long first;
+	long last;
+	long min;
+	long max;
+	int depth;
+
+	cardinality = relation_cardinality(index->rel);
+	if (cardinality == INVALID_TUPLE) {
+		return DB_STORAGE_ERROR;
+	}
+
+	for (depth = 0; (1UL << depth) < cardinality; depth++) {
+	}
+	estimate->pages = 2 * depth;
+	estimate->rows = 0;
+	if (cardinality == 0) {
+		return DB_OK;
+	}
+
+	tuple_id = 0;
+	value = get_value(&tuple_id, index->rel, index->attr);
+	if (value == NULL) {
+		return DB_INDEX_ERROR;
+	}
+	first = db_value_to_long(value);
+
+	tuple_id = cardinality - 1;
+	value = get_value(&tuple_id, index->rel, index->attr);
+	if (value == NULL) {
+		return DB_INDEX_ERROR;
+	}
+	last = db_value_to_long(value);
+
+	min = db_value_to_long(min_value) > first ? db_value_to_long(min_value) : first;
+	max = db_value_to_long(max_value) < last ? db_value_to_long(max_value) : last;
+	if (min > max) {
+		return DB_OK;
+	}
+
+	if (last == first) {
+		estimate->rows = cardinality;
+	} else {
+		estimate->rows = (tuple_id_t)((double)cardinality * ((double)max - min + 1) / ((double)last - first + 1));
+	}
+
+	return DB_OK;
+}
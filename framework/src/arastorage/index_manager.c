@@ -366,6 +366,7 @@ db_result_t index_get_iterator(index_iterator_t *iterator, index_t *index, attri
 	iterator->min_value = *min_value;
 	iterator->max_value = *max_value;
 	iterator->next_item_no = 0;
+	iterator->found_items = 0;
 
 	DB_LOG_D("DB: Acquired an index iterator for %s.%s over the range (%ld,%ld)\n", index->rel->name, index->attr->name, min_value->u.long_value, max_value->u.long_value);
 
@@ -398,6 +399,36 @@ tuple_id_t index_get_next(index_iterator_t *iterator, uint8_t matched_condition)
 	return iterator->index->api->get_next(iterator, matched_condition);
 }
 
+db_result_t index_estimate(index_t *index, attribute_value_t *min_value, attribute_value_t *max_value, index_estimate_t *estimate)
+{
+	if (index->state != INDEX_READY) {
+		return DB_INDEX_ERROR;
+	}
+
+	if (index->api->estimate == NULL) {
+		/* Without an estimate, assume that the whole relation is read. */
+		estimate->rows = relation_cardinality(index->rel);
+		estimate->pages = 0;
+		return DB_OK;
+	}
+
+	return index->api->estimate(index, min_value, max_value, estimate);
+}
+
+/*
+ * Build an empty index from keys sorted in increasing order. Returns
+ * DB_IMPLEMENTATION_ERROR if the index cannot be built this way, in which
+ * case it is left untouched and the keys have to be inserted one by one.
+ */
+db_result_t index_build(index_t *index, index_key_t *keys, tuple_id_t nkeys)
+{
+	if (index->api->build == NULL) {
+		return DB_IMPLEMENTATION_ERROR;
+	}
+
+	return index->api->build(index, keys, nkeys);
+}
+
 /****************************************************************************
 * Private Functions
 ****************************************************************************/
@@ -453,6 +453,67 @@ lvm_status_t lvm_set_long(lvm_instance_t *p, long l)
 	return lvm_set_operand(p, &op);
 }
 
+/*
+ * Emit a placeholder operand for a parameter of a prepared statement.
+ * The placeholder is replaced by a long constant with lvm_bind_long().
+ */
+lvm_status_t lvm_set_param(lvm_instance_t *p, int param)
+{
+	operand_t op;
+
+	op.type = LVM_PARAM;
+	op.value.l = param;
+
+	return lvm_set_operand(p, &op);
+}
+
+/*
+ * Find the position of the placeholder operand of a parameter in the
+ * compiled code. This must be called once the code is complete, since
+ * compiling connectives and operators moves the code around.
+ */
+lvm_ip_t lvm_find_param(lvm_instance_t *p, int param)
+{
+	lvm_ip_t ip;
+	operand_t operand;
+
+	for (ip = 0; ip < p->end;) {
+		switch (*(node_type_t *)(p->code + ip)) {
+		case LVM_CMP_OP:
+		case LVM_ARITH_OP:
+			ip += sizeof(node_type_t) + sizeof(operator_t);
+			break;
+		case LVM_OPERAND:
+			ip += sizeof(node_type_t);
+			memcpy(&operand, p->code + ip, sizeof(operand));
+			if (operand.type == LVM_PARAM && operand.value.l == param) {
+				return ip;
+			}
+			ip += sizeof(operand_t);
+			break;
+		default:
+			return -1;
+		}
+	}
+
+	return -1;
+}
+
+lvm_status_t lvm_bind_long(lvm_instance_t *p, lvm_ip_t ip, long l)
+{
+	operand_t op;
+
+	if (ip < 0 || (size_t)ip + sizeof(op) > (size_t)p->end) {
+		return INVALID_IDENTIFIER;
+	}
+
+	op.type = LVM_LONG;
+	op.value.l = l;
+	memcpy(&p->code[ip], &op, sizeof(op));
+
+	return LVM_TRUE;
+}
+
 lvm_status_t lvm_register_variable(lvm_instance_t *p, char *name, operand_type_t type)
 {
 	variable_id_t id;
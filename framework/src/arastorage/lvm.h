@@ -118,7 +118,8 @@ typedef enum lvm_operator_e operator_t;
 enum operand_type_e {
 	LVM_VARIABLE,
 	LVM_FLOAT,
-	LVM_LONG
+	LVM_LONG,
+	LVM_PARAM
 };
 typedef enum operand_type_e operand_type_t;
 
@@ -182,6 +183,9 @@ lvm_status_t lvm_set_relation(lvm_instance_t *p, operator_t op);
 lvm_status_t lvm_set_operand(lvm_instance_t *p, operand_t *op);
 lvm_status_t lvm_set_operand_value(lvm_instance_t *p, attribute_t *attr, unsigned char *value);
 lvm_status_t lvm_set_long(lvm_instance_t *p, long l);
+lvm_status_t lvm_set_param(lvm_instance_t *p, int param);
+lvm_ip_t lvm_find_param(lvm_instance_t *p, int param);
+lvm_status_t lvm_bind_long(lvm_instance_t *p, lvm_ip_t ip, long l);
 lvm_status_t lvm_set_variable(lvm_instance_t *p, char *name);
 lvm_status_t lvm_set_variable_value(lvm_instance_t *p, char *name, operand_value_t value);
 #endif							/* LVM_H */
@@ -55,6 +55,7 @@
  * Included Files
  ****************************************************************************/
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <tinyara/config.h>
@@ -68,12 +69,26 @@
 #include "list.h"
 #include "aql.h"
 #include "relation.h"
+#include "result.h"
 
 /****************************************************************************
 * Global Function Prototypes
 ****************************************************************************/
 
 LIST(relations);
+
+/*
+ * State of a bulk insertion opened with BEGIN. Tuples inserted into the
+ * relation are only appended to the tuple file, and its indexes are
+ * updated in key order when the insertion is committed.
+ */
+struct relation_bulk_s {
+	relation_t *rel;
+	tuple_id_t first_row;		/* position of the first new row in the tuple file */
+	tuple_id_t first_tuple;		/* tuple id given to the first new row */
+};
+
+static struct relation_bulk_s g_relation_bulk;
 // TODO: SIZE limitation not applied
 //MEMB(relations_memb, relation_t, DB_RELATION_POOL_SIZE);
 //MEMB(attributes_memb, attribute_t, DB_ATTRIBUTE_POOL_SIZE);
@@ -213,6 +228,12 @@ db_result_t relation_deinit(void)
 	relation_t *rel;
 	relation_t *next;
 
+	if (g_relation_bulk.rel != NULL) {
+		DB_LOG_E("DB: Bulk insertion into %s is not committed\n", g_relation_bulk.rel->name);
+		relation_release(g_relation_bulk.rel);
+		g_relation_bulk.rel = NULL;
+	}
+
 	rel = list_head(relations);
 	while (rel != NULL) {
 		next = rel->next;
@@ -563,13 +584,16 @@ db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
 			DB_LOG_V(", ");
 		}
 #endif              /* DEBUG */
-		if (attr->index == NULL) {
-			index_load(rel, attr);
-		}
 		ptr += attr->element_size;
-		if (attr->index != NULL) {
-			if (DB_ERROR(index_insert(attr->index, value, rel->next_row))) {
-				return DB_INDEX_ERROR;
+		/* During bulk insertion, indexes are updated on COMMIT. */
+		if (rel != g_relation_bulk.rel) {
+			if (attr->index == NULL) {
+				index_load(rel, attr);
+			}
+			if (attr->index != NULL) {
+				if (DB_ERROR(index_insert(attr->index, value, rel->next_row))) {
+					return DB_INDEX_ERROR;
+				}
 			}
 		}
 		attr = attr->next;
@@ -581,6 +605,202 @@ db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
 	return storage_put_row(rel, record, FALSE);
 }
 
+db_result_t relation_bulk_begin(relation_t *rel)
+{
+	if (g_relation_bulk.rel != NULL) {
+		DB_LOG_E("DB: Bulk insertion into %s is in progress\n", g_relation_bulk.rel->name);
+		return DB_BUSY_ERROR;
+	}
+
+	/* Keep the relation loaded until COMMIT. */
+	rel->references++;
+	g_relation_bulk.rel = rel;
+	g_relation_bulk.first_row = relation_cardinality(rel);
+	g_relation_bulk.first_tuple = rel->next_row;
+
+	DB_LOG_D("DB: Begin bulk insertion into %s at row %d\n", rel->name, g_relation_bulk.first_row);
+	return DB_OK;
+}
+
+static int bulk_key_compare(const void *p1, const void *p2)
+{
+	long key1;
+	long key2;
+
+	key1 = db_value_to_long(&((index_key_t *)p1)->value);
+	key2 = db_value_to_long(&((index_key_t *)p2)->value);
+	if (key1 < key2) {
+		return -1;
+	}
+	return key1 > key2;
+}
+
+/*
+ * Read the keys of the new rows back from the tuple file and sort them.
+ * Indexes only exist on INT and LONG attributes, which are ordered as long.
+ */
+static db_result_t relation_bulk_keys(relation_t *rel, attribute_t *attr, tuple_id_t nrows, index_key_t **keys)
+{
+	unsigned char *row;
+	tuple_id_t tuple_id;
+	tuple_id_t i;
+	db_result_t result;
+
+	if (attr->domain != DOMAIN_INT && attr->domain != DOMAIN_LONG) {
+		DB_LOG_E("DB: Bulk insertion cannot index %s of domain %d\n", attr->name, attr->domain);
+		return DB_TYPE_ERROR;
+	}
+
+	*keys = (index_key_t *)malloc(sizeof(index_key_t) * nrows);
+	row = (unsigned char *)malloc(sizeof(char) * rel->row_length + 1);
+	if (*keys == NULL || row == NULL) {
+		DB_LOG_E("DB: Failed to allocate bulk keys\n");
+		result = DB_ALLOCATION_ERROR;
+		goto errout;
+	}
+
+	for (i = 0; i < nrows; i++) {
+		tuple_id = g_relation_bulk.first_row + i;
+		result = storage_get_row(rel, &tuple_id, row);
+		if (result != DB_OK) {
+			DB_LOG_E("DB: Failed to read row %d of bulk insertion\n", tuple_id);
+			result = DB_STORAGE_ERROR;
+			goto errout;
+		}
+		result = relation_get_value(rel, attr, row, &(*keys)[i].value);
+		if (DB_ERROR(result)) {
+			goto errout;
+		}
+		(*keys)[i].tuple_id = g_relation_bulk.first_tuple + i;
+	}
+
+	qsort(*keys, nrows, sizeof(index_key_t), bulk_key_compare);
+	free(row);
+	return DB_OK;
+
+errout:
+	if (row != NULL) {
+		free(row);
+	}
+	if (*keys != NULL) {
+		free(*keys);
+		*keys = NULL;
+	}
+	return result;
+}
+
+/*
+ * Add the keys of the new rows to the index. An empty index is built from
+ * the sorted keys in one pass. Otherwise they are inserted in key order, so
+ * that consecutive keys land in the same cached bucket and buckets fill up
+ * and split in order. If an insertion fails, the keys inserted so far are
+ * removed again so that the index is left as it was before COMMIT.
+ */
+static db_result_t relation_bulk_index(relation_t *rel, attribute_t *attr, tuple_id_t nrows)
+{
+	index_key_t *keys;
+	tuple_id_t i;
+	db_result_t result;
+
+	result = relation_bulk_keys(rel, attr, nrows, &keys);
+	if (DB_ERROR(result)) {
+		return result;
+	}
+
+	result = index_build(attr->index, keys, nrows);
+	if (result != DB_IMPLEMENTATION_ERROR) {
+		free(keys);
+		return result;
+	}
+
+	result = DB_OK;
+	for (i = 0; i < nrows; i++) {
+		if (DB_ERROR(index_insert(attr->index, &keys[i].value, keys[i].tuple_id))) {
+			result = DB_INDEX_ERROR;
+			break;
+		}
+	}
+
+	if (DB_ERROR(result)) {
+		while (i > 0) {
+			i--;
+			index_delete(attr->index, &keys[i].value);
+		}
+	}
+
+	free(keys);
+	return result;
+}
+
+/* Remove the keys of the new rows from an index they were inserted into. */
+static void relation_bulk_unindex(relation_t *rel, attribute_t *attr, tuple_id_t nrows)
+{
+	index_key_t *keys;
+	tuple_id_t i;
+
+	if (DB_ERROR(relation_bulk_keys(rel, attr, nrows, &keys))) {
+		DB_LOG_E("DB: Failed to undo bulk insertion on %s.%s\n", rel->name, attr->name);
+		return;
+	}
+
+	for (i = nrows; i > 0; i--) {
+		index_delete(attr->index, &keys[i - 1].value);
+	}
+
+	free(keys);
+}
+
+db_result_t relation_bulk_commit(relation_t *rel)
+{
+	attribute_t *attr;
+	attribute_t *done;
+	tuple_id_t nrows;
+	db_result_t result;
+
+	if (g_relation_bulk.rel == NULL || g_relation_bulk.rel != rel) {
+		DB_LOG_E("DB: No bulk insertion into %s is in progress\n", rel->name);
+		return DB_ARGUMENT_ERROR;
+	}
+
+#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+	/* The new rows must be in the tuple file to be read back. */
+	if (DB_ERROR(storage_flush_insert_buffer())) {
+		return DB_STORAGE_ERROR;
+	}
+#endif
+
+	result = DB_OK;
+	nrows = relation_cardinality(rel) - g_relation_bulk.first_row;
+	DB_LOG_D("DB: Commit bulk insertion of %d rows into %s\n", nrows, rel->name);
+
+	for (attr = list_head(rel->attributes); attr != NULL && nrows > 0; attr = attr->next) {
+		if (attr->index == NULL) {
+			index_load(rel, attr);
+		}
+		if (attr->index == NULL) {
+			continue;
+		}
+		result = relation_bulk_index(rel, attr, nrows);
+		if (DB_ERROR(result)) {
+			DB_LOG_E("DB: Failed to index bulk insertion on %s.%s\n", rel->name, attr->name);
+			break;
+		}
+	}
+
+	/* Leave no index with only a part of the new rows. */
+	if (DB_ERROR(result)) {
+		for (done = list_head(rel->attributes); done != attr; done = done->next) {
+			if (done->index != NULL) {
+				relation_bulk_unindex(rel, done, nrows);
+			}
+		}
+	}
+
+	g_relation_bulk.rel = NULL;
+	relation_release(rel);
+	return result;
+}
+
 /*
  * Update aggregation value whenever each tuple is read.
  */
@@ -678,44 +898,69 @@ static db_result_t generate_attribute_map(source_dest_map_t *attr_map, unsigned
 	return DB_OK;
 }
 
+/*
+ * Estimate the cost of reading the tuples of an index range. The inline
+ * index is searched in the relation itself, so its pages are tuple reads,
+ * while an external index costs page reads and then one tuple read per
+ * matching tuple.
+ */
+static unsigned long index_scan_cost(attribute_t *attr, index_estimate_t *estimate)
+{
+	if (((index_t *)attr->index)->type == INDEX_INLINE) {
+		return (unsigned long)estimate->pages * DB_COST_RANDOM_ROW + (unsigned long)estimate->rows * DB_COST_SEQUENTIAL_ROW;
+	}
+	return (unsigned long)estimate->pages * DB_COST_INDEX_PAGE + (unsigned long)estimate->rows * DB_COST_RANDOM_ROW;
+}
+
 static void select_index(db_handle_t **handle)
 {
-	index_t *index;
+	db_plan_t *plan;
 	attribute_t *attr;
 	operand_value_t min;
 	operand_value_t max;
 	attribute_value_t av_min;
 	attribute_value_t av_max;
-	long range;
-	unsigned long min_range;
-	index = NULL;
-	min_range = ULONG_MAX;
+	index_estimate_t estimate;
+	unsigned long cost;
+
+	/* Pick the index of the attribute whose derived range is cheaper to
+	   read than the sequential scan the plan starts with. */
+	plan = &(*handle)->plan;
 
-	/* Find all indexed and derived attributes, and select the index of
-	   the attribute with the smallest range. */
 	attr = list_head((*handle)->rel->attributes);
 	while (attr != NULL) {
 		if (attr->index != NULL && !LVM_ERROR(lvm_get_derived_range((*handle)->lvm_instance, attr->name, &min, &max))) {
-			range = (unsigned long)max.l - (unsigned long)min.l;
-			DB_LOG_D("DB: The search range for attribute \"%s\" comprises %ld values\n", attr->name, range + 1);
-			if (range <= min_range) {
-				index = attr->index;
-				av_min.domain = av_max.domain = DOMAIN_INT;
-				VALUE_LONG(&av_min) = min.l;
-				VALUE_LONG(&av_max) = max.l;
+			av_min.domain = av_max.domain = DOMAIN_INT;
+			VALUE_LONG(&av_min) = min.l;
+			VALUE_LONG(&av_max) = max.l;
+			if (index_estimate(attr->index, &av_min, &av_max, &estimate) == DB_OK) {
+				cost = index_scan_cost(attr, &estimate);
+				DB_LOG_D("DB: The search range [%ld, %ld] for attribute \"%s\" comprises about %ld tuples, cost %lu\n", min.l, max.l, attr->name, (long)estimate.rows, cost);
+				if (cost < plan->cost) {
+					plan->attr = attr;
+					plan->min = min.l;
+					plan->max = max.l;
+					plan->rows = estimate.rows;
+					plan->cost = cost;
+				}
 			}
 		}
 		attr = attr->next;
 	}
 
-	if (index != NULL) {
-		/* We found a suitable index; get an iterator for it. */
-		if (index_get_iterator(&((*handle)->index_iterator), index, &av_min, &av_max) == DB_OK) {
+	if (plan->attr != NULL) {
+		/* An index is cheaper than a sequential scan; get an iterator for it. */
+		VALUE_LONG(&av_min) = plan->min;
+		VALUE_LONG(&av_max) = plan->max;
+		if (index_get_iterator(&((*handle)->index_iterator), plan->attr->index, &av_min, &av_max) == DB_OK) {
 			(*handle)->flags |= DB_HANDLE_FLAG_SEARCH_INDEX;
+			return;
 		}
-	} else {
-		(*handle)->flags = DB_HANDLE_FLAG_INVALID;
+		plan->attr = NULL;
+		plan->rows = (*handle)->rel->cardinality;
+		plan->cost = plan->scan_cost;
 	}
+	(*handle)->flags = DB_HANDLE_FLAG_INVALID;
 }
 
 static void relation_index_clear(relation_t *rel)
@@ -782,6 +1027,7 @@ static db_result_t generate_selection_result(db_handle_t **handle, relation_t *r
 	}
 
 	attribute_count = result_rel->attribute_count;
+	(*handle)->attribute_count = attribute_count;
 
 	/* Allocate attribute map and tuple row which is used in select operation */
 	(*handle)->attr_map = (source_dest_map_t *)malloc(sizeof(source_dest_map_t) * attribute_count);
@@ -795,6 +1041,11 @@ static db_result_t generate_selection_result(db_handle_t **handle, relation_t *r
 		return DB_IMPLEMENTATION_ERROR;
 	}
 
+	(*handle)->plan.attr = NULL;
+	(*handle)->plan.rows = rel->cardinality;
+	(*handle)->plan.scan_cost = (unsigned long)rel->cardinality * DB_COST_SEQUENTIAL_ROW;
+	(*handle)->plan.cost = (*handle)->plan.scan_cost;
+
 	if ((*handle)->lvm_instance != NULL) {
 		/* Try to establish acceptable ranges for the attribute values. */
 		if (!LVM_ERROR(lvm_derive((*handle)->lvm_instance))) {
@@ -842,15 +1093,89 @@ int db_processing_status(db_handle_t *handle)
 	return handle->flags & DB_HANDLE_FLAG_PROCESSING;
 }
 
+/*
+ * Load the attribute values of a row into the predicate and the projected
+ * tuple, and check whether the predicate is true for it.
+ */
+static int select_match(db_handle_t **handle, storage_row_t row)
+{
+	source_dest_map_t *attr_map_ptr, *attr_map_end;
+	attribute_t *from_attr;
+	unsigned char *from_ptr;
+
+	attr_map_end = (*handle)->attr_map + (*handle)->attribute_count;
+
+	/* Process the attributes in the result relation. */
+	for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+		from_ptr = row + attr_map_ptr->from_offset;
+		from_attr = attr_map_ptr->from_attr;
+
+		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG) {
+			lvm_set_operand_value((*handle)->lvm_instance, from_attr, from_ptr);
+		}
+
+		if (from_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
+			/* The attribute is used just for the predicate,
+			   so do not copy the current value into the result. */
+			continue;
+		}
+
+		if (!((*handle)->adt_flags & AQL_FLAG_AGGREGATE)) {
+			/* No aggregators. Copy the original value into the resulting tuple. */
+			memcpy((*handle)->tuple + attr_map_ptr->to_offset, from_ptr, from_attr->element_size);
+		}
+	}
+
+	/* Check whether the given predicate is true for this tuple. */
+	return (*handle)->lvm_instance == NULL || lvm_execute((*handle)->lvm_instance) == TRUE;
+}
+
+/*
+ * Evaluate the predicate for one row read by relation_process_select() and
+ * add it to the cursor or the aggregation if it matches.
+ */
+static db_result_t select_row(db_handle_t **handle, db_cursor_t *cursor, storage_row_t row)
+{
+	db_result_t result;
+	source_dest_map_t *attr_map_ptr, *attr_map_end;
+	unsigned char *from_ptr;
+	attribute_value_t value;
+
+	if (!select_match(handle, row)) {
+		return DB_OK;
+	}
+
+	(*handle)->current_row++;
+	attr_map_end = (*handle)->attr_map + (*handle)->attribute_count;
+
+	if (!((*handle)->adt_flags & AQL_FLAG_AGGREGATE)) {
+		return cursor_data_add(cursor, (*handle)->tuple_id);
+	}
+
+	for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+		from_ptr = row + attr_map_ptr->from_offset;
+		result = db_phy_to_value(&value, attr_map_ptr->from_attr, from_ptr);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+
+		result = aggregate(attr_map_ptr->to_attr, &value, (*handle)->current_row);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+	}
+
+	return DB_OK;
+}
+
 db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 {
 	db_result_t result;
 	unsigned attribute_count;
 	source_dest_map_t *attr_map_ptr, *attr_map_end;
-	attribute_t *result_attr, *from_attr;
+	attribute_t *result_attr;
 	unsigned char *from_ptr, *to_ptr;
 	char aggr_buf[8];
-	attribute_value_t value;
 	storage_row_t row = NULL;
 	tuple_t result_row;
 
@@ -904,49 +1229,22 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 		return DB_FINISHED;
 	}
 
-	/* Process the attributes in the result relation. */
-	for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-		from_ptr = row + attr_map_ptr->from_offset;
-		from_attr = attr_map_ptr->from_attr;
-
-		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG) {
-			lvm_set_operand_value((*handle)->lvm_instance, from_attr, from_ptr);
-		}
-
-		if (from_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
-			/* The attribute is used just for the predicate,
-			   so do not copy the current value into the result. */
-			continue;
+	/* In a sequential scan, keep evaluating the predicate over the rest of
+	   the batch that storage_get_row() has already read into memory. */
+	for (;;) {
+		result = select_row(handle, cursor, row);
+		if (DB_ERROR(result)) {
+			goto errout;
 		}
 
-		if (!((*handle)->adt_flags & AQL_FLAG_AGGREGATE)) {
-			/* No aggregators. Copy the original value into the resulting tuple. */
-			memcpy(result_row + attr_map_ptr->to_offset, from_ptr, from_attr->element_size);
+		if (((*handle)->flags & DB_HANDLE_FLAG_SEARCH_INDEX) || !storage_row_buffered((*handle)->rel, (*handle)->tuple_id + 1)) {
+			break;
 		}
-	}
 
-	/* Check whether the given predicate is true for this tuple. */
-	if ((*handle)->lvm_instance == NULL || lvm_execute((*handle)->lvm_instance) == TRUE) {
-		(*handle)->current_row++;
-
-		if ((*handle)->adt_flags & AQL_FLAG_AGGREGATE) {
-			for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-				from_ptr = row + attr_map_ptr->from_offset;
-				result = db_phy_to_value(&value, attr_map_ptr->from_attr, from_ptr);
-				if (DB_ERROR(result)) {
-					goto errout;
-				}
-
-				result = aggregate(attr_map_ptr->to_attr, &value, (*handle)->current_row);
-				if (DB_ERROR(result)) {
-					goto errout;
-				}
-			}
-		} else {
-			result = cursor_data_add(cursor, (*handle)->tuple_id);
-			if (DB_ERROR(result)) {
-				goto errout;
-			}
+		(*handle)->tuple_id++;
+		result = storage_get_row((*handle)->rel, &((*handle)->tuple_id), row);
+		if (DB_ERROR(result)) {
+			goto errout;
 		}
 	}
 
@@ -1166,6 +1464,121 @@ db_cursor_t *relation_process_result(db_handle_t *handler)
 	return NULL;
 }
 
+db_cursor_t *relation_stream_result(db_handle_t *handler)
+{
+	db_cursor_t *cursor;
+	tuple_id_t tuple_id;
+	int arr_size;
+
+	cursor = (db_cursor_t *)malloc(sizeof(db_cursor_t));
+	if (cursor == NULL) {
+		DB_LOG_E("DB: Failed to malloc cursor\n");
+		return NULL;
+	}
+	memset(cursor, 0, sizeof(db_cursor_t));
+
+	if (DB_ERROR(cursor_stream_init(&cursor, handler->rel)) || DB_ERROR(cursor_data_set(cursor, handler->attr_map, handler->attribute_count))) {
+		DB_LOG_E("DB: Failed to init cursor and set cursor data\n");
+		cursor_deinit(cursor);
+		return NULL;
+	}
+
+	/* The cursor describes the projection from now on, so the result
+	   relation can be reused by other queries. */
+	relation_release(handler->result_rel);
+	handler->result_rel = NULL;
+
+	/* The B+tree holds its lock for as long as an iteration is in
+	   progress, so the index range is collected into a bitmap of tuple
+	   ids here, which also finishes and releases the iterator. The cursor
+	   then reads only the tuples in the range, one bit per tuple. */
+	if (handler->flags & DB_HANDLE_FLAG_SEARCH_INDEX) {
+		arr_size = GET_CURSOR_DATA_ARR_SIZE(handler->rel->cardinality);
+		cursor->row_arr = (uint32_t *)malloc(sizeof(uint32_t) * arr_size);
+		if (cursor->row_arr == NULL) {
+			DB_LOG_E("DB: Failed to malloc the index range of cursor\n");
+			cursor_deinit(cursor);
+			return NULL;
+		}
+		memset(cursor->row_arr, 0, arr_size * sizeof(uint32_t));
+		cursor->stream_tuples = handler->rel->cardinality;
+		while ((tuple_id = index_get_next(&handler->index_iterator, TRUE)) != INVALID_TUPLE) {
+			if (tuple_id < cursor->stream_tuples) {
+				BIT_SET(cursor->row_arr[GET_INDEX(tuple_id)], GET_POS(tuple_id));
+			}
+		}
+	}
+	handler->tuple_id = -1;
+
+	cursor->handle = handler;
+	return cursor;
+}
+
+/*
+ * Describe the access path chosen for a selection.
+ */
+db_result_t relation_explain(db_handle_t *handle, char *buf, size_t len)
+{
+	db_plan_t *plan;
+	int ret;
+
+	plan = &handle->plan;
+	if (plan->attr == NULL) {
+		ret = snprintf(buf, len, "%s: sequential scan, %ld tuples, cost %lu", handle->rel->name, (long)handle->rel->cardinality, plan->cost);
+	} else {
+		ret = snprintf(buf, len, "%s: %s index scan on %s [%ld, %ld], about %ld of %ld tuples, cost %lu (sequential scan %lu)", handle->rel->name, ((index_t *)plan->attr->index)->type == INDEX_INLINE ? "inline" : "bplustree", plan->attr->name, plan->min, plan->max, (long)plan->rows, (long)handle->rel->cardinality, plan->cost, plan->scan_cost);
+	}
+	if (ret < 0 || (size_t)ret >= len) {
+		return DB_LIMIT_ERROR;
+	}
+	return DB_OK;
+}
+
+/*
+ * Read the tuples of a streaming cursor until one of them fulfils the
+ * condition of the query, and make it the current row of the cursor.
+ */
+db_result_t relation_stream_next(db_cursor_t *cursor)
+{
+	db_handle_t *handle;
+	db_result_t result;
+
+	handle = cursor->handle;
+	for (;;) {
+		handle->tuple_id++;
+		if (handle->flags & DB_HANDLE_FLAG_SEARCH_INDEX) {
+			/* Skip to the next tuple in the index range. */
+			while (handle->tuple_id < cursor->stream_tuples && !BIT_CHECK(cursor->row_arr[GET_INDEX(handle->tuple_id)], GET_POS(handle->tuple_id))) {
+				handle->tuple_id++;
+			}
+			if (handle->tuple_id >= cursor->stream_tuples) {
+				handle->tuple_id = cursor->stream_tuples - 1;
+				return DB_FINISHED;
+			}
+		}
+		result = storage_get_row(handle->rel, &handle->tuple_id, cursor->row);
+		if (DB_ERROR(result)) {
+			DB_LOG_E("DB: Failed to get a row in relation %s!\n", handle->rel->name);
+			return result;
+		} else if (result == DB_FINISHED) {
+			/* Stay at the end of the relation. */
+			handle->tuple_id--;
+			return DB_FINISHED;
+		}
+
+		if (select_match(&handle, cursor->row)) {
+			break;
+		}
+	}
+
+	cursor->current_storage_row = handle->tuple_id;
+	cursor->current_cursor_row = cursor->cursor_rows;
+	cursor->cursor_rows++;
+	cursor->total_rows = cursor->cursor_rows;
+
+	return DB_GOT_ROW;
+}
+
 db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr)
 {
 	aql_adt_t *adt;
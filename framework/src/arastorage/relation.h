@@ -97,7 +97,10 @@
 #define IS_INVALID_CURSOR_ROW(a) ((a) == NULL || ((a)->current_cursor_row >= (a)->cursor_rows))
 
 /* check current storage row is valid or invalid*/
-#define IS_INVALID_STORAGE_ROW(a) ((a) == NULL || ((a)->current_storage_row >= (a)->total_rows) || (a)->current_storage_row >= DB_CURSOR_RESULT_ENTRY)
+#define IS_INVALID_STORAGE_ROW(a) ((a) == NULL || ((a)->current_storage_row >= (a)->total_rows))
+
+/* Check whether cursor fetches its rows on demand */
+#define IS_STREAM_CURSOR(a) ((a)->handle != NULL)
 
 #define RELATION_HAS_TUPLES(rel) ((rel)->tuple_storage >= 0)
 
@@ -159,6 +162,9 @@ struct _db_cursor_s {
 	attribute_id_t attribute_count;
 	size_t storage_row_length;
 	uint32_t *row_arr;
+	tuple_id_t stream_tuples;	/* tuples covered by row_arr of an indexed streaming cursor */
+	db_handle_t *handle;		/* query state of a streaming cursor */
+	unsigned char *row;			/* current row of a streaming cursor */
 	unsigned char tuple[DB_MAX_ELEMENT_SIZE + 1];
 	char name[TUPLE_NAME_LENGTH + 1];
 	char rel_name[RELATION_NAME_LENGTH + 1];
@@ -170,6 +176,7 @@ struct _db_cursor_s {
  ****************************************************************************/
 /* Operations for cursor processing */
 db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel);
+db_result_t cursor_stream_init(db_cursor_t **cursor, relation_t *rel);
 db_result_t cursor_load(db_cursor_t **target, db_cursor_t *src);
 db_result_t cursor_data_add(db_cursor_t *cursor, tuple_id_t tuple_id);
 db_result_t cursor_deinit(db_cursor_t *cursor);
@@ -181,6 +188,9 @@ db_result_t relation_deinit(void);
 db_result_t relation_process_remove(db_handle_t **, db_cursor_t *);
 db_result_t relation_process_select(db_handle_t **, db_cursor_t *);
 db_cursor_t *relation_process_result(db_handle_t *);
+db_cursor_t *relation_stream_result(db_handle_t *);
+db_result_t relation_stream_next(db_cursor_t *);
+db_result_t relation_explain(db_handle_t *, char *, size_t);
 relation_t *relation_load(char *);
 db_result_t relation_release(relation_t *);
 relation_t *relation_create(char *, db_direction_t);
@@ -192,6 +202,8 @@ db_result_t relation_attribute_remove(relation_t *, char *);
 db_result_t relation_set_primary_key(relation_t *, char *);
 db_result_t relation_remove(relation_t *, int);
 db_result_t relation_insert(relation_t *, attribute_value_t *);
+db_result_t relation_bulk_begin(relation_t *);
+db_result_t relation_bulk_commit(relation_t *);
 db_result_t relation_select(db_handle_t **, relation_t *, void *);
 tuple_id_t relation_cardinality(relation_t *);
 
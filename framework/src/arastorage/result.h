@@ -94,8 +94,20 @@ struct source_dest_map_s {
 };
 typedef struct source_dest_map_s source_dest_map_t;
 
+/* The access path chosen for a query */
+struct db_plan_s {
+	attribute_t *attr;			/* attribute of an index scan, NULL for a sequential scan */
+	long min;					/* range of the index scan */
+	long max;
+	tuple_id_t rows;			/* tuples expected to be read */
+	unsigned long cost;
+	unsigned long scan_cost;	/* cost of a sequential scan */
+};
+typedef struct db_plan_s db_plan_t;
+
 struct _db_handle_s {
 	index_iterator_t index_iterator;
+	db_plan_t plan;
 	tuple_id_t tuple_id;
 	tuple_id_t current_row;
 	relation_t *rel;
@@ -105,6 +117,7 @@ struct _db_handle_s {
 	uint8_t flags;
 	uint8_t adt_flags;
 	uint8_t ncolumns;
+	attribute_id_t attribute_count;
 	void *lvm_instance;
 	source_dest_map_t *attr_map;
 };
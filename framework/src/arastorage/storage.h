@@ -102,6 +102,16 @@ db_result_t storage_get_row_amount(relation_t *, tuple_id_t *);
 db_result_t storage_read_from(db_storage_id_t, void *, unsigned long, unsigned);
 db_result_t storage_write_to(db_storage_id_t, void *, unsigned long, unsigned);
 
+#ifdef CONFIG_ARASTORAGE_ENABLE_READ_BUFFER
+db_result_t storage_read_buffer_init(void);
+void storage_read_buffer_deinit(void);
+void storage_read_buffer_clean(void);
+int storage_row_buffered(relation_t *, tuple_id_t);
+#else
+#define storage_read_buffer_clean()
+#define storage_row_buffered(rel, tuple_id) (FALSE)
+#endif
+
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 db_result_t storage_write_buffer_init(void);
 void storage_write_buffer_deinit(void);
@@ -83,6 +83,22 @@ struct index_record_s {
 	uint8_t type;
 };
 
+#ifdef CONFIG_ARASTORAGE_ENABLE_READ_BUFFER
+struct read_buffer_s {
+	char file_name[DB_MAX_FILENAME_LENGTH];	/* name of tuple file in buffer */
+	db_storage_id_t storage;	/* descriptor the rows were read from */
+	unsigned char *buffer;		/* scan buffer */
+	size_t row_length;			/* length of the buffered rows */
+	tuple_id_t first_row;		/* tuple id of the first buffered row */
+	tuple_id_t nrows;			/* number of rows in buffer */
+};
+
+/****************************************************************************
+* Private Variables
+****************************************************************************/
+static struct read_buffer_s g_storage_read_buffer;
+#endif
+
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
@@ -130,6 +146,83 @@ void storage_write_buffer_deinit()
 	}
 }
 #endif
+
+#ifdef CONFIG_ARASTORAGE_ENABLE_READ_BUFFER
+/****************************************************************************
+ * Name: storage_read_buffer_clean
+ *
+ * Desciption: Drop the rows held in the scan buffer. This must be called
+ *   whenever a tuple file is created, truncated or removed, since a new
+ *   file may reuse the name of the buffered one. Writes to the buffered
+ *   file drop it through storage_read_buffer_invalidate().
+ *
+ ****************************************************************************/
+void storage_read_buffer_clean(void)
+{
+	memset(g_storage_read_buffer.file_name, 0, sizeof(g_storage_read_buffer.file_name));
+	g_storage_read_buffer.storage = -1;
+	g_storage_read_buffer.row_length = 0;
+	g_storage_read_buffer.first_row = 0;
+	g_storage_read_buffer.nrows = 0;
+}
+
+/****************************************************************************
+ * Name: storage_read_buffer_invalidate
+ *
+ * Desciption: Drop the scan buffer if it holds rows of the tuple file which
+ *   is about to be written, either by name or by descriptor.
+ *
+ ****************************************************************************/
+static void storage_read_buffer_invalidate(const char *filename, db_storage_id_t fd)
+{
+	if (g_storage_read_buffer.nrows == 0) {
+		return;
+	}
+	if ((filename != NULL && strncmp(g_storage_read_buffer.file_name, filename, DB_MAX_FILENAME_LENGTH) == 0) || (fd >= 0 && fd == g_storage_read_buffer.storage)) {
+		storage_read_buffer_clean();
+	}
+}
+
+db_result_t storage_read_buffer_init(void)
+{
+	if (g_storage_read_buffer.buffer == NULL) {
+		g_storage_read_buffer.buffer = (unsigned char *)malloc(CONFIG_ARASTORAGE_READ_BUFFER_SIZE * sizeof(unsigned char));
+	}
+	if (g_storage_read_buffer.buffer == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	storage_read_buffer_clean();
+	return DB_OK;
+}
+
+void storage_read_buffer_deinit(void)
+{
+	if (g_storage_read_buffer.buffer != NULL) {
+		free(g_storage_read_buffer.buffer);
+		g_storage_read_buffer.buffer = NULL;
+	}
+	storage_read_buffer_clean();
+}
+
+/****************************************************************************
+ * Name: storage_row_buffered
+ *
+ * Desciption: Check whether a row of the relation can be served from the
+ *   scan buffer without touching the tuple file.
+ *
+ ****************************************************************************/
+int storage_row_buffered(relation_t *rel, tuple_id_t tuple_id)
+{
+	if (g_storage_read_buffer.nrows == 0 || g_storage_read_buffer.row_length != rel->row_length) {
+		return FALSE;
+	}
+	if (tuple_id < g_storage_read_buffer.first_row || tuple_id >= g_storage_read_buffer.first_row + g_storage_read_buffer.nrows) {
+		return FALSE;
+	}
+	return strncmp(g_storage_read_buffer.file_name, rel->tuple_filename, DB_MAX_FILENAME_LENGTH) == 0;
+}
+#endif
+
 db_result_t storage_generate_file(char *filename)
 {
 	int fd;
@@ -139,6 +232,7 @@ db_result_t storage_generate_file(char *filename)
 		return DB_STORAGE_ERROR;
 	}
 	storage_close(fd);
+	storage_read_buffer_clean();
 	return DB_OK;
 }
 
@@ -292,6 +386,7 @@ db_result_t storage_drop_relation(relation_t *rel, int remove_tuples)
 	DB_LOG_D("Unlink rel = %s, tuple = %s\n", rel->name, rel->tuple_filename);
 	if (remove_tuples && RELATION_HAS_TUPLES(rel)) {
 		storage_close(rel->tuple_storage);
+		storage_read_buffer_clean();
 		if (DB_ERROR(storage_remove(rel->tuple_filename))) {
 			DB_LOG_D("Failed to remove tuple file : %s\n", rel->tuple_filename);
 			return DB_STORAGE_ERROR;
@@ -500,6 +595,15 @@ db_result_t storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t
 {
 	ssize_t r;
 	tuple_id_t nrows;
+	unsigned char *dest;
+	unsigned length;
+
+#ifdef CONFIG_ARASTORAGE_ENABLE_READ_BUFFER
+	if (storage_row_buffered(rel, *tuple_id)) {
+		memcpy(row, g_storage_read_buffer.buffer + (*tuple_id - g_storage_read_buffer.first_row) * rel->row_length, rel->row_length);
+		return DB_OK;
+	}
+#endif
 
 	if (DB_ERROR(storage_get_row_amount(rel, &nrows))) {
 		return DB_STORAGE_ERROR;
@@ -510,12 +614,29 @@ db_result_t storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t
 		return DB_FINISHED;
 	}
 
+	dest = row;
+	length = rel->row_length;
+
+#ifdef CONFIG_ARASTORAGE_ENABLE_READ_BUFFER
+	/* Read ahead as many of the following rows as fit in the scan buffer,
+	   so that a sequential scan costs one seek and one read per batch. */
+	storage_read_buffer_clean();
+	if (g_storage_read_buffer.buffer != NULL && rel->row_length > 0 && rel->row_length <= CONFIG_ARASTORAGE_READ_BUFFER_SIZE) {
+		nrows -= *tuple_id;
+		if (nrows > CONFIG_ARASTORAGE_READ_BUFFER_SIZE / rel->row_length) {
+			nrows = CONFIG_ARASTORAGE_READ_BUFFER_SIZE / rel->row_length;
+		}
+		dest = g_storage_read_buffer.buffer;
+		length = nrows * rel->row_length;
+	}
+#endif
+
 	if (storage_seek(rel->tuple_storage, *tuple_id * rel->row_length, SEEK_SET) == (off_t)-1) {
 		return DB_STORAGE_ERROR;
 	}
 
-	r = storage_read(rel->tuple_storage, row, rel->row_length);
-	DB_LOG_V("read row = %s, r = %d\n", row, r);
+	r = storage_read(rel->tuple_storage, dest, length);
+	DB_LOG_V("read row = %s, r = %d\n", dest, r);
 
 	if (r == 0) {
 		DB_LOG_E("%DB : read 0 bytes\n");
@@ -528,6 +649,19 @@ db_result_t storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t
 		return DB_STORAGE_ERROR;
 	}
 
+#ifdef CONFIG_ARASTORAGE_ENABLE_READ_BUFFER
+	if (dest != row) {
+		strncpy(g_storage_read_buffer.file_name, rel->tuple_filename, DB_MAX_FILENAME_LENGTH - 1);
+		g_storage_read_buffer.storage = rel->tuple_storage;
+		g_storage_read_buffer.row_length = rel->row_length;
+		g_storage_read_buffer.first_row = *tuple_id;
+		g_storage_read_buffer.nrows = r / rel->row_length;
+		memcpy(row, dest, rel->row_length);
+		DB_LOG_D("DB: Buffered %d rows from relation %s\n", g_storage_read_buffer.nrows, rel->name);
+		return DB_OK;
+	}
+#endif
+
 	DB_LOG_D("DB: Read %d bytes from relation %s\n", rel->row_length, rel->name);
 	return DB_OK;
 }
@@ -552,6 +686,9 @@ db_result_t storage_put_row(relation_t *rel, storage_row_t row, uint8_t flag)
 
 db_result_t storage_write_row(db_storage_id_t fd, storage_row_t row, unsigned length, char *filename)
 {
+#ifdef CONFIG_ARASTORAGE_ENABLE_READ_BUFFER
+	storage_read_buffer_invalidate(filename, fd);
+#endif
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 	if (strncmp(g_storage_write_buffer.file_name, filename, TUPLE_NAME_LENGTH) != 0) {
 		storage_flush_insert_buffer();
@@ -584,6 +721,9 @@ db_result_t storage_flush_insert_buffer()
 		return DB_OK;
 	}
 
+#ifdef CONFIG_ARASTORAGE_ENABLE_READ_BUFFER
+	storage_read_buffer_invalidate(g_storage_write_buffer.file_name, -1);
+#endif
 	fd = storage_open(g_storage_write_buffer.file_name, O_APPEND | O_RDWR);
 	if (fd < 0) {
 		DB_LOG_D("Failed to open %s\n", g_storage_write_buffer.file_name);
@@ -636,6 +776,10 @@ db_result_t storage_write_to(db_storage_id_t fd, void *buffer, unsigned long off
 {
 	ssize_t r;
 
+#ifdef CONFIG_ARASTORAGE_ENABLE_READ_BUFFER
+	storage_read_buffer_invalidate(NULL, fd);
+#endif
+
 	if (storage_seek(fd, offset, SEEK_SET) == (off_t)-1) {
 		return DB_STORAGE_ERROR;
 	}
@@ -18,173 +18,269 @@
 /****************************************************************************
  * Included Files
  ****************************************************************************/
+#include <tinyara/config.h>
 #include <debug.h>
 #include <errno.h>
 #include <unistd.h>
 #include <signal.h>
 #include <queue.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include <semaphore.h>
 #include <libtuv/uv.h>
 #include <libtuv/uv__handle.h>
 #include <eventloop/eventloop.h>
 
 #include "eventloop_internal.h"
 
-struct timer_cb_s {
-	timeout_callback func;
-	void *cb_data;
-};
-typedef struct timer_cb_s timer_cb_t;
+#ifndef CONFIG_EVENTLOOP_TIMER_SLACK
+#define CONFIG_EVENTLOOP_TIMER_SLACK 0
+#endif
+
+/* The initial number of buckets of the timer table, it should be a power of 2.
+ * The table doubles whenever there are more than TIMER_TABLE_LOAD timers per bucket,
+ * so finding a timer takes constant time however many are registered.
+ */
+#define TIMER_TABLE_INIT_SIZE 16
+#define TIMER_TABLE_LOAD 2
 
-/* The structure for wrapping of timer handle to be kept in a list internally. */
+/* Bucket of a timer handle, the low bits are always zero for allocated memory */
+#define TIMER_TABLE_INDEX(t, size) ((((uintptr_t)(t)) >> 3) & ((size) - 1))
+
+/* The structure for wrapping of timer handle to be kept in the timer table internally.
+ * The timer handle and its callback are allocated together.
+ * Ordering and dispatch of timers are done by the min-heap of libtuv loop,
+ * which runs all expired timers in one pass per iteration of the loop.
+ */
 struct timer_node_s {
 	struct timer_node_s *flink;
-	el_timer_t *timer;
+	el_timer_t timer;
+	timeout_callback func;
+	void *cb_data;
+	unsigned int interval;   /* Repeat interval in msec, 0 for one-shot timer */
 };
 typedef struct timer_node_s timer_node_t;
 
-sq_queue_t g_timer_list;  // list node type : timer_node_t
+/* Registered timers hashed by the address of their handle.
+ * The table is allocated with the first timer and is never freed.
+ */
+static sq_queue_t *g_timer_table;
+static unsigned int g_timer_table_size;
+static unsigned int g_timer_count;
+static sem_t g_timer_sem = SEM_INITIALIZER(1);
 
-static bool is_registered_timer(el_timer_t *timer)
+static void timer_table_lock(void)
 {
-	timer_node_t *node_ptr;
+	while (sem_wait(&g_timer_sem) != OK) {
+		if (errno != EINTR) {
+			break;
+		}
+	}
+}
 
-	if (timer == NULL) {
-		return false;
+static void timer_table_unlock(void)
+{
+	sem_post(&g_timer_sem);
+}
+
+/* Find the node of a timer handle. It must be called with the table locked.
+ * The handle is only compared, never dereferenced, because it may be stale.
+ */
+static timer_node_t *find_timer_node(el_timer_t *timer)
+{
+	timer_node_t *node;
+
+	if (g_timer_table == NULL) {
+		return NULL;
 	}
 
-	node_ptr = (timer_node_t *)sq_peek(&g_timer_list);
-	while (node_ptr != NULL && node_ptr->timer != NULL) {
-		if (node_ptr->timer == timer) {
-			return true;
+	node = (timer_node_t *)sq_peek(&g_timer_table[TIMER_TABLE_INDEX(timer, g_timer_table_size)]);
+	while (node != NULL) {
+		if (&node->timer == timer) {
+			return node;
 		}
-		node_ptr = (timer_node_t *)sq_next(node_ptr);
+		node = (timer_node_t *)sq_next(node);
 	}
 
-	return false;
+	return NULL;
 }
 
-static int eventloop_register_timer(el_timer_t *timer)
+/* Rehash all timers into a table of 'size' buckets. It must be called with the table locked.
+ * If the allocation fails, the current table is kept and only gets longer chains.
+ */
+static int resize_timer_table(unsigned int size)
 {
-	timer_node_t *timer_node;
+	sq_queue_t *table;
+	timer_node_t *node;
+	unsigned int i;
 
-	if (timer == NULL) {
-		eldbg("Invalid Parameter\n");
+	table = (sq_queue_t *)EL_ALLOC(sizeof(sq_queue_t) * size);
+	if (table == NULL) {
 		return ERROR;
 	}
+	for (i = 0; i < size; i++) {
+		sq_init(&table[i]);
+	}
 
-	timer_node = (timer_node_t *)EL_ALLOC(sizeof(timer_node_t));
-	if (timer_node == NULL) {
-		eldbg("Failed to allocate timer node\n");
-		return ERROR;
+	for (i = 0; i < g_timer_table_size; i++) {
+		while ((node = (timer_node_t *)sq_remfirst(&g_timer_table[i])) != NULL) {
+			sq_addlast((FAR sq_entry_t *)node, &table[TIMER_TABLE_INDEX(&node->timer, size)]);
+		}
+	}
+
+	EL_FREE(g_timer_table);
+	g_timer_table = table;
+	g_timer_table_size = size;
+
+	return OK;
+}
+
+/* Register a timer node. It must be called with the table locked. */
+static int insert_timer_node(timer_node_t *node)
+{
+	if (g_timer_table == NULL) {
+		if (resize_timer_table(TIMER_TABLE_INIT_SIZE) != OK) {
+			return ERROR;
+		}
+	} else if (g_timer_count >= g_timer_table_size * TIMER_TABLE_LOAD) {
+		(void)resize_timer_table(g_timer_table_size * 2);
 	}
-	timer_node->flink = NULL;
-	timer_node->timer = timer;
-	sq_addlast((FAR sq_entry_t *)timer_node, &g_timer_list);
+
+	sq_addlast((FAR sq_entry_t *)node, &g_timer_table[TIMER_TABLE_INDEX(&node->timer, g_timer_table_size)]);
+	g_timer_count++;
 
 	return OK;
 }
 
+static bool is_registered_timer(el_timer_t *timer)
+{
+	bool ret;
+
+	if (timer == NULL) {
+		return false;
+	}
+
+	timer_table_lock();
+	ret = (find_timer_node(timer) != NULL);
+	timer_table_unlock();
+
+	return ret;
+}
+
+/* Get the timeout to the coalesced deadline.
+ * The expiration time is rounded up to a multiple of CONFIG_EVENTLOOP_TIMER_SLACK,
+ * so timers expiring within the same window share a deadline and are dispatched
+ * together in one iteration of the loop with one wakeup.
+ */
+static unsigned int timer_coalesce(el_loop_t *loop, unsigned int timeout)
+{
+	uint64_t now = uv_now(loop);
+	uint64_t expire = now + timeout;
+
+#if CONFIG_EVENTLOOP_TIMER_SLACK > 0
+	expire = ((expire + CONFIG_EVENTLOOP_TIMER_SLACK - 1) / CONFIG_EVENTLOOP_TIMER_SLACK) * CONFIG_EVENTLOOP_TIMER_SLACK;
+#endif
+
+	return (unsigned int)(expire - now);
+}
+
 void eventloop_unregister_timer(el_timer_t *timer)
 {
-	timer_node_t *ptr;
-	timer_cb_t *callback = NULL;
+	timer_node_t *node;
 
-	if (timer == NULL || timer->data == NULL) {
+	if (timer == NULL) {
 		return;
 	}
 
-	callback = (timer_cb_t *)timer->data;
-
-	ptr = (timer_node_t *)sq_peek(&g_timer_list);
-	while (ptr != NULL && ptr->timer != NULL) {
-		if (ptr->timer == timer) {
-			sq_rem((FAR sq_entry_t *)ptr, &g_timer_list);
-			EL_FREE(callback);
-			EL_FREE(timer);
-			EL_FREE(ptr);
-			break;
-		}
-		ptr = (timer_node_t *)sq_next(ptr);
+	timer_table_lock();
+	node = find_timer_node(timer);
+	if (node == NULL) {
+		timer_table_unlock();
+		return;
 	}
+	sq_rem((FAR sq_entry_t *)node, &g_timer_table[TIMER_TABLE_INDEX(timer, g_timer_table_size)]);
+	g_timer_count--;
+	timer_table_unlock();
+
+	EL_FREE(node);
 }
 
 /* Eventloop calls this function when timeout.
  * It calls callback function registered by user, and frees the timer resource allocated for timeout once.
+ * All timers sharing a coalesced deadline are dispatched by libtuv in the same iteration of the loop.
  */
 static void timeout_callback_func(el_timer_t *timer)
 {
 	int ret;
-	timer_cb_t *callback = NULL;
+	unsigned int timeout;
+	timer_node_t *node;
 
 	if (timer == NULL || timer->data == NULL) {
 		eldbg("Invalid callback timer\n");
 		return;
 	}
 
-	callback = (timer_cb_t *)timer->data;
+	node = (timer_node_t *)timer->data;
 
 	elvdbg("[%d] timeout callback!!\n", getpid());
 
-	if (callback->func) {
-		ret = callback->func(callback->cb_data);
+	if (node->func) {
+		ret = node->func(node->cb_data);
 		/* It is true if eventloop_loop_stop is called in callback function. */
 		if (LOOP_IS_STOPPED(timer->loop)) {
 			return;
 		}
 		/* If callback function returns EVENTLOOP_CALLBACK_STOP, close and unregister the timer. */
-		if (!timer->repeat || ret == EVENTLOOP_CALLBACK_STOP) {
+		if (node->interval == 0 || ret == EVENTLOOP_CALLBACK_STOP) {
 			uv_close((uv_handle_t *)timer, (uv_close_cb)eventloop_unregister_timer);
 			return;
 		}
+		/* The timer could be deleted in callback function. */
+		if (uv__is_closing(timer)) {
+			return;
+		}
+		/* Re-arm the repeated timer on the coalesced deadline of the next period */
+		timeout = timer_coalesce(timer->loop, node->interval);
+		uv_timer_start(timer, (uv_timer_cb)timeout_callback_func, timeout, 0);
 	}
 }
 
 static el_timer_t *add_timer(el_loop_t *loop, unsigned int timeout, bool repeat, timeout_callback func, void *data)
 {
-	int ret;
-	el_timer_t *timer;
-	timer_cb_t *callback;
+	timer_node_t *node;
 
 	if (loop == NULL || func == NULL) {
 		return NULL;
 	}
 
-	timer = (el_timer_t *)EL_ALLOC(sizeof(el_timer_t));
-	if (timer == NULL) {
+	node = (timer_node_t *)EL_ALLOC(sizeof(timer_node_t));
+	if (node == NULL) {
 		eldbg("Failed to allocate timer\n");
 		return NULL;
 	}
-
-	callback = (timer_cb_t *)EL_ALLOC(sizeof(timer_cb_t));
-	if (callback == NULL) {
-		eldbg("Failed to allocate callback\n");
-		EL_FREE(timer);
-		return NULL;
-	}
-	callback->func = func;
-	callback->cb_data = data;
-	timer->data = (void *)callback;
-
-	ret = eventloop_register_timer(timer);
-	if (ret != OK) {
-		EL_FREE(callback);
-		EL_FREE(timer);
+	node->flink = NULL;
+	node->func = func;
+	node->cb_data = data;
+	node->interval = repeat ? timeout : 0;
+
+	timer_table_lock();
+	if (insert_timer_node(node) != OK) {
+		timer_table_unlock();
+		eldbg("Failed to allocate timer table\n");
+		EL_FREE(node);
 		return NULL;
 	}
+	timer_table_unlock();
 
 	uv_update_time(loop);
-	uv_timer_init(loop, timer);
+	uv_timer_init(loop, &node->timer);
+	node->timer.data = (void *)node;
+	timeout = timer_coalesce(loop, timeout);
 
-	if (!repeat) {
-		/* Add timer to be called once after timeout */
-		uv_timer_start(timer, (uv_timer_cb)timeout_callback_func, timeout, 0);
-	} else {
-		/* Add timer to be called every timeout repeatly */
-		uv_timer_start(timer, (uv_timer_cb)timeout_callback_func, timeout, timeout);
-	}
+	/* Repeated timer is re-armed on its coalesced deadline in timeout_callback_func */
+	uv_timer_start(&node->timer, (uv_timer_cb)timeout_callback_func, timeout, 0);
 
-	return timer;
+	return &node->timer;
 }
 
 el_timer_t *eventloop_add_timer(unsigned int timeout, bool repeat, timeout_callback func, void *data)
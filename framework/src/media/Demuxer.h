@@ -104,6 +104,18 @@ public:
 	 *         DEMUXER_ERROR_WANT_DATA means demuxer expect more input data.
 	 */
 	virtual ssize_t pullData(unsigned char *buf, size_t size, void *param = nullptr) = 0;
+	/**
+	 * @brief Pull audio elementary stream data from demuxer without copying
+	 *        Derived class should implement it
+	 * @param[out] buf: set to the elementary stream data inside demuxer.
+	 *             The data stay valid until the next pullData() or pullDataRef().
+	 * @param[in] size: maximum bytes of data wanted
+	 * @return number of bytes of data `buf` points to on success,
+	 *         it may be less than `size` at the end of a demuxed packet,
+	 *         negative value (see demuxer_error_t) on failure,
+	 *         DEMUXER_ERROR_WANT_DATA means demuxer expect more input data.
+	 */
+	virtual ssize_t pullDataRef(unsigned char **buf, size_t size, void *param = nullptr) = 0;
 	/**
 	 * @brief Get size in bytes that demuxer can accept equivalent input stream data surely
 	 *        Derived class should implement it
@@ -86,12 +86,29 @@ ssize_t InputHandler::read(unsigned char *buf, size_t size)
 
 void InputHandler::resetWorker()
 {
+	std::lock_guard<std::mutex> lock(mNotifyMutex);
 	mState = BUFFER_STATE_EMPTY;
 	mTotalBytes = 0;
 }
 
 bool InputHandler::processWorker()
 {
+	if (!mDemuxer && !mDecoder) {
+		// PCM goes to stream buffer as it is, read it from data source in place.
+		unsigned char *region;
+		size_t size = mBufferWriter->reserve(&region, mBufferWriter->sizeOfSpace());
+		if (size > 0) {
+			ssize_t readLen = mInputDataSource->read(region, size);
+			if (readLen <= 0) {
+				// Error occurred, or inputting finished
+				mBufferWriter->setEndOfStream();
+				return false;
+			}
+			mBufferWriter->commit((size_t)readLen);
+		}
+		return true;
+	}
+
 	size_t size = getAvailSpace();
 	if (size > 0) {
 		auto buf = new unsigned char[size];
@@ -144,6 +161,7 @@ void InputHandler::setBufferState(buffer_state_t state)
 
 void InputHandler::onBufferOverrun()
 {
+	std::lock_guard<std::mutex> lock(mNotifyMutex);
 	auto mp = getPlayer();
 	if (mp) {
 		mp->notifyObserver(PLAYER_OBSERVER_COMMAND_BUFFER_OVERRUN);
@@ -152,6 +170,7 @@ void InputHandler::onBufferOverrun()
 
 void InputHandler::onBufferUnderrun()
 {
+	std::lock_guard<std::mutex> lock(mNotifyMutex);
 	auto mp = getPlayer();
 	if (mp) {
 		mp->notifyObserver(PLAYER_OBSERVER_COMMAND_BUFFER_UNDERRUN);
@@ -165,6 +184,7 @@ void InputHandler::onBufferUpdated(ssize_t change, size_t current)
 		wakenWorker();
 	}
 
+	std::lock_guard<std::mutex> lock(mNotifyMutex);
 	if (current == 0) {
 		setBufferState(BUFFER_STATE_EMPTY);
 	} else if (current == mStreamBuffer->getBufferSize()) {
@@ -351,13 +371,11 @@ ssize_t InputHandler::getElementaryStream(unsigned char *buf, size_t size, size_
 		}
 
 		if (*out == nullptr) {
-			*out = buf;
-			if (*expect > *used) {
-				*expect = *used;
-			}
+			// Point to ES data inside demuxer, they are valid until next pull.
+			ret = mDemuxer->pullDataRef(out, *expect);
+		} else {
+			ret = mDemuxer->pullData(*out, *expect);
 		}
-
-		ret = mDemuxer->pullData(*out, *expect);
 		if (ret < 0) {
 			if (ret == DEMUXER_ERROR_WANT_DATA) {
 				// normal case: demuxer want more data
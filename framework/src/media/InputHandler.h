@@ -19,6 +19,7 @@
 #define __MEDIA_INPUTHANDLER_H
 
 #include <memory>
+#include <mutex>
 
 #include <sys/types.h>
 
@@ -48,8 +49,6 @@ public:
 
 	ssize_t read(unsigned char *buf, size_t size);
 
-	void setBufferState(buffer_state_t state);
-
 	virtual void onBufferOverrun() override;
 	virtual void onBufferUnderrun() override;
 	virtual void onBufferUpdated(ssize_t change, size_t current) override;
@@ -61,6 +60,8 @@ public:
 	ssize_t writeToStreamBuffer(unsigned char *buf, size_t size);
 
 private:
+	// Called with mNotifyMutex held
+	void setBufferState(buffer_state_t state);
 	bool registerCodec(audio_type_t audioType, unsigned int channels, unsigned int sampleRate) override;
 	void unregisterCodec() override;
 	size_t getDecodeFrames(unsigned char *buf, size_t *size);
@@ -78,6 +79,8 @@ private:
 	std::shared_ptr<Demuxer> mDemuxer;
 	std::weak_ptr<MediaPlayerImpl> mPlayer;
 
+	// Buffer callbacks come from both reader and writer side of a lock-free stream buffer
+	std::mutex mNotifyMutex;
 	buffer_state_t mState;
 	size_t mTotalBytes;
 };
@@ -102,6 +102,16 @@ bool MediaPlayer::isPlaying()
 	return mPMpImpl->isPlaying();
 }
 
+player_result_t MediaPlayer::setStreamGain(uint8_t gain)
+{
+	return mPMpImpl->setStreamGain(gain);
+}
+
+player_result_t MediaPlayer::setDucking(bool enable)
+{
+	return mPMpImpl->setDucking(enable);
+}
+
 MediaPlayer::~MediaPlayer()
 {
 }
@@ -23,6 +23,9 @@
 #include <debug.h>
 #include <errno.h>
 #include "audio/audio_manager.h"
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+#include "audio/audio_mixer.h"
+#endif
 
 namespace media {
 
@@ -35,6 +38,11 @@ MediaPlayerImpl::MediaPlayerImpl(MediaPlayer &player) : mPlayer(player)
 	mCurState = PLAYER_STATE_NONE;
 	mBuffer = nullptr;
 	mBufSize = 0;
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	mMixerStream = -1;
+	mStreamGain = PLAYER_MAX_STREAM_GAIN;
+	mDucking = false;
+#endif
 }
 
 player_result_t MediaPlayerImpl::create()
@@ -152,23 +160,11 @@ void MediaPlayerImpl::preparePlayer(player_result_t &ret)
 		return notifySync();
 	}
 
-	auto source = mInputHandler.getDataSource();
-	if (set_audio_stream_out(source->getChannels(), source->getSampleRate(),
-							 source->getPcmFormat()) != AUDIO_MANAGER_SUCCESS) {
-		meddbg("MediaPlayer prepare fail : set_audio_stream_out fail\n");
-		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
-		return notifySync();
-	}
-
-	mBufSize = get_user_output_frames_to_byte(get_output_frame_count());
-	if (mBufSize < 0) {
-		meddbg("MediaPlayer prepare fail : get_output_frames_byte_size fail\n");
-		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+	ret = openAudioStream();
+	if (ret != PLAYER_OK) {
 		return notifySync();
 	}
 
-	medvdbg("MediaPlayer mBuffer size : %d\n", mBufSize);
-
 	mBuffer = new unsigned char[mBufSize];
 	if (!mBuffer) {
 		meddbg("MediaPlayer prepare fail : mBuffer allocation fail\n");
@@ -220,6 +216,43 @@ void MediaPlayerImpl::prepareAsyncPlayer()
 	}
 }
 
+player_result_t MediaPlayerImpl::openAudioStream()
+{
+	auto source = mInputHandler.getDataSource();
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	mMixerStream = audio_mixer_open_stream(source->getChannels(), source->getSampleRate(), source->getPcmFormat());
+	if (mMixerStream < 0) {
+		meddbg("MediaPlayer prepare fail : audio_mixer_open_stream fail, ret : %d\n", mMixerStream);
+		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+	}
+
+	if ((audio_mixer_set_stream_gain(mMixerStream, mStreamGain) != AUDIO_MANAGER_SUCCESS) ||
+		(audio_mixer_set_stream_ducking(mMixerStream, mDucking) != AUDIO_MANAGER_SUCCESS)) {
+		meddbg("MediaPlayer prepare fail : mixer stream setup fail\n");
+		audio_mixer_close_stream(mMixerStream);
+		mMixerStream = -1;
+		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+	}
+
+	mBufSize = audio_mixer_get_stream_buffer_size(mMixerStream);
+#else
+	if (set_audio_stream_out(source->getChannels(), source->getSampleRate(),
+							 source->getPcmFormat()) != AUDIO_MANAGER_SUCCESS) {
+		meddbg("MediaPlayer prepare fail : set_audio_stream_out fail\n");
+		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+	}
+
+	mBufSize = get_user_output_frames_to_byte(get_output_frame_count());
+#endif
+	if (mBufSize <= 0) {
+		meddbg("MediaPlayer prepare fail : invalid buffer size %d\n", mBufSize);
+		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+	}
+
+	medvdbg("MediaPlayer mBuffer size : %d\n", mBufSize);
+	return PLAYER_OK;
+}
+
 player_result_t MediaPlayerImpl::unprepare()
 {
 	player_result_t ret = PLAYER_OK;
@@ -256,11 +289,23 @@ void MediaPlayerImpl::unpreparePlayer(player_result_t &ret)
 	}
 	mBufSize = 0;
 
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	PlayerWorker &mpw = PlayerWorker::getWorker();
+	mpw.removePlayer(shared_from_this());
+
+	if (audio_mixer_close_stream(mMixerStream) != AUDIO_MANAGER_SUCCESS) {
+		meddbg("MediaPlayer unprepare fail : audio_mixer_close_stream fail\n");
+		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+		return notifySync();
+	}
+	mMixerStream = -1;
+#else
 	if (reset_audio_stream_out() != AUDIO_MANAGER_SUCCESS) {
 		meddbg("MediaPlayer unprepare fail : reset_audio_stream_out fail\n");
 		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
 		return notifySync();
 	}
+#endif
 
 	mInputHandler.close();
 
@@ -296,6 +341,15 @@ void MediaPlayerImpl::startPlayer()
 		return;
 	}
 
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	/* Other players keep playing, the mixer adds this one to the output */
+	if (audio_mixer_start_stream(mMixerStream) != AUDIO_MANAGER_SUCCESS) {
+		meddbg("MediaPlayer startPlayer fail : audio_mixer_start_stream fail\n");
+		notifyObserver(PLAYER_OBSERVER_COMMAND_START_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
+		return;
+	}
+	mpw.addPlayer(shared_from_this());
+#else
 	if (mCurState == PLAYER_STATE_PAUSED) {
 		auto source = mInputHandler.getDataSource();
 		if (set_audio_stream_out(source->getChannels(), source->getSampleRate(),
@@ -315,6 +369,7 @@ void MediaPlayerImpl::startPlayer()
 		}
 		mpw.setPlayer(curPlayer);
 	}
+#endif
 
 	mCurState = PLAYER_STATE_PLAYING;
 	notifyObserver(PLAYER_OBSERVER_COMMAND_STARTED);
@@ -358,6 +413,16 @@ player_result_t MediaPlayerImpl::stopPlayback()
 	}
 
 	mCurState = PLAYER_STATE_READY;
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	mpw.removePlayer(shared_from_this());
+
+	/* The mixer plays out what is already queued */
+	audio_manager_result_t result = audio_mixer_stop_stream(mMixerStream);
+	if (result != AUDIO_MANAGER_SUCCESS) {
+		meddbg("audio_mixer_stop_stream failed ret : %d\n", result);
+		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+	}
+#else
 	mpw.setPlayer(nullptr);
 
 	audio_manager_result_t result = stop_audio_stream_out();
@@ -365,6 +430,7 @@ player_result_t MediaPlayerImpl::stopPlayback()
 		meddbg("stop_audio_stream_out failed ret : %d\n", result);
 		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
 	}
+#endif
 	
 	return PLAYER_OK;
 }
@@ -397,18 +463,26 @@ void MediaPlayerImpl::pausePlayer()
 		return;
 	}
 
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	audio_manager_result_t result = audio_mixer_pause_stream(mMixerStream);
+#else
 	audio_manager_result_t result = pause_audio_stream_out();
+#endif
 	if (result != AUDIO_MANAGER_SUCCESS) {
 		meddbg("pause_audio_stream_in failed ret : %d\n", result);
 		notifyObserver(PLAYER_OBSERVER_COMMAND_PAUSE_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
 		return;
 	}
 
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	mpw.removePlayer(shared_from_this());
+#else
 	auto prevPlayer = mpw.getPlayer();
 	auto curPlayer = shared_from_this();
 	if (prevPlayer == curPlayer) {
 		mpw.setPlayer(nullptr);
 	}
+#endif
 	mCurState = PLAYER_STATE_PAUSED;
 	notifyObserver(PLAYER_OBSERVER_COMMAND_PAUSED);
 }
@@ -524,6 +598,85 @@ void MediaPlayerImpl::setPlayerVolume(uint8_t vol, player_result_t &ret)
 	return notifySync();
 }
 
+player_result_t MediaPlayerImpl::setStreamGain(uint8_t gain)
+{
+	player_result_t ret = PLAYER_OK;
+
+	std::unique_lock<std::mutex> lock(mCmdMtx);
+	medvdbg("MediaPlayer setStreamGain\n");
+
+	if (gain > PLAYER_MAX_STREAM_GAIN) {
+		meddbg("The given argument is invalid.\n");
+		return PLAYER_ERROR_INVALID_PARAMETER;
+	}
+
+	PlayerWorker &mpw = PlayerWorker::getWorker();
+	if (!mpw.isAlive()) {
+		meddbg("PlayerWorker is not alive\n");
+		return PLAYER_ERROR_NOT_ALIVE;
+	}
+
+	mpw.enQueue(&MediaPlayerImpl::setPlayerStreamGain, shared_from_this(), gain, std::ref(ret));
+	mSyncCv.wait(lock);
+
+	return ret;
+}
+
+void MediaPlayerImpl::setPlayerStreamGain(uint8_t gain, player_result_t &ret)
+{
+	medvdbg("MediaPlayer Worker : setStreamGain %d\n", gain);
+
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	if ((mMixerStream >= 0) && (audio_mixer_set_stream_gain(mMixerStream, gain) != AUDIO_MANAGER_SUCCESS)) {
+		meddbg("audio_mixer_set_stream_gain failed gain : %d\n", gain);
+		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+		return notifySync();
+	}
+	mStreamGain = gain;
+#else
+	ret = PLAYER_ERROR_DEVICE_NOT_SUPPORTED;
+#endif
+
+	return notifySync();
+}
+
+player_result_t MediaPlayerImpl::setDucking(bool enable)
+{
+	player_result_t ret = PLAYER_OK;
+
+	std::unique_lock<std::mutex> lock(mCmdMtx);
+	medvdbg("MediaPlayer setDucking\n");
+
+	PlayerWorker &mpw = PlayerWorker::getWorker();
+	if (!mpw.isAlive()) {
+		meddbg("PlayerWorker is not alive\n");
+		return PLAYER_ERROR_NOT_ALIVE;
+	}
+
+	mpw.enQueue(&MediaPlayerImpl::setPlayerDucking, shared_from_this(), enable, std::ref(ret));
+	mSyncCv.wait(lock);
+
+	return ret;
+}
+
+void MediaPlayerImpl::setPlayerDucking(bool enable, player_result_t &ret)
+{
+	medvdbg("MediaPlayer Worker : setDucking %d\n", enable);
+
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	if ((mMixerStream >= 0) && (audio_mixer_set_stream_ducking(mMixerStream, enable) != AUDIO_MANAGER_SUCCESS)) {
+		meddbg("audio_mixer_set_stream_ducking failed\n");
+		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+		return notifySync();
+	}
+	mDucking = enable;
+#else
+	ret = PLAYER_ERROR_DEVICE_NOT_SUPPORTED;
+#endif
+
+	return notifySync();
+}
+
 player_result_t MediaPlayerImpl::setDataSource(std::unique_ptr<stream::InputDataSource> source)
 {
 	player_result_t ret = PLAYER_OK;
@@ -714,21 +867,11 @@ void MediaPlayerImpl::notifyAsync(player_event_t event)
 			return notifyObserver(PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED, PLAYER_ERROR_FILE_OPEN_FAILED);
 		}
 
-		auto source = mInputHandler.getDataSource();
-		if (set_audio_stream_out(source->getChannels(), source->getSampleRate(),
-								 source->getPcmFormat()) != AUDIO_MANAGER_SUCCESS) {
-			meddbg("MediaPlayer prepare fail : set_audio_stream_out fail\n");
-			return notifyObserver(PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
-		}
-
-		mBufSize = get_user_output_frames_to_byte(get_output_frame_count());
-		if (mBufSize < 0) {
-			meddbg("MediaPlayer prepare fail : get_user_output_frames_to_byte fail\n");
-			return notifyObserver(PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
+		player_result_t ret = openAudioStream();
+		if (ret != PLAYER_OK) {
+			return notifyObserver(PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED, ret);
 		}
 
-		medvdbg("MediaPlayer mBuffer size : %d\n", mBufSize);
-
 		mBuffer = new unsigned char[mBufSize];
 		if (!mBuffer) {
 			meddbg("MediaPlayer prepare fail : mBuffer allocation fail\n");
@@ -749,23 +892,44 @@ void MediaPlayerImpl::notifyAsync(player_event_t event)
 
 void MediaPlayerImpl::playback()
 {
-	ssize_t num_read = mInputHandler.read(mBuffer, (int)mBufSize);
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	/* Decode only when the mixer can take the whole buffer */
+	if (audio_mixer_get_stream_space(mMixerStream) < (unsigned int)mBufSize) {
+		return;
+	}
+#endif
+
+	unsigned char *buf = mBuffer;
+	int size = mBufSize;
+#if defined(CONFIG_AUDIO_STREAM_OUT_MMAP) && !defined(CONFIG_MEDIA_AUDIO_MIXER)
+	/* Read straight into the next driver period when no resampling is needed */
+	void *period = nullptr;
+	unsigned int frames = 0;
+	if (get_audio_stream_out_buffer(&period, &frames) == AUDIO_MANAGER_SUCCESS) {
+		buf = (unsigned char *)period;
+		size = (int)get_user_output_frames_to_byte(frames);
+	} else {
+		period = nullptr;
+	}
+#endif
+
+	ssize_t num_read = mInputHandler.read(buf, size);
 	medvdbg("num_read : %d\n", num_read);
 	if (num_read > 0) {
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+		int ret = audio_mixer_write_stream(mMixerStream, mBuffer, (unsigned int)num_read);
+#elif defined(CONFIG_AUDIO_STREAM_OUT_MMAP)
+		int ret;
+		if (period) {
+			ret = commit_audio_stream_out_buffer(get_user_output_bytes_to_frame((unsigned int)num_read));
+		} else {
+			ret = start_audio_stream_out(mBuffer, get_user_output_bytes_to_frame((unsigned int)num_read));
+		}
+#else
 		int ret = start_audio_stream_out(mBuffer, get_user_output_bytes_to_frame((unsigned int)num_read));
+#endif
 		if (ret < 0) {
-			notifyObserver(PLAYER_OBSERVER_COMMAND_PLAYBACK_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
-			PlayerWorker &mpw = PlayerWorker::getWorker();
-			switch (ret) {
-			case AUDIO_MANAGER_XRUN_STATE:
-				meddbg("AUDIO_MANAGER_XRUN_STATE\n");
-				mpw.enQueue(&MediaPlayerImpl::stopPlayer, shared_from_this(), PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
-				break;
-			default:
-				meddbg("audio manager error : %d\n", ret);
-				mpw.enQueue(&MediaPlayerImpl::stopPlayer, shared_from_this(), PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
-				break;
-			}
+			notifyPlaybackError(ret);
 		}
 	} else if (num_read == 0) {
 		player_result_t errcode = stopPlayback();
@@ -782,6 +946,22 @@ void MediaPlayerImpl::playback()
 	}
 }
 
+void MediaPlayerImpl::notifyPlaybackError(int ret)
+{
+	notifyObserver(PLAYER_OBSERVER_COMMAND_PLAYBACK_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
+	PlayerWorker &mpw = PlayerWorker::getWorker();
+	switch (ret) {
+	case AUDIO_MANAGER_XRUN_STATE:
+		meddbg("AUDIO_MANAGER_XRUN_STATE\n");
+		mpw.enQueue(&MediaPlayerImpl::stopPlayer, shared_from_this(), PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
+		break;
+	default:
+		meddbg("audio manager error : %d\n", ret);
+		mpw.enQueue(&MediaPlayerImpl::stopPlayer, shared_from_this(), PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
+		break;
+	}
+}
+
 MediaPlayerImpl::~MediaPlayerImpl()
 {
 	player_result_t ret;
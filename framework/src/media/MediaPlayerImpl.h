@@ -19,6 +19,7 @@
 #ifndef __MEDIA_MEDIAPLAYERIMPL_H
 #define __MEDIA_MEDIAPLAYERIMPL_H
 
+#include <tinyara/config.h>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -107,6 +108,9 @@ public:
 	player_result_t setDataSource(std::unique_ptr<stream::InputDataSource>);
 	player_result_t setObserver(std::shared_ptr<MediaPlayerObserverInterface>);
 
+	player_result_t setStreamGain(uint8_t gain);
+	player_result_t setDucking(bool enable);
+
 	player_state_t getState();
 	bool isPlaying();
 
@@ -114,6 +118,7 @@ public:
 	void notifyObserver(player_observer_command_t cmd, ...);
 	void notifyAsync(player_event_t event);
 	void playback();
+	void notifyPlaybackError(int ret);
 
 private:
 	void createPlayer(player_result_t &ret);
@@ -124,10 +129,13 @@ private:
 	void startPlayer();
 	void stopPlayer(player_result_t ret);
 	player_result_t stopPlayback();
+	player_result_t openAudioStream();
 	void pausePlayer();
 	void getPlayerVolume(uint8_t *vol, player_result_t &ret);
 	void getPlayerMaxVolume(uint8_t *vol, player_result_t &ret);
 	void setPlayerVolume(uint8_t vol, player_result_t &ret);
+	void setPlayerStreamGain(uint8_t gain, player_result_t &ret);
+	void setPlayerDucking(bool enable, player_result_t &ret);
 	void setPlayerObserver(std::shared_ptr<MediaPlayerObserverInterface> observer);
 	void setPlayerDataSource(std::shared_ptr<stream::InputDataSource> dataSource, player_result_t &ret);
 
@@ -136,6 +144,11 @@ private:
 	std::atomic<player_state_t> mCurState;
 	unsigned char *mBuffer;
 	int mBufSize;
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	int mMixerStream;
+	uint8_t mStreamGain;
+	bool mDucking;
+#endif
 	std::mutex mCmdMtx;
 	std::condition_variable mSyncCv;
 	std::shared_ptr<stream_info_t> mStreamInfo;
@@ -97,6 +97,16 @@ recorder_result_t MediaRecorder::setFileSize(int byte)
 	return mPMrImpl->setFileSize(byte);
 }
 
+recorder_result_t MediaRecorder::addPeriodListener(recorder_period_listener_t listener)
+{
+	return mPMrImpl->addPeriodListener(listener);
+}
+
+recorder_result_t MediaRecorder::clearPeriodListeners()
+{
+	return mPMrImpl->clearPeriodListeners();
+}
+
 bool MediaRecorder::operator==(const MediaRecorder& rhs)
 {
 	return this->mId == rhs.mId;
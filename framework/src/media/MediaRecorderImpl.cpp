@@ -656,6 +656,58 @@ void MediaRecorderImpl::setRecorderFileSize(int byte, recorder_result_t& ret)
 	notifySync();
 }
 
+recorder_result_t MediaRecorderImpl::addPeriodListener(recorder_period_listener_t listener)
+{
+	std::unique_lock<std::mutex> lock(mCmdMtx);
+	medvdbg("MediaRecorderImpl::addPeriodListener()\n");
+	RecorderWorker& mrw = RecorderWorker::getWorker();
+	if (!mrw.isAlive()) {
+		meddbg("Worker is not alive\n");
+		return RECORDER_ERROR_NOT_ALIVE;
+	}
+
+	if (!listener) {
+		meddbg("listener is empty\n");
+		return RECORDER_ERROR_INVALID_PARAM;
+	}
+
+	/* Listeners are only touched on the worker thread, capture() needs no lock to call them. */
+	mrw.enQueue(&MediaRecorderImpl::addRecorderPeriodListener, shared_from_this(), listener);
+	mSyncCv.wait(lock);
+
+	return RECORDER_OK;
+}
+
+void MediaRecorderImpl::addRecorderPeriodListener(recorder_period_listener_t listener)
+{
+	medvdbg("addRecorderPeriodListener\n");
+	mPeriodListeners.push_back(listener);
+	notifySync();
+}
+
+recorder_result_t MediaRecorderImpl::clearPeriodListeners()
+{
+	std::unique_lock<std::mutex> lock(mCmdMtx);
+	medvdbg("MediaRecorderImpl::clearPeriodListeners()\n");
+	RecorderWorker& mrw = RecorderWorker::getWorker();
+	if (!mrw.isAlive()) {
+		meddbg("Worker is not alive\n");
+		return RECORDER_ERROR_NOT_ALIVE;
+	}
+
+	mrw.enQueue(&MediaRecorderImpl::clearRecorderPeriodListeners, shared_from_this());
+	mSyncCv.wait(lock);
+
+	return RECORDER_OK;
+}
+
+void MediaRecorderImpl::clearRecorderPeriodListeners()
+{
+	medvdbg("clearRecorderPeriodListeners\n");
+	mPeriodListeners.clear();
+	notifySync();
+}
+
 void MediaRecorderImpl::capture()
 {
 	medvdbg("MediaRecorderImpl::capture()\n");
@@ -680,6 +732,10 @@ void MediaRecorderImpl::capture()
 		int ret = 0;
 		int size = get_user_input_frames_to_byte(frames);
 
+		for (auto &listener : mPeriodListeners) {
+			listener(mBuffer, size);
+		}
+
 		while (size > 0) {
 			int written = mOutputHandler.write(mBuffer + ret, size);
 			medvdbg("written : %d size : %d frames : %d\n", written, size, frames);
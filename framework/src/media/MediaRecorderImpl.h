@@ -23,6 +23,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <queue>
+#include <vector>
 #include <atomic>
 #include <functional>
 #include <iostream>
@@ -102,6 +103,8 @@ public:
 	bool isRecording();
 	recorder_result_t setDuration(int second);
 	recorder_result_t setFileSize(int byte);
+	recorder_result_t addPeriodListener(recorder_period_listener_t listener);
+	recorder_result_t clearPeriodListeners();
 	void notifySync();
 	void notifyObserver(recorder_observer_command_t cmd, ...);
 	void capture();
@@ -121,11 +124,14 @@ private:
 	void setRecorderDataSource(std::shared_ptr<stream::OutputDataSource> dataSource, recorder_result_t& ret);
 	void setRecorderDuration(int second, recorder_result_t& ret);
 	void setRecorderFileSize(int byte, recorder_result_t& ret);
+	void addRecorderPeriodListener(recorder_period_listener_t listener);
+	void clearRecorderPeriodListeners();
 
 private:
 	std::atomic<recorder_state_t> mCurState;
 	stream::OutputHandler mOutputHandler;
 	std::shared_ptr<MediaRecorderObserverInterface> mRecorderObserver;
+	std::vector<recorder_period_listener_t> mPeriodListeners;
 
 	MediaRecorder& mRecorder;
 	unsigned char* mBuffer;
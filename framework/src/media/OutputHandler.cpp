@@ -101,7 +101,9 @@ bool OutputHandler::stop()
 	medvdbg("OutputHandler::stop()\n");
 	flush();
 
-	return StreamHandler::stop();
+	bool ret = StreamHandler::stop();
+	std::vector<unsigned char>().swap(mWriteBuffer);
+	return ret;
 }
 
 void OutputHandler::flush()
@@ -126,11 +128,15 @@ void OutputHandler::resetWorker()
 
 void OutputHandler::writeToSource(size_t size)
 {
-	auto buf = new unsigned char[size];
+	/* Reused for every write, it never grows beyond the stream buffer size */
+	if (mWriteBuffer.size() < size) {
+		mWriteBuffer.resize(size);
+	}
+
+	auto buf = mWriteBuffer.data();
 	auto readed = mBufferReader->read(buf, size);
 	if (readed != size) {
 		meddbg("StreamBufferReader::read failed! size : %u, readed : %u\n", size, readed);
-		delete[] buf;
 		return;
 	}
 
@@ -140,8 +146,6 @@ void OutputHandler::writeToSource(size_t size)
 		meddbg("OutputDataSource::write returned <= 0! size : %u, written : %d\n", size, written);
 		mBufferWriter->setEndOfStream();
 	}
-
-	delete[] buf;
 }
 
 bool OutputHandler::processWorker()
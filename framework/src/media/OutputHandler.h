@@ -20,6 +20,7 @@
 
 #include <sys/types.h>
 #include <memory>
+#include <vector>
 #include <media/OutputDataSource.h>
 
 #include "StreamHandler.h"
@@ -56,6 +57,7 @@ private:
 	void writeToSource(size_t size);
 	std::shared_ptr<OutputDataSource> mOutputDataSource;
 	std::shared_ptr<Encoder> mEncoder;
+	std::vector<unsigned char> mWriteBuffer;
 
 	bool mIsFlushing;
 	std::mutex mFlushMutex;
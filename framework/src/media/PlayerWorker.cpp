@@ -21,6 +21,9 @@
 
 #include "PlayerWorker.h"
 #include "MediaPlayerImpl.h"
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+#include "audio/audio_mixer.h"
+#endif
 
 #ifndef CONFIG_MEDIA_PLAYER_STACKSIZE
 #define CONFIG_MEDIA_PLAYER_STACKSIZE 4096
@@ -47,12 +50,37 @@ PlayerWorker& PlayerWorker::getWorker()
 
 bool PlayerWorker::processLoop()
 {
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+	/* Every playing player queues a period, then one mixed period goes to the card.
+	 * Iterate over a copy, a player removes itself when it reaches the end of stream. */
+	bool playing = false;
+	auto players = mPlayers;
+	for (auto &player : players) {
+		if (player->getState() == PLAYER_STATE_PLAYING) {
+			player->playback();
+			playing = true;
+		}
+	}
+
+	int ret = audio_mixer_process();
+	if (ret < 0) {
+		meddbg("audio_mixer_process failed ret : %d\n", ret);
+		for (auto &player : players) {
+			if (player->getState() == PLAYER_STATE_PLAYING) {
+				player->notifyPlaybackError(ret);
+			}
+		}
+	}
+
+	return playing || ret > 0;
+#else
 	if (mCurPlayer && (mCurPlayer->getState() == PLAYER_STATE_PLAYING)) {
 		mCurPlayer->playback();
 		return true;
 	}
 
 	return false;
+#endif
 }
 
 void PlayerWorker::setPlayer(std::shared_ptr<MediaPlayerImpl> player)
@@ -65,4 +93,21 @@ std::shared_ptr<MediaPlayerImpl> PlayerWorker::getPlayer()
 	return mCurPlayer;
 }
 
+#ifdef CONFIG_MEDIA_AUDIO_MIXER
+void PlayerWorker::addPlayer(std::shared_ptr<MediaPlayerImpl> player)
+{
+	for (auto &p : mPlayers) {
+		if (p == player) {
+			return;
+		}
+	}
+	mPlayers.push_back(player);
+}
+
+void PlayerWorker::removePlayer(std::shared_ptr<MediaPlayerImpl> player)
+{
+	mPlayers.remove(player);
+}
+#endif
+
 } // namespace media
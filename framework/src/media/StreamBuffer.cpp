@@ -45,8 +45,8 @@
 namespace media {
 namespace stream {
 
-StreamBuffer::StreamBuffer(size_t bufferSize, size_t threshold)
-	: mObserver(nullptr), mEOS(false), mBufferSize(bufferSize), mThreshold(threshold)
+StreamBuffer::StreamBuffer(size_t bufferSize, size_t threshold, bool lockFree)
+	: mObserver(nullptr), mEOS(false), mBufferSize(bufferSize), mThreshold(threshold), mLockFree(lockFree), mReaderWant(0), mWriterWant(0)
 {
 	mRingBuf.buf = nullptr;
 	mRingBuf.depth = 0;
@@ -92,6 +92,16 @@ size_t StreamBuffer::write(unsigned char *buf, size_t size)
 	return rb_write(&mRingBuf, buf, size);
 }
 
+size_t StreamBuffer::reserve(unsigned char **buf, size_t size)
+{
+	return rb_reserve(&mRingBuf, (void **)buf, size);
+}
+
+size_t StreamBuffer::commit(size_t size)
+{
+	return rb_commit(&mRingBuf, size);
+}
+
 size_t StreamBuffer::sizeOfSpace()
 {
 	return rb_avail(&mRingBuf);
@@ -112,6 +122,46 @@ bool StreamBuffer::isEndOfStream()
 	return mEOS;
 }
 
+void StreamBuffer::waitForData(size_t size)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mReaderWant = size;
+	// Publish mReaderWant before checking data, pairs with the fence in wakeReader().
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	mCondv.wait(lock, [this, size] { return (sizeOfData() >= size) || mEOS; });
+	mReaderWant = 0;
+}
+
+void StreamBuffer::waitForSpace(size_t size)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mWriterWant = size;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	mCondv.wait(lock, [this, size] { return (sizeOfSpace() >= size) || mEOS; });
+	mWriterWant = 0;
+}
+
+void StreamBuffer::wakeReader()
+{
+	// Data were published before, now check if the reader is waiting for them.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	size_t want = mReaderWant;
+	if ((want != 0) && (sizeOfData() >= want)) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mCondv.notify_all();
+	}
+}
+
+void StreamBuffer::wakeWriter()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	size_t want = mWriterWant;
+	if ((want != 0) && (sizeOfSpace() >= want)) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mCondv.notify_all();
+	}
+}
+
 void StreamBuffer::setObserver(BufferObserverInterface *observer)
 {
 	mObserver = observer;
@@ -140,7 +190,7 @@ void StreamBuffer::notifyObserver(State st, ...)
 }
 
 StreamBuffer::Builder::Builder()
-	: mBufferSize(CONFIG_STREAM_BUFFER_SIZE_DEFAULT), mThreshold(CONFIG_STREAM_BUFFER_THRESHOLD_DEFAULT)
+	: mBufferSize(CONFIG_STREAM_BUFFER_SIZE_DEFAULT), mThreshold(CONFIG_STREAM_BUFFER_THRESHOLD_DEFAULT), mLockFree(false)
 {
 }
 
@@ -166,13 +216,19 @@ StreamBuffer::Builder &StreamBuffer::Builder::setThreshold(size_t threshold)
 	return *this;
 }
 
+StreamBuffer::Builder &StreamBuffer::Builder::setLockFree(bool lockFree)
+{
+	mLockFree = lockFree;
+	return *this;
+}
+
 std::shared_ptr<StreamBuffer> StreamBuffer::Builder::build()
 {
 	if (mThreshold > mBufferSize) {
 		mThreshold = mBufferSize;
 	}
 
-	auto instance = std::make_shared<StreamBuffer>(mBufferSize, mThreshold);
+	auto instance = std::make_shared<StreamBuffer>(mBufferSize, mThreshold, mLockFree);
 	if (instance->init(mBufferSize)) {
 		return instance;
 	}
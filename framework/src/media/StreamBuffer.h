@@ -20,6 +20,7 @@
 #define __MEDIA_STREAMBUFFER_H
 
 #include <memory>
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include "utils/rb.h"
@@ -38,14 +39,21 @@ public:
 		Builder();
 		Builder &setBufferSize(size_t bufferSize);
 		Builder &setThreshold(size_t threshold);
+		/**
+		 * Lock-free mode is for one reader thread and one writer thread.
+		 * Data go through without locking, a waiting side is only woken up
+		 * once the data (or space) it waits for crosses the threshold.
+		 */
+		Builder &setLockFree(bool lockFree);
 		std::shared_ptr<StreamBuffer> build();
 
 	private:
 		size_t mBufferSize;
 		size_t mThreshold;
+		bool mLockFree;
 	};
 
-	StreamBuffer(size_t bufferSize, size_t threshold);
+	StreamBuffer(size_t bufferSize, size_t threshold, bool lockFree = false);
 	virtual ~StreamBuffer();
 	/**
 	 * Initialize stream buffer with specific buffer size.
@@ -63,6 +71,7 @@ public:
 	void setObserver(BufferObserverInterface *observer);
 	std::mutex &getMutex() { return mMutex; }
 	std::condition_variable &getCondv() { return mCondv; }
+	bool isLockFree() { return mLockFree; }
 
 public:
 	enum class State {
@@ -87,6 +96,15 @@ public:
 	 * Write(push) data into stream buffer.
 	 */
 	size_t write(unsigned char *buf, size_t size);
+	/**
+	 * Get a contiguous region of free space to produce data in place.
+	 * Returns its size, which may be less than `size` at the end of the ring.
+	 */
+	size_t reserve(unsigned char **buf, size_t size);
+	/**
+	 * Make data produced in the region of reserve() readable.
+	 */
+	size_t commit(size_t size);
 	/**
 	 * Get bytes of data available in stream buffer.
 	 */
@@ -105,15 +123,38 @@ public:
 	bool isEndOfStream();
 	size_t getBufferSize() { return mBufferSize; }
 	size_t getThreshold() { return mThreshold; }
+	/**
+	 * Lock-free mode: block the reader until `size` bytes of data are
+	 * available or end of stream. `size` should not exceed the threshold.
+	 */
+	void waitForData(size_t size);
+	/**
+	 * Lock-free mode: block the writer until `size` bytes of space are
+	 * available or end of stream. `size` should not exceed the threshold.
+	 */
+	void waitForSpace(size_t size);
+	/**
+	 * Lock-free mode: wake up the reader if the data it waits for arrived.
+	 */
+	void wakeReader();
+	/**
+	 * Lock-free mode: wake up the writer if the space it waits for is free.
+	 */
+	void wakeWriter();
 
 private:
 	std::mutex mMutex;
 	std::condition_variable mCondv;
 	BufferObserverInterface *mObserver;
 	rb_t mRingBuf;
-	bool mEOS;
+	std::atomic<bool> mEOS;
 	size_t mBufferSize;
 	size_t mThreshold;
+	bool mLockFree;
+	// bytes of data the reader waits for, 0 if it's not waiting
+	std::atomic<size_t> mReaderWant;
+	// bytes of space the writer waits for, 0 if it's not waiting
+	std::atomic<size_t> mWriterWant;
 };
 
 } // namespace stream
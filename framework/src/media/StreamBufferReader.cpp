@@ -36,6 +36,10 @@ StreamBufferReader::StreamBufferReader(std::shared_ptr<StreamBuffer> stream)
 size_t StreamBufferReader::copy(unsigned char *buf, size_t size, size_t offset)
 {
 	medvdbg("offset %lu, size %lu\n", offset, size);
+	if (mStream->isLockFree()) {
+		return mStream->copy(buf, size, offset);
+	}
+
 	std::lock_guard<std::mutex> lock(mStream->getMutex());
 	size_t len = mStream->copy(buf, size, offset);
 	medvdbg("copied %lu\n", len);
@@ -45,6 +49,10 @@ size_t StreamBufferReader::copy(unsigned char *buf, size_t size, size_t offset)
 size_t StreamBufferReader::read(unsigned char *buf, size_t size, bool sync)
 {
 	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+	if (mStream->isLockFree()) {
+		return readLockFree(buf, size, sync);
+	}
+
 	std::unique_lock<std::mutex> lock(mStream->getMutex());
 
 	size_t rlen = 0;
@@ -86,14 +94,64 @@ size_t StreamBufferReader::read(unsigned char *buf, size_t size, bool sync)
 	return rlen;
 }
 
+size_t StreamBufferReader::readLockFree(unsigned char *buf, size_t size, bool sync)
+{
+	size_t rlen = 0;
+
+	while (rlen < size) {
+		// Read data from stream as much as possible
+		size_t temp = mStream->read(buf + rlen, size - rlen);
+		if (temp > 0) {
+			mStream->notifyObserver(StreamBuffer::State::UPDATED, -((ssize_t) temp));
+			// Writer may be waiting for more spaces.
+			mStream->wakeWriter();
+			rlen += temp;
+		}
+
+		if (!sync || rlen == size) {
+			break;
+		}
+
+		if (mStream->isEndOfStream()) {
+			// Data may be written just before EOS, read them out before leaving.
+			if (mStream->sizeOfData() == 0) {
+				medvdbg("EOS break\n");
+				break;
+			}
+			continue;
+		}
+
+		medvdbg("read %lu/%lu\n", rlen, size);
+		// Notify observer, shouldn't be blocked.
+		mStream->notifyObserver(StreamBuffer::State::UNDERRUN);
+		// Wait until the rest is available, or at least threshold bytes of it.
+		size_t want = size - rlen;
+		if (want > mStream->getThreshold()) {
+			want = mStream->getThreshold();
+		}
+		mStream->waitForData(want);
+	}
+
+	medvdbg("read %lu\n", rlen);
+	return rlen;
+}
+
 size_t StreamBufferReader::sizeOfData()
 {
+	if (mStream->isLockFree()) {
+		return mStream->sizeOfData();
+	}
+
 	std::lock_guard<std::mutex> lock(mStream->getMutex());
 	return mStream->sizeOfData();
 }
 
 bool StreamBufferReader::isEndOfStream()
 {
+	if (mStream->isLockFree()) {
+		return mStream->isEndOfStream();
+	}
+
 	std::lock_guard<std::mutex> lock(mStream->getMutex());
 	return mStream->isEndOfStream();
 }
@@ -38,6 +38,10 @@ public:
 public:
 	bool isEndOfStream();
 
+private:
+	// read in lock-free mode of the stream buffer
+	size_t readLockFree(unsigned char *buf, size_t size, bool sync);
+
 private:
 	std::shared_ptr<StreamBuffer> mStream;
 };
@@ -36,6 +36,10 @@ StreamBufferWriter::StreamBufferWriter(std::shared_ptr<StreamBuffer> stream)
 size_t StreamBufferWriter::write(unsigned char *buf, size_t size, bool sync)
 {
 	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+	if (mStream->isLockFree()) {
+		return writeLockFree(buf, size, sync);
+	}
+
 	std::unique_lock<std::mutex> lock(mStream->getMutex());
 
 	size_t wlen = 0;
@@ -76,12 +80,86 @@ size_t StreamBufferWriter::write(unsigned char *buf, size_t size, bool sync)
 	return wlen;
 }
 
+size_t StreamBufferWriter::writeLockFree(unsigned char *buf, size_t size, bool sync)
+{
+	size_t wlen = 0;
+
+	while (wlen < size) {
+		// Streaming may be stopped (EOS was set)
+		if (mStream->isEndOfStream()) {
+			// Don't need to write anymore
+			medvdbg("EOS break\n");
+			break;
+		}
+
+		// Write data into stream as much as possible
+		size_t temp = mStream->write(buf + wlen, size - wlen);
+		if (temp > 0) {
+			mStream->notifyObserver(StreamBuffer::State::UPDATED, (ssize_t) temp);
+			// Reader may be waiting for more data.
+			mStream->wakeReader();
+			wlen += temp;
+		}
+
+		if (!sync || wlen == size) {
+			break;
+		}
+
+		medvdbg("written %lu/%lu\n", wlen, size);
+		// There's not enough space
+		// Notify observer, shouldn't be blocked.
+		mStream->notifyObserver(StreamBuffer::State::OVERRUN);
+		// Wait until the rest fits, or at least threshold bytes of it.
+		size_t want = size - wlen;
+		if (want > mStream->getThreshold()) {
+			want = mStream->getThreshold();
+		}
+		mStream->waitForSpace(want);
+	}
+
+	medvdbg("written %lu\n", wlen);
+	return wlen;
+}
+
 size_t StreamBufferWriter::sizeOfSpace()
 {
+	if (mStream->isLockFree()) {
+		return mStream->sizeOfSpace();
+	}
+
 	std::lock_guard<std::mutex> lock(mStream->getMutex());
 	return mStream->sizeOfSpace();
 }
 
+size_t StreamBufferWriter::reserve(unsigned char **buf, size_t size)
+{
+	if (mStream->isLockFree()) {
+		return mStream->reserve(buf, size);
+	}
+
+	std::lock_guard<std::mutex> lock(mStream->getMutex());
+	return mStream->reserve(buf, size);
+}
+
+size_t StreamBufferWriter::commit(size_t size)
+{
+	size_t wlen;
+
+	if (mStream->isLockFree()) {
+		wlen = mStream->commit(size);
+		mStream->notifyObserver(StreamBuffer::State::UPDATED, (ssize_t) wlen);
+		mStream->wakeReader();
+		return wlen;
+	}
+
+	std::lock_guard<std::mutex> lock(mStream->getMutex());
+	wlen = mStream->commit(size);
+	mStream->notifyObserver(StreamBuffer::State::UPDATED, (ssize_t) wlen);
+	// Reader may be waiting for more data, so it's necessary to notify after writing.
+	mStream->getCondv().notify_one();
+	return wlen;
+}
+
 void StreamBufferWriter::setEndOfStream()
 {
 	std::lock_guard<std::mutex> lock(mStream->getMutex());
@@ -90,7 +168,8 @@ void StreamBufferWriter::setEndOfStream()
 	mStream->setEndOfStream();
 
 	// Reader may be waiting for more data, so it's necessary to notify.
-	mStream->getCondv().notify_one();
+	// In lock-free mode writer may be waiting for space as well.
+	mStream->getCondv().notify_all();
 }
 
 } // namespace stream
@@ -33,10 +33,24 @@ public:
 public:
 	virtual size_t write(unsigned char *buf, size_t size, bool sync = true);
 	virtual size_t sizeOfSpace();
+	/**
+	 * Get a contiguous free region in stream buffer, so that a data source can
+	 * read into it directly. Returns its size, 0 if stream buffer is full.
+	 * Only one region can be reserved at a time.
+	 */
+	virtual size_t reserve(unsigned char **buf, size_t size);
+	/**
+	 * Make `size` bytes produced in the reserved region readable.
+	 */
+	virtual size_t commit(size_t size);
 
 public:
 	void setEndOfStream();
 
+private:
+	// write in lock-free mode of the stream buffer
+	size_t writeLockFree(unsigned char *buf, size_t size, bool sync);
+
 private:
 	std::shared_ptr<StreamBuffer> mStream;
 };
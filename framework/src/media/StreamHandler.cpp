@@ -28,6 +28,13 @@
 #define CONFIG_HANDLER_STREAM_BUFFER_THRESHOLD 2048
 #endif
 
+// Handler's stream buffer has one writer and one reader thread
+#ifdef CONFIG_MEDIA_STREAM_BUFFER_LOCKFREE
+#define HANDLER_STREAM_BUFFER_LOCKFREE true
+#else
+#define HANDLER_STREAM_BUFFER_LOCKFREE false
+#endif
+
 namespace media {
 namespace stream {
 
@@ -49,6 +56,7 @@ bool StreamHandler::open()
 		auto streamBuffer = StreamBuffer::Builder()
 								.setBufferSize(CONFIG_HANDLER_STREAM_BUFFER_SIZE)
 								.setThreshold(CONFIG_HANDLER_STREAM_BUFFER_THRESHOLD)
+								.setLockFree(HANDLER_STREAM_BUFFER_LOCKFREE)
 								.build();
 
 		if (!streamBuffer) {
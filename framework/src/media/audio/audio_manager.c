@@ -51,6 +51,12 @@
 #define AUDIO_STREAM_BUFFER_SHORT_PERIOD 1024
 #define AUDIO_STREAM_BUFFER_LONG_PERIOD 2048
 
+#ifdef CONFIG_AUDIO_STREAM_OUT_MMAP
+#define AUDIO_STREAM_OUT_FLAGS (PCM_OUT | PCM_MMAP)
+#else
+#define AUDIO_STREAM_OUT_FLAGS PCM_OUT
+#endif
+
 #define AUDIO_STREAM_BUFFER_SHORT_PERIOD_COUNT 4
 #define AUDIO_STREAM_BUFFER_LONG_PERIOD_COUNT 8
 
@@ -72,6 +78,14 @@
 #define AUDIO_STREAM_VOICE_RECOGNITION_SAMPLE_RATE AUDIO_SAMP_RATE_16K
 #define AUDIO_STREAM_VOICE_RECOGNITION_CHANNEL AUDIO_STREAM_CHANNEL_STEREO
 
+#ifndef CONFIG_AUDIO_STREAM_IN_PERIOD_SIZE
+#define CONFIG_AUDIO_STREAM_IN_PERIOD_SIZE AUDIO_STREAM_VOICE_RECOGNITION_PERIOD_SIZE
+#endif
+
+#ifndef CONFIG_AUDIO_STREAM_IN_PERIOD_COUNT
+#define CONFIG_AUDIO_STREAM_IN_PERIOD_COUNT AUDIO_STREAM_VOICE_RECOGNITION_PERIOD_COUNT
+#endif
+
 #define AUDIO_STREAM_RETRY_COUNT 2
 
 #define AUDIO_DEVICE_MAX_VOLUME 10
@@ -128,7 +142,7 @@ struct audio_resample_s {
 	bool necessary;             // if resampling/rechanneling is needed (format-converting is not supported now)
 	void *buffer;               // pointer to the buffer used for resampling
 	uint32_t buffer_size;       // size in bytes of the buffer
-	uint32_t frames;            // number of frames in the buffer
+	uint32_t frames;            // number of frames in the buffer (or in the open period with mmap output)
 	float ratio;                // sample rate converting ratio
 	src_handle_t handle;        // handle of resampler
 	/* user provided/desired */
@@ -505,6 +519,116 @@ static unsigned int resample_stream_out(audio_card_info_t *card, void *data, uns
 	return resampled_frames;
 }
 
+#ifdef CONFIG_AUDIO_STREAM_OUT_MMAP
+/*
+ * Get the next period of the output pcm, waiting for the driver to return
+ * one if all of them are queued.
+ * area: Returns the start of the period.
+ * frames: Returns the size of the period in card frames.
+ * return: 0 on success, a negative errno from tinyalsa on failure.
+ */
+static int begin_stream_out_period(audio_card_info_t *card, void **area, unsigned int *frames)
+{
+	unsigned int offset;
+	int ret;
+
+	while (1) {
+		*frames = pcm_get_buffer_size(card->pcm);
+		ret = pcm_mmap_begin(card->pcm, area, &offset, frames);
+		if (ret < 0 || *frames > 0) {
+			return ret;
+		}
+		ret = pcm_wait(card->pcm, -1);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+}
+
+/*
+ * Queue the period got from begin_stream_out_period() with its first
+ * `frames` frames filled, and start the pcm if it is not running yet.
+ * return: 0 on success, a negative errno from tinyalsa on failure.
+ */
+static int commit_stream_out_period(audio_card_info_t *card, unsigned int frames)
+{
+	int ret;
+
+	ret = pcm_mmap_commit(card->pcm, 0, frames);
+	if (ret < 0) {
+		return ret;
+	}
+	return pcm_start(card->pcm);
+}
+
+/*
+ * Same as resample_stream_out(), but the generated frames are written into
+ * the periods of the output pcm. A period is queued once it is full, the
+ * one being filled stays open across calls and its fill level is kept in
+ * card->resample.frames.
+ * used_frames: In, the number of input frames already consumed by an earlier
+ *              call. Out, the number consumed so far, also on failure, so a
+ *              retry resumes there instead of queueing the periods again.
+ * return: On success, the number of frames generated. Otherwise, a negative
+ *         errno from tinyalsa or AUDIO_MANAGER_RESAMPLE_FAIL.
+ */
+static int resample_stream_out_mmap(audio_card_info_t *card, void *data, unsigned int frames, unsigned int *used_frames)
+{
+	unsigned int resampled_frames = 0;
+	unsigned int period_frames;
+	void *period;
+	src_data_t srcData = { 0, };
+	int src_ret;
+	int ret;
+
+	srcData.origin_channel_num = card->resample.user_channel;
+	srcData.origin_sample_rate = card->resample.user_sample_rate;
+	srcData.origin_sample_width = SAMPLE_WIDTH_16BITS; // TODO: support user format later
+	srcData.desired_channel_num = pcm_get_channels(card->pcm);
+	srcData.desired_sample_rate = pcm_get_rate(card->pcm);
+	srcData.desired_sample_width = SAMPLE_WIDTH_16BITS;
+
+	while (frames > *used_frames) {
+		ret = begin_stream_out_period(card, &period, &period_frames);
+		if (ret < 0) {
+			return ret;
+		}
+
+		srcData.data_in = (const void *)((char *)data + get_user_output_frames_to_byte(*used_frames));
+		srcData.input_frames = frames - *used_frames;
+		srcData.data_out = (void *)((char *)period + get_card_output_frames_to_byte(card->resample.frames));
+		srcData.out_buf_length = get_card_output_frames_to_byte(period_frames - card->resample.frames);
+
+		src_ret = src_simple(card->resample.handle, &srcData);
+		if (src_ret < 0) {
+			meddbg("Fail to resample in:%u/%u, error %d\n", *used_frames, frames, src_ret);
+			return AUDIO_MANAGER_RESAMPLE_FAIL;
+		}
+
+		*used_frames += srcData.input_frames_used;
+		if (srcData.output_frames_gen > 0) {
+			resampled_frames += srcData.output_frames_gen;
+			card->resample.frames += srcData.output_frames_gen;
+			if (card->resample.frames == period_frames) {
+				ret = commit_stream_out_period(card, period_frames);
+				if (ret < 0) {
+					/* The pcm is prepared again on an xrun, this period is gone */
+					card->resample.frames = 0;
+					return ret;
+				}
+				card->resample.frames = 0;
+			}
+		} else if (frames != *used_frames) {
+			meddbg("Error: output buffer is full, used input frames %d/%d\n", *used_frames, frames);
+			return AUDIO_MANAGER_RESAMPLE_FAIL;
+		}
+		medvdbg("%d frames generated from %d/%d\n", resampled_frames, *used_frames, frames);
+	}
+
+	return resampled_frames;
+}
+#endif
+
 static audio_manager_result_t get_audio_volume(audio_io_direction_t direct)
 {
 	audio_manager_result_t ret = AUDIO_MANAGER_SUCCESS;
@@ -682,8 +806,8 @@ audio_manager_result_t set_audio_stream_in(unsigned int channels, unsigned int s
 	memset(&config, 0, sizeof(struct pcm_config));
 	config.rate = get_closest_samprate(sample_rate, INPUT);
 	config.format = format;
-	config.period_size = AUDIO_STREAM_VOICE_RECOGNITION_PERIOD_SIZE;
-	config.period_count = AUDIO_STREAM_VOICE_RECOGNITION_PERIOD_COUNT;
+	config.period_size = CONFIG_AUDIO_STREAM_IN_PERIOD_SIZE;
+	config.period_count = CONFIG_AUDIO_STREAM_IN_PERIOD_COUNT;
 	config.channels = channel_num;
 	medvdbg("Device samplerate: %u, User requested: %u\n", config.rate, sample_rate);
 	medvdbg("Device channel: %u User requested: %u\n", config.channels, channels);
@@ -789,7 +913,7 @@ audio_manager_result_t set_audio_stream_out(unsigned int channels, unsigned int
 	config.channels = channel_num;
 	medvdbg("[OUT] Device samplerate: %u, User requested: %u\n", config.rate, sample_rate);
 	medvdbg("[OUT] Device channel: %u, User requested: %u\n", config.channels, channels);
-	card->pcm = pcm_open(g_actual_audio_out_card_id, card->device_id, PCM_OUT, &config);
+	card->pcm = pcm_open(g_actual_audio_out_card_id, card->device_id, AUDIO_STREAM_OUT_FLAGS, &config);
 
 	if (!pcm_is_ready(card->pcm)) {
 		meddbg("fail to pcm_is_ready() error : %s", pcm_get_error(card->pcm));
@@ -825,6 +949,9 @@ audio_manager_result_t set_audio_stream_out(unsigned int channels, unsigned int
 			}
 			medvdbg("resampling ratio %f, frames %u -> %d\n", card->resample.ratio, get_output_frame_count(), (int)resample_buffer_frames);
 		}
+		card->resample.frames = 0;
+#ifndef CONFIG_AUDIO_STREAM_OUT_MMAP
+		// With mmap output, resampled frames go straight into the pcm periods.
 		card->resample.buffer_size = get_card_output_frames_to_byte((int)resample_buffer_frames);
 		card->resample.buffer = malloc(card->resample.buffer_size);
 		if (!card->resample.buffer) {
@@ -835,6 +962,7 @@ audio_manager_result_t set_audio_stream_out(unsigned int channels, unsigned int
 			goto error_with_pcm;
 		}
 		medvdbg("resampling buffer 0x%x, buffer_size %u\n", card->resample.buffer, card->resample.buffer_size);
+#endif
 	}
 
 	card_config->status = AUDIO_CARD_READY;
@@ -936,6 +1064,9 @@ int start_audio_stream_out(void *data, unsigned int frames)
 {
 	int ret = 0;
 	int prepare_retry = AUDIO_STREAM_RETRY_COUNT;
+#ifdef CONFIG_AUDIO_STREAM_OUT_MMAP
+	unsigned int used_frames = 0;
+#endif
 	audio_card_info_t *card;
 	medvdbg("start_audio_stream_out(%u)\n", frames);
 
@@ -953,6 +1084,12 @@ int start_audio_stream_out(void *data, unsigned int frames)
 
 	pthread_mutex_lock(&(card->card_mutex));
 
+#ifdef CONFIG_AUDIO_STREAM_OUT_MMAP
+	// Resampling is done below, straight into the pcm periods.
+	if (card->resample.necessary && frames > get_output_frame_count()) {
+		frames = get_output_frame_count();
+	}
+#else
 	if (card->resample.necessary) {
 		if (frames > get_output_frame_count()) {
 			frames = get_output_frame_count();
@@ -967,6 +1104,7 @@ int start_audio_stream_out(void *data, unsigned int frames)
 		data = card->resample.buffer;
 		frames = card->resample.frames;
 	}
+#endif
 
 	if (card->config[card->device_id].status == AUDIO_CARD_PAUSE) {
 		ret = ioctl(pcm_get_file_descriptor(card->pcm), AUDIOIOC_RESUME, 0UL);
@@ -980,7 +1118,24 @@ int start_audio_stream_out(void *data, unsigned int frames)
 	card->config[card->device_id].status = AUDIO_CARD_RUNNING;
 
 	do {
+#ifdef CONFIG_AUDIO_STREAM_OUT_MMAP
+		if (card->resample.necessary) {
+			/* After an xrun this resumes at the first frame not yet queued */
+			ret = resample_stream_out_mmap(card, data, frames, &used_frames);
+			if (ret == AUDIO_MANAGER_RESAMPLE_FAIL) {
+				meddbg("Fail to resample!!\n");
+				goto error_with_lock;
+			}
+			if (ret == 0) {
+				/* Everything went into the period that is still open */
+				break;
+			}
+		} else {
+			ret = pcm_mmap_write(card->pcm, data, get_card_output_frames_to_byte(frames));
+		}
+#else
 		ret = pcm_writei(card->pcm, data, frames);
+#endif
 		if (ret < 0) {
 			if (ret == -EPIPE) {
 				if (prepare_retry > 0) {
@@ -1013,6 +1168,99 @@ error_with_lock:
 	return ret;
 }
 
+#ifdef CONFIG_AUDIO_STREAM_OUT_MMAP
+int get_audio_stream_out_buffer(void **data, unsigned int *frames)
+{
+	int ret;
+	int prepare_retry = AUDIO_STREAM_RETRY_COUNT;
+	audio_card_info_t *card;
+
+	if ((data == NULL) || (frames == NULL)) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	if (g_actual_audio_out_card_id < 0) {
+		meddbg("Found no active output audio card\n");
+		return AUDIO_MANAGER_NO_AVAIL_CARD;
+	}
+
+	card = &g_audio_out_cards[g_actual_audio_out_card_id];
+
+	if ((card->config[card->device_id].status == AUDIO_CARD_IDLE) || (card->config[card->device_id].status == AUDIO_CARD_NONE)) {
+		meddbg("Card status is wrong status : %d\n", card->config[card->device_id].status);
+		return AUDIO_MANAGER_INVALID_DEVICE;
+	}
+
+	if (card->resample.necessary) {
+		// Periods hold card frames, the user has to go through start_audio_stream_out().
+		return AUDIO_MANAGER_DEVICE_NOT_SUPPORT;
+	}
+
+	pthread_mutex_lock(&(card->card_mutex));
+
+	if (card->config[card->device_id].status == AUDIO_CARD_PAUSE) {
+		ret = ioctl(pcm_get_file_descriptor(card->pcm), AUDIOIOC_RESUME, 0UL);
+		if (ret < 0) {
+			meddbg("Fail to ioctl AUDIOIOC_RESUME, ret = %d\n", ret);
+			ret = AUDIO_MANAGER_DEVICE_FAIL;
+			goto error_with_lock;
+		}
+	}
+
+	card->config[card->device_id].status = AUDIO_CARD_RUNNING;
+
+	while ((ret = begin_stream_out_period(card, data, frames)) == -EPIPE) {
+		if (prepare_retry-- <= 0 || pcm_prepare(card->pcm) != OK) {
+			meddbg("Fail to recover from xrun\n");
+			ret = AUDIO_MANAGER_XRUN_STATE;
+			goto error_with_lock;
+		}
+	}
+	if (ret < 0) {
+		meddbg("Fail to get a pcm period, ret = %d\n", ret);
+		ret = AUDIO_MANAGER_OPERATION_FAIL;
+	}
+
+error_with_lock:
+	pthread_mutex_unlock(&(card->card_mutex));
+
+	return ret;
+}
+
+int commit_audio_stream_out_buffer(unsigned int frames)
+{
+	int ret;
+	audio_card_info_t *card;
+
+	if (g_actual_audio_out_card_id < 0) {
+		meddbg("Found no active output audio card\n");
+		return AUDIO_MANAGER_NO_AVAIL_CARD;
+	}
+
+	card = &g_audio_out_cards[g_actual_audio_out_card_id];
+
+	if (card->config[card->device_id].status != AUDIO_CARD_RUNNING) {
+		meddbg("Card status is wrong status : %d\n", card->config[card->device_id].status);
+		return AUDIO_MANAGER_INVALID_DEVICE;
+	}
+
+	if (frames == 0) {
+		// Nothing to play, the same period is returned by the next get.
+		return 0;
+	}
+
+	pthread_mutex_lock(&(card->card_mutex));
+	ret = commit_stream_out_period(card, frames);
+	pthread_mutex_unlock(&(card->card_mutex));
+
+	if (ret < 0) {
+		meddbg("Fail to queue a pcm period, ret = %d\n", ret);
+		return AUDIO_MANAGER_OPERATION_FAIL;
+	}
+	return frames;
+}
+#endif
+
 static audio_manager_result_t pause_audio_stream(audio_io_direction_t direct)
 {
 	audio_manager_result_t ret;
@@ -1107,6 +1355,16 @@ audio_manager_result_t stop_audio_stream_out(void)
 	}
 	pthread_mutex_lock(&(card->card_mutex));
 
+#ifdef CONFIG_AUDIO_STREAM_OUT_MMAP
+	// Queue the period the resampler was still filling, or throw it away.
+	if (card->resample.necessary && card->resample.frames > 0) {
+		if (card->config[card->device_id].status == AUDIO_CARD_RUNNING) {
+			commit_stream_out_period(card, card->resample.frames);
+		}
+		card->resample.frames = 0;
+	}
+#endif
+
 	if (card->config[card->device_id].status == AUDIO_CARD_PAUSE) {
 		if ((ret = pcm_drop(card->pcm)) < 0) {
 			meddbg("pcm_drop faled, ret = %d\n", ret);
@@ -1268,6 +1526,24 @@ unsigned int get_output_frame_count(void)
 	return pcm_get_buffer_size(g_audio_out_cards[g_actual_audio_out_card_id].pcm);
 }
 
+unsigned int get_card_output_channels(void)
+{
+	if (g_actual_audio_out_card_id < 0) {
+		return 0;
+	}
+
+	return pcm_get_channels(g_audio_out_cards[g_actual_audio_out_card_id].pcm);
+}
+
+unsigned int get_card_output_sample_rate(void)
+{
+	if (g_actual_audio_out_card_id < 0) {
+		return 0;
+	}
+
+	return pcm_get_rate(g_audio_out_cards[g_actual_audio_out_card_id].pcm);
+}
+
 unsigned int get_card_output_frames_to_byte(unsigned int frames)
 {
 	if ((g_actual_audio_out_card_id < 0) || (frames == 0)) {
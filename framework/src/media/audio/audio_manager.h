@@ -176,6 +176,42 @@ int start_audio_stream_in(void *data, unsigned int frames);
  ****************************************************************************/
 int start_audio_stream_out(void *data, unsigned int frames);
 
+#ifdef CONFIG_AUDIO_STREAM_OUT_MMAP
+/****************************************************************************
+ * Name: get_audio_stream_out_buffer
+ *
+ * Description:
+ *   Get the next period of the output device to be filled in place, waiting
+ *   for the device to return one if all of them are queued. Fill it and pass
+ *   the number of frames written to commit_audio_stream_out_buffer().
+ *   If the output audio device have been paused, resume it.
+ *   Not available while resampling, use start_audio_stream_out() instead.
+ *
+ * Input parameters:
+ *   data: returns the start of the period
+ *   frames: returns the size of the period in frames
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. AUDIO_MANAGER_DEVICE_NOT_SUPPORT if
+ *   the stream is resampled. Otherwise, a negative value.
+ ****************************************************************************/
+int get_audio_stream_out_buffer(void **data, unsigned int *frames);
+
+/****************************************************************************
+ * Name: commit_audio_stream_out_buffer
+ *
+ * Description:
+ *   Queue the period got from get_audio_stream_out_buffer() for playback.
+ *
+ * Input parameters:
+ *   frames: number of frames written from the start of the period
+ *
+ * Return Value:
+ *   On success, the number of frames queued. Otherwise, a negative value.
+ ****************************************************************************/
+int commit_audio_stream_out_buffer(unsigned int frames);
+#endif
+
 /****************************************************************************
  * Name: pause_audio_stream_in
  *
@@ -323,6 +359,30 @@ unsigned int get_user_input_bytes_to_frame(unsigned int bytes);
  ****************************************************************************/
 unsigned int get_output_frame_count(void);
 
+/****************************************************************************
+ * Name: get_card_output_channels
+ *
+ * Description:
+ *   Get the number of channels the active output audio device is opened
+ *   with, which may differ from the value requested in set_audio_stream_out().
+ *
+ * Return Value:
+ *   On success, the channel count of the output pcm. Otherwise, 0.
+ ****************************************************************************/
+unsigned int get_card_output_channels(void);
+
+/****************************************************************************
+ * Name: get_card_output_sample_rate
+ *
+ * Description:
+ *   Get the sample rate the active output audio device is opened with,
+ *   which may differ from the value requested in set_audio_stream_out().
+ *
+ * Return Value:
+ *   On success, the sample rate of the output pcm. Otherwise, 0.
+ ****************************************************************************/
+unsigned int get_card_output_sample_rate(void);
+
 /****************************************************************************
  * Name: get_card_output_frames_to_byte
  *
@@ -0,0 +1,682 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <debug.h>
+#include <pthread.h>
+#include <tinyalsa/tinyalsa.h>
+
+#include "audio_manager.h"
+#include "audio_mixer.h"
+#include "resample/samplerate.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#ifndef CONFIG_MEDIA_AUDIO_MIXER_STREAMS
+#define CONFIG_MEDIA_AUDIO_MIXER_STREAMS 4
+#endif
+
+#ifndef CONFIG_MEDIA_AUDIO_MIXER_SAMPLE_RATE
+#define CONFIG_MEDIA_AUDIO_MIXER_SAMPLE_RATE 44100
+#endif
+
+#ifndef CONFIG_MEDIA_AUDIO_MIXER_PERIOD_SIZE
+#define CONFIG_MEDIA_AUDIO_MIXER_PERIOD_SIZE 1024
+#endif
+
+#ifndef CONFIG_MEDIA_AUDIO_MIXER_DUCKING_GAIN
+#define CONFIG_MEDIA_AUDIO_MIXER_DUCKING_GAIN 25
+#endif
+
+#ifndef CONFIG_AUDIO_RESAMPLER_BUFSIZE
+#define CONFIG_AUDIO_RESAMPLER_BUFSIZE 4096
+#endif
+
+/* Format the card is asked for, the mixer then follows what the card gives */
+#define AUDIO_MIXER_DEFAULT_CHANNELS 2
+#define AUDIO_MIXER_CHANNELS (g_audio_mixer.channels)
+#define AUDIO_MIXER_SAMPLE_RATE (g_audio_mixer.sample_rate)
+#define AUDIO_MIXER_FRAME_BYTES (AUDIO_MIXER_CHANNELS * sizeof(int16_t))
+#define AUDIO_MIXER_PERIOD CONFIG_MEDIA_AUDIO_MIXER_PERIOD_SIZE
+
+/* A stream may queue this many periods ahead of the mixer */
+#define AUDIO_MIXER_QUEUE_PERIODS 3
+
+/* Extra frames the resampler may produce by rounding up */
+#define AUDIO_MIXER_SRC_SLACK 16
+
+/* Gains are Q15 fixed point, so a sample times a gain still fits in 32 bits */
+#define AUDIO_MIXER_GAIN_SHIFT 15
+#define AUDIO_MIXER_UNITY_GAIN (1 << AUDIO_MIXER_GAIN_SHIFT)
+#define AUDIO_MIXER_PERCENT_TO_GAIN(p) (((uint32_t)(p) * AUDIO_MIXER_UNITY_GAIN) / 100)
+#define AUDIO_MIXER_DUCKING_GAIN AUDIO_MIXER_PERCENT_TO_GAIN(CONFIG_MEDIA_AUDIO_MIXER_DUCKING_GAIN)
+
+#define AUDIO_MIXER_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+enum audio_mixer_stream_state_e {
+	AUDIO_MIXER_STREAM_NONE = 0,	// slot is free
+	AUDIO_MIXER_STREAM_IDLE,
+	AUDIO_MIXER_STREAM_RUNNING,
+	AUDIO_MIXER_STREAM_PAUSED,
+	AUDIO_MIXER_STREAM_DRAINING	// mixed until the queue is empty, then idle
+};
+
+struct audio_mixer_stream_s {
+	enum audio_mixer_stream_state_e state;
+	bool ducking;               // attenuate other streams while this one plays
+	uint32_t gain;              // Q15 gain applied before mixing
+	/* user provided */
+	uint32_t user_sample_rate;  // sample rate from a user
+	uint32_t user_channel;      // channel info from a user
+	uint8_t user_format;        // bytes per sample of user format
+	uint32_t period_frames;     // user frames matching one mixer period
+	/* conversion to the mixer format */
+	src_handle_t handle;        // NULL if the user format matches the mixer
+	int16_t *convert;           // resampler output for one user period
+	uint32_t convert_frames;    // capacity of convert in frames
+	/* frames waiting to be mixed */
+	int16_t *queue;
+	uint32_t queue_frames;      // capacity of queue in frames
+	uint32_t head;              // index of the next frame to mix
+	uint32_t count;             // number of frames queued
+};
+
+struct audio_mixer_s {
+	struct audio_mixer_stream_s streams[CONFIG_MEDIA_AUDIO_MIXER_STREAMS];
+	int nstreams;               // number of open streams
+	uint32_t channels;          // channels of the opened card
+	uint32_t sample_rate;       // sample rate of the opened card
+	bool card_running;          // a period was written since the card was opened or drained
+	int32_t *accum;             // wide accumulator for one period
+	int16_t *output;            // saturated period handed to the card
+	pthread_mutex_t mutex;      // protects the streams
+	pthread_mutex_t card_mutex; // protects the card and output, taken before mutex
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+static struct audio_mixer_s g_audio_mixer = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.card_mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static struct audio_mixer_stream_s *audio_mixer_get_stream(int id)
+{
+	if ((id < 0) || (id >= CONFIG_MEDIA_AUDIO_MIXER_STREAMS)) {
+		return NULL;
+	}
+
+	if (g_audio_mixer.streams[id].state == AUDIO_MIXER_STREAM_NONE) {
+		return NULL;
+	}
+
+	return &g_audio_mixer.streams[id];
+}
+
+static audio_manager_result_t audio_mixer_open_card(struct audio_mixer_s *mixer)
+{
+	audio_manager_result_t ret;
+	unsigned int channels;
+	unsigned int sample_rate;
+
+	ret = set_audio_stream_out(AUDIO_MIXER_DEFAULT_CHANNELS, CONFIG_MEDIA_AUDIO_MIXER_SAMPLE_RATE, PCM_FORMAT_S16_LE);
+	if (ret != AUDIO_MANAGER_SUCCESS) {
+		meddbg("set_audio_stream_out failed ret : %d\n", ret);
+		return ret;
+	}
+
+	/*
+	 * Mix in the format the card is actually opened with. Streams are
+	 * converted once on their way into the mixer, and the card does not
+	 * resample the mixed periods again.
+	 */
+	channels = get_card_output_channels();
+	sample_rate = get_card_output_sample_rate();
+	if ((channels == 0) || (sample_rate == 0)) {
+		meddbg("no output card format, channels : %u sample rate : %u\n", channels, sample_rate);
+		reset_audio_stream_out();
+		return AUDIO_MANAGER_CARD_NOT_READY;
+	}
+
+	if ((channels != AUDIO_MIXER_DEFAULT_CHANNELS) || (sample_rate != CONFIG_MEDIA_AUDIO_MIXER_SAMPLE_RATE)) {
+		medvdbg("card opened with %u ch %u Hz, mix in that format\n", channels, sample_rate);
+		reset_audio_stream_out();
+		ret = set_audio_stream_out(channels, sample_rate, PCM_FORMAT_S16_LE);
+		if (ret != AUDIO_MANAGER_SUCCESS) {
+			meddbg("set_audio_stream_out failed ret : %d\n", ret);
+			return ret;
+		}
+	}
+
+	mixer->channels = channels;
+	mixer->sample_rate = sample_rate;
+
+	mixer->accum = (int32_t *)malloc(AUDIO_MIXER_PERIOD * AUDIO_MIXER_CHANNELS * sizeof(int32_t));
+	mixer->output = (int16_t *)malloc(AUDIO_MIXER_PERIOD * AUDIO_MIXER_FRAME_BYTES);
+	if (!mixer->accum || !mixer->output) {
+		meddbg("malloc for the mixing buffers is failed\n");
+		free(mixer->accum);
+		free(mixer->output);
+		mixer->accum = NULL;
+		mixer->output = NULL;
+		reset_audio_stream_out();
+		return AUDIO_MANAGER_OPERATION_FAIL;
+	}
+
+	mixer->card_running = false;
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+static void audio_mixer_close_card(struct audio_mixer_s *mixer)
+{
+	if (mixer->card_running) {
+		stop_audio_stream_out();
+		mixer->card_running = false;
+	}
+	reset_audio_stream_out();
+
+	free(mixer->accum);
+	free(mixer->output);
+	mixer->accum = NULL;
+	mixer->output = NULL;
+}
+
+static void audio_mixer_free_stream(struct audio_mixer_stream_s *stream)
+{
+	if (stream->handle) {
+		src_destroy(stream->handle);
+	}
+	free(stream->convert);
+	free(stream->queue);
+	memset(stream, 0, sizeof(struct audio_mixer_stream_s));
+}
+
+/* Number of user frames which are sure to fit in the queue once converted */
+static uint32_t audio_mixer_stream_space(struct audio_mixer_stream_s *stream)
+{
+	uint32_t room = stream->queue_frames - stream->count;
+
+	if (room <= AUDIO_MIXER_SRC_SLACK) {
+		return 0;
+	}
+
+	return (uint32_t)(((uint64_t)(room - AUDIO_MIXER_SRC_SLACK) * stream->user_sample_rate) / AUDIO_MIXER_SAMPLE_RATE);
+}
+
+static int audio_mixer_convert(struct audio_mixer_stream_s *stream, const int16_t *data, uint32_t frames)
+{
+	uint32_t used_frames = 0;
+	uint32_t converted_frames = 0;
+	src_data_t srcData = { 0, };
+
+	srcData.origin_channel_num = stream->user_channel;
+	srcData.origin_sample_rate = stream->user_sample_rate;
+	srcData.origin_sample_width = SAMPLE_WIDTH_16BITS;
+	srcData.desired_channel_num = AUDIO_MIXER_CHANNELS;
+	srcData.desired_sample_rate = AUDIO_MIXER_SAMPLE_RATE;
+	srcData.desired_sample_width = SAMPLE_WIDTH_16BITS;
+
+	while (frames > used_frames) {
+		srcData.data_in = (const void *)(data + used_frames * stream->user_channel);
+		srcData.input_frames = frames - used_frames;
+		srcData.data_out = (void *)(stream->convert + converted_frames * AUDIO_MIXER_CHANNELS);
+		srcData.out_buf_length = (stream->convert_frames - converted_frames) * AUDIO_MIXER_FRAME_BYTES;
+
+		int src_ret = src_simple(stream->handle, &srcData);
+		if (src_ret < 0) {
+			meddbg("Fail to resample in:%u/%u, error %d\n", used_frames, frames, src_ret);
+			return AUDIO_MANAGER_RESAMPLE_FAIL;
+		}
+
+		used_frames += srcData.input_frames_used;
+		if (srcData.output_frames_gen > 0) {
+			converted_frames += srcData.output_frames_gen;
+		} else if (frames != used_frames) {
+			meddbg("Error: output buffer is full, used input frames %u/%u\n", used_frames, frames);
+			return AUDIO_MANAGER_RESAMPLE_FAIL;
+		}
+	}
+
+	return converted_frames;
+}
+
+static void audio_mixer_enqueue(struct audio_mixer_stream_s *stream, const int16_t *data, uint32_t frames)
+{
+	uint32_t tail;
+	uint32_t chunk;
+
+	if (frames > stream->queue_frames - stream->count) {
+		meddbg("mixer queue overflow, drop %u frames\n", frames - (stream->queue_frames - stream->count));
+		frames = stream->queue_frames - stream->count;
+	}
+
+	tail = (stream->head + stream->count) % stream->queue_frames;
+	chunk = AUDIO_MIXER_MIN(frames, stream->queue_frames - tail);
+	memcpy(stream->queue + tail * AUDIO_MIXER_CHANNELS, data, chunk * AUDIO_MIXER_FRAME_BYTES);
+	memcpy(stream->queue, data + chunk * AUDIO_MIXER_CHANNELS, (frames - chunk) * AUDIO_MIXER_FRAME_BYTES);
+	stream->count += frames;
+}
+
+static void audio_mixer_accumulate(int32_t *accum, const int16_t *samples, uint32_t nsamples, uint32_t gain)
+{
+	uint32_t i;
+
+	if (gain == AUDIO_MIXER_UNITY_GAIN) {
+		for (i = 0; i < nsamples; i++) {
+			accum[i] += samples[i];
+		}
+	} else if (gain != 0) {
+		for (i = 0; i < nsamples; i++) {
+			accum[i] += ((int32_t)samples[i] * (int32_t)gain) >> AUDIO_MIXER_GAIN_SHIFT;
+		}
+	}
+}
+
+static void audio_mixer_saturate(int16_t *output, const int32_t *accum, uint32_t nsamples)
+{
+	uint32_t i;
+	int32_t sample;
+
+	for (i = 0; i < nsamples; i++) {
+		sample = accum[i];
+		if (sample > INT16_MAX) {
+			sample = INT16_MAX;
+		} else if (sample < INT16_MIN) {
+			sample = INT16_MIN;
+		}
+		output[i] = (int16_t)sample;
+	}
+}
+
+static void audio_mixer_mix_stream(int32_t *accum, struct audio_mixer_stream_s *stream, uint32_t frames, uint32_t gain)
+{
+	uint32_t chunk = AUDIO_MIXER_MIN(frames, stream->queue_frames - stream->head);
+
+	audio_mixer_accumulate(accum, stream->queue + stream->head * AUDIO_MIXER_CHANNELS, chunk * AUDIO_MIXER_CHANNELS, gain);
+	audio_mixer_accumulate(accum + chunk * AUDIO_MIXER_CHANNELS, stream->queue, (frames - chunk) * AUDIO_MIXER_CHANNELS, gain);
+
+	stream->head = (stream->head + frames) % stream->queue_frames;
+	stream->count -= frames;
+}
+
+static bool audio_mixer_is_mixable(struct audio_mixer_stream_s *stream)
+{
+	return (stream->state == AUDIO_MIXER_STREAM_RUNNING) || (stream->state == AUDIO_MIXER_STREAM_DRAINING);
+}
+
+static audio_manager_result_t audio_mixer_set_stream_state(int id, enum audio_mixer_stream_state_e state)
+{
+	struct audio_mixer_stream_s *stream;
+
+	pthread_mutex_lock(&g_audio_mixer.mutex);
+	stream = audio_mixer_get_stream(id);
+	if (!stream) {
+		pthread_mutex_unlock(&g_audio_mixer.mutex);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	if ((state == AUDIO_MIXER_STREAM_DRAINING) && (stream->count == 0)) {
+		state = AUDIO_MIXER_STREAM_IDLE;
+	}
+	stream->state = state;
+	pthread_mutex_unlock(&g_audio_mixer.mutex);
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+int audio_mixer_open_stream(unsigned int channels, unsigned int sample_rate, int format)
+{
+	struct audio_mixer_s *mixer = &g_audio_mixer;
+	struct audio_mixer_stream_s *stream = NULL;
+	int ret;
+	int id;
+
+	if ((channels == 0) || (sample_rate == 0)) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	if (pcm_format_to_bits((enum pcm_format)format) != 16) {
+		meddbg("mixer supports 16 bit samples only, format : %d\n", format);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	pthread_mutex_lock(&mixer->card_mutex);
+	pthread_mutex_lock(&mixer->mutex);
+
+	for (id = 0; id < CONFIG_MEDIA_AUDIO_MIXER_STREAMS; id++) {
+		if (mixer->streams[id].state == AUDIO_MIXER_STREAM_NONE) {
+			stream = &mixer->streams[id];
+			break;
+		}
+	}
+
+	if (!stream) {
+		meddbg("All %d mixer streams are in use\n", CONFIG_MEDIA_AUDIO_MIXER_STREAMS);
+		pthread_mutex_unlock(&mixer->mutex);
+		pthread_mutex_unlock(&mixer->card_mutex);
+		return AUDIO_MANAGER_DEVICE_ALREADY_IN_USE;
+	}
+
+	if (mixer->nstreams == 0) {
+		ret = audio_mixer_open_card(mixer);
+		if (ret != AUDIO_MANAGER_SUCCESS) {
+			pthread_mutex_unlock(&mixer->mutex);
+			pthread_mutex_unlock(&mixer->card_mutex);
+			return ret;
+		}
+	}
+
+	stream->user_channel = channels;
+	stream->user_sample_rate = sample_rate;
+	stream->user_format = pcm_format_to_bits((enum pcm_format)format) >> 3;
+	stream->gain = AUDIO_MIXER_UNITY_GAIN;
+	stream->period_frames = (AUDIO_MIXER_PERIOD * sample_rate + AUDIO_MIXER_SAMPLE_RATE - 1) / AUDIO_MIXER_SAMPLE_RATE;
+	stream->queue_frames = AUDIO_MIXER_PERIOD * AUDIO_MIXER_QUEUE_PERIODS;
+	stream->queue = (int16_t *)malloc(stream->queue_frames * AUDIO_MIXER_FRAME_BYTES);
+	if (!stream->queue) {
+		meddbg("malloc for a mixer queue is failed\n");
+		ret = AUDIO_MANAGER_OPERATION_FAIL;
+		goto errout;
+	}
+
+	if ((channels != AUDIO_MIXER_CHANNELS) || (sample_rate != AUDIO_MIXER_SAMPLE_RATE)) {
+		stream->handle = src_init(CONFIG_AUDIO_RESAMPLER_BUFSIZE);
+		if (!stream->handle) {
+			meddbg("src_init failed\n");
+			ret = AUDIO_MANAGER_RESAMPLE_FAIL;
+			goto errout;
+		}
+
+		stream->convert_frames = AUDIO_MIXER_PERIOD + AUDIO_MIXER_SRC_SLACK;
+		stream->convert = (int16_t *)malloc(stream->convert_frames * AUDIO_MIXER_FRAME_BYTES);
+		if (!stream->convert) {
+			meddbg("malloc for a mixer resampling buffer is failed\n");
+			ret = AUDIO_MANAGER_RESAMPLE_FAIL;
+			goto errout;
+		}
+	}
+
+	stream->state = AUDIO_MIXER_STREAM_IDLE;
+	mixer->nstreams++;
+	medvdbg("mixer stream %d opened, %u ch %u Hz, %u frames per period\n", id, channels, sample_rate, stream->period_frames);
+
+	pthread_mutex_unlock(&mixer->mutex);
+	pthread_mutex_unlock(&mixer->card_mutex);
+	return id;
+
+errout:
+	audio_mixer_free_stream(stream);
+	if (mixer->nstreams == 0) {
+		audio_mixer_close_card(mixer);
+	}
+	pthread_mutex_unlock(&mixer->mutex);
+	pthread_mutex_unlock(&mixer->card_mutex);
+	return ret;
+}
+
+audio_manager_result_t audio_mixer_close_stream(int id)
+{
+	struct audio_mixer_s *mixer = &g_audio_mixer;
+	struct audio_mixer_stream_s *stream;
+
+	/* Waits for a period being written to the card */
+	pthread_mutex_lock(&mixer->card_mutex);
+	pthread_mutex_lock(&mixer->mutex);
+	stream = audio_mixer_get_stream(id);
+	if (!stream) {
+		pthread_mutex_unlock(&mixer->mutex);
+		pthread_mutex_unlock(&mixer->card_mutex);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	audio_mixer_free_stream(stream);
+	if (--mixer->nstreams == 0) {
+		audio_mixer_close_card(mixer);
+	}
+	medvdbg("mixer stream %d closed, %d streams left\n", id, mixer->nstreams);
+
+	pthread_mutex_unlock(&mixer->mutex);
+	pthread_mutex_unlock(&mixer->card_mutex);
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t audio_mixer_start_stream(int id)
+{
+	return audio_mixer_set_stream_state(id, AUDIO_MIXER_STREAM_RUNNING);
+}
+
+audio_manager_result_t audio_mixer_pause_stream(int id)
+{
+	return audio_mixer_set_stream_state(id, AUDIO_MIXER_STREAM_PAUSED);
+}
+
+audio_manager_result_t audio_mixer_stop_stream(int id)
+{
+	return audio_mixer_set_stream_state(id, AUDIO_MIXER_STREAM_DRAINING);
+}
+
+int audio_mixer_write_stream(int id, void *data, unsigned int bytes)
+{
+	struct audio_mixer_stream_s *stream;
+	uint32_t frame_bytes;
+	uint32_t frames;
+	uint32_t used_frames = 0;
+	uint32_t chunk;
+	const int16_t *in;
+	int ret;
+
+	if (!data) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	pthread_mutex_lock(&g_audio_mixer.mutex);
+	stream = audio_mixer_get_stream(id);
+	if (!stream) {
+		pthread_mutex_unlock(&g_audio_mixer.mutex);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	frame_bytes = stream->user_channel * stream->user_format;
+	frames = AUDIO_MIXER_MIN(bytes / frame_bytes, audio_mixer_stream_space(stream));
+
+	while (used_frames < frames) {
+		chunk = AUDIO_MIXER_MIN(frames - used_frames, stream->period_frames);
+		in = (const int16_t *)((uint8_t *)data + used_frames * frame_bytes);
+
+		if (stream->handle) {
+			ret = audio_mixer_convert(stream, in, chunk);
+			if (ret < 0) {
+				pthread_mutex_unlock(&g_audio_mixer.mutex);
+				return ret;
+			}
+			audio_mixer_enqueue(stream, stream->convert, (uint32_t)ret);
+		} else {
+			audio_mixer_enqueue(stream, in, chunk);
+		}
+		used_frames += chunk;
+	}
+
+	pthread_mutex_unlock(&g_audio_mixer.mutex);
+	return used_frames * frame_bytes;
+}
+
+unsigned int audio_mixer_get_stream_space(int id)
+{
+	struct audio_mixer_stream_s *stream;
+	unsigned int bytes = 0;
+
+	pthread_mutex_lock(&g_audio_mixer.mutex);
+	stream = audio_mixer_get_stream(id);
+	if (stream) {
+		bytes = audio_mixer_stream_space(stream) * stream->user_channel * stream->user_format;
+	}
+	pthread_mutex_unlock(&g_audio_mixer.mutex);
+
+	return bytes;
+}
+
+unsigned int audio_mixer_get_stream_buffer_size(int id)
+{
+	struct audio_mixer_stream_s *stream;
+	unsigned int bytes = 0;
+
+	pthread_mutex_lock(&g_audio_mixer.mutex);
+	stream = audio_mixer_get_stream(id);
+	if (stream) {
+		bytes = stream->period_frames * stream->user_channel * stream->user_format;
+	}
+	pthread_mutex_unlock(&g_audio_mixer.mutex);
+
+	return bytes;
+}
+
+audio_manager_result_t audio_mixer_set_stream_gain(int id, uint8_t gain)
+{
+	struct audio_mixer_stream_s *stream;
+
+	if (gain > 100) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	pthread_mutex_lock(&g_audio_mixer.mutex);
+	stream = audio_mixer_get_stream(id);
+	if (!stream) {
+		pthread_mutex_unlock(&g_audio_mixer.mutex);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+	stream->gain = AUDIO_MIXER_PERCENT_TO_GAIN(gain);
+	pthread_mutex_unlock(&g_audio_mixer.mutex);
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t audio_mixer_set_stream_ducking(int id, bool ducking)
+{
+	struct audio_mixer_stream_s *stream;
+
+	pthread_mutex_lock(&g_audio_mixer.mutex);
+	stream = audio_mixer_get_stream(id);
+	if (!stream) {
+		pthread_mutex_unlock(&g_audio_mixer.mutex);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+	stream->ducking = ducking;
+	pthread_mutex_unlock(&g_audio_mixer.mutex);
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+int audio_mixer_process(void)
+{
+	struct audio_mixer_s *mixer = &g_audio_mixer;
+	struct audio_mixer_stream_s *stream;
+	uint32_t mixed_frames = 0;
+	uint32_t frames;
+	uint32_t gain;
+	bool ducking = false;
+	int ret;
+	int id;
+
+	/*
+	 * The streams are locked only while a period is mixed into the output
+	 * buffer. Writing it to the card may block for a period, and players
+	 * keep queueing samples meanwhile. card_mutex keeps the card and the
+	 * output buffer from being closed under the write.
+	 */
+	pthread_mutex_lock(&mixer->card_mutex);
+	pthread_mutex_lock(&mixer->mutex);
+
+	if (mixer->nstreams == 0) {
+		pthread_mutex_unlock(&mixer->mutex);
+		pthread_mutex_unlock(&mixer->card_mutex);
+		return 0;
+	}
+
+	for (id = 0; id < CONFIG_MEDIA_AUDIO_MIXER_STREAMS; id++) {
+		stream = &mixer->streams[id];
+		if (audio_mixer_is_mixable(stream) && stream->ducking && (stream->count > 0)) {
+			ducking = true;
+			break;
+		}
+	}
+
+	memset(mixer->accum, 0, AUDIO_MIXER_PERIOD * AUDIO_MIXER_CHANNELS * sizeof(int32_t));
+
+	for (id = 0; id < CONFIG_MEDIA_AUDIO_MIXER_STREAMS; id++) {
+		stream = &mixer->streams[id];
+		if (!audio_mixer_is_mixable(stream)) {
+			continue;
+		}
+
+		/* A stream short of a full period is padded with silence */
+		frames = AUDIO_MIXER_MIN(stream->count, AUDIO_MIXER_PERIOD);
+		if (frames > 0) {
+			gain = stream->gain;
+			if (ducking && !stream->ducking) {
+				gain = (gain * AUDIO_MIXER_DUCKING_GAIN) >> AUDIO_MIXER_GAIN_SHIFT;
+			}
+			audio_mixer_mix_stream(mixer->accum, stream, frames, gain);
+			if (frames > mixed_frames) {
+				mixed_frames = frames;
+			}
+		}
+
+		if ((stream->state == AUDIO_MIXER_STREAM_DRAINING) && (stream->count == 0)) {
+			stream->state = AUDIO_MIXER_STREAM_IDLE;
+		}
+	}
+
+	if (mixed_frames > 0) {
+		audio_mixer_saturate(mixer->output, mixer->accum, mixed_frames * AUDIO_MIXER_CHANNELS);
+	}
+	pthread_mutex_unlock(&mixer->mutex);
+
+	if (mixed_frames == 0) {
+		/* Let the card play out what it has rather than feeding it silence */
+		if (mixer->card_running) {
+			stop_audio_stream_out();
+			mixer->card_running = false;
+		}
+		pthread_mutex_unlock(&mixer->card_mutex);
+		return 0;
+	}
+
+	ret = start_audio_stream_out(mixer->output, mixed_frames);
+	if (ret >= 0) {
+		mixer->card_running = true;
+	} else {
+		meddbg("start_audio_stream_out failed ret : %d\n", ret);
+	}
+
+	pthread_mutex_unlock(&mixer->card_mutex);
+	return ret;
+}
@@ -0,0 +1,189 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/**
+ * @file audio_mixer.h
+ * @brief Software mixing stage in front of the active output audio card.
+ */
+
+#ifndef __AUDIO_MIXER_H
+#define __AUDIO_MIXER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "audio_manager.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_open_stream
+ *
+ * Description:
+ *   Open a mixer stream. The output card is opened with the mixer format
+ *   when the first stream is opened. Samples written to the stream are
+ *   converted to the mixer rate and channels, then queued until they are
+ *   mixed by audio_mixer_process(). A new stream is idle until it is
+ *   started.
+ *
+ * Input parameters:
+ *   channels: number of channels of the stream
+ *   sample_rate: sample rate of the stream
+ *   format: pcm format of the stream, only 16 bit formats are supported
+ *
+ * Return Value:
+ *   On success, a stream id (>= 0). Otherwise a negative value.
+ ****************************************************************************/
+int audio_mixer_open_stream(unsigned int channels, unsigned int sample_rate, int format);
+
+/****************************************************************************
+ * Name: audio_mixer_close_stream
+ *
+ * Description:
+ *   Close a mixer stream and discard the samples it still queues. The
+ *   output card is closed with the last stream.
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_close_stream(int id);
+
+/****************************************************************************
+ * Name: audio_mixer_start_stream
+ *
+ * Description:
+ *   Mix the stream into the output from the next period on.
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_start_stream(int id);
+
+/****************************************************************************
+ * Name: audio_mixer_pause_stream
+ *
+ * Description:
+ *   Stop mixing the stream but keep its queued samples for a later start.
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_pause_stream(int id);
+
+/****************************************************************************
+ * Name: audio_mixer_stop_stream
+ *
+ * Description:
+ *   Play out the queued samples of the stream, then leave it idle.
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_stop_stream(int id);
+
+/****************************************************************************
+ * Name: audio_mixer_write_stream
+ *
+ * Description:
+ *   Convert the samples to the mixer format and queue them on the stream.
+ *   Only as many whole frames as audio_mixer_get_stream_space() reports are
+ *   taken, the write never blocks.
+ *
+ * Input parameters:
+ *   id: stream id
+ *   data: samples in the format the stream was opened with
+ *   bytes: size of data in bytes
+ *
+ * Return Value:
+ *   On success, the number of bytes taken. Otherwise a negative value.
+ ****************************************************************************/
+int audio_mixer_write_stream(int id, void *data, unsigned int bytes);
+
+/****************************************************************************
+ * Name: audio_mixer_get_stream_space
+ *
+ * Description:
+ *   Get how many bytes in the stream format can be written right now.
+ *
+ * Return Value:
+ *   Number of bytes, 0 if the stream queue is full or the id is invalid.
+ ****************************************************************************/
+unsigned int audio_mixer_get_stream_space(int id);
+
+/****************************************************************************
+ * Name: audio_mixer_get_stream_buffer_size
+ *
+ * Description:
+ *   Get the size in bytes of one mixer period in the stream format. It is
+ *   the amount a player should decode for each audio_mixer_process().
+ *
+ * Return Value:
+ *   Number of bytes, 0 if the id is invalid.
+ ****************************************************************************/
+unsigned int audio_mixer_get_stream_buffer_size(int id);
+
+/****************************************************************************
+ * Name: audio_mixer_set_stream_gain
+ *
+ * Description:
+ *   Set the gain applied to the stream before it is mixed.
+ *
+ * Input parameters:
+ *   id: stream id
+ *   gain: gain in percent, 100 keeps the samples unchanged
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_set_stream_gain(int id, uint8_t gain);
+
+/****************************************************************************
+ * Name: audio_mixer_set_stream_ducking
+ *
+ * Description:
+ *   While a ducking stream has samples to play, all other streams are
+ *   attenuated by CONFIG_MEDIA_AUDIO_MIXER_DUCKING_GAIN.
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_set_stream_ducking(int id, bool ducking);
+
+/****************************************************************************
+ * Name: audio_mixer_process
+ *
+ * Description:
+ *   Mix up to one period of every running or draining stream and write it
+ *   to the output card. The cost is linear in the number of streams times
+ *   the period size. When nothing is left to mix, the card is drained.
+ *
+ * Return Value:
+ *   The number of frames written, 0 if there was nothing to mix.
+ *   Otherwise a negative value.
+ ****************************************************************************/
+int audio_mixer_process(void);
+
+#if defined(__cplusplus)
+}								/* extern "C" */
+#endif
+#endif
@@ -24,14 +24,23 @@
 ** file at : https://github.com/erikd/libsamplerate/blob/master/COPYING
 */
 
+#ifdef __TINYARA__
+#include <tinyara/config.h>
+#endif
+
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
 #include "samplerate.h"
 #include "../../utils/remix.h"
 
+#ifdef __ARM_FEATURE_SIMD32
+#include <arm_acle.h>
+#endif
+
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -93,9 +102,60 @@
 // Check src context initialized or not
 #define CHECK_SRC_CONTEXT_INIT(src) ((src)->in_buffer != NULL)
 
+#ifndef CONFIG_AUDIO_RESAMPLER_QUALITY
+#define CONFIG_AUDIO_RESAMPLER_QUALITY SRC_QUALITY_MEDIUM
+#endif
+
+// Polyphase taps per phase, multiples of 4 to keep the dot product unrolled
+#define POLYPHASE_TAPS_MEDIUM   (16)
+#define POLYPHASE_TAPS_HIGH     (32)
+#define POLYPHASE_TAPS_MAX      POLYPHASE_TAPS_HIGH
+
+// Passband edge relative to the lower Nyquist frequency
+#define POLYPHASE_ROLLOFF_MEDIUM    (0.85f)
+#define POLYPHASE_ROLLOFF_HIGH      (0.92f)
+
+// Q15 coefficients
+#define Q15_SHIFT   (15)
+#define Q15_ONE     (1 << Q15_SHIFT)
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
 /****************************************************************************
  * Private Declarations
  ****************************************************************************/
+/**
+ * @structure src_polyphase_table_s: Q15 coefficients of one filter bank.
+ * @brief Shared by all converters with the same ratio and quality, see
+ *        get_polyphase_table().
+ */
+struct src_polyphase_table_s {
+	struct src_polyphase_table_s *next;
+	int32_t phases;             // interpolation factor L
+	int32_t step;               // decimation factor M
+	int32_t taps;               // taps per phase
+	int16_t coeff[];            // phases x taps, each phase reversed in time
+};
+
+/**
+ * @structure src_polyphase_s: polyphase filter bank converting by L/M.
+ * @brief The input is kept per channel, so that a phase is a plain dot product
+ *        of two int16_t arrays, which maps on dual 16-bit MAC instructions.
+ */
+struct src_polyphase_s {
+	const int16_t *table;       // phases x taps Q15 coefficients, each phase reversed in time
+	int32_t phases;             // interpolation factor L
+	int32_t step;               // decimation factor M
+	int32_t taps;               // taps per phase
+	int32_t phase;              // phase of the next output frame
+	int32_t pos;                // index of the newest input frame used by the next output frame
+	int32_t fill;               // number of frames in hist
+	int32_t hist_frames;        // capacity of hist in frames
+	int16_t *hist[SRC_MAX_CH];  // input frames per channel
+};
+
 /**
  * @structure src_context_s: main structure used for SRC, it contains context
  *            variables used between src_simple() calls.
@@ -119,6 +179,8 @@ struct src_context_s {
 	float ratio;            // (float)new_sample_rate / (float)old_sample_rate
 	float inverse_ratio;    // (float)old_sample_rate / (float)new_sample_rate
 	uint32_t fp_frac;       // fraction part value of last fixed point index
+	src_quality_t quality;  // quality requested before first use
+	struct src_polyphase_s *poly; // polyphase filter bank, NULL for linear interpolation
 	/**
 	 * @brief   Function pointer to resampling process function
 	 * @param   src_context_t *: pointer to resampler object.
@@ -143,6 +205,10 @@ static const int32_t filter_22khz_coeff[] = {
 	-10484531, -5820678, 2898328, 2089257,
 };
 
+// Filter banks built so far, a device only uses a few ratios
+static struct src_polyphase_table_s *g_polyphase_tables;
+static pthread_mutex_t g_polyphase_lock = PTHREAD_MUTEX_INITIALIZER;
+
 
 /****************************************************************************
  * Private Functions
@@ -269,6 +335,248 @@ static void convolution_filtering(src_context_t *src, int32_t num_frames_add)
 	}
 }
 
+static int32_t gcd(int32_t a, int32_t b)
+{
+	while (b != 0) {
+		int32_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/**
+ * @brief   Dot product of input samples and one filter phase in Q15.
+ * @remarks taps must be a multiple of 4. With the ARM DSP extension two
+ *          16x16 products are accumulated per SMLAD instruction.
+ * @param   x: pointer to the oldest input sample.
+ * @param   h: pointer to the first coefficient of the phase.
+ * @param   taps: number of coefficients.
+ * @return  sum of products, Q15 scaled.
+ */
+static int32_t dot_q15(const int16_t *x, const int16_t *h, int32_t taps)
+{
+	int32_t sum = 0;
+	int32_t i;
+#ifdef __ARM_FEATURE_SIMD32
+	int32_t xx;
+	int32_t hh;
+	for (i = 0; i < taps; i += 2) {
+		memcpy(&xx, x + i, sizeof(xx));
+		memcpy(&hh, h + i, sizeof(hh));
+		sum = __smlad(xx, hh, sum);
+	}
+#else
+	for (i = 0; i < taps; i += 4) {
+		sum += x[i] * h[i] + x[i + 1] * h[i + 1] + x[i + 2] * h[i + 2] + x[i + 3] * h[i + 3];
+	}
+#endif
+	return sum;
+}
+
+/**
+ * @brief   Fill the phase table with a Blackman windowed sinc low-pass filter.
+ * @remarks The prototype runs at L times the input rate, its cutoff is below
+ *          both Nyquist frequencies. Each phase is normalized to unit DC gain,
+ *          the rounding error of a phase goes to its largest tap so that the
+ *          gain does not change from one output frame to the next.
+ * @param   table: filter bank with phases, step and taps set.
+ * @param   rolloff: passband edge relative to the lower Nyquist frequency.
+ */
+static void build_polyphase_table(struct src_polyphase_table_s *table, float rolloff)
+{
+	float coeff[POLYPHASE_TAPS_MAX];
+	int16_t *phase;
+	int32_t length = table->phases * table->taps;
+	float cutoff = rolloff / (float)MAXIMUM(table->phases, table->step);
+	float center = (float)(length - 1) / 2;
+	int32_t p, t, n, largest, qsum;
+	long q;
+
+	for (p = 0; p < table->phases; p++) {
+		float sum = 0;
+		largest = 0;
+		for (t = 0; t < table->taps; t++) {
+			n = p + t * table->phases;
+			float x = (float)M_PI * cutoff * ((float)n - center);
+			float sinc = FLOAT_EQUAL(x, 0) ? 1.0f : sinf(x) / x;
+			float w = (float)(2 * M_PI) * (float)n / (float)(length - 1);
+			float window = 0.42f - 0.5f * cosf(w) + 0.08f * cosf(2 * w);
+			coeff[t] = sinc * window;
+			sum += coeff[t];
+			if (coeff[t] > coeff[largest]) {
+				largest = t;
+			}
+		}
+		// The dot product walks the input forwards, so store the phase reversed.
+		phase = table->coeff + p * table->taps;
+		qsum = 0;
+		for (t = 0; t < table->taps; t++) {
+			q = (long)roundf(coeff[t] / sum * (float)Q15_ONE);
+			q = MAXIMUM(INT16_MIN, MINIMUM(INT16_MAX, q));
+			phase[table->taps - 1 - t] = (int16_t)q;
+			qsum += q;
+		}
+		phase[table->taps - 1 - largest] += Q15_ONE - qsum;
+	}
+}
+
+/**
+ * @brief   Get the filter bank for a ratio and a number of taps.
+ * @remarks The table is built on first use and kept for the lifetime of the
+ *          system, so opening another stream at the same rates costs no
+ *          sinf()/cosf() evaluation. It is never modified once published.
+ * @param   phases: interpolation factor L.
+ * @param   step: decimation factor M.
+ * @param   taps: taps per phase.
+ * @param   rolloff: passband edge relative to the lower Nyquist frequency.
+ * @return  pointer to the coefficients, NULL when out of memory.
+ */
+static const int16_t *get_polyphase_table(int32_t phases, int32_t step, int32_t taps, float rolloff)
+{
+	struct src_polyphase_table_s *table;
+
+	pthread_mutex_lock(&g_polyphase_lock);
+	for (table = g_polyphase_tables; table != NULL; table = table->next) {
+		if (table->phases == phases && table->step == step && table->taps == taps) {
+			break;
+		}
+	}
+	if (table == NULL) {
+		table = (struct src_polyphase_table_s *)malloc(sizeof(struct src_polyphase_table_s) + phases * taps * sizeof(int16_t));
+		if (table != NULL) {
+			table->phases = phases;
+			table->step = step;
+			table->taps = taps;
+			build_polyphase_table(table, rolloff);
+			table->next = g_polyphase_tables;
+			g_polyphase_tables = table;
+		}
+	}
+	pthread_mutex_unlock(&g_polyphase_lock);
+
+	return (table != NULL) ? table->coeff : NULL;
+}
+
+/**
+ * @brief   Set up a polyphase filter bank for the ratio of src.
+ * @param   src: pointer to resampler object, rates and channels are set.
+ * @return  0 on success, SRC_ERR_NOT_SUPPORT if the ratio needs too many
+ *          phases, other negative values mean failure.
+ */
+static int init_polyphase(src_context_t *src)
+{
+	struct src_polyphase_s *poly;
+	int32_t divisor = gcd(src->new_sample_rate, src->old_sample_rate);
+	int32_t phases = src->new_sample_rate / divisor;
+	int32_t scratch_frames = src->in_buffer_bytes / NEW_FRAMES_TO_BYTES(src, 1);
+	int32_t i;
+
+	RETURN_VAL_IF_FAIL((phases <= SRC_POLYPHASE_MAX_PHASES), SRC_ERR_NOT_SUPPORT);
+
+	poly = (struct src_polyphase_s *)calloc(1, sizeof(struct src_polyphase_s));
+	RETURN_VAL_IF_FAIL((poly != NULL), SRC_ERR_MALLOC_FAILED);
+
+	poly->phases = phases;
+	poly->step = src->old_sample_rate / divisor;
+	poly->taps = (src->quality == SRC_QUALITY_HIGH) ? POLYPHASE_TAPS_HIGH : POLYPHASE_TAPS_MEDIUM;
+	poly->table = get_polyphase_table(poly->phases, poly->step, poly->taps, (src->quality == SRC_QUALITY_HIGH) ? POLYPHASE_ROLLOFF_HIGH : POLYPHASE_ROLLOFF_MEDIUM);
+	// History keeps taps - 1 old frames in front of a full scratch buffer
+	poly->hist_frames = scratch_frames + poly->taps;
+	poly->hist[0] = (int16_t *)malloc(poly->hist_frames * src->new_channel_num * sizeof(int16_t));
+	if (!poly->table || !poly->hist[0]) {
+		free(poly->hist[0]);
+		free(poly);
+		return SRC_ERR_MALLOC_FAILED;
+	}
+	for (i = 1; i < src->new_channel_num; i++) {
+		poly->hist[i] = poly->hist[0] + i * poly->hist_frames;
+	}
+
+	// Start from silence, the first output frame only sees the first input frame
+	for (i = 0; i < src->new_channel_num; i++) {
+		memset(poly->hist[i], 0, (poly->taps - 1) * sizeof(int16_t));
+	}
+	poly->fill = poly->taps - 1;
+	poly->pos = poly->taps - 1;
+	poly->phase = 0;
+
+	src->poly = poly;
+	return SRC_ERR_NO_ERROR;
+}
+
+static void destroy_polyphase(src_context_t *src)
+{
+	if (src->poly) {
+		free(src->poly->hist[0]);
+		free(src->poly);
+		src->poly = NULL;
+	}
+}
+
+/**
+ * @brief   Convert through the polyphase filter bank.
+ * @remarks Same contract as the linear path of src_simple(): accept as many
+ *          input frames as fit, generate as many output frames as fit.
+ * @param   src: pointer to resampler object.
+ * @param   src_data: pointer to the user given src_data_t structure
+ * @param   out_buffer_frames: capacity of the output buffer in frames
+ * @return  0 on success, negative value means failure.
+ */
+static int resample_polyphase(src_context_t *src, src_data_t *src_data, int32_t out_buffer_frames)
+{
+	struct src_polyphase_s *poly = src->poly;
+	int32_t channels_num = src->new_channel_num;
+	int16_t *output = (int16_t *)src_data->data_out;
+	int32_t output_frames_gen = 0;
+	int32_t frames, shift, i, j;
+
+	// Drop frames which no output frame reaches any more
+	shift = poly->pos - (poly->taps - 1);
+	if (shift > 0) {
+		for (j = 0; j < channels_num; j++) {
+			memmove(poly->hist[j], poly->hist[j] + shift, (poly->fill - shift) * sizeof(int16_t));
+		}
+		poly->fill -= shift;
+		poly->pos -= shift;
+	}
+
+	// Rechannel into the scratch buffer, then split the channels into the history
+	frames = MINIMUM(src_data->input_frames, poly->hist_frames - poly->fill);
+	frames = MINIMUM(frames, src->in_buffer_bytes / NEW_FRAMES_TO_BYTES(src, 1));
+	if (frames > 0) {
+		int32_t ret = rechannel(ch2layout(src->old_channel_num), ch2layout(channels_num), \
+						(const int16_t *)src_data->data_in, frames, src->in_buffer, frames);
+		RETURN_VAL_IF_FAIL((ret == frames), SRC_ERR_UNKNOWN);
+		for (i = 0; i < frames; i++) {
+			for (j = 0; j < channels_num; j++) {
+				poly->hist[j][poly->fill + i] = src->in_buffer[i * channels_num + j];
+			}
+		}
+		poly->fill += frames;
+	} else {
+		frames = 0;
+	}
+
+	while ((output_frames_gen < out_buffer_frames) && (poly->pos < poly->fill)) {
+		const int16_t *coeff = poly->table + poly->phase * poly->taps;
+		int32_t start = poly->pos - (poly->taps - 1);
+		for (j = 0; j < channels_num; j++) {
+			int32_t sum = dot_q15(poly->hist[j] + start, coeff, poly->taps);
+			*output++ = clip((sum + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT);
+		}
+		output_frames_gen++;
+
+		poly->phase += poly->step;
+		poly->pos += poly->phase / poly->phases;
+		poly->phase %= poly->phases;
+	}
+
+	src_data->input_frames_used = frames;
+	src_data->output_frames_gen = output_frames_gen;
+	return SRC_ERR_NO_ERROR;
+}
+
 /**
  * @brief   Check validation of the given src_data.
  * @param   src: pointer to resampler object.
@@ -334,6 +642,17 @@ static int init_src_context(src_context_t *src, src_data_t *src_data)
 	src->ratio = (float)src->new_sample_rate / (float)src->old_sample_rate;
 	src->inverse_ratio = (float)src->old_sample_rate / (float)src->new_sample_rate;
 
+	// Common ratios go through a polyphase filter bank unless low quality is requested
+	src->poly = NULL;
+	if (src->quality != SRC_QUALITY_LOW) {
+		int ret = init_polyphase(src);
+		if (ret == SRC_ERR_NO_ERROR) {
+			return SRC_ERR_NO_ERROR;
+		}
+		RETURN_VAL_IF_FAIL((ret == SRC_ERR_NOT_SUPPORT), ret);
+		// Too many phases for this ratio, fall back to linear interpolation
+	}
+
 	// Set overlap frame number and converting function as per converting ratio
 	if (src->old_sample_rate > src->new_sample_rate) {
 		// down resampling
@@ -378,6 +697,8 @@ src_handle_t src_init(int size)
 	src->in_buffer_bytes = (((size + max_frame_size - 1) / max_frame_size) * max_frame_size);
 	src->in_buffer_frames = 0;
 	src->in_buffer = NULL;
+	src->quality = (src_quality_t)CONFIG_AUDIO_RESAMPLER_QUALITY;
+	src->poly = NULL;
 	// Other members will be initilized before first use,
 	// as soon as in_buffer allocated in init_src_context().
 
@@ -389,6 +710,8 @@ int src_destroy(src_handle_t handle)
 	src_context_t *src = (src_context_t *)handle;
 	RETURN_VAL_IF_FAIL((src != NULL), SRC_ERR_BAD_PARAMS);
 
+	destroy_polyphase(src);
+
 	free(src->in_buffer);
 	src->in_buffer = NULL;
 
@@ -396,6 +719,18 @@ int src_destroy(src_handle_t handle)
 	return SRC_ERR_NO_ERROR;
 }
 
+int src_set_quality(src_handle_t handle, src_quality_t quality)
+{
+	src_context_t *src = (src_context_t *)handle;
+	RETURN_VAL_IF_FAIL((src != NULL), SRC_ERR_BAD_PARAMS);
+	RETURN_VAL_IF_FAIL(((quality >= SRC_QUALITY_LOW) && (quality <= SRC_QUALITY_HIGH)), SRC_ERR_BAD_PARAMS);
+	// The filter bank is built on first use
+	RETURN_VAL_IF_FAIL((!CHECK_SRC_CONTEXT_INIT(src)), SRC_ERR_NOT_SUPPORT);
+
+	src->quality = quality;
+	return SRC_ERR_NO_ERROR;
+}
+
 bool src_is_valid_ratio(float ratio)
 {
 	if ((ratio <= SRC_MAX_RATIO) && (ratio >= SRC_MIN_RATIO)) {
@@ -437,7 +772,11 @@ int src_simple(src_handle_t handle, src_data_t *src_data)
 	if (!CHECK_SRC_CONTEXT_INIT(src)) {
 		ret = init_src_context(src, src_data);
 		RETURN_VAL_IF_FAIL((ret == SRC_ERR_NO_ERROR), ret);
-		RETURN_VAL_IF_FAIL((src->src_func != NULL), SRC_ERR_UNKNOWN);
+		RETURN_VAL_IF_FAIL(((src->poly != NULL) || (src->src_func != NULL)), SRC_ERR_UNKNOWN);
+	}
+
+	if (src->poly != NULL) {
+		return resample_polyphase(src, src_data, out_buffer_frames);
 	}
 
 	// Update output buffer to src context (used in converting proccess functions)
@@ -67,6 +67,21 @@ enum {
 	SAMPLE_WIDTH_MAX = SAMPLE_WIDTH_32BITS,
 };
 
+/**
+ * @enum  Define resampling quality levels.
+ * @brief Higher levels run a longer polyphase filter and take more CPU.
+ *        Ratios which need more than SRC_POLYPHASE_MAX_PHASES filter phases
+ *        are always converted with linear interpolation.
+ */
+typedef enum {
+	SRC_QUALITY_LOW = 0,        // linear interpolation
+	SRC_QUALITY_MEDIUM = 1,     // polyphase filter, 16 taps per phase
+	SRC_QUALITY_HIGH = 2,       // polyphase filter, 32 taps per phase
+} src_quality_t;
+
+// Largest interpolation factor run through a polyphase filter, 160 covers 44.1K<->48K
+#define SRC_POLYPHASE_MAX_PHASES 160
+
 /**
  * @typedef src_handle_t, SRC(Sample Rate Convertor) hanlde type declaration.
  * @brief   NULL means invalid handle.
@@ -135,6 +150,17 @@ src_handle_t src_init(int size);
  */
 int src_destroy(src_handle_t handle);
 
+/**
+ * @brief   Select the resampling quality of a SRC instance.
+ * @remarks src_init() selects CONFIG_AUDIO_RESAMPLER_QUALITY. The quality can
+ *          only be changed before the first src_simple() call.
+ * @param   handle: pointer to a SRC instance, returned by src_init().
+ * @param   quality: one of src_quality_t.
+ * @return  0 on success, otherwise, it means failure.
+ * @see     src_quality_t
+ */
+int src_set_quality(src_handle_t handle, src_quality_t quality);
+
 /**
  * @brief   Check if the conversion ratio is valid or not.
  * @remarks To provide high quality SRC, conversion ratio is limited in a range.
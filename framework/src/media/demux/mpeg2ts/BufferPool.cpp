@@ -0,0 +1,86 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <debug.h>
+#include <string.h>
+#include "BufferPool.h"
+
+#define NUM_SIZE_CLASSES (MAX_BUFFER_SHIFT - MIN_BUFFER_SHIFT + 1)
+
+BufferPool::BufferPool()
+{
+	memset(mFreeCount, 0, sizeof(mFreeCount));
+}
+
+BufferPool::~BufferPool()
+{
+	int i;
+
+	for (i = 0; i < NUM_SIZE_CLASSES; i++) {
+		while (mFreeCount[i] > 0) {
+			delete[] mFreeBuffers[i][--mFreeCount[i]];
+		}
+	}
+}
+
+int BufferPool::sizeClass(uint32_t size)
+{
+	int index = 0;
+
+	while (((uint32_t)1 << (MIN_BUFFER_SHIFT + index)) < size) {
+		if (++index >= NUM_SIZE_CLASSES) {
+			return -1;
+		}
+	}
+
+	return index;
+}
+
+uint8_t *BufferPool::acquire(uint32_t size, uint32_t *capacity)
+{
+	uint8_t *buffer;
+	int index = sizeClass(size);
+
+	if (index < 0) {
+		meddbg("Buffer size %u is too large!\n", size);
+		return nullptr;
+	}
+
+	*capacity = (uint32_t)1 << (MIN_BUFFER_SHIFT + index);
+	if (mFreeCount[index] > 0) {
+		return mFreeBuffers[index][--mFreeCount[index]];
+	}
+
+	buffer = new uint8_t[*capacity];
+	if (!buffer) {
+		meddbg("Run out of memory! Allocating %u bytes failed!\n", *capacity);
+	}
+	return buffer;
+}
+
+void BufferPool::release(uint8_t *buffer, uint32_t capacity)
+{
+	int index = sizeClass(capacity);
+
+	if (index < 0 || mFreeCount[index] >= MAX_FREE_BUFFERS) {
+		delete[] buffer;
+		return;
+	}
+
+	mFreeBuffers[index][mFreeCount[index]++] = buffer;
+}
@@ -0,0 +1,55 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#ifndef __BUFFER_POOL_H
+#define __BUFFER_POOL_H
+
+#include <stdint.h>
+
+/* Recycles data buffers of sections and PES packets.
+ * Buffers are grouped in power of two size classes, so a stream with a steady
+ * packet size is served from the free lists without any heap allocation.
+ */
+class BufferPool
+{
+public:
+	enum {
+		MIN_BUFFER_SHIFT = 6,    // smallest size class, 64 bytes
+		MAX_BUFFER_SHIFT = 16,   // largest size class, covers any 16 bit data length
+		MAX_FREE_BUFFERS = 2,    // free buffers kept per size class
+	};
+
+	BufferPool();
+	virtual ~BufferPool();
+	// get a buffer of at least `size` bytes, its real size is returned in `capacity`
+	uint8_t *acquire(uint32_t size, uint32_t *capacity);
+	// give back a buffer got from acquire(), `capacity` is the value acquire() returned
+	void release(uint8_t *buffer, uint32_t capacity);
+
+private:
+	// index of the size class which holds `size` bytes, -1 if it's too large
+	int sizeClass(uint32_t size);
+
+private:
+	// free buffers of each size class, kept in fixed arrays so recycling never allocates
+	uint8_t *mFreeBuffers[MAX_BUFFER_SHIFT - MIN_BUFFER_SHIFT + 1][MAX_FREE_BUFFERS];
+	// number of free buffers of each size class
+	uint8_t mFreeCount[MAX_BUFFER_SHIFT - MIN_BUFFER_SHIFT + 1];
+};
+
+#endif /* __BUFFER_POOL_H */
@@ -23,10 +23,16 @@
 #define PACKET_LENGTH(buffer)   ((buffer[4] << 8) | buffer[5])
 #define PES_PACKET_HEAD_BYTES   (6) // packet_start_code_prefix + stream_id + PES_packet_length
 
-std::shared_ptr<PESPacket> PESPacket::create(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size)
+std::shared_ptr<PESPacket> PESPacket::create(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size, std::shared_ptr<BufferPool> pool)
 {
 	auto instance = std::make_shared<PESPacket>();
-	if (instance && instance->initialize(pid, continuityCounter, pData, size)) {
+	if (!instance) {
+		meddbg("create PESPacket instance failed!\n");
+		return nullptr;
+	}
+
+	instance->setBufferPool(pool);
+	if (instance->initialize(pid, continuityCounter, pData, size)) {
 		return instance;
 	}
 
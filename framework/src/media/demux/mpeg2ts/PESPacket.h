@@ -27,7 +27,8 @@ class PESPacket : public Section
 {
 public:
 	// should always use this static method to create a new PESPacket instance
-	static std::shared_ptr<PESPacket> create(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size);
+	// pool, if not null, data buffer is taken from and given back to the pool
+	static std::shared_ptr<PESPacket> create(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size, std::shared_ptr<BufferPool> pool = nullptr);
 	// constructor and destructor
 	PESPacket() {}
 	virtual ~PESPacket() {}
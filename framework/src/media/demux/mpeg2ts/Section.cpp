@@ -19,6 +19,7 @@
 #include <debug.h>
 #include <string.h>
 #include "Mpeg2TsTypes.h"
+#include "BufferPool.h"
 #include "Section.h"
 #include "SectionParser.h"
 
@@ -28,10 +29,16 @@
 #define CONTINUITY_COUNTER_MOD  (16) // Continuity counter's module value
 
 
-std::shared_ptr<Section> Section::create(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size)
+std::shared_ptr<Section> Section::create(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size, std::shared_ptr<BufferPool> pool)
 {
 	auto instance = std::make_shared<Section>();
-	if (instance && instance->initialize(pid, continuityCounter, pData, size)) {
+	if (!instance) {
+		meddbg("create Section instance failed!\n");
+		return nullptr;
+	}
+
+	instance->setBufferPool(pool);
+	if (instance->initialize(pid, continuityCounter, pData, size)) {
 		return instance;
 	}
 
@@ -42,10 +49,22 @@ std::shared_ptr<Section> Section::create(ts_pid_t pid, uint8_t continuityCounter
 bool Section::initialize(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size)
 {
 	mSectionDataLen = parseLengthField(pData, size);
-	mSectionData = new uint8_t[mSectionDataLen];
-	if (!mSectionData) {
-		meddbg("Run out of memory! Allocating %d bytes failed!\n", mSectionDataLen);
-		return false;
+	mPresentDataLen = 0;
+	if (mSectionDataLen > mSectionDataCap) {
+		// data buffer of last use is too small
+		releaseData();
+		if (mBufferPool) {
+			mSectionData = mBufferPool->acquire(mSectionDataLen, &mSectionDataCap);
+		} else {
+			mSectionData = new uint8_t[mSectionDataLen];
+			mSectionDataCap = mSectionDataLen;
+		}
+		if (!mSectionData) {
+			meddbg("Run out of memory! Allocating %d bytes failed!\n", mSectionDataLen);
+			mSectionDataCap = 0;
+			mSectionDataLen = 0;
+			return false;
+		}
 	}
 
 	if (mSectionDataLen < size) {
@@ -66,17 +85,28 @@ Section::Section()
 	: mPid(INVALID_PID)
 	, mContinuityCounter(0)
 	, mSectionData(nullptr)
+	, mSectionDataCap(0)
 	, mSectionDataLen(0)
 	, mPresentDataLen(0)
 {
 }
 
 Section::~Section()
+{
+	releaseData();
+}
+
+void Section::releaseData(void)
 {
 	if (mSectionData) {
-		delete[] mSectionData;
+		if (mBufferPool) {
+			mBufferPool->release(mSectionData, mSectionDataCap);
+		} else {
+			delete[] mSectionData;
+		}
 		mSectionData = nullptr;
 	}
+	mSectionDataCap = 0;
 }
 
 bool Section::appendData(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size)
@@ -22,16 +22,21 @@
 #include <memory>
 #include "Mpeg2TsTypes.h"
 
+class BufferPool;
 class Section
 {
 public:
 	// should always use this static method to create a new section instance
-	static std::shared_ptr<Section> create(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size);
+	// pool, if not null, data buffer is taken from and given back to the pool
+	static std::shared_ptr<Section> create(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size, std::shared_ptr<BufferPool> pool = nullptr);
 	// constructor and destructor
 	Section();
 	virtual ~Section();
 	// initialize section member and allocate data buffer
+	// it can be called again to reuse the instance, data buffer is kept if it's large enough
 	bool initialize(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size);
+	// set pool to recycle data buffer, must be called before initialize()
+	void setBufferPool(std::shared_ptr<BufferPool> pool) { mBufferPool = pool; }
 	// append new section data from ts packet payload
 	bool appendData(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size);
 	// verify mpeg2 crc32
@@ -52,6 +57,8 @@ protected:
 	virtual uint16_t parseLengthField(uint8_t *pData, uint16_t size);
 	// calculates the MPEG2 32 bit CRC
 	uint32_t crc32(uint8_t *data, uint32_t length);
+	// give data buffer back to pool or free it
+	void releaseData(void);
 
 private:
 	// PID of transport stream this section from
@@ -60,6 +67,10 @@ private:
 	uint8_t mContinuityCounter;
 	// section data buffer allocated
 	uint8_t *mSectionData;
+	// size in bytes of section data buffer
+	uint32_t mSectionDataCap;
+	// pool which section data buffer comes from, null means heap
+	std::shared_ptr<BufferPool> mBufferPool;
 	// total data length in bytes of a completed section
 	uint16_t mSectionDataLen;
 	// present data length in section data buffer
@@ -22,6 +22,7 @@
 #include <debug.h>
 
 #include "Mpeg2TsTypes.h"
+#include "BufferPool.h"
 #include "TSPacket.h"
 #include "Section.h"
 #include "PATParser.h"
@@ -102,6 +103,12 @@ bool TSDemuxer::initialize(void)
 		return false;
 	}
 
+	mBufferPool = std::make_shared<BufferPool>();
+	if (!mBufferPool) {
+		meddbg("mBufferPool is nullptr!\n");
+		return false;
+	}
+
 	return true;
 }
 
@@ -119,84 +126,114 @@ ssize_t TSDemuxer::pushData(uint8_t *buf, size_t size)
 	return (ssize_t)written;
 }
 
-ssize_t TSDemuxer::pullData(uint8_t *buf, size_t size, void *param)
+bool TSDemuxer::setupPESPid(void *param)
 {
-	if (mPESPid == INVALID_PID) {
-		// setup PES pid
-		prog_num_t progNum;
-		if (param) {
-			progNum = *((prog_num_t *)param);
-		} else {
-			// use default 1st program
-			std::vector<prog_num_t> programs;
-			mParserManager->getPrograms(programs);
-			progNum = programs[0];
-		}
-		uint8_t streamType;
-		if (!mParserManager->getAudioStreamInfo(progNum, streamType, mPESPid)) {
-			meddbg("get audio PES PID failed\n");
-			return DEMUXER_ERROR_NOT_READY;
-		}
-		medvdbg("setup audio PES PID: 0x%x\n", mPESPid);
+	prog_num_t progNum;
+	if (param) {
+		progNum = *((prog_num_t *)param);
+	} else {
+		// use default 1st program
+		std::vector<prog_num_t> programs;
+		mParserManager->getPrograms(programs);
+		progNum = programs[0];
 	}
 
-	int ret = DEMUXER_ERROR_NONE;
-	size_t fill = 0;
-	size_t need;
-	while (fill < size) {
-		need = size - fill;
-		if (mPESParser->getESData() != nullptr) {
-			// get remaining payload in last PES packet
-			if (need > mPESParser->getESDataLen() - mPESDataUsed) {
-				need = mPESParser->getESDataLen() - mPESDataUsed;
-			}
+	uint8_t streamType;
+	if (!mParserManager->getAudioStreamInfo(progNum, streamType, mPESPid)) {
+		meddbg("get audio PES PID failed\n");
+		return false;
+	}
 
-			memcpy(&buf[fill], mPESParser->getESData() + mPESDataUsed, need);
-			mPESDataUsed += need;
-			fill += need;
-			medvdbg("Got ES data %u(%u)/%u\n", fill, need, size);
+	medvdbg("setup audio PES PID: 0x%x\n", mPESPid);
+	return true;
+}
 
-			if (mPESDataUsed == mPESParser->getESDataLen()) {
-				// all ES data in PES parser have been read.
-				medvdbg("All ES data (%u) in PES parser have been read!\n", mPESParser->getESDataLen());
-				mPESParser->reset();
-				mPESDataUsed = 0;
-			}
-			continue;
-		} else {
-			medvdbg("Need to get new PES packet!\n");
+ssize_t TSDemuxer::nextESData(uint8_t **data, size_t size, void *param)
+{
+	if (mPESPid == INVALID_PID) {
+		if (!setupPESPid(param)) {
+			return DEMUXER_ERROR_NOT_READY;
 		}
+	}
+
+	while ((mPESParser->getESData() == nullptr) || (mPESDataUsed == mPESParser->getESDataLen())) {
+		// All ES data in PES parser have been handed out in previous calls,
+		// so nobody refers to them any more.
+		mPESParser->reset();
+		mPESDataUsed = 0;
+		medvdbg("Need to get new PES packet!\n");
 
 		// get new PES packet
 		std::shared_ptr<PESPacket> pPESPacket = nullptr;
-		ret = getPESPacket(pPESPacket);
+		int ret = getPESPacket(pPESPacket);
 		if (ret == DEMUXER_ERROR_WANT_DATA) {
 			medvdbg("Push more data to get PES packet\n");
-			break;
+			return ret;
 		}
 
 		if (ret != DEMUXER_ERROR_NONE) {
 			meddbg("Get PES packet failed! error: %d\n", ret);
-			break;
+			return ret;
 		}
 
 		// parse PES packet
-		if (mPESParser->parse(pPESPacket)) {
-			mPESDataUsed = 0;
-		} else {
+		if (!mPESParser->parse(pPESPacket)) {
 			meddbg("PES parse failed!\n");
 			continue;
 		}
-	} // end while
+		mSparePESPacket = pPESPacket;
+	}
+
+	// get remaining payload in current PES packet
+	size_t avail = mPESParser->getESDataLen() - mPESDataUsed;
+	if (size > avail) {
+		size = avail;
+	}
+
+	*data = mPESParser->getESData() + mPESDataUsed;
+	mPESDataUsed += size;
+	medvdbg("Got ES data %u/%u\n", mPESDataUsed, mPESParser->getESDataLen());
+	return (ssize_t)size;
+}
+
+ssize_t TSDemuxer::pullData(uint8_t *buf, size_t size, void *param)
+{
+	ssize_t ret = DEMUXER_ERROR_NONE;
+	size_t fill = 0;
+	uint8_t *data;
+
+	while (fill < size) {
+		ret = nextESData(&data, size - fill, param);
+		if (ret < 0) {
+			break;
+		}
+
+		memcpy(&buf[fill], data, (size_t)ret);
+		fill += (size_t)ret;
+	}
 
 	if (fill == 0) {
 		medvdbg("Got nothing, please check error: %d\n", ret);
-		return (ssize_t)ret;
+		return ret;
 	}
 
 	return (ssize_t)fill;
 }
 
+ssize_t TSDemuxer::pullDataRef(uint8_t **buf, size_t size, void *param)
+{
+	if (size == 0) {
+		return DEMUXER_ERROR_NONE;
+	}
+
+	ssize_t ret = nextESData(buf, size, param);
+	if (ret < 0) {
+		medvdbg("Got nothing, please check error: %d\n", ret);
+	}
+
+	return ret;
+}
+
 bool TSDemuxer::getPrograms(std::vector<prog_num_t> &progs)
 {
 	return mParserManager->getPrograms(progs);
@@ -307,7 +344,10 @@ std::shared_ptr<Section> TSDemuxer::PSIUnpack(std::shared_ptr<TSPacket> pTSPacke
 		}
 
 		// and then handle new section
-		auto newSection = Section::create(pTSPacket->getPid(), pTSPacket->continuityCounter(), ptrPayload + 1 + u8PointerField, lenPayload - 1 - u8PointerField);
+		auto newSection = Section::create(pTSPacket->getPid(), pTSPacket->continuityCounter(), ptrPayload + 1 + u8PointerField, lenPayload - 1 - u8PointerField, mBufferPool);
+		if (!newSection) {
+			return pSection;
+		}
 		if (newSection->isCompleted()) {
 			if (pSection != nullptr) {
 				meddbg("It should be unreachable! Fixme if it happen!\n");
@@ -347,28 +387,39 @@ std::shared_ptr<PESPacket> TSDemuxer::PESUnpack(std::shared_ptr<TSPacket> pTSPac
 	if (pTSPacket->payloadUnitStartIndicator()) {
 		// new PES packet start
 		medvdbg("new PES packet (PID:%u) start...\n", pTSPacket->getPid());
-		auto newPacket = PESPacket::create(pTSPacket->getPid(), pTSPacket->continuityCounter(), ptrPayload, lenPayload);
+		std::shared_ptr<PESPacket> newPacket;
+		if (mSparePESPacket && mSparePESPacket.use_count() == 1) {
+			// PES parser has released the last packet, reuse it and its data buffer
+			newPacket = mSparePESPacket;
+			if (!newPacket->initialize(pTSPacket->getPid(), pTSPacket->continuityCounter(), ptrPayload, lenPayload)) {
+				mSparePESPacket = nullptr;
+				return pPESPacket;
+			}
+		} else {
+			newPacket = PESPacket::create(pTSPacket->getPid(), pTSPacket->continuityCounter(), ptrPayload, lenPayload, mBufferPool);
+			if (!newPacket) {
+				return pPESPacket;
+			}
+		}
+
 		if (newPacket->isCompleted()) {
 			medvdbg("PES packet (PID:%u) complete\n", pTSPacket->getPid());
 			pPESPacket = newPacket;
 		} else {
-			auto it = mPidPESPacketMap.find(pTSPacket->getPid());
-			if (it != mPidPESPacketMap.end()) {
-				// incomplete PES packet with same PID exist, remove it!
-				mPidPESPacketMap.erase(it);
-			}
-			mPidPESPacketMap.insert(std::pair<uint16_t, std::shared_ptr<PESPacket>>(pTSPacket->getPid(), newPacket));
+			// replace incomplete PES packet with same PID if it exists,
+			// the map entry is kept to avoid allocating a node per packet.
+			mPidPESPacketMap[pTSPacket->getPid()] = newPacket;
 		}
 	} else {
 		// PES packet appending
 		auto it = mPidPESPacketMap.find(pTSPacket->getPid());
-		if (it != mPidPESPacketMap.end()) {
+		if ((it != mPidPESPacketMap.end()) && it->second) {
 			auto prePacket = it->second;
 			prePacket->appendData(pTSPacket->getPid(), pTSPacket->continuityCounter(), ptrPayload, lenPayload);
 			if (prePacket->isCompleted()) {
 				medvdbg("PES packet (PID:%u) complete\n", pTSPacket->getPid());
 				pPESPacket = prePacket;
-				mPidPESPacketMap.erase(it);
+				it->second = nullptr;
 			}
 		}
 	}
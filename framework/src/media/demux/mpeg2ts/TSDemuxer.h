@@ -30,6 +30,7 @@
 #include "../../Demuxer.h"
 
 class ParserManager;
+class BufferPool;
 class Section;
 class TSPacket;
 class PESParser;
@@ -61,6 +62,8 @@ public:
 	// pull audio elementary stream data of the given program number
 	// param, pointer to program nubmer of uint16, nullptr means first program as default
 	virtual ssize_t pullData(uint8_t *buf, size_t size, void *param = nullptr) override;
+	// pull audio elementary stream data without copying, see Demuxer::pullDataRef()
+	virtual ssize_t pullDataRef(uint8_t **buf, size_t size, void *param = nullptr) override;
 	// prepare TSDemuxer, preparse TS data in stream buffer to get program information ahead
 	virtual int prepare(void) override;
 	// check if TSDemuxer is ready (prepare succeed)
@@ -77,6 +80,14 @@ private:
 	bool isPsiPid(uint16_t pid);
 	// check if the given PID is PES packet's PID we need
 	bool isPESPid(uint16_t pid);
+	// setup PID of the audio PES packets of the given program
+	// param, pointer to program nubmer of uint16, nullptr means first program as default
+	bool setupPESPid(void *param);
+	// point to at most `size` bytes of ES data in the current PES packet, and mark them used
+	// ES data stay valid until next call, a new PES packet is extracted when all were used
+	// on success, return number of bytes (> 0)
+	// on failure, return negative value (see demuxer_error_e)
+	ssize_t nextESData(uint8_t **data, size_t size, void *param);
 	// extract a PES packet from the input transport stream
 	// on success, return 0
 	// on failure, return negative value (see demuxer_error_e)
@@ -110,6 +121,10 @@ private:
 	std::shared_ptr<stream::StreamBufferWriter> mBufferWriter;
 	// PES parser
 	std::shared_ptr<PESParser> mPESParser;
+	// pool to recycle data buffers of sections and PES packets
+	std::shared_ptr<BufferPool> mBufferPool;
+	// last PES packet given to PES parser, reused for the next one once parser releases it
+	std::shared_ptr<PESPacket> mSparePESPacket;
 	// TS packet
 	std::shared_ptr<TSPacket> mTSPacket;
 	uint16_t mPESPid;
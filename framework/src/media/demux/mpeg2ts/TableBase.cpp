@@ -27,6 +27,7 @@ TableBase::TableBase()
 	, mLastSectionNum(0)
 	, mMultiSectionCRC(nullptr)
 	, mMultiSectionFlag(nullptr)
+	, mMultiSectionCap(0)
 {
 }
 
@@ -77,19 +78,23 @@ bool TableBase::initTable(uint8_t version, uint8_t sectionNumber, uint8_t lastSe
 {
 	int i;
 
-	resetTable();
+	if (lastSectionNumber + 1 > mMultiSectionCap) {
+		// arrays of the previous version are too small
+		resetTable();
 
-	mMultiSectionFlag = new bool[lastSectionNumber + 1];
-	if (!mMultiSectionFlag) {
-		meddbg("Out of memory! lastSectionNumber 0x%x\n", lastSectionNumber);
-		return false;
-	}
+		mMultiSectionFlag = new bool[lastSectionNumber + 1];
+		if (!mMultiSectionFlag) {
+			meddbg("Out of memory! lastSectionNumber 0x%x\n", lastSectionNumber);
+			return false;
+		}
 
-	mMultiSectionCRC = new uint32_t[lastSectionNumber + 1];
-	if (!mMultiSectionCRC) {
-		meddbg("Out of memory! lastSectionNumber 0x%x\n", lastSectionNumber);
-		resetTable();
-		return false;
+		mMultiSectionCRC = new uint32_t[lastSectionNumber + 1];
+		if (!mMultiSectionCRC) {
+			meddbg("Out of memory! lastSectionNumber 0x%x\n", lastSectionNumber);
+			resetTable();
+			return false;
+		}
+		mMultiSectionCap = lastSectionNumber + 1;
 	}
 
 	for (i = 0; i <= lastSectionNumber; i++) {
@@ -147,6 +152,8 @@ void TableBase::resetTable(void)
 		mMultiSectionCRC= nullptr;
 	}
 
+	mMultiSectionCap = 0;
+
 	mVersion = INVALID_VN;
 	mLastSectionNum = 0;
 }
@@ -42,6 +42,8 @@ private:
 	uint32_t *mMultiSectionCRC;
 	// flag value (received or not) of each section
 	bool *mMultiSectionFlag;
+	// number of sections the arrays above can hold
+	uint16_t mMultiSectionCap;
 
 protected :
 	TableBase();
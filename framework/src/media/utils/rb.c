@@ -24,8 +24,12 @@
 #include "rb.h"
 #include "internal_defs.h"
 
-#define IS_EMPTY(rbp) (rbp->rd_idx == rbp->wr_idx)
-#define IS_FULL(rbp) ((rbp->rd_idx & IDX_MASK) == (rbp->wr_idx & IDX_MASK) && (rbp->rd_idx & MSB_MASK) != (rbp->wr_idx & MSB_MASK))
+/* The index moved by the other side is loaded with acquire semantics, and
+ * an index is stored with release semantics after the data it covers, so
+ * one reader and one writer can work on the buffer concurrently.
+ */
+#define LOAD_IDX(idx)           __atomic_load_n(&(idx), __ATOMIC_ACQUIRE)
+#define STORE_IDX(idx, val)     __atomic_store_n(&(idx), (val), __ATOMIC_RELEASE)
 
 /**
  * @brief  Increase the buffer index while writing or reading the ring-buffer.
@@ -64,12 +68,17 @@ size_t rb_used(rb_p rbp)
 {
 	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
 
-	if (IS_EMPTY(rbp)) {
+	// Take a snapshot of both indexes, either may be moved by the other side.
+	size_t wr_idx = LOAD_IDX(rbp->wr_idx);
+	size_t rd_idx = LOAD_IDX(rbp->rd_idx);
+
+	if (wr_idx == rd_idx) {
+		// empty
 		return SIZE_ZERO;
 	}
 
-	size_t wr_idx = (rbp->wr_idx & IDX_MASK);
-	size_t rd_idx = (rbp->rd_idx & IDX_MASK);
+	wr_idx = (wr_idx & IDX_MASK);
+	rd_idx = (rd_idx & IDX_MASK);
 
 	if (wr_idx > rd_idx) {
 		return (wr_idx - rd_idx);
@@ -155,6 +164,28 @@ size_t rb_read_ext(rb_p rbp, void *ptr, size_t len, size_t offset)
 	return len;
 }
 
+size_t rb_reserve(rb_p rbp, void **ptr, size_t len)
+{
+	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
+	RETURN_VAL_IF_FAIL(ptr != NULL, SIZE_ZERO);
+
+	size_t wr_idx = (rbp->wr_idx & IDX_MASK);
+	len = MINIMUM(len, rb_avail(rbp));
+	len = MINIMUM(len, (rbp->depth - wr_idx));
+
+	*ptr = (void *)((uint8_t *)rbp->buf + wr_idx);
+	return len;
+}
+
+size_t rb_commit(rb_p rbp, size_t len)
+{
+	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
+
+	len = MINIMUM(len, rb_avail(rbp));
+	_incr(rbp, &rbp->wr_idx, len);
+	return len;
+}
+
 bool rb_reset(rb_p rbp)
 {
 	RETURN_VAL_IF_FAIL(rbp != NULL, false);
@@ -176,5 +207,5 @@ static void _incr(rb_p rbp, volatile size_t *p_idx, size_t len)
 		idx -= rbp->depth;
 	}
 
-	*p_idx = msb | idx;
+	STORE_IDX(*p_idx, msb | idx);
 }
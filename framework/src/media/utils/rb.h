@@ -30,7 +30,10 @@ extern "C" {
 #define IDX_MASK (SIZE_MAX>>1)
 #define MSB_MASK (~IDX_MASK)    /* also the maximum value of the buffer depth */
 
-/* ring buffer structure */
+/* ring buffer structure
+ * One writer and one reader may use the ring buffer concurrently without lock,
+ * the writer only moves wr_idx and the reader only moves rd_idx.
+ */
 struct rb_s {
 	void *buf;                  /* pointer to the buffer allocated   */
 	size_t depth;               /* maximum size of the ring buffer   */
@@ -102,6 +105,25 @@ size_t rb_read(rb_p rbp, void *ptr, size_t len);
  */
 size_t rb_read_ext(rb_p rbp, void *ptr, size_t len, size_t offset);
 
+/**
+ * @brief  Get a contiguous free region at the write position, so that data
+ *         can be produced in place. The data become readable by rb_commit().
+ * @param  rbp: Pointer to the ring-buffer object
+ * @param  ptr: Pointer to save the start address of the region
+ * @param  len: maximum length wanted
+ * @return length of the region, range[0, len], it may be less than the
+ *         free space when the region reaches the end of the buffer.
+ */
+size_t rb_reserve(rb_p rbp, void **ptr, size_t len);
+
+/**
+ * @brief  Make data produced in the region of rb_reserve() readable.
+ * @param  rbp: Pointer to the ring-buffer object
+ * @param  len: length of the data produced
+ * @return size of data committed, range[0, len]
+ */
+size_t rb_commit(rb_p rbp, size_t len);
+
 /**
  * @brief  Reset ring-buffer, data in ring-buffer will be dropped.
  * @param  rbp: Pointer to the ring-buffer object
@@ -18,6 +18,7 @@
 /****************************************************************************
  * Included Files
  ****************************************************************************/
+#include <tinyara/config.h>
 #include <debug.h>
 #include <errno.h>
 #include <mqueue.h>
@@ -95,6 +96,9 @@ int messaging_cleanup(const char *port_name)
 	do {
 		if ((strncmp(port_info->name, port_name, strlen(port_name) + 1) == 0) && (my_pid == port_info->pid)) {
 			cleanup_pid = port_info->pid;
+#ifdef CONFIG_MESSAGING_SHM
+			messaging_shm_drain(port_info->mqdes);
+#endif
 			mq_close(port_info->mqdes);
 			sq_rem((FAR sq_entry_t *)port_info, port_info_list_ptr);
 			MSG_FREE(port_info->data);
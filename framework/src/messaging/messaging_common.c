@@ -18,6 +18,7 @@
 /****************************************************************************
  * Included Files
  ****************************************************************************/
+#include <tinyara/config.h>
 #include <debug.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -121,6 +122,9 @@ int messaging_parse_packet(char *packet, char *buf, int buflen, pid_t *sender_pi
 	uint32_t parsing_version;
 	int ret = OK;
 	uint32_t offset;
+#ifdef CONFIG_MESSAGING_SHM
+	messaging_shm_desc_t *desc;
+#endif
 
 	my_version = messaging_get_version();
 
@@ -141,6 +145,26 @@ int messaging_parse_packet(char *packet, char *buf, int buflen, pid_t *sender_pi
 	case 1:
 		*sender_pid = ((messaging_packet_t *)packet)->sender_pid;
 		*msg_type = ((messaging_packet_t *)packet)->msg_type;
+#ifdef CONFIG_MESSAGING_SHM
+		if (MSG_PACKET_IS_SHM(packet)) {
+			/* The message is in the shared buffer, copy it and drop our reference.
+			 * A message which does not fit is dropped as mq_receive() would do, not truncated.
+			 */
+			desc = (messaging_shm_desc_t *)(packet + offset);
+			if (desc->msglen > (uint32_t)buflen) {
+				msgdbg("[Messaging] recv fail : message %u is larger than buffer %d.\n", desc->msglen, buflen);
+				messaging_shm_release(desc->shm);
+				errno = EMSGSIZE;
+				ret = ERROR;
+				break;
+			}
+			memcpy(buf, MSG_SHM_DATA(desc->shm), desc->msglen);
+			messaging_shm_release(desc->shm);
+			*msg_type &= ~MSG_TYPE_SHM;
+			ret = OK;
+			break;
+		}
+#endif
 		memcpy(buf, packet + offset, buflen);
 		ret = OK;
 		break;
@@ -223,7 +247,13 @@ void messaging_run_callback(int signo, siginfo_t *data)
 		}
 
 		/* Parsing the received data to user message buffer. */
-		ret = messaging_parse_packet(recv_packet, recv_info->msg->buf, recv_info->msg->buflen, &(recv_info->msg->sender_pid), &msg_type);
+		recv_info->msg->buflen = recv_info->buflen;
+#ifdef CONFIG_MESSAGING_SHM
+		if (MSG_PACKET_IS_SHM(recv_packet)) {
+			recv_info->msg->buflen = MSG_SHM_MSGLEN(recv_packet);
+		}
+#endif
+		ret = messaging_parse_packet(recv_packet, recv_info->msg->buf, recv_info->buflen, &(recv_info->msg->sender_pid), &msg_type);
 		if (ret != OK) {
 			msgdbg("[Messaging] Not supported version, received version : %d.\n", ret);
 			goto errout_with_recv_packet;
@@ -46,6 +46,39 @@ struct messaging_packet_s {
 typedef struct messaging_packet_s messaging_packet_t;
 #define MSG_HEADER_SIZE (sizeof(messaging_packet_t) - sizeof(char *)) /* Messaging Version 1 */
 
+/**
+ * @brief The shared buffer which carries a large message instead of the message queue.
+ * @details The message data follows this header. The buffer is returned to the pool
+ * when the sender and all receivers release it.
+ */
+struct messaging_shmbuf_s {
+	struct messaging_shmbuf_s *flink;
+	int size;
+	int refs;
+	uint32_t reserved;
+};
+typedef struct messaging_shmbuf_s messaging_shmbuf_t;
+#define MSG_SHM_DATA(shm) ((char *)(shm) + sizeof(messaging_shmbuf_t))
+
+/**
+ * @brief The descriptor which is sent through the message queue instead of the message.
+ */
+struct messaging_shm_desc_s {
+	messaging_shmbuf_t *shm;
+	uint32_t msglen;
+};
+typedef struct messaging_shm_desc_s messaging_shm_desc_t;
+
+/* This flag in msg_type of the header means that the message is messaging_shm_desc_t. */
+#define MSG_TYPE_SHM 0x100
+#define MSG_PACKET_IS_SHM(packet) ((((messaging_packet_t *)(packet))->msg_type & MSG_TYPE_SHM) != 0)
+
+/* The length of the message which a descriptor packet carries.
+ * It never exceeds the receive buffer, messaging_parse_packet() fails with EMSGSIZE otherwise.
+ */
+#define MSG_SHM_DESC(packet) ((messaging_shm_desc_t *)((char *)(packet) + ((messaging_packet_t *)(packet))->offset))
+#define MSG_SHM_MSGLEN(packet) ((int)MSG_SHM_DESC(packet)->msglen)
+
 #define MAX_PORT_NAME_SIZE 64
 
 /**
@@ -88,6 +121,7 @@ typedef enum msg_send_type_e msg_send_type_t;
 struct msg_recv_info_s {
 	mqd_t mqdes;
 	msg_recv_buf_t *msg;
+	int buflen;			/* Size of msg->buf, msg->buflen is updated to the received length */
 	msg_callback_t user_cb;
 	char *cb_data;
 	char port_name[MAX_PORT_NAME_SIZE];
@@ -125,7 +159,7 @@ int messaging_send_internal(const char *port_name, msg_send_type_t msg_type, msg
 /**
  * @brief Internal function for sending message packet which has header and message.
  */
-int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_callback_info_t *cb_info);
+int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, messaging_shmbuf_t *shm);
 /**
  * @brief Internal function for receiving APIs.
  */
@@ -142,6 +176,15 @@ int messaging_parse_packet(char *packet, char *buf, int buflen, pid_t *sender_pi
  * @brief Internal function for getting g_port_info_list
  */
 sq_queue_t *messaging_get_port_info_list(void);
+#ifdef CONFIG_MESSAGING_SHM
+/**
+ * @brief Internal functions for the shared buffer transport.
+ */
+messaging_shmbuf_t *messaging_shm_prepare(msg_send_data_t *send_data);
+void messaging_shm_ref(messaging_shmbuf_t *shm);
+void messaging_shm_release(messaging_shmbuf_t *shm);
+void messaging_shm_drain(mqd_t mqdes);
+#endif
 /*
  *@endcond
  */
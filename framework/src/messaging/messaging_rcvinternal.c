@@ -71,8 +71,12 @@ static int messaging_rcv_nonblock(mqd_t mqdes, const char *port_name, msg_recv_b
 	char *recv_packet;
 	int msg_type;
 	char *internal_portname;
+	int buflen;
+	int msglen;
 
-	recv_size = recv_buf->buflen + MSG_HEADER_SIZE;
+	/* recv_buf->buflen is updated to the received length, keep the capacity for next messages. */
+	buflen = recv_buf->buflen;
+	recv_size = buflen + MSG_HEADER_SIZE;
 	recv_packet = (char *)MSG_ALLOC(recv_size);
 	if (recv_packet == NULL) {
 		msgdbg("[Messaging] recv fail : out of memory for packet.\n");
@@ -82,12 +86,19 @@ static int messaging_rcv_nonblock(mqd_t mqdes, const char *port_name, msg_recv_b
 	while (1) {
 		recv_size_chk = mq_receive(mqdes, (char *)recv_packet, recv_size, 0);
 		if (recv_size_chk > 0 && recv_size_chk <= recv_size) {
-			ret = messaging_parse_packet(recv_packet, recv_buf->buf, recv_buf->buflen, &recv_buf->sender_pid, &msg_type);
+			msglen = recv_size_chk;
+#ifdef CONFIG_MESSAGING_SHM
+			/* The size of a descriptor packet is not the size of the message. */
+			if (MSG_PACKET_IS_SHM(recv_packet)) {
+				msglen = MSG_SHM_MSGLEN(recv_packet);
+			}
+#endif
+			ret = messaging_parse_packet(recv_packet, recv_buf->buf, buflen, &recv_buf->sender_pid, &msg_type);
 			if (ret != OK) {
 				MSG_FREE(recv_packet);
 				goto errout_with_mq;
 			}
-			recv_buf->buflen = recv_size_chk;
+			recv_buf->buflen = msglen;
 			(*cb_info->cb_func)(msg_type, recv_buf, cb_info->cb_data);
 		} else if (recv_size_chk == ERROR && errno == EAGAIN) {
 			msgdbg("[Messaging] recv : empty queue, but NONBLOCK mode.\n");
@@ -114,6 +125,7 @@ static int messaging_rcv_nonblock(mqd_t mqdes, const char *port_name, msg_recv_b
 	}
 	nonblock_data->mqdes = mqdes;
 	nonblock_data->msg = recv_buf;
+	nonblock_data->buflen = buflen;
 	nonblock_data->user_cb = cb_info->cb_func;
 	nonblock_data->cb_data = cb_info->cb_data;
 	strncpy(nonblock_data->port_name, port_name, strlen(port_name) + 1);
@@ -172,6 +184,9 @@ static int messaging_rcv_block(mqd_t mqdes, const char *port_name, msg_recv_buf_
 	char *recv_packet;
 	int msg_type = OK;
 	char *internal_portname;
+#ifdef CONFIG_MESSAGING_SHM
+	int msglen = recv_buf->buflen;
+#endif
 
 	recv_size = MSG_HEADER_SIZE + recv_buf->buflen;
 	recv_packet = (char *)MSG_ALLOC(recv_size);
@@ -188,14 +203,25 @@ static int messaging_rcv_block(mqd_t mqdes, const char *port_name, msg_recv_buf_
 		goto cleanup_return;
 	}
 
+#ifdef CONFIG_MESSAGING_SHM
+	if (MSG_PACKET_IS_SHM(recv_packet)) {
+		msglen = MSG_SHM_MSGLEN(recv_packet);
+	}
+#endif
 	ret = messaging_parse_packet(recv_packet, recv_buf->buf, recv_buf->buflen, &recv_buf->sender_pid, &msg_type);
 	if (ret != OK) {
 		msg_type = ERROR;
 		goto cleanup_return;
 	}
+#ifdef CONFIG_MESSAGING_SHM
+	recv_buf->buflen = msglen;
+#endif
 
 cleanup_return:
 	MSG_FREE(recv_packet);
+#ifdef CONFIG_MESSAGING_SHM
+	messaging_shm_drain(mqdes);
+#endif
 	mq_close(mqdes);
 	MSG_ASPRINTF(&internal_portname, "%s%d", port_name, getpid());
 	mq_unlink(internal_portname);
@@ -0,0 +1,294 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <queue.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <messaging/messaging.h>
+#include "messaging_internal.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+struct messaging_shm_pool_s {
+	sem_t sem;
+	sq_queue_t used;		/* Buffers which are referenced by a sender or a queued descriptor */
+	sq_queue_t freelist;	/* Released buffers kept for reuse */
+	int nfree;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+/* The messaging library is linked once in a flat build, so every task sees the same pool. */
+static struct messaging_shm_pool_s g_shm_pool = {
+	SEM_INITIALIZER(1),
+	{NULL, NULL},
+	{NULL, NULL},
+	0
+};
+
+/****************************************************************************
+ * private functions
+ ****************************************************************************/
+static void messaging_shm_lock(void)
+{
+	while (sem_wait(&g_shm_pool.sem) != OK) {
+		/* Only the signal can wake up this waiting, so try again. */
+		if (errno != EINTR) {
+			break;
+		}
+	}
+}
+
+static void messaging_shm_unlock(void)
+{
+	sem_post(&g_shm_pool.sem);
+}
+
+static messaging_shmbuf_t *messaging_shm_find(void *buf)
+{
+	messaging_shmbuf_t *shm;
+
+	shm = (messaging_shmbuf_t *)sq_peek(&g_shm_pool.used);
+	while (shm != NULL) {
+		if (MSG_SHM_DATA(shm) == (char *)buf) {
+			return shm;
+		}
+		shm = (messaging_shmbuf_t *)sq_next(shm);
+	}
+	return NULL;
+}
+
+static messaging_shmbuf_t *messaging_shm_get(int size)
+{
+	messaging_shmbuf_t *shm;
+	messaging_shmbuf_t *prev = NULL;
+
+	messaging_shm_lock();
+
+	/* Reuse a released buffer if it fits without wasting more than half of it. */
+	shm = (messaging_shmbuf_t *)sq_peek(&g_shm_pool.freelist);
+	while (shm != NULL) {
+		if (shm->size >= size && shm->size / 2 <= size) {
+			if (prev == NULL) {
+				sq_remfirst(&g_shm_pool.freelist);
+			} else {
+				sq_remafter((FAR sq_entry_t *)prev, &g_shm_pool.freelist);
+			}
+			g_shm_pool.nfree--;
+			break;
+		}
+		prev = shm;
+		shm = (messaging_shmbuf_t *)sq_next(shm);
+	}
+
+	if (shm == NULL) {
+		shm = (messaging_shmbuf_t *)MSG_ALLOC(sizeof(messaging_shmbuf_t) + size);
+		if (shm == NULL) {
+			messaging_shm_unlock();
+			msgdbg("[Messaging] shm alloc fail : out of memory, size %d.\n", size);
+			return NULL;
+		}
+		shm->size = size;
+	}
+
+	shm->refs = 1;
+	sq_addfirst((FAR sq_entry_t *)shm, &g_shm_pool.used);
+	messaging_shm_unlock();
+
+	return shm;
+}
+
+/****************************************************************************
+ * Name : messaging_shm_ref
+ *
+ * Description:
+ *  Take one more reference on the shared buffer.
+ *  It is called for each descriptor before it is put into a message queue.
+ ****************************************************************************/
+void messaging_shm_ref(messaging_shmbuf_t *shm)
+{
+	messaging_shm_lock();
+	shm->refs++;
+	messaging_shm_unlock();
+}
+
+/****************************************************************************
+ * Name : messaging_shm_release
+ *
+ * Description:
+ *  Drop one reference of the shared buffer.
+ *  When the last reference is dropped, the buffer goes back to the pool.
+ ****************************************************************************/
+void messaging_shm_release(messaging_shmbuf_t *shm)
+{
+	messaging_shm_lock();
+	if (--shm->refs > 0) {
+		messaging_shm_unlock();
+		return;
+	}
+
+	sq_rem((FAR sq_entry_t *)shm, &g_shm_pool.used);
+	if (g_shm_pool.nfree < CONFIG_MESSAGING_SHM_NCACHED) {
+		sq_addfirst((FAR sq_entry_t *)shm, &g_shm_pool.freelist);
+		g_shm_pool.nfree++;
+		shm = NULL;
+	}
+	messaging_shm_unlock();
+
+	if (shm != NULL) {
+		MSG_FREE(shm);
+	}
+}
+
+/****************************************************************************
+ * Name : messaging_shm_prepare
+ *
+ * Description:
+ *  Select the shared buffer which carries send_data.
+ *  If the message was allocated by messaging_shm_alloc, it is sent as it is.
+ *  Otherwise a large message is copied into a new shared buffer once,
+ *  and all receivers share that copy.
+ *
+ * Return Value:
+ *  A referenced shared buffer, which should be released by the caller after sending.
+ *  NULL if the message should be copied into the packet.
+ ****************************************************************************/
+messaging_shmbuf_t *messaging_shm_prepare(msg_send_data_t *send_data)
+{
+	messaging_shmbuf_t *shm;
+
+	messaging_shm_lock();
+	shm = messaging_shm_find(send_data->msg);
+	if (shm != NULL) {
+		if (send_data->msglen > shm->size) {
+			messaging_shm_unlock();
+			msgdbg("[Messaging] send fail : msglen %d exceeds shared buffer %d.\n", send_data->msglen, shm->size);
+			return NULL;
+		}
+		shm->refs++;
+		messaging_shm_unlock();
+		return shm;
+	}
+	messaging_shm_unlock();
+
+	if (send_data->msglen < CONFIG_MESSAGING_SHM_THRESHOLD) {
+		return NULL;
+	}
+
+	shm = messaging_shm_get(send_data->msglen);
+	if (shm == NULL) {
+		/* Fall back to copy the message into the packet. */
+		return NULL;
+	}
+	memcpy(MSG_SHM_DATA(shm), send_data->msg, send_data->msglen);
+
+	return shm;
+}
+
+/****************************************************************************
+ * Name : messaging_shm_drain
+ *
+ * Description:
+ *  Release the shared buffers of descriptors which remain in the queue.
+ *  It is called before the receiver removes its message port.
+ ****************************************************************************/
+void messaging_shm_drain(mqd_t mqdes)
+{
+	struct mq_attr attr;
+	struct mq_attr old_attr;
+	char *packet;
+
+	if (mq_getattr(mqdes, &attr) != OK || attr.mq_curmsgs == 0) {
+		return;
+	}
+
+	packet = (char *)MSG_ALLOC(attr.mq_msgsize);
+	if (packet == NULL) {
+		msgdbg("[Messaging] drain fail : out of memory for packet.\n");
+		return;
+	}
+
+	attr.mq_flags = O_NONBLOCK;
+	(void)mq_setattr(mqdes, &attr, &old_attr);
+	while (mq_receive(mqdes, packet, attr.mq_msgsize, 0) > 0) {
+		if (MSG_PACKET_IS_SHM(packet)) {
+			messaging_shm_release(((messaging_shm_desc_t *)(packet + MSG_HEADER_SIZE))->shm);
+		}
+	}
+	(void)mq_setattr(mqdes, &old_attr, NULL);
+
+	MSG_FREE(packet);
+}
+
+/****************************************************************************
+ * public functions
+ ****************************************************************************/
+/****************************************************************************
+ * messaging_shm_alloc
+ ****************************************************************************/
+void *messaging_shm_alloc(int size)
+{
+	messaging_shmbuf_t *shm;
+
+	if (size <= 0) {
+		msgdbg("[Messaging] shm alloc fail : invalid size %d.\n", size);
+		return NULL;
+	}
+
+	shm = messaging_shm_get(size);
+	if (shm == NULL) {
+		return NULL;
+	}
+
+	return MSG_SHM_DATA(shm);
+}
+
+/****************************************************************************
+ * messaging_shm_free
+ ****************************************************************************/
+int messaging_shm_free(void *buf)
+{
+	messaging_shmbuf_t *shm;
+
+	if (buf == NULL) {
+		msgdbg("[Messaging] shm free fail : invalid param.\n");
+		return ERROR;
+	}
+
+	messaging_shm_lock();
+	shm = messaging_shm_find(buf);
+	messaging_shm_unlock();
+	if (shm == NULL) {
+		msgdbg("[Messaging] shm free fail : %p is not a shared buffer.\n", buf);
+		return ERROR;
+	}
+
+	messaging_shm_release(shm);
+	return OK;
+}
@@ -78,6 +78,7 @@ static int messaging_set_async_callback(const char *port_name, msg_recv_buf_t *r
 	}
 	data->mqdes = mqdes;
 	data->msg = recv_data;
+	data->buflen = recv_data->buflen;
 	data->user_cb = param->cb_func;
 	data->cb_data = param->cb_data;
 	strncpy(data->port_name, reply_portname, strlen(reply_portname) + 1);
@@ -100,11 +101,12 @@ static int messaging_set_async_callback(const char *port_name, msg_recv_buf_t *r
  *  msg       : The message to be sent
  *  msglen    : The length of message to be sent
  *  priority  : A non-negative integer that specifies the priority of this message
+ *  shm       : The shared buffer which has the message. If it is NULL, the message is copied into the packet.
  * 
  * Return Value:
  *  On success, 0 (OK) is returned.; On failure, -1 (ERROR) is returned.
  ****************************************************************************/
-int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_callback_info_t *cb_info)
+int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, messaging_shmbuf_t *shm)
 {
 	int ret = OK;
 	mqd_t mqdes;
@@ -115,7 +117,11 @@ int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_s
 	uint32_t msg_offset;
 	uint32_t msg_version;
 
-	send_size = MSG_HEADER_SIZE + send_data->msglen;
+	if (shm != NULL) {
+		send_size = MSG_HEADER_SIZE + sizeof(messaging_shm_desc_t);
+	} else {
+		send_size = MSG_HEADER_SIZE + send_data->msglen;
+	}
 
 	internal_attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
 	internal_attr.mq_msgsize = send_size;
@@ -131,6 +137,25 @@ int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_s
 		return ERROR;
 	}
 
+#ifdef CONFIG_MESSAGING_SHM
+	/* Only the descriptor goes through the queue, so check the message against the
+	 * receive buffer here. It fails with EMSGSIZE like mq_send() of a copied message.
+	 */
+	if (shm != NULL) {
+		ret = mq_getattr(mqdes, &internal_attr);
+		if (ret == OK && MSG_HEADER_SIZE + send_data->msglen > internal_attr.mq_msgsize) {
+			errno = EMSGSIZE;
+			ret = ERROR;
+		}
+		if (ret != OK) {
+			msgdbg("[Messaging] send fail : errno %d, message %d.\n", errno, send_data->msglen);
+			mq_close(mqdes);
+			mq_unlink(port_name);
+			return ERROR;
+		}
+	}
+#endif
+
 	send_packet = (char *)MSG_ALLOC(send_size);
 	if (send_packet == NULL) {
 		msgdbg("[Messaging] send fail : out of memory for including header.\n");
@@ -162,14 +187,29 @@ int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_s
 	} else {
 		send_type = MSG_REPLY_REQUIRED;
 	}
+#ifdef CONFIG_MESSAGING_SHM
+	if (shm != NULL) {
+		/* Only the descriptor goes through the queue. The receiver releases the reference after reading. */
+		send_type |= MSG_TYPE_SHM;
+		((messaging_shm_desc_t *)(send_packet + msg_offset))->shm = shm;
+		((messaging_shm_desc_t *)(send_packet + msg_offset))->msglen = send_data->msglen;
+		messaging_shm_ref(shm);
+	} else
+#endif
+	{
+		/* Copy the real send message. */
+		memcpy(send_packet + msg_offset, send_data->msg, send_data->msglen);
+	}
 	((messaging_packet_t *)send_packet)->msg_type = send_type;
 
-	/* Copy the real send message. */
-	memcpy(send_packet + msg_offset, send_data->msg, send_data->msglen);
-
 	ret = mq_send(mqdes, (char *)send_packet, send_size, send_data->priority);
 	if (ret != OK) {
 		msgdbg("[Messaging] send fail : errno %d.\n", errno);
+#ifdef CONFIG_MESSAGING_SHM
+		if (shm != NULL) {
+			messaging_shm_release(shm);
+		}
+#endif
 		MSG_FREE(send_packet);
 		mq_close(mqdes);
 		mq_unlink(port_name);
@@ -212,18 +252,26 @@ int messaging_send_internal(const char *port_name, msg_send_type_t msg_type, msg
 	int recv_arr[CONFIG_MESSAGING_RECV_LIST_SIZE];
 	char *private_portname;
 	int recv_cnt;
+	messaging_shmbuf_t *shm = NULL;
+
+#ifdef CONFIG_MESSAGING_SHM
+	/* All receivers share one buffer for a large message. */
+	shm = messaging_shm_prepare(send_data);
+#endif
 
 	/* Check that how many receivers are waiting. */
 	while (read_status != MSG_READ_ALL) {
 		(void)messaging_init_recv_arr(recv_arr);
 		read_status = READ_MSG_RECEIVER(port_name, recv_arr, recv_cnt);
 		if (read_status == ERROR) {
-			return ERROR;
+			ret = ERROR;
+			goto done;
 		}
 
 		if (msg_type != MSG_SEND_MULTI && recv_cnt > 1) {
 			msgdbg("[Messaging] send fail : too many receivers(%d)are waiting.\n", recv_cnt);
-			return ERROR;
+			ret = ERROR;
+			goto done;
 		}
 
 		/* Send message to each receivers. */
@@ -234,25 +282,32 @@ int messaging_send_internal(const char *port_name, msg_send_type_t msg_type, msg
 			MSG_ASPRINTF(&private_portname, "%s%d", port_name, recv_arr[recv_idx]);
 			if (private_portname == NULL) {
 				msgdbg("[Messaging] send fail : out of memory for private portname.\n");
-				return ERROR;
+				ret = ERROR;
+				goto done;
 			}
 			if (msg_type == MSG_SEND_ASYNC) {
 				if (recv_cnt == 1) {
 					ret = messaging_set_async_callback(port_name, recv_data, cb_info);
 					if (ret != OK) {
 						MSG_FREE(private_portname);
-						return ERROR;
+						ret = ERROR;
+						goto done;
 					}
 				}
-				ret = messaging_send_packet(private_portname, msg_type, send_data, cb_info);
-			} else {
-				ret = messaging_send_packet(private_portname, msg_type, send_data, NULL);
 			}
+			ret = messaging_send_packet(private_portname, msg_type, send_data, shm);
 			MSG_FREE(private_portname);
 		}
 	}
 	if (ret == OK) {
-		return recv_cnt;
+		ret = recv_cnt;
+	}
+
+done:
+#ifdef CONFIG_MESSAGING_SHM
+	if (shm != NULL) {
+		messaging_shm_release(shm);
 	}
+#endif
 	return ret;
 }
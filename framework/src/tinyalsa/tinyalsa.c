@@ -1129,6 +1129,14 @@ int pcm_stop(struct pcm *pcm)
 		size = mq_timedreceive(pcm->mq, (FAR char *)&msg, sizeof(msg), &prio, &st_time);
 	} while (size > 0);
 
+	/* The driver has given every buffer back, mmap can start over from the first one */
+	if (pcm->flags & PCM_MMAP) {
+		int i;
+		for (i = 0; i < pcm->buffer_cnt; i++) {
+			pcm->pBuffers[i]->flags &= ~AUDIO_APB_MMAP_ENQUEUED;
+		}
+	}
+
 	pcm->prepared = 0;
 	pcm->running = 0;
 	pcm->draining = 0;
@@ -1181,6 +1189,7 @@ int pcm_drain(struct pcm *pcm)
 				return oops(pcm, EINTR, "Interrupted while waiting for deque message from kernel\n");
 			}
 			if (msg.msgId == AUDIO_MSG_DEQUEUE) {
+				((struct ap_buffer_s *)msg.u.pPtr)->flags &= ~AUDIO_APB_MMAP_ENQUEUED;
 				pcm->buf_idx--;
 			} else if (msg.msgId == AUDIO_MSG_XRUN) {
 				/* Underrun to be handled by client */
@@ -1397,6 +1406,8 @@ int pcm_wait(struct pcm *pcm, int timeout)
 	int prio;
 	struct timespec st_time;
 	int count = 0;
+	int need;
+	int cnt = 0;
 	int ret;
 
 	if (pcm == NULL) {
@@ -1420,6 +1431,10 @@ int pcm_wait(struct pcm *pcm, int timeout)
 			apb = (struct ap_buffer_s *)msg.u.pPtr;
 			apb->flags &= ~AUDIO_APB_MMAP_ENQUEUED;
 			apb->curbyte = 0;
+			if ((pcm->flags & PCM_OUT) && pcm->buf_idx > 0) {
+				/* pcm_drain waits for buf_idx buffers, this one is done */
+				pcm->buf_idx--;
+			}
 			count++;
 		} else if (msg.msgId == AUDIO_MSG_XRUN) {
 			/* Underrun to be handled by client */
@@ -1452,8 +1467,12 @@ int pcm_wait(struct pcm *pcm, int timeout)
 		audvdbg("avail update %d buffer_size %d\n", pcm_avail_update(pcm), pcm->buffer_size);
 		return 1;
 	}
-	int cnt = 0;
-	while (cnt < pcm->buffer_cnt - 1) {
+
+	/* A playback writer only needs the next period, waiting for more
+	 * would let the queue run dry and add latency
+	 */
+	need = (pcm->flags & PCM_OUT) ? 1 : pcm->buffer_cnt - 1;
+	while (cnt < need) {
 		/* If there were no buffers in the queue, wait for codec to put a buffer on the queue */
 		if (timeout > 0) {
 			/* Use the timeout given by application */
@@ -1480,6 +1499,9 @@ int pcm_wait(struct pcm *pcm, int timeout)
 			apb = (struct ap_buffer_s *)msg.u.pPtr;
 			apb->flags &= ~AUDIO_APB_MMAP_ENQUEUED;
 			apb->curbyte = 0;
+			if ((pcm->flags & PCM_OUT) && pcm->buf_idx > 0) {
+				pcm->buf_idx--;
+			}
 			cnt++;
 		} else if (msg.msgId == AUDIO_MSG_XRUN) {
 			/* Underrun to be handled by client */
@@ -1488,7 +1510,7 @@ int pcm_wait(struct pcm *pcm, int timeout)
 			break;
 		}
 	}
-	if (cnt == pcm->buffer_cnt - 1) {
+	if (cnt == need) {
 		return 1;
 	}
 
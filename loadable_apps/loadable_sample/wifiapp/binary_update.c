@@ -188,6 +188,8 @@ static void print_binary_info_list(binary_update_info_list_t *binary_info_list)
 		binary_info_list->bin_info[bin_idx].name, binary_info_list->bin_info[bin_idx].active_ver, \
 		binary_info_list->bin_info[bin_idx].inactive_partsize, binary_info_list->bin_info[bin_idx].active_dev, binary_info_list->bin_info[bin_idx].inactive_dev);
 	}
+	printf(" -------------------------------------------------------------------- \n");
+	printf(" Loading time until all binaries are running : %u msec\n", binary_info_list->loading_time);
 	printf(" ==================================================================== \n");
 }
 
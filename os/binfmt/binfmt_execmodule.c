@@ -300,8 +300,19 @@ int exec_module(FAR const struct binary_s *binp)
 #endif
 
 	/* Store the address of the applications userspace object in the tcb  */
-	/* The app's userspace object will be found at an offset of 4 bytes from the start of the binary */
-	((struct tcb_s *)tcb)->uspace = (uint32_t)binp->alloc[0] + 4;
+#ifdef CONFIG_ELF_XIP
+	if (binp->xip) {
+		/* gnu-elf-xip.ld places the userspace object at the start of the
+		 * text in flash, alloc[0] only holds the writable sections.
+		 */
+
+		((struct tcb_s *)tcb)->uspace = (uint32_t)binp->xiptext;
+	} else
+#endif
+	{
+		/* The app's userspace object will be found at an offset of 4 bytes from the start of the binary */
+		((struct tcb_s *)tcb)->uspace = (uint32_t)binp->alloc[0] + 4;
+	}
 
 	/* Then activate the task at the provided priority */
 
@@ -93,7 +93,15 @@ int load_binary(int binary_idx, FAR const char *filename, load_attr_t *load_attr
 	uint32_t size = load_attr->ram_size;
 	struct tcb_s *tcb;
 
-	if (mm_allocate_ram_partition(&start_addr, &size, load_attr->bin_name) < 0) {
+#ifdef CONFIG_BINMGR_PARALLEL_LOADING
+	/* Binaries can be loaded by several loading threads at the same time */
+	sched_lock();
+#endif
+	ret = mm_allocate_ram_partition(&start_addr, &size, load_attr->bin_name);
+#ifdef CONFIG_BINMGR_PARALLEL_LOADING
+	sched_unlock();
+#endif
+	if (ret < 0) {
 		berr("ERROR: Failed to allocate RAM partition\n");
 		errcode = ENOMEM;
 		goto errout;
@@ -123,6 +131,9 @@ int load_binary(int binary_idx, FAR const char *filename, load_attr_t *load_attr
 	bin->uheap_size = size;
 #endif
 	bin->compression_type = load_attr->compression_type;
+#ifdef CONFIG_ELF_XIP
+	bin->xip = load_attr->xip;
+#endif
 
 	/* Load the module into memory */
 
@@ -143,7 +154,9 @@ int load_binary(int binary_idx, FAR const char *filename, load_attr_t *load_attr
 #ifdef CONFIG_APP_BINARY_SEPARATION
 	/* The first 4 bytes of the text section of the application must contain a
 	pointer to the application's mm_heap object. Here we will store the mm_heap
-	pointer to the start of the text section */
+	pointer to the start of the text section. For the execute-in-place binary,
+	the text lies in flash and alloc[0] points to the start of the data section
+	instead, gnu-elf-xip.ld reserves its first word there. */
 	*(uint32_t *)(bin->alloc[0]) = (uint32_t)start_addr;
 	tcb = (struct tcb_s *)sched_self();
 	tcb->ram_start = (uint32_t)start_addr;
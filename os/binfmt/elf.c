@@ -244,7 +244,9 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 	loadinfo.offset = binp->offset;
 	loadinfo.filelen = binp->filelen;
 	loadinfo.compression_type = binp->compression_type;
-
+#ifdef CONFIG_ELF_XIP
+	loadinfo.xip = binp->xip;
+#endif
 
 	ret = elf_init(binp->filename, &loadinfo);
 #ifdef CONFIG_APP_BINARY_SEPARATION
@@ -265,17 +267,29 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 		goto errout_with_init;
 	}
 
-	/* Bind the program to the exported symbol table */
+#ifdef CONFIG_ELF_XIP
+	if (loadinfo.xip) {
+		/* All relocations of the execute-in-place binary were resolved at
+		 * build time and its entry point is an absolute flash address.
+		 */
 
-	ret = elf_bind(&loadinfo, binp->exports, binp->nexports);
-	if (ret != 0) {
-		berr("Failed to bind symbols program binary: %d\n", ret);
-		goto errout_with_load;
-	}
+		binp->entrypt = (main_t)loadinfo.ehdr.e_entry;
+		binp->xiptext = loadinfo.xiptext;
+	} else
+#endif
+	{
+		/* Bind the program to the exported symbol table */
+
+		ret = elf_bind(&loadinfo, binp->exports, binp->nexports);
+		if (ret != 0) {
+			berr("Failed to bind symbols program binary: %d\n", ret);
+			goto errout_with_load;
+		}
 
-	/* Return the load information */
+		/* Return the load information */
 
-	binp->entrypt = (main_t)(loadinfo.textalloc + loadinfo.ehdr.e_entry);
+		binp->entrypt = (main_t)(loadinfo.textalloc + loadinfo.ehdr.e_entry);
+	}
 	if (binp->stacksize == 0) {
 		binp->stacksize = CONFIG_ELF_STACKSIZE;
 	}
@@ -57,6 +57,9 @@
 #include <tinyara/config.h>
 
 #include <sys/types.h>
+#ifdef CONFIG_ELF_XIP
+#include <sys/ioctl.h>
+#endif
 
 #include <stdint.h>
 #include <stdlib.h>
@@ -70,6 +73,9 @@
 #include <tinyara/addrenv.h>
 #include <tinyara/mm/mm.h>
 #include <tinyara/binfmt/elf.h>
+#ifdef CONFIG_ELF_XIP
+#include <tinyara/fs/ioctl.h>
+#endif
 
 #include "libelf.h"
 
@@ -146,6 +152,54 @@ static void elf_elfsize(struct elf_loadinfo_s *loadinfo)
 	loadinfo->datasize = datasize;
 }
 
+/****************************************************************************
+ * Name: elf_xipinit
+ *
+ * Description:
+ *   Prepare the execute-in-place load of a pre-linked ELF file.  The
+ *   memory-mapped address of the ELF file is looked up so that the text
+ *   sections can be verified against it and the RAM allocation is reduced
+ *   to the writable sections.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_XIP
+static int elf_xipinit(FAR struct elf_loadinfo_s *loadinfo)
+{
+	FAR void *base = NULL;
+	int ret;
+
+	if (loadinfo->ehdr.e_type != ET_EXEC) {
+		berr("ERROR: XIP binary is not pre-linked: e_type=%d\n", loadinfo->ehdr.e_type);
+		return -EINVAL;
+	}
+
+	if (loadinfo->compression_type != COMPRESS_TYPE_NONE) {
+		berr("ERROR: XIP binary cannot be compressed: %d\n", loadinfo->compression_type);
+		return -EINVAL;
+	}
+
+	ret = ioctl(loadinfo->filfd, BIOC_XIPBASE, (unsigned long)((uintptr_t)&base));
+	if (ret < 0 || base == NULL) {
+		berr("ERROR: Failed to get XIP base address: %d\n", ret);
+		return -ENOSYS;
+	}
+
+	loadinfo->xipbase = (uintptr_t)base + loadinfo->offset;
+	loadinfo->xiptext = 0;
+	binfo("XIP base: %08lx\n", (unsigned long)loadinfo->xipbase);
+
+	/* Text sections are executed from flash and need no RAM */
+
+	loadinfo->textsize = 0;
+	return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: elf_loadfile
  *
@@ -193,6 +247,34 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
 			pptr = &text;
 		}
 
+#ifdef CONFIG_ELF_XIP
+		if (loadinfo->xip) {
+			/* The image was linked at its final addresses.  Read-only
+			 * sections must match their location in flash and writable
+			 * sections must match their location in the RAM allocation.
+			 */
+
+			if (pptr == &text) {
+				if (shdr->sh_addr != loadinfo->xipbase + shdr->sh_offset) {
+					berr("ERROR: Section %d linked at %08lx, but lies at %08lx\n", i, (unsigned long)shdr->sh_addr, (unsigned long)(loadinfo->xipbase + shdr->sh_offset));
+					return -ENOEXEC;
+				}
+
+				if (loadinfo->xiptext == 0 || shdr->sh_addr < loadinfo->xiptext) {
+					loadinfo->xiptext = shdr->sh_addr;
+				}
+
+				binfo("%d. %08lx (XIP)\n", i, (unsigned long)shdr->sh_addr);
+				continue;
+			}
+
+			if (shdr->sh_addr != (uintptr_t)*pptr) {
+				berr("ERROR: Section %d linked at %08lx, but loaded at %08lx\n", i, (unsigned long)shdr->sh_addr, (unsigned long)*pptr);
+				return -ENOEXEC;
+			}
+		}
+#endif
+
 		/* SHT_NOBITS indicates that there is no data in the file for the
 		 * section.
 		 */
@@ -269,6 +351,20 @@ int elf_load(FAR struct elf_loadinfo_s *loadinfo)
 
 	elf_elfsize(loadinfo);
 
+#ifdef CONFIG_ELF_XIP
+	if (loadinfo->xip) {
+		ret = elf_xipinit(loadinfo);
+		if (ret < 0) {
+			berr("ERROR: elf_xipinit failed: %d\n", ret);
+			goto errout_with_buffers;
+		}
+	} else if (loadinfo->ehdr.e_type != ET_REL) {
+		berr("ERROR: Not a relocatable file: e_type=%d\n", loadinfo->ehdr.e_type);
+		ret = -EINVAL;
+		goto errout_with_buffers;
+	}
+#endif
+
 	/* Determine the heapsize to allocate.  heapsize is ignored if there is
 	 * no address environment because the heap is a shared resource in that
 	 * case.  If there is no dynamic stack then heapsize must at least as big
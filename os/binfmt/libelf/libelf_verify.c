@@ -96,7 +96,8 @@ static const char g_elfmagic[EI_MAGIC_SIZE] = {
  *
  *   -ENOEXEC  : Not an ELF file
  *   -EINVAL : Not a relocatable ELF file or not supported by the current,
- *               configured architecture.
+ *               configured architecture.  If CONFIG_ELF_XIP is enabled,
+ *               pre-linked executable files are accepted as well.
  *
  ****************************************************************************/
 
@@ -116,7 +117,11 @@ int elf_verifyheader(FAR const Elf32_Ehdr *ehdr)
 
 	/* Verify that this is a relocatable file */
 
+#ifdef CONFIG_ELF_XIP
+	if (ehdr->e_type != ET_REL && ehdr->e_type != ET_EXEC) {
+#else
 	if (ehdr->e_type != ET_REL) {
+#endif
 		berr("Not a relocatable file: e_type=%d\n", ehdr->e_type);
 		return -EINVAL;
 	}
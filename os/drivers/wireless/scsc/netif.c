@@ -27,6 +27,7 @@
 #include <tinyara/kmalloc.h>
 #include <tinyara/clock.h>
 #include <tinyara/net/net.h>
+#include <tinyara/net/ethernet.h>
 #include <arpa/inet.h>
 #include <net/lwip/netif/etharp.h>
 #include <net/lwip/ethip6.h>
@@ -387,6 +388,23 @@ void slsi_ethernetif_input(struct netif *dev, u8_t *frame_ptr, u16_t len)
 	SLSI_MUTEX_UNLOCK(sdev->rx_data_mutex);
 }
 
+#ifdef CONFIG_NET_ETHERNET_RXLOAN
+static void slsi_ethernetif_rx_release(void *arg)
+{
+	slsi_kfree_mbuf((struct max_buff *)arg);
+}
+
+/* Pass the mbuf to lwIP without copying it, lwIP frees it when done */
+void slsi_ethernetif_input_loan(struct netif *dev, struct max_buff *mbuf)
+{
+	struct netdev_vif *ndev_vif = netdev_priv(dev);
+	struct slsi_dev *sdev = ndev_vif->sdev;
+
+	SLSI_INCR_DATA_PATH_STATS(sdev->dp_stats.rx_num_packets_given_to_lwip);
+	ethernetif_input_loan(dev, slsi_mbuf_get_data(mbuf), mbuf->data_len, slsi_ethernetif_rx_release, mbuf);
+}
+#endif
+
 static err_t slsi_linkoutput(struct netif *dev, struct pbuf *buf)
 {
 	struct netdev_vif *ndev_vif = netdev_priv(dev);
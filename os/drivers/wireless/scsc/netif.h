@@ -115,4 +115,8 @@ void slsi_netif_remove(struct slsi_dev *sdev, struct netif *dev);
 void slsi_netif_remove_all(struct slsi_dev *sdev);
 void slsi_netif_deinit(struct slsi_dev *sdev);
 void slsi_ethernetif_input(struct netif *netif, u8_t *frame_ptr, u16_t len);
+#ifdef CONFIG_NET_ETHERNET_RXLOAN
+struct max_buff;
+void slsi_ethernetif_input_loan(struct netif *netif, struct max_buff *mbuf);
+#endif
 #endif /*__SLSI_NETIF_H__*/
@@ -296,10 +296,14 @@ int slsi_rx_data(struct slsi_dev *sdev, struct netif *dev, struct max_buff *mbuf
 	if (slsi_rx_data_process_mbuf(sdev, dev, mbuf, fromBA) == 0) {
 #ifdef CONFIG_SLSI_RX_PERFORMANCE_TEST
 		slsi_rx_performance_test(sdev, dev, mbuf);
+		slsi_kfree_mbuf(mbuf);
+#elif defined(CONFIG_NET_ETHERNET_RXLOAN)
+		/* lwIP frees the mbuf once the packet is consumed */
+		slsi_ethernetif_input_loan(dev, mbuf);
 #else
 		slsi_ethernetif_input(dev, slsi_mbuf_get_data(mbuf), mbuf->data_len);
-#endif
 		slsi_kfree_mbuf(mbuf);
+#endif
 	}
 	return 0;
 }
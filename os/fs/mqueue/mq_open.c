@@ -202,6 +202,16 @@ mqd_t mq_open(FAR const char *mq_name, int oflags, ...)
 			goto errout_with_inode;
 		}
 
+#ifdef CONFIG_MQ_SPSC
+		/* Preallocate the ring of a single-producer/single-consumer queue */
+
+		if ((oflags & O_SPSC) != 0 && mq_spsc_alloc(msgq) != OK) {
+			errcode = ENOSPC;
+			mq_msgqfree(msgq);
+			goto errout_with_inode;
+		}
+#endif
+
 		/* Create a message queue descriptor for the TCB */
 
 		mqdes = mq_descreate(NULL, msgq, oflags);
@@ -113,7 +113,13 @@ int close(int fd)
 		/* Close a socket descriptor */
 
 #if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+#ifdef CONFIG_NET_SOCKET_EPOLL
+		/* epoll descriptors follow the socket descriptors */
+
+		if ((unsigned int)fd < (CONFIG_NFILE_DESCRIPTORS + CONFIG_NSOCKET_DESCRIPTORS + CONFIG_NET_SOCKET_EPOLL_MAX)) {
+#else
 		if ((unsigned int)fd < (CONFIG_NFILE_DESCRIPTORS + CONFIG_NSOCKET_DESCRIPTORS)) {
+#endif
 			ret = net_close(fd);
 			leave_cancellation_point();
 			return ret;
@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/vfs/fs_sendfile.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/sendfile.h>
+#include <errno.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/net/net.h>
+
+#if defined(CONFIG_NET_SENDFILE) && CONFIG_NFILE_DESCRIPTORS > 0
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile
+ *
+ * Description:
+ *   sendfile() copies data between one file descriptor and another. When
+ *   'infd' is a file and 'outfd' a TCP socket, the file is read directly
+ *   into network buffers which are queued on the connection by reference
+ *   (see net_sendfile()). All other cases are handled by lib_sendfile().
+ *
+ *   See include/sys/sendfile.h for the parameters and returned value.
+ *
+ ****************************************************************************/
+
+ssize_t sendfile(int outfd, int infd, FAR off_t *offset, size_t count)
+{
+	FAR struct file *filep;
+	ssize_t ret;
+
+	if ((unsigned int)outfd >= CONFIG_NFILE_DESCRIPTORS && (unsigned int)outfd < (CONFIG_NFILE_DESCRIPTORS + CONFIG_NSOCKET_DESCRIPTORS) && (unsigned int)infd < CONFIG_NFILE_DESCRIPTORS) {
+		filep = fs_getfilep(infd);
+		if (filep == NULL) {
+			/* fs_getfilep() has set errno */
+
+			return ERROR;
+		}
+
+		ret = net_sendfile(outfd, filep, offset, count);
+		if (ret >= 0 || get_errno() != ENOSYS) {
+			return ret;
+		}
+
+		/* Not a TCP socket, use the generic read/write loop */
+	}
+
+	return lib_sendfile(outfd, infd, offset, count);
+}
+
+#endif							/* CONFIG_NET_SENDFILE && CONFIG_NFILE_DESCRIPTORS > 0 */
@@ -77,6 +77,14 @@
 
 #define MQ_NONBLOCK O_NONBLOCK
 
+/* Non-standard mq_open() flag used with O_CREAT.  The queue is created as a
+ * single-producer/single-consumer ring: it must have only one sender and
+ * one receiver, and messages are delivered in FIFO order regardless of
+ * their priority.
+ */
+
+#define O_SPSC      (1 << 12)
+
 /********************************************************************************
  * Global Type Declarations
  ********************************************************************************/
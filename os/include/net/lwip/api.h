@@ -345,9 +345,15 @@ err_t netconn_recv(struct netconn *conn, struct netbuf **new_buf);
 err_t netconn_recv_tcp_pbuf(struct netconn *conn, struct pbuf **new_buf);
 err_t netconn_sendto(struct netconn *conn, struct netbuf *buf, const ip_addr_t *addr, u16_t port);
 err_t netconn_send(struct netconn *conn, struct netbuf *buf);
+#if LWIP_SOCKET_MMSG
+err_t netconn_send_multi(struct netconn *conn, struct netbuf **bufs, u16_t count, u16_t *sent);
+#endif
 err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written);
 #define netconn_write(conn, dataptr, size, apiflags) \
 		netconn_write_partly(conn, dataptr, size, apiflags, NULL)
+#if LWIP_SENDFILE
+err_t netconn_write_ref(struct netconn *conn, struct pbuf *ref, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written);
+#endif
 err_t netconn_close(struct netconn *conn);
 err_t netconn_shutdown(struct netconn *conn, u8_t shut_rx, u8_t shut_tx);
 
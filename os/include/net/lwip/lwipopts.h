@@ -432,6 +432,42 @@
 #define TCP_TIMESTAMPS	CONFIG_NET_TCP_TIMESTAMPS
 #endif
 
+#ifdef CONFIG_NET_TCP_SACK
+#define LWIP_TCP_SACK	CONFIG_NET_TCP_SACK
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK_MAX_BLOCKS
+#define TCP_SACK_MAX_BLOCKS	CONFIG_NET_TCP_SACK_MAX_BLOCKS
+#endif
+
+#ifdef CONFIG_NET_TCP_PCB_HASH
+#define LWIP_TCP_PCB_HASH	CONFIG_NET_TCP_PCB_HASH
+#endif
+
+#ifdef CONFIG_NET_TCP_PCB_HASH_SIZE
+#define TCP_PCB_HASH_SIZE	CONFIG_NET_TCP_PCB_HASH_SIZE
+#endif
+
+#ifdef CONFIG_NET_ETHERNET_RXLOAN
+#define LWIP_SUPPORT_CUSTOM_PBUF	1
+#endif
+
+#ifdef CONFIG_NET_SENDFILE
+#define LWIP_SENDFILE			CONFIG_NET_SENDFILE
+#define LWIP_SENDFILE_BUFSIZE		CONFIG_NET_SENDFILE_BUFSIZE
+#endif
+
+#ifdef CONFIG_NET_SOCKET_EPOLL
+#define LWIP_SOCKET_EPOLL		CONFIG_NET_SOCKET_EPOLL
+#define LWIP_SOCKET_EPOLL_MAX		CONFIG_NET_SOCKET_EPOLL_MAX
+#define LWIP_SOCKET_EPOLL_ITEMS		CONFIG_NET_SOCKET_EPOLL_ITEMS
+#endif
+
+#ifdef CONFIG_NET_SOCKET_MMSG
+#define LWIP_SOCKET_MMSG		CONFIG_NET_SOCKET_MMSG
+#define LWIP_SOCKET_MMSG_BATCH		CONFIG_NET_SOCKET_MMSG_BATCH
+#endif
+
 #ifdef CONFIG_NET_TCP_KEEPALIVE
 #define LWIP_TCP_KEEPALIVE              CONFIG_NET_TCP_KEEPALIVE
 #endif
@@ -457,6 +493,14 @@
 #define LWIP_UDPLITE	CONFIG_NET_UDPLITE
 #endif
 
+#ifdef CONFIG_NET_UDP_PCB_HASH
+#define LWIP_UDP_PCB_HASH	CONFIG_NET_UDP_PCB_HASH
+#endif
+
+#ifdef CONFIG_NET_UDP_PCB_HASH_SIZE
+#define UDP_PCB_HASH_SIZE	CONFIG_NET_UDP_PCB_HASH_SIZE
+#endif
+
 #ifdef CONFIG_NET_NETBUF_RECVINFO
 #define LWIP_NETBUF_RECVINFO	CONFIG_NET_NETBUF_RECVINFO
 #endif
@@ -382,6 +382,15 @@
 #define MEMP_NUM_TCP_SEG                16
 #endif
 
+/**
+ * MEMP_NUM_TCP_PBUF_REF: the number of TCP segments that reference the
+ * payload of another pbuf, queued by tcp_write_ref().
+ * (requires the LWIP_SENDFILE option)
+ */
+#ifndef MEMP_NUM_TCP_PBUF_REF
+#define MEMP_NUM_TCP_PBUF_REF           MEMP_NUM_TCP_SEG
+#endif
+
 /**
  * MEMP_NUM_REASSDATA: the number of IP packets simultaneously queued for
  * reassembly (whole packets, not fragments!)
@@ -1093,6 +1102,21 @@
 #define UDP_TTL                         (IP_DEFAULT_TTL)
 #endif
 
+/**
+ * LWIP_UDP_PCB_HASH==1: look up the pcb of an incoming datagram in a table
+ * indexed by local port instead of walking the whole udp_pcbs list.
+ */
+#ifndef LWIP_UDP_PCB_HASH
+#define LWIP_UDP_PCB_HASH               0
+#endif
+
+/**
+ * UDP_PCB_HASH_SIZE: number of buckets of the UDP port table.
+ */
+#ifndef UDP_PCB_HASH_SIZE
+#define UDP_PCB_HASH_SIZE               16
+#endif
+
 /**
  * LWIP_NETBUF_RECVINFO==1: append destination addr and port to every netbuf.
  */
@@ -1277,6 +1301,43 @@
 #define LWIP_TCP_TIMESTAMPS             0
 #endif
 
+/**
+ * LWIP_TCP_SACK==1: support TCP selective acknowledgments (RFC 2018).
+ * SACK is only used on a connection when both ends sent the SACK-permitted
+ * option in their SYN. Out-of-order segments (see TCP_QUEUE_OOSEQ) are then
+ * reported in the ACKs we send, and the SACK blocks we receive are kept on
+ * the unacked queue so that loss recovery only retransmits the holes.
+ */
+#ifndef LWIP_TCP_SACK
+#define LWIP_TCP_SACK                   0
+#endif
+
+/**
+ * TCP_SACK_MAX_BLOCKS: maximum number of SACK blocks sent in one ACK
+ * (1..4). At most 3 fit next to the timestamp option.
+ */
+#ifndef TCP_SACK_MAX_BLOCKS
+#define TCP_SACK_MAX_BLOCKS             3
+#endif
+
+/**
+ * LWIP_TCP_PCB_HASH==1: demultiplex incoming segments through hash tables
+ * instead of walking the pcb lists. Active and TIME-WAIT pcbs are indexed by
+ * their ports and remote address, listening pcbs by their local port. The
+ * lists are kept for the timers and all other iterations.
+ */
+#ifndef LWIP_TCP_PCB_HASH
+#define LWIP_TCP_PCB_HASH               0
+#endif
+
+/**
+ * TCP_PCB_HASH_SIZE: number of buckets of each TCP pcb table. Around the
+ * number of concurrent connections is a good value.
+ */
+#ifndef TCP_PCB_HASH_SIZE
+#define TCP_PCB_HASH_SIZE               32
+#endif
+
 /**
  * TCP_WND_UPDATE_THRESHOLD: difference in window to trigger an
  * explicit window update
@@ -1757,6 +1818,70 @@
 #define LWIP_SOCKET_OFFSET              0
 #endif
 
+/**
+ * LWIP_SOCKET_EPOLL==1: Enable lwip_epoll_create/ctl/wait. Socket events are
+ * pushed into the ready list of every epoll instance watching the socket, so
+ * a wait costs time proportional to the ready sockets instead of the watched
+ * ones. Epoll descriptors follow the socket descriptors, starting at
+ * LWIP_SOCKET_OFFSET + MEMP_NUM_NETCONN.
+ */
+#ifndef LWIP_SOCKET_EPOLL
+#define LWIP_SOCKET_EPOLL               0
+#endif
+
+/**
+ * LWIP_SOCKET_EPOLL_MAX: the number of epoll instances that can be open at
+ * the same time.
+ */
+#ifndef LWIP_SOCKET_EPOLL_MAX
+#define LWIP_SOCKET_EPOLL_MAX           1
+#endif
+
+/**
+ * LWIP_SOCKET_EPOLL_ITEMS: the number of socket registrations shared by all
+ * epoll instances.
+ */
+#ifndef LWIP_SOCKET_EPOLL_ITEMS
+#define LWIP_SOCKET_EPOLL_ITEMS         MEMP_NUM_NETCONN
+#endif
+
+/**
+ * LWIP_SOCKET_MMSG==1: Enable lwip_recvmmsg() and lwip_sendmmsg(), which move
+ * several datagrams per call. Datagrams sent in one call are handed to the
+ * tcpip thread in batches of LWIP_SOCKET_MMSG_BATCH netbufs, one message
+ * each, instead of one message per datagram.
+ */
+#ifndef LWIP_SOCKET_MMSG
+#define LWIP_SOCKET_MMSG                0
+#endif
+
+/**
+ * LWIP_SOCKET_MMSG_BATCH: the number of datagrams lwip_sendmmsg() passes to
+ * the tcpip thread at once. The netbuf pointers live on the caller's stack.
+ */
+#ifndef LWIP_SOCKET_MMSG_BATCH
+#define LWIP_SOCKET_MMSG_BATCH          8
+#endif
+
+/**
+ * LWIP_SENDFILE==1: Enable tcp_write_ref() and netconn_write_ref(), which
+ * queue the payload of a pbuf for sending without copying it. The queued
+ * segments hold a reference on the pbuf until they are acknowledged. This is
+ * used by the kernel sendfile() to send file data without a second copy.
+ */
+#ifndef LWIP_SENDFILE
+#define LWIP_SENDFILE                   0
+#endif
+
+/**
+ * LWIP_SENDFILE_BUFSIZE: the size of the buffers sendfile() reads the file
+ * into. Each buffer is sent by reference, so a multiple of TCP_MSS avoids
+ * short segments.
+ */
+#ifndef LWIP_SENDFILE_BUFSIZE
+#define LWIP_SENDFILE_BUFSIZE           (2 * TCP_MSS)
+#endif
+
 /**
  * LWIP_TCP_KEEPALIVE==1: Enable TCP_KEEPIDLE, TCP_KEEPINTVL and TCP_KEEPCNT
  * options processing. Note that TCP_KEEPIDLE and TCP_KEEPINTVL have to be set
@@ -103,6 +103,15 @@ struct api_msg {
 	union {
 		/** used for lwip_netconn_do_send */
 		struct netbuf *b;
+#if LWIP_SOCKET_MMSG
+		/** used for lwip_netconn_do_send_multi */
+		struct {
+			struct netbuf **bufs;
+			u16_t count;
+			/** number of netbufs sent, set by the tcpip thread */
+			u16_t sent;
+		} bm;
+#endif
 		/** used for lwip_netconn_do_newconn */
 		struct {
 			u8_t proto;
@@ -123,6 +132,10 @@ struct api_msg {
 			const void *dataptr;
 			size_t len;
 			u8_t apiflags;
+#if LWIP_SENDFILE
+			/** pbuf holding dataptr, sent by reference if not NULL */
+			struct pbuf *ref;
+#endif
 #if LWIP_SO_SNDTIMEO
 			u32_t time_started;
 #endif							/* LWIP_SO_SNDTIMEO */
@@ -204,6 +217,9 @@ void lwip_netconn_do_connect(void *m);
 void lwip_netconn_do_disconnect(void *m);
 void lwip_netconn_do_listen(void *m);
 void lwip_netconn_do_send(void *m);
+#if LWIP_SOCKET_MMSG
+void lwip_netconn_do_send_multi(void *m);
+#endif
 void lwip_netconn_do_recv(void *m);
 #if TCP_LISTEN_BACKLOG
 void lwip_netconn_do_accepted(void *m);
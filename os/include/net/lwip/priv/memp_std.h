@@ -64,6 +64,9 @@ LWIP_MEMPOOL(RAW_PCB, MEMP_NUM_RAW_PCB, sizeof(struct raw_pcb), "RAW_PCB")
 	LWIP_MEMPOOL(TCP_PCB, MEMP_NUM_TCP_PCB, sizeof(struct tcp_pcb), "TCP_PCB")
 	LWIP_MEMPOOL(TCP_PCB_LISTEN, MEMP_NUM_TCP_PCB_LISTEN, sizeof(struct tcp_pcb_listen), "TCP_PCB_LISTEN")
 	LWIP_MEMPOOL(TCP_SEG, MEMP_NUM_TCP_SEG, sizeof(struct tcp_seg), "TCP_SEG")
+#if LWIP_SENDFILE && !LWIP_NETIF_TX_SINGLE_PBUF
+	LWIP_MEMPOOL(TCP_PBUF_REF, MEMP_NUM_TCP_PBUF_REF, sizeof(struct pbuf_custom_ref), "TCP_PBUF_REF")
+#endif							/* LWIP_SENDFILE && !LWIP_NETIF_TX_SINGLE_PBUF */
 #endif							/* LWIP_TCP */
 #if LWIP_IPV4 && IP_REASSEMBLY
 	LWIP_MEMPOOL(REASSDATA, MEMP_NUM_REASSDATA, sizeof(struct ip_reassdata), "REASSDATA")
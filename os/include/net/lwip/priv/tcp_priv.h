@@ -99,6 +99,9 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb);
 void tcp_rexmit(struct tcp_pcb *pcb);
 void tcp_rexmit_rto(struct tcp_pcb *pcb);
 void tcp_rexmit_fast(struct tcp_pcb *pcb);
+#if LWIP_TCP_SACK
+void tcp_rexmit_sack(struct tcp_pcb *pcb);
+#endif
 u32_t tcp_update_rcv_ann_wnd(struct tcp_pcb *pcb);
 err_t tcp_process_refused_data(struct tcp_pcb *pcb);
 
@@ -279,13 +282,32 @@ struct tcp_seg {
 #define TF_SEG_DATA_CHECKSUMMED (u8_t)0x04U	/* ALL data (not the header) is
 											   checksummed into 'chksum' */
 #define TF_SEG_OPTS_WND_SCALE   (u8_t)0x08U	/* Include WND SCALE option */
+#define TF_SEG_OPTS_SACK_PERM   (u8_t)0x10U	/* Include SACK Permitted option */
+#define TF_SEG_SACKED           (u8_t)0x20U	/* Unacked segment was SACKed by the peer */
 	struct tcp_hdr *tcphdr;	/* the TCP header */
 };
 
+#if LWIP_SENDFILE && !LWIP_NETIF_TX_SINGLE_PBUF
+#ifndef LWIP_PBUF_CUSTOM_REF_DEFINED
+#define LWIP_PBUF_CUSTOM_REF_DEFINED
+/** A custom pbuf that holds a reference to another pbuf, which is freed
+ * when this custom pbuf is freed. This is used to create a custom PBUF_REF
+ * that points into the original pbuf. */
+struct pbuf_custom_ref {
+	/** 'base class' */
+	struct pbuf_custom pc;
+	/** pointer to the original pbuf that is referenced */
+	struct pbuf *original;
+};
+#endif							/* LWIP_PBUF_CUSTOM_REF_DEFINED */
+#endif							/* LWIP_SENDFILE && !LWIP_NETIF_TX_SINGLE_PBUF */
+
 #define LWIP_TCP_OPT_EOL        0
 #define LWIP_TCP_OPT_NOP        1
 #define LWIP_TCP_OPT_MSS        2
 #define LWIP_TCP_OPT_WS         3
+#define LWIP_TCP_OPT_SACK_PERM  4
+#define LWIP_TCP_OPT_SACK       5
 #define LWIP_TCP_OPT_TS         8
 
 #define LWIP_TCP_OPT_LEN_MSS    4
@@ -302,10 +324,23 @@ struct tcp_seg {
 #define LWIP_TCP_OPT_LEN_WS_OUT 0
 #endif
 
+#if LWIP_TCP_SACK
+#define LWIP_TCP_OPT_LEN_SACK_PERM     2
+#define LWIP_TCP_OPT_LEN_SACK_PERM_OUT 4	/* aligned for output (includes NOP padding) */
+#define LWIP_TCP_OPT_LEN_SACK_BLOCK    8
+/* SACK option holding n blocks, aligned for output (includes NOP padding) */
+#define LWIP_TCP_OPT_LEN_SACK_OUT(n)   (4 + (n) * LWIP_TCP_OPT_LEN_SACK_BLOCK)
+/* a SACK option never carries more than 4 blocks (40 bytes of options) */
+#define LWIP_TCP_SACK_BLOCKS_MAX       4
+#else
+#define LWIP_TCP_OPT_LEN_SACK_PERM_OUT 0
+#endif
+
 #define LWIP_TCP_OPT_LENGTH(flags) \
 		(flags & TF_SEG_OPTS_MSS       ? LWIP_TCP_OPT_LEN_MSS    : 0) + \
 		(flags & TF_SEG_OPTS_TS        ? LWIP_TCP_OPT_LEN_TS_OUT : 0) + \
-		(flags & TF_SEG_OPTS_WND_SCALE ? LWIP_TCP_OPT_LEN_WS_OUT : 0)
+		(flags & TF_SEG_OPTS_WND_SCALE ? LWIP_TCP_OPT_LEN_WS_OUT : 0) + \
+		(flags & TF_SEG_OPTS_SACK_PERM ? LWIP_TCP_OPT_LEN_SACK_PERM_OUT : 0)
 
 /** This returns a TCP header option for MSS in an u32_t */
 #define TCP_BUILD_MSS_OPTION(mss) lwip_htonl(0x02040000 | ((mss) & 0xFFFF))
@@ -349,6 +384,24 @@ extern struct tcp_pcb **const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
    3) All PCBs in the tcp_listen_pcbs list is in LISTEN state.
    4) All PCBs in the tcp_tw_pcbs list is in TIME-WAIT state.
 */
+#if LWIP_TCP_PCB_HASH
+/* Demux tables mirroring the active, TIME-WAIT and listen lists, chained
+   through hash_next. Bound pcbs are never looked up on input. */
+extern struct tcp_pcb *tcp_active_hash[TCP_PCB_HASH_SIZE];
+extern struct tcp_pcb *tcp_tw_hash[TCP_PCB_HASH_SIZE];
+extern union tcp_listen_pcbs_t tcp_listen_hash[TCP_PCB_HASH_SIZE];
+
+#define TCP_PCB_HASH_PORT(port) ((port) % TCP_PCB_HASH_SIZE)
+u16_t tcp_pcb_hash(u16_t local_port, const ip_addr_t *remote_ip, u16_t remote_port);
+void tcp_pcb_hash_add(struct tcp_pcb **pcbs, struct tcp_pcb *pcb);
+void tcp_pcb_hash_remove(struct tcp_pcb **pcbs, struct tcp_pcb *pcb);
+#define TCP_HASH_ADD(pcbs, npcb) tcp_pcb_hash_add((pcbs), (npcb))
+#define TCP_HASH_RMV(pcbs, npcb) tcp_pcb_hash_remove((pcbs), (npcb))
+#else
+#define TCP_HASH_ADD(pcbs, npcb)
+#define TCP_HASH_RMV(pcbs, npcb)
+#endif							/* LWIP_TCP_PCB_HASH */
+
 /* Define two macros, TCP_REG and TCP_RMV that registers a TCP PCB
    with a PCB list or removes a PCB from a list, respectively. */
 #ifndef TCP_DEBUG_PCB_LISTS
@@ -367,6 +420,7 @@ extern struct tcp_pcb **const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
 		(npcb)->next = *(pcbs); \
 		LWIP_ASSERT("TCP_REG: npcb->next != npcb", (npcb)->next != (npcb)); \
 		*(pcbs) = (npcb); \
+		TCP_HASH_ADD(pcbs, npcb); \
 		LWIP_ASSERT("TCP_RMV: tcp_pcbs sane", tcp_pcbs_sane()); \
 		tcp_timer_needed(); \
 	} while (0)
@@ -383,6 +437,7 @@ extern struct tcp_pcb **const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
 			} \
 		} \
 		(npcb)->next = NULL; \
+		TCP_HASH_RMV(pcbs, npcb); \
 		LWIP_ASSERT("TCP_RMV: tcp_pcbs sane", tcp_pcbs_sane()); \
 		LWIP_DEBUGF(TCP_DEBUG, ("TCP_RMV: removed %p from %p\n", (npcb), *(pcbs))); \
 	} while (0)
@@ -393,6 +448,7 @@ extern struct tcp_pcb **const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
 	do {                                             \
 		(npcb)->next = *pcbs;                          \
 		*(pcbs) = (npcb);                              \
+		TCP_HASH_ADD(pcbs, npcb);                      \
 		tcp_timer_needed();                            \
 	} while (0)
 
@@ -413,6 +469,7 @@ extern struct tcp_pcb **const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
 			}                                            \
 		}                                              \
 		(npcb)->next = NULL;                           \
+		TCP_HASH_RMV(pcbs, npcb);                      \
 	} while (0)
 
 #endif							/* LWIP_DEBUG */
@@ -69,6 +69,9 @@
 
 #include <sys/select.h>
 #include <sys/uio.h>
+#if LWIP_SOCKET_EPOLL
+#include <sys/epoll.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -167,6 +170,7 @@ struct lwip_setgetsockopt_data {
 #endif /* IOV_MAX */
 
 struct msghdr;
+struct mmsghdr;
 
 /* struct msghdr->msg_flags bit field values */
 #define MSG_TRUNC   0x04
@@ -287,6 +291,7 @@ struct linger {
 #define MSG_OOB        0x04		/* Unimplemented: Requests out-of-band data. The significance and semantics of out-of-band data are protocol-specific */
 #define MSG_DONTWAIT   0x08		/* Nonblocking i/o for this operation only */
 #define MSG_MORE       0x10		/* Sender will send more */
+#define MSG_WAITFORONE 0x20		/* recvmmsg(): only wait for the first datagram */
 
 /*
  * Options for level IPPROTO_IP
@@ -492,6 +497,11 @@ int lwip_read(int s, void *mem, size_t len);
 int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from, socklen_t * fromlen);
 int lwip_send(int s, const void *dataptr, size_t size, int flags);
 int lwip_sendmsg(int s, const struct msghdr *message, int flags);
+#if LWIP_SOCKET_MMSG
+struct timespec;
+int lwip_recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout);
+int lwip_sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags);
+#endif
 int lwip_sendto(int s, const void *dataptr, size_t size, int flags, const struct sockaddr *to, socklen_t tolen);
 int lwip_socket(int domain, int type, int protocol);
 int lwip_write(int s, const void *dataptr, size_t size);
@@ -501,6 +511,11 @@ int lwip_ioctl(int s, long cmd, void *argp);
 int lwip_fcntl(int s, int cmd, int val);
 
 int lwip_poll(int fd, struct pollfd *fds, bool setup);
+#if LWIP_SOCKET_EPOLL
+int lwip_epoll_create(int size);
+int lwip_epoll_ctl(int epfd, int op, int fd, struct epoll_event *event);
+int lwip_epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout);
+#endif
 #ifdef __cplusplus
 }
 #endif
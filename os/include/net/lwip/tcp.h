@@ -154,7 +154,7 @@ typedef u32_t tcpwnd_size_t;
 typedef u16_t tcpwnd_size_t;
 #endif
 
-#if LWIP_WND_SCALE || TCP_LISTEN_BACKLOG || LWIP_TCP_TIMESTAMPS
+#if LWIP_WND_SCALE || TCP_LISTEN_BACKLOG || LWIP_TCP_TIMESTAMPS || LWIP_TCP_SACK
 typedef u16_t tcpflags_t;
 #else
 typedef u8_t tcpflags_t;
@@ -174,11 +174,19 @@ enum tcp_state {
 	TIME_WAIT = 10
 };
 
+#if LWIP_TCP_PCB_HASH
+#define TCP_PCB_HASH_COMMON(type) \
+		type *hash_next; /* for the demux hash chain */
+#else
+#define TCP_PCB_HASH_COMMON(type)
+#endif
+
 /**
  * members common to struct tcp_pcb and struct tcp_listen_pcb
  */
 #define TCP_PCB_COMMON(type) \
 		type *next; /* for the linked list */ \
+		TCP_PCB_HASH_COMMON(type) \
 		void *callback_arg; \
 		enum tcp_state state; /* TCP state */ \
 		u8_t prio; \
@@ -230,6 +238,9 @@ struct tcp_pcb {
 #endif
 #if LWIP_TCP_TIMESTAMPS
 #define TF_TIMESTAMP   0x0400U	/* Timestamp option enabled */
+#endif
+#if LWIP_TCP_SACK
+#define TF_SACK        0x0800U	/* SACK option enabled */
 #endif
 
 	/* the rest of the fields are in host byte order
@@ -315,6 +326,16 @@ struct tcp_pcb {
 	u32_t ts_recent;
 #endif							/* LWIP_TCP_TIMESTAMPS */
 
+#if LWIP_TCP_SACK
+	/* receiver: start of the most recently queued out-of-order segment,
+	   its block is reported first */
+	u32_t rcv_sack_recent;
+	/* sender scoreboard, SACKed segments are marked on ->unacked */
+	u32_t sack_high;		/* highest sequence number SACKed by the peer */
+	u32_t sack_recover;		/* snd_nxt when fast recovery was entered */
+	u32_t sack_rexmit;		/* holes below this were retransmitted already */
+#endif							/* LWIP_TCP_SACK */
+
 	/* idle time before KEEPALIVE is sent */
 	u32_t keep_idle;
 #if LWIP_TCP_KEEPALIVE
@@ -409,6 +430,9 @@ err_t tcp_shutdown(struct tcp_pcb *pcb, int shut_rx, int shut_tx);
 #define TCP_WRITE_FLAG_MORE 0x02
 
 err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags);
+#if LWIP_SENDFILE
+err_t tcp_write_ref(struct tcp_pcb *pcb, struct pbuf *ref, const void *dataptr, u16_t len, u8_t apiflags);
+#endif
 
 void tcp_setprio(struct tcp_pcb *pcb, u8_t prio);
 
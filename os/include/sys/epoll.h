@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @defgroup EPOLL_KERNEL EPOLL
+ * @brief Provides APIs for epoll
+ * @ingroup KERNEL
+ *
+ * @{
+ */
+
+/// @file sys/epoll.h
+/// @brief I/O event notification APIs for sockets
+
+#ifndef __INCLUDE_SYS_EPOLL_H
+#define __INCLUDE_SYS_EPOLL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_NET_SOCKET_EPOLL
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/* Operations for epoll_ctl() */
+
+#define EPOLL_CTL_ADD 1			/* Register a socket */
+#define EPOLL_CTL_DEL 2			/* Unregister a socket */
+#define EPOLL_CTL_MOD 3			/* Change the events of a registered socket */
+
+/* Event bits, values match Linux */
+
+#define EPOLLIN       0x001		/* Data can be read */
+#define EPOLLOUT      0x004		/* Data can be written */
+#define EPOLLERR      0x008		/* Error condition, always reported */
+#define EPOLLET       (1u << 31)	/* Edge-triggered notification */
+
+/****************************************************************************
+ * Type Definitions
+ ****************************************************************************/
+
+typedef union epoll_data {
+	void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+} epoll_data_t;
+
+struct epoll_event {
+	uint32_t events;			/* Requested events or returned events */
+	epoll_data_t data;			/* Returned with the event as is */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/**
+ * @ingroup EPOLL_KERNEL
+ * @brief open an epoll descriptor, released with close()
+ * @details @b #include <sys/epoll.h> \n
+ * Linux API, size is ignored but must be positive
+ * @since TizenRT v3.0
+ */
+EXTERN int epoll_create(int size);
+
+/**
+ * @ingroup EPOLL_KERNEL
+ * @brief add, modify or remove a socket watched by an epoll descriptor
+ * @details @b #include <sys/epoll.h> \n
+ * Linux API. Only socket descriptors can be watched.
+ * @since TizenRT v3.0
+ */
+EXTERN int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *event);
+
+/**
+ * @ingroup EPOLL_KERNEL
+ * @brief wait for events on an epoll descriptor
+ * @details @b #include <sys/epoll.h> \n
+ * Linux API. timeout is in milliseconds, -1 waits forever.
+ * @since TizenRT v3.0
+ */
+EXTERN int epoll_wait(int epfd, FAR struct epoll_event *events, int maxevents, int timeout);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* CONFIG_NET_SOCKET_EPOLL */
+
+#endif							/* __INCLUDE_SYS_EPOLL_H */
+/**
+ * @} */
@@ -132,6 +132,21 @@ extern "C" {
 
 ssize_t sendfile(int outfd, int infd, FAR off_t *offset, size_t count);
 
+/************************************************************************
+ * Name: lib_sendfile
+ *
+ * Description:
+ *   The read()/write() implementation of sendfile() from the C library.
+ *   When CONFIG_NET_SENDFILE is selected, sendfile() sends files to TCP
+ *   sockets without copying and falls back to lib_sendfile() for the
+ *   other descriptors.
+ *
+ ************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE
+ssize_t lib_sendfile(int outfd, int infd, FAR off_t *offset, size_t count);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -100,6 +100,13 @@ struct msghdr {
 	int msg_flags;                 /* flags on received message */
 };
 
+/* One message of recvmmsg() and sendmmsg() */
+
+struct mmsghdr {
+	struct msghdr msg_hdr;         /* message header */
+	unsigned int msg_len;          /* bytes received or sent */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -321,6 +328,42 @@ int getpeername(int s, struct sockaddr *name, socklen_t *namelen);
 ssize_t recvmsg(int sockfd, struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, struct msghdr *msg, int flags);
 
+#ifdef CONFIG_NET_SOCKET_MMSG
+/**
+* @brief   receive several datagrams from a socket
+*
+* @details @b #include <sys/socket.h>\n
+* SYSTEM CALL API\n
+* Linux API. Each entry of msgvec receives one datagram and msg_len is set to
+* its length. With MSG_WAITFORONE only the first datagram is waited for.
+* timeout, if not NULL, is checked after each datagram as on Linux.
+* @param[in] sockfd the file descriptor associated with the socket.
+* @param[inout] msgvec array of messages
+* @param[in] vlen number of entries in msgvec
+* @param[in] flags the type of message reception
+* @param[in] timeout null or the time after which no more datagrams are received
+* @return On success, returns the number of messages received, On failure, -1 is returned.
+* @since TizenRT v3.0
+*/
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen, int flags, FAR struct timespec *timeout);
+
+/**
+* @brief   send several datagrams on a socket
+*
+* @details @b #include <sys/socket.h>\n
+* SYSTEM CALL API\n
+* Linux API. Each entry of msgvec is sent as one datagram and msg_len is set
+* to the bytes sent. Datagrams are handed to the stack in batches.
+* @param[in] sockfd the file descriptor associated with the socket.
+* @param[inout] msgvec array of messages
+* @param[in] vlen number of entries in msgvec
+* @param[in] flags the type of message transmission
+* @return On success, returns the number of messages sent, On failure, -1 is returned.
+* @since TizenRT v3.0
+*/
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen, int flags);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -134,12 +134,16 @@ struct load_attr_s {
 	uint16_t offset;			/* The offset from which ELF binary has to be read in MTD partition */
 	uint8_t priority;			/* Priority of the binary */
 	uint8_t compression_type;	/* Binary compression type */
+#ifdef CONFIG_ELF_XIP
+	bool xip;					/* Binary is pre-linked and executed in place from flash */
+#endif
 };
 typedef struct load_attr_s load_attr_t;
 
 /* The structure of binaries' information list */
 struct binary_update_info_list_s {
 	uint32_t bin_count;
+	uint32_t loading_time;		/* Time in msec from the start of loading at boot until all successfully loaded binaries are running, 0 if not yet */
 	binary_update_info_t bin_info[BINARY_COUNT];
 };
 typedef struct binary_update_info_list_s binary_update_info_list_t;
@@ -149,6 +149,10 @@ struct binary_s {
 	size_t filelen;                 /* Size of binary size, used only when underlying is MTD */
 	size_t offset;                  /* Offset of binary from partition start*/
 	uint8_t compression_type;		/* Binary Compression type */
+#ifdef CONFIG_ELF_XIP
+	bool xip;					/* Binary is pre-linked and executed in place */
+	uintptr_t xiptext;			/* Flash address of the text, starts with the userspace object */
+#endif
 
 	/* Unload module callback */
 
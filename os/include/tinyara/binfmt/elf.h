@@ -167,6 +167,11 @@ struct elf_loadinfo_s {
 	int filfd;					/* Descriptor for the file being loaded */
 	uint16_t offset;             /* elf offset when binary header is included */
 	uint8_t compression_type;		/* Binary Compression type */
+#ifdef CONFIG_ELF_XIP
+	bool xip;					/* Execute text sections in place from flash */
+	uintptr_t xipbase;			/* Memory-mapped address of the partition holding the ELF */
+	uintptr_t xiptext;			/* Flash address of the lowest read-only section */
+#endif
 	uintptr_t symtab;			/* Copy of symbol table */
 	uintptr_t reltab;			/* Copy of relocation table */
 };
@@ -81,6 +81,7 @@
 /* This structure defines a message queue */
 
 struct mq_des;					/* forward reference */
+struct mqueue_spsc_s;			/* forward reference */
 
 struct mqueue_inode_s {
 	FAR struct inode *inode;	/* Containing inode */
@@ -100,6 +101,9 @@ struct mqueue_inode_s {
 	int ntsigno;				/* Notification: Signal number */
 	union sigval ntvalue;		/* Notification: Signal value */
 #endif
+#ifdef CONFIG_MQ_SPSC
+	FAR struct mqueue_spsc_s *spsc;	/* Ring of an O_SPSC queue (NULL if none) */
+#endif
 };
 
 /* This describes the message queue descriptor that is held in the
@@ -172,6 +176,25 @@ void mq_msgqfree(FAR struct mqueue_inode_s *msgq);
 
 FAR struct mqueue_inode_s *mq_msgqalloc(mode_t mode, FAR struct mq_attr *attr);
 
+#ifdef CONFIG_MQ_SPSC
+/****************************************************************************
+ * Name: mq_spsc_alloc
+ *
+ * Description:
+ *   Allocate the ring of a message queue opened with O_SPSC.  Every slot
+ *   and both ring indexes start on a separate cache line.
+ *
+ * Parameters:
+ *   msgq - The message queue allocated by mq_msgqalloc()
+ *
+ * Return Value:
+ *   OK on success; ERROR if the ring cannot be allocated.
+ *
+ ****************************************************************************/
+
+int mq_spsc_alloc(FAR struct mqueue_inode_s *msgq);
+#endif
+
 /****************************************************************************
  * Name: mq_descreate
  *
@@ -98,6 +98,27 @@ void ethernetif_status_callback(struct netif *netif);
 err_t ethernetif_init(struct netif *netif);
 int ethernetif_input(struct netif *netif);
 
+#ifdef CONFIG_NET_ETHERNET_RXLOAN
+/* Gives a receive buffer back to the driver that loaned it with
+ * ethernetif_input_loan(). Called from the task that frees the last
+ * reference on the packet, normally the tcpip thread or a socket user,
+ * never from an interrupt handler.
+ */
+
+typedef void (*ethernetif_rxrelease_t)(FAR void *arg);
+
+/* Pass a received frame to lwIP without copying it. The frame stays in the
+ * driver's buffer until lwIP is done with it, then release(arg) is called.
+ * When CONFIG_NET_ETHERNET_RXLOAN_MAX buffers are already on loan, the frame
+ * is copied into the PBUF_POOL as ethernetif_input() does and released at
+ * once, so the driver never runs out of receive buffers. Returns 0 if the
+ * frame was taken (release has been or will be called), -1 if it was
+ * dropped for lack of memory (release has been called).
+ */
+
+int ethernetif_input_loan(struct netif *netif, FAR uint8_t *frame, uint16_t len, ethernetif_rxrelease_t release, FAR void *arg);
+#endif
+
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C" {
@@ -466,6 +466,30 @@ int net_clone(FAR struct socket *psock1, FAR struct socket *psock2);
 
 int net_vfcntl(int sockfd, int cmd, va_list ap);
 
+/****************************************************************************
+ * Function: net_sendfile
+ *
+ * Description:
+ *   Send part of a file on a TCP socket without copying it into the stack.
+ *   This is called by sendfile() when the output descriptor is a socket.
+ *
+ * Parameters:
+ *   outfd    Socket descriptor of a connected TCP socket
+ *   infile   The file to send from
+ *   offset   As for sendfile()
+ *   count    Number of bytes to send
+ *
+ * Returned Value:
+ *   The number of bytes sent; -1 on error with errno set appropriately.
+ *   errno is ENOSYS if outfd is not a TCP socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE
+struct file;
+ssize_t net_sendfile(int outfd, FAR struct file *infile, FAR off_t *offset, size_t count);
+#endif
+
 /****************************************************************************
  * Function: netdev_foreach
  *
@@ -141,6 +141,9 @@ void binary_manager_update_running_state(int bin_id)
 	BIN_STATE(bin_idx) = BINARY_RUNNING;
 	bmvdbg("binary '%s' state is changed, state = %d.\n", BIN_NAME(bin_idx), BIN_STATE(bin_idx));
 
+	/* Check whether all binaries loaded at boot are running now */
+	binary_manager_check_all_running();
+
 	/* Notify that binary is started. */
 	binary_manager_notify_state_changed(bin_idx, BINARY_STARTED);
 }
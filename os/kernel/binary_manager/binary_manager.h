@@ -45,6 +45,7 @@
 /* Supported binary types */
 #define BIN_TYPE_BIN               0                          /* 'bin' type for kernel binary */
 #define BIN_TYPE_ELF               1                          /* 'elf' type for user binary */
+#define BIN_TYPE_XIP               3                          /* 'elf' type for pre-linked user binary executed in place */
 
 /* Binary information configuration */
 #define PARTS_PER_BIN              2                          /* The number of partitions per binary */
@@ -156,6 +157,8 @@ int binary_manager_send_statecb_msg(int recv_binidx, char *bin_name, uint8_t sta
 void binary_manager_notify_state_changed(int bin_idx, uint8_t state);
 int binary_manager_load_binary(int bin_idx);
 int binary_manager_loading(char *loading_data[]);
+void binary_manager_check_all_running(void);
+uint32_t binary_manager_get_loading_time(void);
 uint32_t binary_manager_get_binary_count(void);
 int binary_manager_get_index_with_binid(int bin_id);
 void binary_manager_get_info_with_name(int request_pid, char *bin_name);
@@ -149,6 +149,7 @@ void binary_manager_get_info_all(int requester_pid)
 			}
 		}
 		response_msg.data.bin_count = bin_count + 1;
+		response_msg.data.loading_time = binary_manager_get_loading_time();
 		response_msg.result = BINMGR_OK;
 	} else {
 		response_msg.result = BINMGR_NOT_FOUND;
@@ -30,8 +30,10 @@
 #include <sched.h>
 #include <stdint.h>
 #include <string.h>
+#include <semaphore.h>
 #include <sys/types.h>
 
+#include <tinyara/clock.h>
 #include <tinyara/mm/mm.h>
 #include <tinyara/sched.h>
 #include <tinyara/init.h>
@@ -57,6 +59,20 @@ struct binary_header_s {
 } __attribute__((__packed__));
 typedef struct binary_header_s binary_header_t;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+/* Loading time of binaries at boot */
+static clock_t g_loadall_start;
+static uint32_t g_loadall_time;
+static bool g_loadall_done;
+
+#ifdef CONFIG_BINMGR_PARALLEL_LOADING
+/* Loading threads of binaries post this semaphore on completion */
+static sem_t g_loadall_sem;
+static int g_loadall_cnt;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -96,7 +112,11 @@ static int binary_manager_read_header(int bin_idx, int part_idx, binary_header_t
 	}
 
 	/* Verify header data */
+#ifdef CONFIG_ELF_XIP
+	if (header_data->bin_type != BIN_TYPE_ELF && header_data->bin_type != BIN_TYPE_XIP) {
+#else
 	if (header_data->bin_type != BIN_TYPE_ELF) {
+#endif
 		bmdbg("Invalid header data : headersize %d, binsize %d, ramsize %d, bintype %d\n", header_data->header_size, header_data->bin_size, header_data->bin_ramsize, header_data->bin_type);
 		goto errout_with_fd;
 	}
@@ -224,6 +244,9 @@ int binary_manager_load_binary(int bin_idx)
 		load_attr.stack_size = header_data[latest_idx].bin_stacksize;
 		load_attr.priority = header_data[latest_idx].bin_priority;
 		load_attr.offset = CHECKSUM_SIZE + header_data[latest_idx].header_size;
+#ifdef CONFIG_ELF_XIP
+		load_attr.xip = (header_data[latest_idx].bin_type == BIN_TYPE_XIP);
+#endif
 
 		bmvdbg("BIN[%d] %s %d %d\n", bin_idx, devname, load_attr.bin_size, load_attr.offset);
 
@@ -258,22 +281,76 @@ int binary_manager_load_binary(int bin_idx)
 	return ERROR;
 }
 
+#ifdef CONFIG_BINMGR_PARALLEL_LOADING
+/* Create loading thread to load one binary in parallel with others */
+static int binary_manager_load_parallel(int bin_idx)
+{
+	char type_str[2];
+	char idx_str[12];
+	char *loading_data[LOADTHD_ARGC + 1];
+
+	loading_data[0] = itoa(LOADCMD_LOAD, type_str, 10);
+	loading_data[1] = itoa(bin_idx, idx_str, 10);
+	loading_data[2] = NULL;
+
+	return binary_manager_loading(loading_data);
+}
+#endif
+
 static int binary_manager_load_all(void)
 {
 	int ret;
 	int bin_idx;
 	int load_cnt;
 	uint32_t bin_count;
+#ifdef CONFIG_BINMGR_PARALLEL_LOADING
+	int thread_cnt;
+#endif
 
 	load_cnt = 0;
 	bin_count = binary_manager_get_binary_count();
+	g_loadall_start = clock_systimer();
+
+#ifdef CONFIG_BINMGR_PARALLEL_LOADING
+	thread_cnt = 0;
+	g_loadall_cnt = 0;
+	sem_init(&g_loadall_sem, 0, 0);
 
+	/* Each binary is loaded and started by its own loading thread,
+	 * so that flash I/O of one binary overlaps with relocation of others.
+	 */
+	for (bin_idx = 1; bin_idx <= bin_count; bin_idx++) {
+		ret = binary_manager_load_parallel(bin_idx);
+		if (ret > 0) {
+			thread_cnt++;
+		} else {
+			/* Fall back to load it in this thread */
+			bmdbg("Failed to create loading thread for binary %d\n", bin_idx);
+			if (binary_manager_load_binary(bin_idx) == OK) {
+				load_cnt++;
+			}
+		}
+	}
+
+	/* Wait for all loading threads to be finished */
+	while (thread_cnt > 0) {
+		if (sem_wait(&g_loadall_sem) == OK) {
+			thread_cnt--;
+		}
+	}
+	sem_destroy(&g_loadall_sem);
+	load_cnt += g_loadall_cnt;
+#else
 	for (bin_idx = 1; bin_idx <= bin_count; bin_idx++) {
 		ret = binary_manager_load_binary(bin_idx);
 		if (ret == OK) {
 			load_cnt++;
 		}
 	}
+#endif
+
+	g_loadall_done = true;
+	binary_manager_check_all_running();
 
 	if (load_cnt > 0) {
 		return load_cnt;
@@ -414,6 +491,22 @@ static int loading_thread(int argc, char *argv[])
 
 	ret = BINMGR_INVALID_PARAM;
 	switch (load_cmd) {
+#ifdef CONFIG_BINMGR_PARALLEL_LOADING
+	case LOADCMD_LOAD:
+		if (argc <= 2) {
+			bmdbg("Invalid arguments for loading, argc %d\n", argc);
+			break;
+		}
+		/* [2] bin_idx for loading */
+		ret = binary_manager_load_binary((int)atoi(argv[2]));
+		sched_lock();
+		if (ret == OK) {
+			g_loadall_cnt++;
+		}
+		sched_unlock();
+		sem_post(&g_loadall_sem);
+		break;
+#endif
 	case LOADCMD_LOAD_ALL:
 		ret = binary_manager_load_all();
 		break;
@@ -446,6 +539,60 @@ static int loading_thread(int argc, char *argv[])
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+/****************************************************************************
+ * Name: binary_manager_check_all_running
+ *
+ * Description:
+ *   This function records the time taken from the start of loading at boot
+ *   until all binaries loaded at boot are running. It is called whenever
+ *   loading at boot is finished or a binary notifies that it is started.
+ *   Only successful loads are counted, a binary which failed to load stays
+ *   inactive and is not waited for. If no binary could be loaded, the time
+ *   until loading gave up is recorded.
+ *
+ ****************************************************************************/
+void binary_manager_check_all_running(void)
+{
+	int bin_idx;
+	uint32_t bin_count;
+
+	sched_lock();
+	if (!g_loadall_done || g_loadall_time != 0) {
+		sched_unlock();
+		return;
+	}
+
+	bin_count = binary_manager_get_binary_count();
+	for (bin_idx = 1; bin_idx <= bin_count; bin_idx++) {
+		if (BIN_STATE(bin_idx) == BINARY_LOADING_DONE) {
+			/* Loaded, but not running yet */
+			sched_unlock();
+			return;
+		}
+	}
+
+	g_loadall_time = TICK2MSEC(clock_systimer() - g_loadall_start);
+	if (g_loadall_time == 0) {
+		g_loadall_time = 1;
+	}
+	sched_unlock();
+
+	bmvdbg("All binaries are running in %u msec\n", g_loadall_time);
+}
+
+/****************************************************************************
+ * Name: binary_manager_get_loading_time
+ *
+ * Description:
+ *   This function returns the time in msec taken until all binaries loaded
+ *   at boot are running. 0 is returned if they are not running yet.
+ *
+ ****************************************************************************/
+uint32_t binary_manager_get_loading_time(void)
+{
+	return g_loadall_time;
+}
+
 /****************************************************************************
  * Name: binary_manager_loading
  *
@@ -59,6 +59,8 @@
 #include <mqueue.h>
 #include <tinyara/mqueue.h>
 
+#include "mqueue/mqueue.h"
+
 /************************************************************************
  * Definitions
  ************************************************************************/
@@ -112,6 +114,11 @@ int mq_getattr(mqd_t mqdes, struct mq_attr *mq_stat)
 		mq_stat->mq_msgsize = mqdes->msgq->maxmsgsize;
 		mq_stat->mq_flags = mqdes->oflags;
 		mq_stat->mq_curmsgs = (size_t)mqdes->msgq->nmsgs;
+#ifdef CONFIG_MQ_SPSC
+		if (mqdes->msgq->spsc != NULL) {
+			mq_stat->mq_curmsgs = (size_t)mq_spsc_nmsgs(mqdes->msgq);
+		}
+#endif
 
 		ret = OK;
 	}
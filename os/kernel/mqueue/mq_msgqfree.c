@@ -118,6 +118,14 @@ void mq_msgqfree(FAR struct mqueue_inode_s *msgq)
 		curr = next;
 	}
 
+#ifdef CONFIG_MQ_SPSC
+	/* The ring of a single-producer/single-consumer queue */
+
+	if (msgq->spsc != NULL) {
+		sched_kfree(msgq->spsc);
+	}
+#endif
+
 	/* Then deallocate the message queue itself */
 
 	sched_kfree(msgq);
@@ -271,9 +271,6 @@ FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes)
 
 ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuffer, int *prio)
 {
-	FAR struct tcb_s *btcb;
-	irqstate_t saved_state;
-	FAR struct mqueue_inode_s *msgq;
 	ssize_t rcvmsglen;
 
 	trace_begin(TTRACE_TAG_IPC, "mq_doreceive");
@@ -298,7 +295,39 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 
 	/* Check if any tasks are waiting for the MQ not full event. */
 
-	msgq = mqdes->msgq;
+	mq_wakesender(mqdes->msgq);
+
+	trace_end(TTRACE_TAG_IPC);
+
+	/* Return the length of the message transferred to the user buffer */
+
+	return rcvmsglen;
+}
+
+/****************************************************************************
+ * Name: mq_wakesender
+ *
+ * Description:
+ *   This is internal, common logic shared by mq_doreceive and the SPSC
+ *   receive path.  It awakens the highest priority task that was waiting
+ *   for the message queue to become non-full.
+ *
+ * Parameters:
+ *   msgq - The message queue that a message was removed from
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ * - Pre-emption should be disabled throughout this call.
+ *
+ ****************************************************************************/
+
+void mq_wakesender(FAR struct mqueue_inode_s *msgq)
+{
+	FAR struct tcb_s *btcb;
+	irqstate_t saved_state;
+
 	if (msgq->nwaitnotfull > 0) {
 		/* Find the highest priority task that is waiting for
 		 * this queue to be not-full in g_waitingformqnotfull list.
@@ -322,10 +351,4 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 
 		irqrestore(saved_state);
 	}
-
-	trace_end(TTRACE_TAG_IPC);
-
-	/* Return the length of the message transferred to the user buffer */
-
-	return rcvmsglen;
 }
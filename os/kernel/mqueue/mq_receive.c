@@ -150,6 +150,16 @@ ssize_t mq_receive(mqd_t mqdes, FAR char *msg, size_t msglen, FAR int *prio)
 		return ERROR;
 	}
 
+#ifdef CONFIG_MQ_SPSC
+	/* A single-producer/single-consumer queue does not use the message list */
+
+	if (mqdes->msgq->spsc != NULL) {
+		ret = mq_spsc_receive(mqdes, msg, prio, NULL);
+		leave_cancellation_point();
+		return ret;
+	}
+#endif
+
 	/* Get the next message from the message queue.  We will disable
 	 * pre-emption until we have completed the message received.  This
 	 * is not too bad because if the receipt takes a long time, it will
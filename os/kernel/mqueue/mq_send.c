@@ -152,6 +152,16 @@ int mq_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
 		return ERROR;
 	}
 
+#ifdef CONFIG_MQ_SPSC
+	/* A single-producer/single-consumer queue does not use the message list */
+
+	if (mqdes->msgq->spsc != NULL) {
+		ret = mq_spsc_send(mqdes, msg, msglen, prio, NULL);
+		leave_cancellation_point();
+		return ret;
+	}
+#endif
+
 	/* Get a pointer to the message queue */
 
 	sched_lock();
@@ -348,7 +348,6 @@ int mq_waitsend(mqd_t mqdes)
 
 int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg, size_t msglen, int prio)
 {
-	FAR struct tcb_s *btcb;
 	FAR struct mqueue_inode_s *msgq;
 	FAR struct mqueue_msg_s *next;
 	FAR struct mqueue_msg_s *prev;
@@ -393,6 +392,37 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 	msgq->nmsgs++;
 	irqrestore(saved_state);
 
+	mq_notifyreceiver(msgq);
+	sched_unlock();
+	trace_end(TTRACE_TAG_IPC);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mq_notifyreceiver
+ *
+ * Description:
+ *   This is internal, common logic shared by mq_dosend and the SPSC send
+ *   path.  It notifies any tasks that were waiting for message queue
+ *   notifications setup by mq_notify and awakens the highest priority task
+ *   that was waiting for the message not empty event.
+ *
+ * Parameters:
+ *   msgq - The message queue that a message was added to
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions/restrictions:
+ * - Pre-emption should be disabled throughout this call.
+ *
+ ****************************************************************************/
+
+void mq_notifyreceiver(FAR struct mqueue_inode_s *msgq)
+{
+	FAR struct tcb_s *btcb;
+	irqstate_t saved_state;
+
 	/* Check if we need to notify any tasks that are attached to the
 	 * message queue
 	 */
@@ -448,7 +478,4 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 	}
 
 	irqrestore(saved_state);
-	sched_unlock();
-	trace_end(TTRACE_TAG_IPC);
-	return OK;
 }
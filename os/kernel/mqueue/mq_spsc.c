@@ -0,0 +1,472 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/mqueue/mq_spsc.c
+ *
+ *   Single-producer/single-consumer message queues.
+ *
+ *   A queue opened with O_SPSC keeps its messages in a preallocated ring
+ *   instead of the prioritized message list.  The head index is written
+ *   only by the receiver and the tail index only by the sender, so a message is passed without a critical section, without
+ *   allocating a message structure and without walking the priority list.
+ *   The blocking paths are entered only when the ring is full or empty.
+ *
+ *   The caller guarantees that only one thread (or one interrupt handler)
+ *   sends and only one thread receives.  Messages are delivered in FIFO
+ *   order; the message priority is returned to the receiver but does not
+ *   reorder the queue.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/arch.h>
+#include <tinyara/cancelpt.h>
+#include <tinyara/wdog.h>
+
+#include "sched/sched.h"
+#include "clock/clock.h"
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_SPSC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MQ_SPSC_ALIGN(n)      (((n) + CONFIG_MQ_SPSC_CACHELINE - 1) & ~(CONFIG_MQ_SPSC_CACHELINE - 1))
+
+/* The indexes run over [0, 2 * nslots) so that a full ring can be told
+ * apart from an empty one without a shared counter.
+ */
+
+#define MQ_SPSC_NEXT(r, i)    ((i) + 1 == 2 * (r)->nslots ? 0 : (i) + 1)
+#define MQ_SPSC_COUNT(r, h, t) ((t) >= (h) ? (t) - (h) : (t) + 2 * (r)->nslots - (h))
+#define MQ_SPSC_SLOT(r, i)    ((FAR struct mqueue_spsc_slot_s *)((FAR char *)(r) + sizeof(struct mqueue_spsc_s) + \
+				((i) < (r)->nslots ? (i) : (i) - (r)->nslots) * (r)->slotsize))
+
+/* Publish the slot contents before the index which hands it over */
+
+#define MQ_SPSC_BARRIER()     __sync_synchronize()
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+/* One message in the ring.  The message data follows this header. */
+
+struct mqueue_spsc_slot_s {
+	uint16_t msglen;			/* Message data length */
+	uint8_t priority;			/* Priority of message */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_spsc_trysend
+ *
+ * Description:
+ *   Put the message into the ring if there is a free slot.  Only the tail
+ *   index is written, so this does not need a critical section.
+ *
+ ****************************************************************************/
+
+static int mq_spsc_trysend(FAR struct mqueue_inode_s *msgq, FAR const char *msg, size_t msglen, int prio)
+{
+	FAR struct mqueue_spsc_s *ring = msgq->spsc;
+	FAR struct mqueue_spsc_slot_s *slot;
+	uint16_t tail = ring->tail;
+
+	if (MQ_SPSC_COUNT(ring, ring->head, tail) >= (uint16_t)msgq->maxmsgs) {
+		return ERROR;
+	}
+
+	slot = MQ_SPSC_SLOT(ring, tail);
+	slot->msglen = msglen;
+	slot->priority = prio;
+	memcpy((FAR char *)(slot + 1), msg, msglen);
+
+	MQ_SPSC_BARRIER();
+	ring->tail = MQ_SPSC_NEXT(ring, tail);
+	MQ_SPSC_BARRIER();
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mq_spsc_tryreceive
+ *
+ * Description:
+ *   Take the oldest message from the ring if there is one.  Only the head
+ *   index is written, so this does not need a critical section.
+ *
+ ****************************************************************************/
+
+static ssize_t mq_spsc_tryreceive(FAR struct mqueue_inode_s *msgq, FAR char *ubuffer, FAR int *prio)
+{
+	FAR struct mqueue_spsc_s *ring = msgq->spsc;
+	FAR struct mqueue_spsc_slot_s *slot;
+	uint16_t head = ring->head;
+	ssize_t rcvmsglen;
+
+	if (head == ring->tail) {
+		return ERROR;
+	}
+
+	MQ_SPSC_BARRIER();
+	slot = MQ_SPSC_SLOT(ring, head);
+	rcvmsglen = slot->msglen;
+	memcpy(ubuffer, (FAR const char *)(slot + 1), rcvmsglen);
+	if (prio) {
+		*prio = slot->priority;
+	}
+
+	MQ_SPSC_BARRIER();
+	ring->head = MQ_SPSC_NEXT(ring, head);
+	MQ_SPSC_BARRIER();
+
+	return rcvmsglen;
+}
+
+/****************************************************************************
+ * Name: mq_spsc_wait
+ *
+ * Description:
+ *   Block until the ring is no longer full (sender) or no longer empty
+ *   (receiver).  This follows mq_waitsend() and mq_waitreceive() so that
+ *   mq_waitirq() and the timeout handlers work unchanged.
+ *
+ * Assumptions:
+ * - Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static int mq_spsc_wait(mqd_t mqdes, bool send)
+{
+	FAR struct tcb_s *rtcb;
+	FAR struct mqueue_inode_s *msgq = mqdes->msgq;
+	FAR struct mqueue_spsc_s *ring = msgq->spsc;
+
+	for (;;) {
+		if (send && MQ_SPSC_COUNT(ring, ring->head, ring->tail) < (uint16_t)msgq->maxmsgs) {
+			return OK;
+		}
+
+		if (!send && ring->head != ring->tail) {
+			return OK;
+		}
+
+		if ((mqdes->oflags & O_NONBLOCK) != 0) {
+			set_errno(EAGAIN);
+			return ERROR;
+		}
+
+		rtcb = this_task();
+		rtcb->msgwaitq = msgq;
+		if (send) {
+			msgq->nwaitnotfull++;
+		} else {
+			msgq->nwaitnotempty++;
+		}
+
+		set_errno(OK);
+		up_block_task(rtcb, send ? TSTATE_WAIT_MQNOTFULL : TSTATE_WAIT_MQNOTEMPTY);
+
+		/* Either the ring changed or the wait was interrupted by a signal
+		 * or a timeout (EINTR or ETIMEDOUT).
+		 */
+
+		if (get_errno() != OK) {
+			return ERROR;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: mq_spsc_startwait
+ *
+ * Description:
+ *   Start the watchdog for mq_timedsend() and mq_timedreceive().
+ *
+ * Assumptions:
+ * - Interrupts are disabled so that the time stays valid until the wait
+ *   begins.
+ *
+ ****************************************************************************/
+
+static int mq_spsc_startwait(FAR const struct timespec *abstime, wdentry_t timeout)
+{
+	FAR struct tcb_s *rtcb = this_task();
+	int ticks;
+	int result;
+
+	result = clock_abstime2ticks(CLOCK_REALTIME, abstime, &ticks);
+	if (result == OK && ticks <= 0) {
+		result = ETIMEDOUT;
+	}
+
+	if (result != OK) {
+		set_errno(result);
+		return ERROR;
+	}
+
+	wd_start(rtcb->waitdog, ticks, timeout, 1, getpid());
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_spsc_alloc
+ *
+ * Description:
+ *   Allocate the ring for a message queue opened with O_SPSC.  Every slot
+ *   and both indexes start on a separate cache line so that the sender and
+ *   the receiver do not write to the same line.
+ *
+ * Parameters:
+ *   msgq - The message queue which maxmsgs and maxmsgsize are already set
+ *
+ * Return Value:
+ *   OK on success; ERROR if the ring cannot be allocated.
+ *
+ ****************************************************************************/
+
+int mq_spsc_alloc(FAR struct mqueue_inode_s *msgq)
+{
+	FAR struct mqueue_spsc_s *ring;
+	uint16_t slotsize;
+
+	if (msgq->maxmsgs <= 0) {
+		return ERROR;
+	}
+
+	slotsize = MQ_SPSC_ALIGN(sizeof(struct mqueue_spsc_slot_s) + msgq->maxmsgsize);
+	ring = (FAR struct mqueue_spsc_s *)kmm_memalign(CONFIG_MQ_SPSC_CACHELINE, sizeof(struct mqueue_spsc_s) + msgq->maxmsgs * slotsize);
+	if (ring == NULL) {
+		return ERROR;
+	}
+
+	ring->nslots = msgq->maxmsgs;
+	ring->slotsize = slotsize;
+	ring->head = 0;
+	ring->tail = 0;
+	msgq->spsc = ring;
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mq_spsc_nmsgs
+ *
+ * Description:
+ *   Return the number of messages in the ring.
+ *
+ ****************************************************************************/
+
+int mq_spsc_nmsgs(FAR struct mqueue_inode_s *msgq)
+{
+	FAR struct mqueue_spsc_s *ring = msgq->spsc;
+
+	return MQ_SPSC_COUNT(ring, ring->head, ring->tail);
+}
+
+/****************************************************************************
+ * Name: mq_spsc_send
+ *
+ * Description:
+ *   The O_SPSC path of mq_send() and mq_timedsend().  The message is put
+ *   into the ring without a critical section.  Only when the ring is full,
+ *   or a receiver has to be notified, the scheduler is involved.
+ *
+ * Parameters:
+ *   mqdes   - Message queue descriptor
+ *   msg     - Message to send
+ *   msglen  - The length of the message in bytes
+ *   prio    - The priority of the message
+ *   abstime - The absolute time to wait until, or NULL to wait forever
+ *
+ * Return Value:
+ *   Same as mq_send() and mq_timedsend().
+ *
+ * Assumptions:
+ * - The caller has verified the input parameters using mq_verifysend().
+ *
+ ****************************************************************************/
+
+int mq_spsc_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio, FAR const struct timespec *abstime)
+{
+	FAR struct mqueue_inode_s *msgq = mqdes->msgq;
+	FAR struct tcb_s *rtcb;
+	irqstate_t saved_state;
+	int ret = OK;
+
+	while (mq_spsc_trysend(msgq, msg, msglen, prio) != OK) {
+		/* The ring is full.  An interrupt handler cannot wait for it. */
+
+		if (up_interrupt_context()) {
+			set_errno(EAGAIN);
+			return ERROR;
+		}
+
+		rtcb = this_task();
+		if (abstime) {
+			rtcb->waitdog = wd_create();
+			if (!rtcb->waitdog) {
+				set_errno(EINVAL);
+				return ERROR;
+			}
+		}
+
+		saved_state = irqsave();
+		if (abstime) {
+			ret = mq_spsc_startwait(abstime, (wdentry_t)mq_sndtimeout);
+		}
+
+		if (ret == OK) {
+			ret = mq_spsc_wait(mqdes, true);
+		}
+
+		if (abstime) {
+			wd_cancel(rtcb->waitdog);
+		}
+		irqrestore(saved_state);
+
+		if (abstime) {
+			wd_delete(rtcb->waitdog);
+			rtcb->waitdog = NULL;
+		}
+
+		if (ret != OK) {
+			return ERROR;
+		}
+	}
+
+	/* Take the slow path only if somebody waits for this message */
+
+	if (msgq->nwaitnotempty > 0
+#ifndef CONFIG_DISABLE_SIGNALS
+		|| msgq->ntmqdes != NULL
+#endif
+	) {
+		sched_lock();
+		mq_notifyreceiver(msgq);
+		sched_unlock();
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mq_spsc_receive
+ *
+ * Description:
+ *   The O_SPSC path of mq_receive() and mq_timedreceive().  The message is
+ *   taken from the ring without a critical section.  Only when the ring is
+ *   empty, or a sender waits for a free slot, the scheduler is involved.
+ *
+ * Parameters:
+ *   mqdes   - Message queue descriptor
+ *   msg     - Buffer to receive the message
+ *   prio    - If not NULL, a location to store message priority.
+ *   abstime - The absolute time to wait until, or NULL to wait forever
+ *
+ * Return Value:
+ *   Same as mq_receive() and mq_timedreceive().
+ *
+ * Assumptions:
+ * - The caller has verified the input parameters using mq_verifyreceive().
+ *
+ ****************************************************************************/
+
+ssize_t mq_spsc_receive(mqd_t mqdes, FAR char *msg, FAR int *prio, FAR const struct timespec *abstime)
+{
+	FAR struct mqueue_inode_s *msgq = mqdes->msgq;
+	FAR struct tcb_s *rtcb;
+	irqstate_t saved_state;
+	ssize_t rcvmsglen;
+	int ret = OK;
+
+	while ((rcvmsglen = mq_spsc_tryreceive(msgq, msg, prio)) < 0) {
+		/* The ring is empty. */
+
+		rtcb = this_task();
+		if (abstime) {
+			rtcb->waitdog = wd_create();
+			if (!rtcb->waitdog) {
+				set_errno(EINVAL);
+				return ERROR;
+			}
+		}
+
+		saved_state = irqsave();
+		if (abstime) {
+			ret = mq_spsc_startwait(abstime, (wdentry_t)mq_rcvtimeout);
+		}
+
+		if (ret == OK) {
+			ret = mq_spsc_wait(mqdes, false);
+		}
+
+		if (abstime) {
+			wd_cancel(rtcb->waitdog);
+		}
+		irqrestore(saved_state);
+
+		if (abstime) {
+			wd_delete(rtcb->waitdog);
+			rtcb->waitdog = NULL;
+		}
+
+		if (ret != OK) {
+			return ERROR;
+		}
+	}
+
+	/* Take the slow path only if a sender waits for a free slot */
+
+	if (msgq->nwaitnotfull > 0) {
+		sched_lock();
+		mq_wakesender(msgq);
+		sched_unlock();
+	}
+
+	return rcvmsglen;
+}
+
+#endif /* CONFIG_MQ_SPSC */
@@ -92,6 +92,10 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: mq_rcvtimeout
  *
@@ -110,7 +114,7 @@
  *
  ****************************************************************************/
 
-static void mq_rcvtimeout(int argc, uint32_t pid)
+void mq_rcvtimeout(int argc, uint32_t pid)
 {
 	FAR struct tcb_s *wtcb;
 	irqstate_t saved_state;
@@ -142,10 +146,6 @@ static void mq_rcvtimeout(int argc, uint32_t pid)
 	irqrestore(saved_state);
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: mq_timedreceive
  *
@@ -223,6 +223,16 @@ ssize_t mq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen, FAR int *prio
 		return ERROR;
 	}
 
+#ifdef CONFIG_MQ_SPSC
+	/* A single-producer/single-consumer queue does not use the message list */
+
+	if (mqdes->msgq->spsc != NULL) {
+		ret = mq_spsc_receive(mqdes, msg, prio, abstime);
+		leave_cancellation_point();
+		return ret;
+	}
+#endif
+
 	/* Create a watchdog.  We will not actually need this watchdog
 	 * unless the queue is not empty, but we will reserve it up front
 	 * before we enter the following critical section.
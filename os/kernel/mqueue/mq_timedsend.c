@@ -92,6 +92,10 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: mq_sndtimeout
  *
@@ -110,7 +114,7 @@
  *
  ****************************************************************************/
 
-static void mq_sndtimeout(int argc, uint32_t pid)
+void mq_sndtimeout(int argc, uint32_t pid)
 {
 	FAR struct tcb_s *wtcb;
 	irqstate_t saved_state;
@@ -142,10 +146,6 @@ static void mq_sndtimeout(int argc, uint32_t pid)
 	irqrestore(saved_state);
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: mq_send
  *
@@ -225,6 +225,16 @@ int mq_timedsend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio, FAR
 		return ERROR;
 	}
 
+#ifdef CONFIG_MQ_SPSC
+	/* A single-producer/single-consumer queue does not use the message list */
+
+	if (mqdes->msgq->spsc != NULL) {
+		ret = mq_spsc_send(mqdes, msg, msglen, prio, abstime);
+		leave_cancellation_point();
+		return ret;
+	}
+#endif
+
 	/* Get a pointer to the message queue */
 
 	msgq = mqdes->msgq;
@@ -116,6 +116,23 @@ struct mqueue_msg_s {
 	char mail[MQ_MAX_BYTES];		/* Message data */
 };
 
+#ifdef CONFIG_MQ_SPSC
+/* This structure describes the ring of an O_SPSC message queue.  The head
+ * index is written only by the receiver and the tail index only by the
+ * sender, and they are kept on separate cache lines.  The slots follow
+ * this structure.
+ */
+
+struct mqueue_spsc_s {
+	uint16_t nslots;			/* Number of slots in the ring */
+	uint16_t slotsize;			/* Cache line aligned size of one slot */
+	volatile uint16_t head;		/* Next slot to receive */
+	uint8_t reserved1[CONFIG_MQ_SPSC_CACHELINE - 3 * sizeof(uint16_t)];
+	volatile uint16_t tail;		/* Next slot to send */
+	uint8_t reserved2[CONFIG_MQ_SPSC_CACHELINE - sizeof(uint16_t)];
+};
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -151,6 +168,7 @@ EXTERN sq_queue_t g_desfree;
  ****************************************************************************/
 
 struct tcb_s;        /* Forward reference */
+struct timespec;     /* Forward reference */
 struct task_group_s; /* Forward reference */
 
 /* Functions defined in mq_initialize.c ************************************/
@@ -170,6 +188,7 @@ void mq_waitirq(FAR struct tcb_s *wtcb, int errcode);
 int mq_verifyreceive(mqd_t mqdes, FAR char *msg, size_t msglen);
 FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes);
 ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuffer, FAR int *prio);
+void mq_wakesender(FAR struct mqueue_inode_s *msgq);
 
 /* mq_sndinternal.c ********************************************************/
 
@@ -177,6 +196,23 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio);
 FAR struct mqueue_msg_s *mq_msgalloc(void);
 int mq_waitsend(mqd_t mqdes);
 int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg, size_t msglen, int prio);
+void mq_notifyreceiver(FAR struct mqueue_inode_s *msgq);
+
+/* mq_timedsend.c **********************************************************/
+
+void mq_sndtimeout(int argc, uint32_t pid);
+
+/* mq_timedreceive.c *******************************************************/
+
+void mq_rcvtimeout(int argc, uint32_t pid);
+
+#ifdef CONFIG_MQ_SPSC
+/* mq_spsc.c ***************************************************************/
+
+int mq_spsc_nmsgs(FAR struct mqueue_inode_s *msgq);
+int mq_spsc_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio, FAR const struct timespec *abstime);
+ssize_t mq_spsc_receive(mqd_t mqdes, FAR char *msg, FAR int *prio, FAR const struct timespec *abstime);
+#endif
 
 /* mq_release.c ************************************************************/
 
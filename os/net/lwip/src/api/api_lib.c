@@ -698,20 +698,46 @@ err_t netconn_send(struct netconn *conn, struct netbuf *buf)
 	return err;
 }
 
+#if LWIP_SOCKET_MMSG
 /**
- * Send data over a TCP netconn.
+ * Send several netbufs over a UDP or RAW netconn with a single call into the
+ * tcpip thread. Sending stops at the first netbuf that fails.
  *
- * @param conn the TCP netconn over which to send data
- * @param dataptr pointer to the application buffer that contains the data to send
- * @param size size of the application data to send
- * @param apiflags combination of following flags :
- * - NETCONN_COPY: data will be copied into memory belonging to the stack
- * - NETCONN_MORE: for TCP connection, PSH flag will be set on last segment sent
- * - NETCONN_DONTBLOCK: only write the data if all data can be written at once
- * @param bytes_written pointer to a location that receives the number of written bytes
- * @return ERR_OK if data was sent, any other err_t on error
+ * @param conn the UDP or RAW netconn over which to send data
+ * @param bufs the netbufs to send, in order
+ * @param count number of entries in bufs
+ * @param sent set to the number of netbufs that were sent
+ * @return ERR_OK if all netbufs were sent, else the error of the first one
+ *         that was not
  */
-err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written)
+err_t netconn_send_multi(struct netconn *conn, struct netbuf **bufs, u16_t count, u16_t *sent)
+{
+	API_MSG_VAR_DECLARE(msg);
+	err_t err;
+
+	LWIP_ERROR("netconn_send_multi: invalid conn", (conn != NULL), return ERR_ARG;);
+	LWIP_ERROR("netconn_send_multi: invalid sent", (sent != NULL), return ERR_ARG;);
+
+	LWIP_DEBUGF(API_LIB_DEBUG, ("netconn_send_multi: sending %" U16_F " netbufs\n", count));
+
+	API_MSG_VAR_ALLOC(msg);
+	API_MSG_VAR_REF(msg).conn = conn;
+	API_MSG_VAR_REF(msg).msg.bm.bufs = bufs;
+	API_MSG_VAR_REF(msg).msg.bm.count = count;
+	API_MSG_VAR_REF(msg).msg.bm.sent = 0;
+	err = netconn_apimsg(lwip_netconn_do_send_multi, &API_MSG_VAR_REF(msg));
+	*sent = API_MSG_VAR_REF(msg).msg.bm.sent;
+	API_MSG_VAR_FREE(msg);
+
+	return err;
+}
+#endif							/* LWIP_SOCKET_MMSG */
+
+/**
+ * Send data over a TCP netconn, by reference if 'ref' is not NULL.
+ * Shared by netconn_write_partly() and netconn_write_ref().
+ */
+static err_t netconn_write_internal(struct netconn *conn, struct pbuf *ref, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written)
 {
 	API_MSG_VAR_DECLARE(msg);
 	err_t err;
@@ -740,6 +766,11 @@ err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t siz
 	API_MSG_VAR_REF(msg).msg.w.dataptr = dataptr;
 	API_MSG_VAR_REF(msg).msg.w.apiflags = apiflags;
 	API_MSG_VAR_REF(msg).msg.w.len = size;
+#if LWIP_SENDFILE
+	API_MSG_VAR_REF(msg).msg.w.ref = ref;
+#else
+	LWIP_UNUSED_ARG(ref);
+#endif
 #if LWIP_SO_SNDTIMEO
 	if (conn->send_timeout != 0) {
 		/* get the time we started, which is later compared to
@@ -768,6 +799,45 @@ err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t siz
 	return err;
 }
 
+/**
+ * Send data over a TCP netconn.
+ *
+ * @param conn the TCP netconn over which to send data
+ * @param dataptr pointer to the application buffer that contains the data to send
+ * @param size size of the application data to send
+ * @param apiflags combination of following flags :
+ * - NETCONN_COPY: data will be copied into memory belonging to the stack
+ * - NETCONN_MORE: for TCP connection, PSH flag will be set on last segment sent
+ * - NETCONN_DONTBLOCK: only write the data if all data can be written at once
+ * @param bytes_written pointer to a location that receives the number of written bytes
+ * @return ERR_OK if data was sent, any other err_t on error
+ */
+err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written)
+{
+	return netconn_write_internal(conn, NULL, dataptr, size, apiflags, bytes_written);
+}
+
+#if LWIP_SENDFILE
+/**
+ * Send data held by a pbuf over a TCP netconn without copying it.
+ * The queued segments take their own references on 'ref', so the caller
+ * may free it once this returns.
+ *
+ * @param conn the TCP netconn over which to send data
+ * @param ref the pbuf that holds the data
+ * @param dataptr start of the data to send, inside ref
+ * @param size size of the data to send
+ * @param apiflags NETCONN_MORE and NETCONN_DONTBLOCK, NETCONN_COPY is ignored
+ * @param bytes_written pointer to a location that receives the number of written bytes
+ * @return ERR_OK if data was sent, any other err_t on error
+ */
+err_t netconn_write_ref(struct netconn *conn, struct pbuf *ref, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written)
+{
+	LWIP_ERROR("netconn_write_ref: invalid ref", (ref != NULL), return ERR_ARG;);
+	return netconn_write_internal(conn, ref, dataptr, size, apiflags & ~NETCONN_COPY, bytes_written);
+}
+#endif							/* LWIP_SENDFILE */
+
 /**
  * Close ot shutdown a TCP netconn (doesn't delete it).
  *
@@ -1360,6 +1360,50 @@ void lwip_netconn_do_listen(void *m)
 }
 #endif							/* LWIP_TCP */
 
+/** Send one netbuf on the RAW or UDP pcb of a netconn */
+static err_t netconn_send_netbuf(struct netconn *conn, struct netbuf *buf)
+{
+	err_t err;
+
+	if (ERR_IS_FATAL(conn->last_err)) {
+		return conn->last_err;
+	}
+	err = ERR_CONN;
+	if (conn->pcb.tcp != NULL) {
+		switch (NETCONNTYPE_GROUP(conn->type)) {
+#if LWIP_RAW
+		case NETCONN_RAW:
+			if (ip_addr_isany(&buf->addr) || IP_IS_ANY_TYPE_VAL(buf->addr)) {
+				err = raw_send(conn->pcb.raw, buf->p);
+			} else {
+				err = raw_sendto(conn->pcb.raw, buf->p, &buf->addr);
+			}
+			break;
+#endif
+#if LWIP_UDP
+		case NETCONN_UDP:
+#if LWIP_CHECKSUM_ON_COPY
+			if (ip_addr_isany(&buf->addr) || IP_IS_ANY_TYPE_VAL(buf->addr)) {
+				err = udp_send_chksum(conn->pcb.udp, buf->p, buf->flags & NETBUF_FLAG_CHKSUM, buf->toport_chksum);
+			} else {
+				err = udp_sendto_chksum(conn->pcb.udp, buf->p, &buf->addr, buf->port, buf->flags & NETBUF_FLAG_CHKSUM, buf->toport_chksum);
+			}
+#else							/* LWIP_CHECKSUM_ON_COPY */
+			if (ip_addr_isany_val(buf->addr) || IP_IS_ANY_TYPE_VAL(buf->addr)) {
+				err = udp_send(conn->pcb.udp, buf->p);
+			} else {
+				err = udp_sendto(conn->pcb.udp, buf->p, &buf->addr, buf->port);
+			}
+#endif							/* LWIP_CHECKSUM_ON_COPY */
+			break;
+#endif							/* LWIP_UDP */
+		default:
+			break;
+		}
+	}
+	return err;
+}
+
 /**
  * Send some data on a RAW or UDP pcb contained in a netconn
  * Called from netconn_send
@@ -1370,45 +1414,32 @@ void lwip_netconn_do_send(void *m)
 {
 	struct api_msg *msg = (struct api_msg *)m;
 
-	if (ERR_IS_FATAL(msg->conn->last_err)) {
-		msg->err = msg->conn->last_err;
-	} else {
-		msg->err = ERR_CONN;
-		if (msg->conn->pcb.tcp != NULL) {
-			switch (NETCONNTYPE_GROUP(msg->conn->type)) {
-#if LWIP_RAW
-			case NETCONN_RAW:
-				if (ip_addr_isany(&msg->msg.b->addr) || IP_IS_ANY_TYPE_VAL(msg->msg.b->addr)) {
-					msg->err = raw_send(msg->conn->pcb.raw, msg->msg.b->p);
-				} else {
-					msg->err = raw_sendto(msg->conn->pcb.raw, msg->msg.b->p, &msg->msg.b->addr);
-				}
-				break;
-#endif
-#if LWIP_UDP
-			case NETCONN_UDP:
-#if LWIP_CHECKSUM_ON_COPY
-				if (ip_addr_isany(&msg->msg.b->addr) || IP_IS_ANY_TYPE_VAL(msg->msg.b->addr)) {
-					msg->err = udp_send_chksum(msg->conn->pcb.udp, msg->msg.b->p, msg->msg.b->flags & NETBUF_FLAG_CHKSUM, msg->msg.b->toport_chksum);
-				} else {
-					msg->err = udp_sendto_chksum(msg->conn->pcb.udp, msg->msg.b->p, &msg->msg.b->addr, msg->msg.b->port, msg->msg.b->flags & NETBUF_FLAG_CHKSUM, msg->msg.b->toport_chksum);
-				}
-#else							/* LWIP_CHECKSUM_ON_COPY */
-				if (ip_addr_isany_val(msg->msg.b->addr) || IP_IS_ANY_TYPE_VAL(msg->msg.b->addr)) {
-					msg->err = udp_send(msg->conn->pcb.udp, msg->msg.b->p);
-				} else {
-					msg->err = udp_sendto(msg->conn->pcb.udp, msg->msg.b->p, &msg->msg.b->addr, msg->msg.b->port);
-				}
-#endif							/* LWIP_CHECKSUM_ON_COPY */
-				break;
-#endif							/* LWIP_UDP */
-			default:
-				break;
-			}
+	msg->err = netconn_send_netbuf(msg->conn, msg->msg.b);
+	TCPIP_APIMSG_ACK(msg);
+}
+
+#if LWIP_SOCKET_MMSG
+/**
+ * Send several netbufs on a RAW or UDP pcb contained in a netconn, stopping
+ * at the first one that fails.
+ * Called from netconn_send_multi
+ *
+ * @param m the api_msg_msg pointing to the connection
+ */
+void lwip_netconn_do_send_multi(void *m)
+{
+	struct api_msg *msg = (struct api_msg *)m;
+
+	msg->err = ERR_OK;
+	for (msg->msg.bm.sent = 0; msg->msg.bm.sent < msg->msg.bm.count; msg->msg.bm.sent++) {
+		msg->err = netconn_send_netbuf(msg->conn, msg->msg.bm.bufs[msg->msg.bm.sent]);
+		if (msg->err != ERR_OK) {
+			break;
 		}
 	}
 	TCPIP_APIMSG_ACK(msg);
 }
+#endif							/* LWIP_SOCKET_MMSG */
 
 #if LWIP_TCP
 /**
@@ -1523,7 +1554,14 @@ static err_t lwip_netconn_do_writemore(struct netconn *conn WRITE_DELAYED_PARAM)
 			}
 		}
 		LWIP_ASSERT("lwip_netconn_do_writemore: invalid length!", ((conn->write_offset + len) <= conn->current_msg->msg.w.len));
-		err = tcp_write(conn->pcb.tcp, dataptr, len, apiflags);
+#if LWIP_SENDFILE
+		if (conn->current_msg->msg.w.ref != NULL) {
+			err = tcp_write_ref(conn->pcb.tcp, conn->current_msg->msg.w.ref, dataptr, len, apiflags);
+		} else
+#endif
+		{
+			err = tcp_write(conn->pcb.tcp, dataptr, len, apiflags);
+		}
 		/* if OK or memory error, check available space */
 		if ((err == ERR_OK) || (err == ERR_MEM)) {
 err_mem:
@@ -335,6 +335,52 @@ static struct lwip_select_cb *select_cb_list;
     and checked in event_callback to see if it has changed. */
 static volatile int select_cb_ctr;
 
+#if LWIP_SOCKET_EPOLL
+struct lwip_epoll;
+
+/** Registration of a socket with an epoll instance */
+struct lwip_epoll_item {
+	/** next registration of the same socket */
+	struct lwip_epoll_item *sock_next;
+	/** next item on the ready list of the instance */
+	struct lwip_epoll_item *ready_next;
+	/** owning instance, NULL while the item is free */
+	struct lwip_epoll *ep;
+	/** watched socket descriptor */
+	int fd;
+	/** requested EPOLL* events, EPOLLERR is always included */
+	u32_t events;
+	/** returned to the user together with the events */
+	epoll_data_t data;
+	/** 1 while the item is on the ready list */
+	u8_t queued;
+};
+
+/** An epoll instance: sockets with pending events are queued on its ready
+    list by event_callback, so lwip_epoll_wait never scans idle sockets. */
+struct lwip_epoll {
+	/** 1 while the descriptor is open */
+	u8_t used;
+	/** 1 while a task sleeps in lwip_epoll_wait */
+	u8_t waiting;
+	/** the semaphore is kept for the lifetime of the slot */
+	u8_t sem_valid;
+	/** ready list, in the order the events came in */
+	struct lwip_epoll_item *ready_head;
+	struct lwip_epoll_item *ready_tail;
+	/** semaphore to wake up the waiting task */
+	sys_sem_t sem;
+};
+
+/** Epoll descriptors are numbered after the socket descriptors */
+#define EPOLL_FD_OFFSET (LWIP_SOCKET_OFFSET + NUM_SOCKETS)
+
+static struct lwip_epoll epolls[LWIP_SOCKET_EPOLL_MAX];
+static struct lwip_epoll_item epoll_items[LWIP_SOCKET_EPOLL_ITEMS];
+/** Registrations of each socket, indexed like sockets[] */
+static struct lwip_epoll_item *epoll_sock_items[NUM_SOCKETS];
+#endif							/* LWIP_SOCKET_EPOLL */
+
 #if LWIP_SOCKET_SET_ERRNO
 #ifdef ERRNO
 #ifndef set_errno
@@ -358,6 +404,9 @@ static volatile int select_cb_ctr;
 
 /* Forward delcaration of some functions */
 static void event_callback(struct netconn *conn, enum netconn_evt evt, u16_t len);
+#if LWIP_SOCKET_EPOLL
+static int lwip_epoll_close(int epfd);
+#endif
 #if !LWIP_TCPIP_CORE_LOCKING
 static void lwip_getsockopt_callback(void *arg);
 static void lwip_setsockopt_callback(void *arg);
@@ -542,6 +591,95 @@ struct socket *trycheck_selwait_socket(int s)
 	return NULL;
 }
 
+#if LWIP_SOCKET_EPOLL
+/** Current EPOLL* state of a socket, called with SYS_ARCH protected */
+static u32_t epoll_sock_events(struct socket *sock)
+{
+	u32_t events = 0;
+
+	if (sock->lastdata != NULL || sock->rcvevent > 0) {
+		events |= EPOLLIN;
+	}
+	if (sock->sendevent != 0) {
+		events |= EPOLLOUT;
+	}
+	if (sock->errevent != 0) {
+		events |= EPOLLERR;
+	}
+	return events;
+}
+
+/** Append an item to the ready list of its instance and wake up the waiter,
+    called with SYS_ARCH protected */
+static void epoll_queue_item(struct lwip_epoll_item *item)
+{
+	struct lwip_epoll *ep = item->ep;
+
+	if (item->queued) {
+		return;
+	}
+	item->queued = 1;
+	item->ready_next = NULL;
+	if (ep->ready_tail != NULL) {
+		ep->ready_tail->ready_next = item;
+	} else {
+		ep->ready_head = item;
+	}
+	ep->ready_tail = item;
+
+	if (ep->waiting) {
+		ep->waiting = 0;
+		sys_sem_signal(&ep->sem);
+	}
+}
+
+/** Take an item off the ready list, called with SYS_ARCH protected */
+static void epoll_unqueue_item(struct lwip_epoll_item *item)
+{
+	struct lwip_epoll *ep = item->ep;
+	struct lwip_epoll_item *prev = NULL;
+	struct lwip_epoll_item *it;
+
+	if (!item->queued) {
+		return;
+	}
+	for (it = ep->ready_head; it != NULL; prev = it, it = it->ready_next) {
+		if (it == item) {
+			if (prev != NULL) {
+				prev->ready_next = it->ready_next;
+			} else {
+				ep->ready_head = it->ready_next;
+			}
+			if (ep->ready_tail == it) {
+				ep->ready_tail = prev;
+			}
+			break;
+		}
+	}
+	item->queued = 0;
+	item->ready_next = NULL;
+}
+
+/** Drop all epoll registrations of a socket that is being freed */
+static void epoll_drop_socket(struct socket *sock)
+{
+	struct lwip_epoll_item *item;
+	struct lwip_epoll_item *next;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	item = epoll_sock_items[sock - sockets];
+	epoll_sock_items[sock - sockets] = NULL;
+	for (; item != NULL; item = next) {
+		next = item->sock_next;
+		epoll_unqueue_item(item);
+		item->sock_next = NULL;
+		item->ep = NULL;
+	}
+	SYS_ARCH_UNPROTECT(lev);
+}
+#endif							/* LWIP_SOCKET_EPOLL */
+
 /**
  * Allocate a new socket for a given netconn.
  *
@@ -595,6 +733,10 @@ void free_socket(struct socket *sock, int is_tcp)
 	sock->lastoffset = 0;
 	sock->err = 0;
 
+#if LWIP_SOCKET_EPOLL
+	epoll_drop_socket(sock);
+#endif
+
 	/* Protect socket array */
 	SYS_ARCH_SET(sock->conn, NULL);
 	/* don't use 'sock' after this line, as another task might have allocated it */
@@ -758,6 +900,12 @@ int lwip_close(int s)
 
 	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_close(%d)\n", s));
 
+#if LWIP_SOCKET_EPOLL
+	if (s >= EPOLL_FD_OFFSET) {
+		return lwip_epoll_close(s);
+	}
+#endif
+
 	sock = get_socket(s);
 	if (!sock) {
 		return -1;
@@ -890,6 +1038,41 @@ int lwip_listen(int s, int backlog)
 	return 0;
 }
 
+/* Store the source address of the data in 'buf', a pbuf for TCP sockets
+ * and a netbuf otherwise, into 'from'.
+ */
+static void lwip_recv_fromaddr(struct socket *sock, void *buf, struct sockaddr *from, socklen_t *fromlen)
+{
+	u16_t port;
+	ip_addr_t tmpaddr;
+	ip_addr_t *fromaddr;
+	union sockaddr_aligned saddr;
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+		fromaddr = &tmpaddr;
+		netconn_getaddr(sock->conn, fromaddr, &port, 0);
+	} else {
+		port = netbuf_fromport((struct netbuf *)buf);
+		fromaddr = netbuf_fromaddr((struct netbuf *)buf);
+	}
+
+#if LWIP_IPV4 && LWIP_IPV6
+	/* Dual-stack: Map IPv4 addresses to IPv4 mapped IPv6 */
+	if (NETCONNTYPE_ISIPV6(netconn_type(sock->conn)) && IP_IS_V4(fromaddr)) {
+		ip4_2_ipv4_mapped_ipv6(ip_2_ip6(fromaddr), ip_2_ip4(fromaddr));
+		IP_SET_TYPE(fromaddr, IPADDR_TYPE_V6);
+	}
+#endif							/* LWIP_IPV4 && LWIP_IPV6 */
+
+	IPADDR_PORT_TO_SOCKADDR(&saddr, fromaddr, port);
+	ip_addr_debug_print(SOCKETS_DEBUG, fromaddr);
+	LWIP_DEBUGF(SOCKETS_DEBUG, (" port=%" U16_F "\n", port));
+	if (*fromlen > saddr.sa.sa_len) {
+		*fromlen = saddr.sa.sa_len;
+	}
+	MEMCPY(from, &saddr, *fromlen);
+}
+
 int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen)
 {
 	struct socket *sock;
@@ -994,34 +1177,8 @@ int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from
 		/* Check to see from where the data was. */
 		if (done) {
 			if (from && fromlen) {
-				u16_t port;
-				ip_addr_t tmpaddr;
-				ip_addr_t *fromaddr;
-				union sockaddr_aligned saddr;
-				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom(%d): addr=", s));
-				if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
-					fromaddr = &tmpaddr;
-					netconn_getaddr(sock->conn, fromaddr, &port, 0);
-				} else {
-					port = netbuf_fromport((struct netbuf *)buf);
-					fromaddr = netbuf_fromaddr((struct netbuf *)buf);
-				}
-
-#if LWIP_IPV4 && LWIP_IPV6
-				/* Dual-stack: Map IPv4 addresses to IPv4 mapped IPv6 */
-				if (NETCONNTYPE_ISIPV6(netconn_type(sock->conn)) && IP_IS_V4(fromaddr)) {
-					ip4_2_ipv4_mapped_ipv6(ip_2_ip6(fromaddr), ip_2_ip4(fromaddr));
-					IP_SET_TYPE(fromaddr, IPADDR_TYPE_V6);
-				}
-#endif							/* LWIP_IPV4 && LWIP_IPV6 */
-
-				IPADDR_PORT_TO_SOCKADDR(&saddr, fromaddr, port);
-				ip_addr_debug_print(SOCKETS_DEBUG, fromaddr);
-				LWIP_DEBUGF(SOCKETS_DEBUG, (" port=%" U16_F " len=%d\n", port, off));
-				if (*fromlen > saddr.sa.sa_len) {
-					*fromlen = saddr.sa.sa_len;
-				}
-				MEMCPY(from, &saddr, *fromlen);
+				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom(%d): len=%d addr=", s, off));
+				lwip_recv_fromaddr(sock, buf, from, fromlen);
 			}
 		}
 
@@ -1095,11 +1252,99 @@ int lwip_send(int s, const void *data, size_t size, int flags)
 	return (err == ERR_OK ? (int)written : -1);
 }
 
+#if LWIP_UDP || LWIP_RAW
+/* Build the netbuf sending the datagram described by 'msg' on a UDP or RAW
+ * socket. The netbuf references the data of the IO vectors unless
+ * LWIP_NETIF_TX_SINGLE_PBUF is set.
+ */
+static err_t lwip_sendmsg_netbuf(const struct msghdr *msg, struct netbuf **out)
+{
+	struct netbuf *chain_buf;
+#if LWIP_NETIF_TX_SINGLE_PBUF
+	int size = 0;
+#endif
+	int i;
+	err_t err = ERR_OK;
+
+	LWIP_ERROR("lwip_sendmsg: invalid msghdr name", (((msg->msg_name == NULL) && (msg->msg_namelen == 0)) || IS_SOCK_ADDR_LEN_VALID(msg->msg_namelen)), return ERR_ARG;);
+
+	/* initialize chain buffer with destination */
+	chain_buf = netbuf_new();
+	if (!chain_buf) {
+		return ERR_MEM;
+	}
+	if (msg->msg_name) {
+		u16_t remote_port;
+		SOCKADDR_TO_IPADDR_PORT((const struct sockaddr *)msg->msg_name, &chain_buf->addr, remote_port);
+		netbuf_fromport(chain_buf) = remote_port;
+	}
+#if LWIP_NETIF_TX_SINGLE_PBUF
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		size += msg->msg_iov[i].iov_len;
+	}
+	/* Allocate a new netbuf and copy the data into it. */
+	if (netbuf_alloc(chain_buf, (u16_t) size) == NULL) {
+		err = ERR_MEM;
+	} else {
+		/* flatten the IO vectors */
+		size_t offset = 0;
+		for (i = 0; i < msg->msg_iovlen; i++) {
+			MEMCPY(&((u8_t *) chain_buf->p->payload)[offset], msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+			offset += msg->msg_iov[i].iov_len;
+		}
+#if LWIP_CHECKSUM_ON_COPY
+		{
+			/* This can be improved by using LWIP_CHKSUM_COPY() and aggregating the checksum for each IO vector */
+			u16_t chksum = ~inet_chksum_pbuf(chain_buf->p);
+			netbuf_set_chksum(chain_buf, chksum);
+		}
+#endif							/* LWIP_CHECKSUM_ON_COPY */
+		err = ERR_OK;
+	}
+#else							/* LWIP_NETIF_TX_SINGLE_PBUF */
+	/* create a chained netbuf from the IO vectors. NOTE: we assemble a pbuf chain
+	   manually to avoid having to allocate, chain, and delete a netbuf for each iov */
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_REF);
+		if (p == NULL) {
+			err = ERR_MEM;	/* let netbuf_delete() cleanup chain_buf */
+			break;
+		}
+		p->payload = msg->msg_iov[i].iov_base;
+		LWIP_ASSERT("iov_len < u16_t", msg->msg_iov[i].iov_len <= 0xFFFF);
+		p->len = p->tot_len = (u16_t) msg->msg_iov[i].iov_len;
+		/* netbuf empty, add new pbuf */
+		if (chain_buf->p == NULL) {
+			chain_buf->p = chain_buf->ptr = p;
+			/* add pbuf to existing pbuf chain */
+		} else {
+			pbuf_cat(chain_buf->p, p);
+		}
+	}
+#endif							/* LWIP_NETIF_TX_SINGLE_PBUF */
+
+#if LWIP_IPV4 && LWIP_IPV6
+	/* Dual-stack: Unmap IPv4 mapped IPv6 addresses */
+	if (err == ERR_OK && IP_IS_V6_VAL(chain_buf->addr) && ip6_addr_isipv4mappedipv6(ip_2_ip6(&chain_buf->addr))) {
+		unmap_ipv4_mapped_ipv6(ip_2_ip4(&chain_buf->addr), ip_2_ip6(&chain_buf->addr));
+		IP_SET_TYPE_VAL(chain_buf->addr, IPADDR_TYPE_V4);
+	}
+#endif							/* LWIP_IPV4 && LWIP_IPV6 */
+
+	if (err != ERR_OK) {
+		netbuf_delete(chain_buf);
+		return err;
+	}
+	*out = chain_buf;
+	return ERR_OK;
+}
+#endif							/* LWIP_UDP || LWIP_RAW */
+
 int lwip_sendmsg(int s, const struct msghdr *msg, int flags)
 {
 	struct socket *sock;
-	int i;
 #if LWIP_TCP
+	int i;
 	u8_t write_flags;
 	size_t written;
 #endif
@@ -1159,92 +1404,241 @@ int lwip_sendmsg(int s, const struct msghdr *msg, int flags)
 		struct netbuf *chain_buf;
 
 		LWIP_UNUSED_ARG(flags);
-		LWIP_ERROR("lwip_sendmsg: invalid msghdr name", (((msg->msg_name == NULL) && (msg->msg_namelen == 0)) || IS_SOCK_ADDR_LEN_VALID(msg->msg_namelen)), sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
 
-		/* initialize chain buffer with destination */
-		chain_buf = netbuf_new();
-		if (!chain_buf) {
-			sock_set_errno(sock, err_to_errno(ERR_MEM));
+		err = lwip_sendmsg_netbuf(msg, &chain_buf);
+		if (err == ERR_OK) {
+			size = netbuf_len(chain_buf);
+
+			/* send the data */
+			err = netconn_send(sock->conn, chain_buf);
+
+			/* deallocated the buffer */
+			netbuf_delete(chain_buf);
+		}
+
+		sock_set_errno(sock, err_to_errno(err));
+		return (err == ERR_OK ? size : -1);
+	}
+#else							/* LWIP_UDP || LWIP_RAW */
+	sock_set_errno(sock, err_to_errno(ERR_ARG));
+	return -1;
+#endif							/* LWIP_UDP || LWIP_RAW */
+}
+
+#if LWIP_SOCKET_MMSG
+#if LWIP_UDP || LWIP_RAW
+/* Receive one datagram into the IO vectors of 'msg'. Returns its length, or
+ * -1 with errno set.
+ */
+static int lwip_recvmsg_dgram(int s, struct socket *sock, struct msghdr *msg, int flags)
+{
+	struct netbuf *buf;
+	u16_t buflen;
+	u16_t off = 0;
+	int i;
+	err_t err;
+
+	/* with no IO vectors the datagram is consumed and reported truncated */
+	if (msg->msg_iov == NULL && msg->msg_iovlen > 0) {
+		sock_set_errno(sock, EINVAL);
+		return -1;
+	}
+
+	if (sock->lastdata) {
+		buf = (struct netbuf *)sock->lastdata;
+	} else {
+		if (((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn)) && (sock->rcvevent <= 0)) {
+			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvmmsg(%d): returning EWOULDBLOCK\n", s));
+			set_errno(EWOULDBLOCK);
 			return -1;
 		}
-		if (msg->msg_name) {
-			u16_t remote_port;
-			SOCKADDR_TO_IPADDR_PORT((const struct sockaddr *)msg->msg_name, &chain_buf->addr, remote_port);
-			netbuf_fromport(chain_buf) = remote_port;
+		err = netconn_recv(sock->conn, &buf);
+		if (err != ERR_OK) {
+			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvmmsg(%d): error is \"%s\"!\n", s, lwip_strerr(err)));
+			sock_set_errno(sock, err_to_errno(err));
+			return -1;
 		}
-#if LWIP_NETIF_TX_SINGLE_PBUF
-		for (i = 0; i < msg->msg_iovlen; i++) {
-			size += msg->msg_iov[i].iov_len;
+	}
+
+	/* scatter the datagram over the IO vectors, the rest is discarded */
+	buflen = buf->p->tot_len;
+	for (i = 0; i < msg->msg_iovlen && off < buflen; i++) {
+		u16_t copylen = buflen - off;
+		if (msg->msg_iov[i].iov_len < copylen) {
+			copylen = (u16_t)msg->msg_iov[i].iov_len;
 		}
-		/* Allocate a new netbuf and copy the data into it. */
-		if (netbuf_alloc(chain_buf, (u16_t) size) == NULL) {
-			err = ERR_MEM;
+		pbuf_copy_partial(buf->p, msg->msg_iov[i].iov_base, copylen, off);
+		off += copylen;
+	}
+	msg->msg_flags = (off < buflen) ? MSG_TRUNC : 0;
+	msg->msg_controllen = 0;
+
+	if (msg->msg_name && msg->msg_namelen) {
+		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvmmsg(%d): len=%d addr=", s, off));
+		lwip_recv_fromaddr(sock, buf, (struct sockaddr *)msg->msg_name, &msg->msg_namelen);
+	}
+
+	if ((flags & MSG_PEEK) == 0) {
+		sock->lastdata = NULL;
+		netbuf_delete(buf);
+	} else {
+		sock->lastdata = buf;
+	}
+	return off;
+}
+#endif							/* LWIP_UDP || LWIP_RAW */
+
+int lwip_recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+	struct socket *sock;
+	unsigned int count;
+	u32_t start = 0;
+	u32_t wait = 0;
+	int ret;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvmmsg(%d, %p, %u, 0x%x, ..)\n", s, msgvec, vlen, flags));
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	LWIP_ERROR("lwip_recvmmsg: invalid msgvec", (msgvec != NULL && vlen > 0), sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
+	if (timeout) {
+		start = sys_now();
+		wait = (u32_t)timeout->tv_sec * 1000 + (u32_t)(timeout->tv_nsec / 1000000);
+	}
+
+	for (count = 0; count < vlen; count++) {
+		struct msghdr *msg = &msgvec[count].msg_hdr;
+
+		if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+			/* a stream has no message boundaries, fill the first IO vector */
+			if (msg->msg_iov == NULL || msg->msg_iovlen == 0) {
+				sock_set_errno(sock, EINVAL);
+				ret = -1;
+			} else {
+				ret = lwip_recvfrom(s, msg->msg_iov->iov_base, msg->msg_iov->iov_len, flags & ~MSG_WAITFORONE, NULL, NULL);
+				msg->msg_flags = 0;
+				msg->msg_controllen = 0;
+			}
 		} else {
-			/* flatten the IO vectors */
-			size_t offset = 0;
-			for (i = 0; i < msg->msg_iovlen; i++) {
-				MEMCPY(&((u8_t *) chain_buf->p->payload)[offset], msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
-				offset += msg->msg_iov[i].iov_len;
+#if LWIP_UDP || LWIP_RAW
+			ret = lwip_recvmsg_dgram(s, sock, msg, flags);
+#else
+			sock_set_errno(sock, err_to_errno(ERR_ARG));
+			ret = -1;
+#endif
+		}
+
+		if (ret < 0) {
+			if (count > 0) {
+				/* return the datagrams already received, the error shows up
+				   on the next call */
+				break;
 			}
-#if LWIP_CHECKSUM_ON_COPY
-			{
-				/* This can be improved by using LWIP_CHKSUM_COPY() and aggregating the checksum for each IO vector */
-				u16_t chksum = ~inet_chksum_pbuf(chain_buf->p);
-				netbuf_set_chksum(chain_buf, chksum);
+			return -1;
+		}
+		msgvec[count].msg_len = (unsigned int)ret;
+		if (ret == 0 && NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+			/* peer closed */
+			count++;
+			break;
+		}
+
+		if (flags & MSG_WAITFORONE) {
+			flags |= MSG_DONTWAIT;
+		}
+		/* Like Linux, the timeout is only checked after each datagram */
+		if (timeout && (u32_t)(sys_now() - start) >= wait) {
+			count++;
+			break;
+		}
+	}
+
+	sock_set_errno(sock, 0);
+	return (int)count;
+}
+
+int lwip_sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	struct socket *sock;
+	unsigned int count = 0;
+	err_t err = ERR_OK;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_sendmmsg(%d, %p, %u, 0x%x)\n", s, msgvec, vlen, flags));
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	LWIP_ERROR("lwip_sendmmsg: invalid msgvec", (msgvec != NULL && vlen > 0), sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+		int ret;
+
+		for (count = 0; count < vlen; count++) {
+			ret = lwip_sendmsg(s, &msgvec[count].msg_hdr, flags);
+			if (ret < 0) {
+				return (count > 0) ? (int)count : -1;
 			}
-#endif							/* LWIP_CHECKSUM_ON_COPY */
-			err = ERR_OK;
+			msgvec[count].msg_len = (unsigned int)ret;
 		}
-#else							/* LWIP_NETIF_TX_SINGLE_PBUF */
-		/* create a chained netbuf from the IO vectors. NOTE: we assemble a pbuf chain
-		   manually to avoid having to allocate, chain, and delete a netbuf for each iov */
-		for (i = 0; i < msg->msg_iovlen; i++) {
-			struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_REF);
-			if (p == NULL) {
-				err = ERR_MEM;	/* let netbuf_delete() cleanup chain_buf */
+		return (int)count;
+	}
+#if LWIP_UDP || LWIP_RAW
+	LWIP_UNUSED_ARG(flags);
+
+	/* Build up to LWIP_SOCKET_MMSG_BATCH netbufs and send them with a single
+	   call into the tcpip thread. */
+	while (count < vlen && err == ERR_OK) {
+		struct netbuf *bufs[LWIP_SOCKET_MMSG_BATCH];
+		u16_t n;
+		u16_t i;
+		u16_t sent;
+		err_t send_err;
+
+		for (n = 0; n < LWIP_SOCKET_MMSG_BATCH && count + n < vlen; n++) {
+			struct msghdr *msg = &msgvec[count + n].msg_hdr;
+			if (msg->msg_iov == NULL || msg->msg_iovlen == 0) {
+				err = ERR_ARG;
 				break;
 			}
-			p->payload = msg->msg_iov[i].iov_base;
-			LWIP_ASSERT("iov_len < u16_t", msg->msg_iov[i].iov_len <= 0xFFFF);
-			p->len = p->tot_len = (u16_t) msg->msg_iov[i].iov_len;
-			/* netbuf empty, add new pbuf */
-			if (chain_buf->p == NULL) {
-				chain_buf->p = chain_buf->ptr = p;
-				/* add pbuf to existing pbuf chain */
-			} else {
-				pbuf_cat(chain_buf->p, p);
+			err = lwip_sendmsg_netbuf(msg, &bufs[n]);
+			if (err != ERR_OK) {
+				break;
 			}
 		}
-		/* save size of total chain */
-		if (err == ERR_OK) {
-			size = netbuf_len(chain_buf);
+		if (n == 0) {
+			break;
 		}
-#endif							/* LWIP_NETIF_TX_SINGLE_PBUF */
 
-		if (err == ERR_OK) {
-#if LWIP_IPV4 && LWIP_IPV6
-			/* Dual-stack: Unmap IPv4 mapped IPv6 addresses */
-			if (IP_IS_V6_VAL(chain_buf->addr) && ip6_addr_isipv4mappedipv6(ip_2_ip6(&chain_buf->addr))) {
-				unmap_ipv4_mapped_ipv6(ip_2_ip4(&chain_buf->addr), ip_2_ip6(&chain_buf->addr));
-				IP_SET_TYPE_VAL(chain_buf->addr, IPADDR_TYPE_V4);
+		sent = 0;
+		send_err = netconn_send_multi(sock->conn, bufs, n, &sent);
+		for (i = 0; i < n; i++) {
+			if (i < sent) {
+				msgvec[count + i].msg_len = netbuf_len(bufs[i]);
 			}
-#endif							/* LWIP_IPV4 && LWIP_IPV6 */
-
-			/* send the data */
-			err = netconn_send(sock->conn, chain_buf);
+			netbuf_delete(bufs[i]);
 		}
+		count += sent;
+		if (send_err != ERR_OK) {
+			err = send_err;
+		}
+	}
 
-		/* deallocated the buffer */
-		netbuf_delete(chain_buf);
-
+	if (count == 0) {
 		sock_set_errno(sock, err_to_errno(err));
-		return (err == ERR_OK ? size : -1);
+		return -1;
 	}
+	/* report the datagrams sent before the error, as Linux does */
+	sock_set_errno(sock, 0);
+	return (int)count;
 #else							/* LWIP_UDP || LWIP_RAW */
 	sock_set_errno(sock, err_to_errno(ERR_ARG));
 	return -1;
 #endif							/* LWIP_UDP || LWIP_RAW */
 }
+#endif							/* LWIP_SOCKET_MMSG */
 
 int lwip_sendto(int s, const void *data, size_t size, int flags, const struct sockaddr *to, socklen_t tolen)
 {
@@ -1882,6 +2276,42 @@ int lwip_poll(int fd, struct pollfd *fds, bool setup)
 
 #endif							/*LWIP_SELECT */
 
+#if LWIP_SOCKET_EPOLL
+/**
+ * Queue the epoll registrations of a socket that became ready. Only events
+ * that make the socket ready queue it: a level-triggered item that is no
+ * longer ready is dropped by lwip_epoll_wait, and an edge-triggered item is
+ * queued again on each new event. Called with SYS_ARCH protected.
+ */
+static void epoll_sock_event(struct socket *sock, int s, enum netconn_evt evt)
+{
+	struct lwip_epoll_item *item;
+	u32_t edge;
+	u32_t ready;
+
+	switch (evt) {
+	case NETCONN_EVT_RCVPLUS:
+		edge = EPOLLIN;
+		break;
+	case NETCONN_EVT_SENDPLUS:
+		edge = EPOLLOUT;
+		break;
+	case NETCONN_EVT_ERROR:
+		edge = EPOLLERR;
+		break;
+	default:
+		return;
+	}
+
+	ready = epoll_sock_events(sock) & edge;
+	for (item = epoll_sock_items[s - LWIP_SOCKET_OFFSET]; item != NULL; item = item->sock_next) {
+		if (item->events & ready) {
+			epoll_queue_item(item);
+		}
+	}
+}
+#endif							/* LWIP_SOCKET_EPOLL */
+
 /**
  * Callback registered in the netconn layer for each socket-netconn.
  * Processes recvevent (data available) and wakes up tasks waiting for select.
@@ -1948,6 +2378,10 @@ static void event_callback(struct netconn *conn, enum netconn_evt evt, u16_t len
 		break;
 	}
 
+#if LWIP_SOCKET_EPOLL
+	epoll_sock_event(sock, s, evt);
+#endif
+
 	if (sock->select_waiting == 0) {
 		/* none is waiting for this socket, no need to check select_cb_list */
 		SYS_ARCH_UNPROTECT(lev);
@@ -2022,6 +2456,320 @@ again:
 	SYS_ARCH_UNPROTECT(lev);
 }
 
+#if LWIP_SOCKET_EPOLL
+/** Map an epoll descriptor to its instance, sets errno on failure */
+static struct lwip_epoll *get_epoll(int epfd)
+{
+	int i = epfd - EPOLL_FD_OFFSET;
+
+	if (i < 0 || i >= LWIP_SOCKET_EPOLL_MAX || !epolls[i].used) {
+		LWIP_DEBUGF(SOCKETS_DEBUG, ("get_epoll(%d): invalid\n", epfd));
+		set_errno(EBADF);
+		return NULL;
+	}
+	return &epolls[i];
+}
+
+/**
+ * Open an epoll instance. The descriptor is released with lwip_close().
+ *
+ * @param size ignored, must be positive as on Linux
+ * @return the epoll descriptor; -1 on error
+ */
+int lwip_epoll_create(int size)
+{
+	struct lwip_epoll *ep;
+	int i;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	if (size <= 0) {
+		set_errno(EINVAL);
+		return -1;
+	}
+
+	for (i = 0; i < LWIP_SOCKET_EPOLL_MAX; i++) {
+		ep = &epolls[i];
+		SYS_ARCH_PROTECT(lev);
+		if (!ep->used) {
+			ep->used = 1;
+			ep->waiting = 0;
+			ep->ready_head = NULL;
+			ep->ready_tail = NULL;
+			SYS_ARCH_UNPROTECT(lev);
+			if (!ep->sem_valid) {
+				if (sys_sem_new(&ep->sem, 0) != ERR_OK) {
+					ep->used = 0;
+					set_errno(ENOMEM);
+					return -1;
+				}
+				ep->sem_valid = 1;
+			}
+			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_epoll_create() = %d\n", i + EPOLL_FD_OFFSET));
+			return i + EPOLL_FD_OFFSET;
+		}
+		SYS_ARCH_UNPROTECT(lev);
+	}
+
+	set_errno(EMFILE);
+	return -1;
+}
+
+/** Close an epoll instance and drop all its registrations */
+static int lwip_epoll_close(int epfd)
+{
+	struct lwip_epoll *ep;
+	struct lwip_epoll_item **pitem;
+	int i;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	ep = get_epoll(epfd);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	SYS_ARCH_PROTECT(lev);
+	for (i = 0; i < NUM_SOCKETS; i++) {
+		pitem = &epoll_sock_items[i];
+		while (*pitem != NULL) {
+			if ((*pitem)->ep == ep) {
+				struct lwip_epoll_item *item = *pitem;
+				*pitem = item->sock_next;
+				item->sock_next = NULL;
+				item->ready_next = NULL;
+				item->queued = 0;
+				item->ep = NULL;
+			} else {
+				pitem = &(*pitem)->sock_next;
+			}
+		}
+	}
+	ep->ready_head = NULL;
+	ep->ready_tail = NULL;
+	ep->used = 0;
+	if (ep->waiting) {
+		/* let the waiter see the instance is gone */
+		ep->waiting = 0;
+		sys_sem_signal(&ep->sem);
+	}
+	SYS_ARCH_UNPROTECT(lev);
+
+	set_errno(0);
+	return 0;
+}
+
+/**
+ * Add, modify or remove the registration of a socket with an epoll instance.
+ * A socket that is already ready is queued right away.
+ *
+ * @param epfd the epoll descriptor
+ * @param op EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ * @param fd the socket descriptor
+ * @param event requested events and user data, unused for EPOLL_CTL_DEL
+ * @return 0 on success; -1 on error
+ */
+int lwip_epoll_ctl(int epfd, int op, int fd, struct epoll_event *event)
+{
+	struct lwip_epoll *ep;
+	struct socket *sock;
+	struct lwip_epoll_item **pitem;
+	struct lwip_epoll_item *item;
+	int err = 0;
+	int i;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_epoll_ctl(%d, %d, %d)\n", epfd, op, fd));
+
+	ep = get_epoll(epfd);
+	if (ep == NULL) {
+		return -1;
+	}
+	sock = get_socket(fd);
+	if (sock == NULL) {
+		return -1;
+	}
+	if (op != EPOLL_CTL_DEL && event == NULL) {
+		set_errno(EFAULT);
+		return -1;
+	}
+
+	SYS_ARCH_PROTECT(lev);
+	for (pitem = &epoll_sock_items[fd - LWIP_SOCKET_OFFSET]; *pitem != NULL; pitem = &(*pitem)->sock_next) {
+		if ((*pitem)->ep == ep) {
+			break;
+		}
+	}
+	item = *pitem;
+
+	switch (op) {
+	case EPOLL_CTL_ADD:
+		if (item != NULL) {
+			err = EEXIST;
+			break;
+		}
+		for (i = 0; i < LWIP_SOCKET_EPOLL_ITEMS; i++) {
+			if (epoll_items[i].ep == NULL) {
+				item = &epoll_items[i];
+				break;
+			}
+		}
+		if (item == NULL) {
+			err = ENOMEM;
+			break;
+		}
+		item->ep = ep;
+		item->fd = fd;
+		item->queued = 0;
+		item->ready_next = NULL;
+		item->sock_next = *pitem;
+		*pitem = item;
+		/* fall through */
+	case EPOLL_CTL_MOD:
+		if (item == NULL) {
+			err = ENOENT;
+			break;
+		}
+		item->events = event->events | EPOLLERR;
+		item->data = event->data;
+		if (epoll_sock_events(sock) & item->events) {
+			epoll_queue_item(item);
+		}
+		break;
+	case EPOLL_CTL_DEL:
+		if (item == NULL) {
+			err = ENOENT;
+			break;
+		}
+		*pitem = item->sock_next;
+		epoll_unqueue_item(item);
+		item->sock_next = NULL;
+		item->ep = NULL;
+		break;
+	default:
+		err = EINVAL;
+		break;
+	}
+	SYS_ARCH_UNPROTECT(lev);
+
+	if (err != 0) {
+		set_errno(err);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Move up to maxevents ready items into events. Level-triggered items that
+ * are still ready go back to the tail of the ready list so that busy sockets
+ * take turns; edge-triggered items stay off until their next event.
+ * Called with SYS_ARCH protected.
+ */
+static int epoll_collect(struct lwip_epoll *ep, struct epoll_event *events, int maxevents)
+{
+	struct lwip_epoll_item *item;
+	struct lwip_epoll_item *requeue = NULL;
+	struct lwip_epoll_item **requeue_tail = &requeue;
+	u32_t ready;
+	int nready = 0;
+
+	while (nready < maxevents && (item = ep->ready_head) != NULL) {
+		ep->ready_head = item->ready_next;
+		if (ep->ready_head == NULL) {
+			ep->ready_tail = NULL;
+		}
+		item->queued = 0;
+		item->ready_next = NULL;
+
+		ready = epoll_sock_events(&sockets[item->fd - LWIP_SOCKET_OFFSET]) & item->events;
+		if (ready == 0) {
+			continue;
+		}
+		events[nready].events = ready;
+		events[nready].data = item->data;
+		nready++;
+
+		if (!(item->events & EPOLLET)) {
+			*requeue_tail = item;
+			requeue_tail = &item->ready_next;
+		}
+	}
+
+	while (requeue != NULL) {
+		item = requeue;
+		requeue = item->ready_next;
+		epoll_queue_item(item);
+	}
+	return nready;
+}
+
+/**
+ * Wait for events on the sockets registered with an epoll instance. Only the
+ * ready list is visited, so the cost does not depend on the number of
+ * watched sockets. One task is expected to wait on an instance at a time.
+ *
+ * @param epfd the epoll descriptor
+ * @param events filled with up to maxevents ready sockets
+ * @param maxevents size of events, must be positive
+ * @param timeout in milliseconds, 0 to poll, -1 to wait forever
+ * @return the number of entries in events; 0 on timeout; -1 on error
+ */
+int lwip_epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+	struct lwip_epoll *ep;
+	u32_t start = 0;
+	u32_t elapsed;
+	u32_t msectimeout;
+	int nready;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_epoll_wait(%d, %d, %d)\n", epfd, maxevents, timeout));
+
+	if (events == NULL || maxevents <= 0) {
+		set_errno(EINVAL);
+		return -1;
+	}
+	ep = get_epoll(epfd);
+	if (ep == NULL) {
+		return -1;
+	}
+	if (timeout > 0) {
+		start = sys_now();
+	}
+
+	for (;;) {
+		SYS_ARCH_PROTECT(lev);
+		ep->waiting = 0;
+		if (!ep->used) {
+			SYS_ARCH_UNPROTECT(lev);
+			set_errno(EBADF);
+			return -1;
+		}
+		nready = epoll_collect(ep, events, maxevents);
+		if (nready > 0 || timeout == 0) {
+			SYS_ARCH_UNPROTECT(lev);
+			break;
+		}
+		/* sys_arch_sem_wait treats 0 as forever */
+		msectimeout = 0;
+		if (timeout > 0) {
+			elapsed = sys_now() - start;
+			if (elapsed >= (u32_t)timeout) {
+				SYS_ARCH_UNPROTECT(lev);
+				break;
+			}
+			msectimeout = (u32_t)timeout - elapsed;
+		}
+		ep->waiting = 1;
+		SYS_ARCH_UNPROTECT(lev);
+
+		sys_arch_sem_wait(&ep->sem, msectimeout);
+	}
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_epoll_wait: nready=%d\n", nready));
+	set_errno(0);
+	return nready;
+}
+#endif							/* LWIP_SOCKET_EPOLL */
+
 /**
  * Close one end of a full-duplex connection.
  */
@@ -142,6 +142,15 @@ struct tcp_pcb **const tcp_pcb_lists[] = { &tcp_listen_pcbs.pcbs, &tcp_bound_pcb
 		   &tcp_active_pcbs, &tcp_tw_pcbs
 };
 
+#if LWIP_TCP_PCB_HASH
+/** Active pcbs by ports and remote address */
+struct tcp_pcb *tcp_active_hash[TCP_PCB_HASH_SIZE];
+/** TIME-WAIT pcbs by ports and remote address */
+struct tcp_pcb *tcp_tw_hash[TCP_PCB_HASH_SIZE];
+/** Listening pcbs by local port */
+union tcp_listen_pcbs_t tcp_listen_hash[TCP_PCB_HASH_SIZE];
+#endif							/* LWIP_TCP_PCB_HASH */
+
 u8_t tcp_active_pcbs_changed;
 
 /** Timer counter to handle calling slow-timer from tcp_tmr() */
@@ -1117,6 +1126,7 @@ tcp_slowtmr_start:
 				LWIP_ASSERT("tcp_slowtmr: first pcb == tcp_active_pcbs", tcp_active_pcbs == pcb);
 				tcp_active_pcbs = pcb->next;
 			}
+			TCP_HASH_RMV(&tcp_active_pcbs, pcb);
 
 			if (pcb_reset) {
 				tcp_rst(pcb->snd_nxt, pcb->rcv_nxt, &pcb->local_ip, &pcb->remote_ip, pcb->local_port, pcb->remote_port);
@@ -1181,6 +1191,7 @@ tcp_slowtmr_start:
 				LWIP_ASSERT("tcp_slowtmr: first pcb == tcp_tw_pcbs", tcp_tw_pcbs == pcb);
 				tcp_tw_pcbs = pcb->next;
 			}
+			TCP_HASH_RMV(&tcp_tw_pcbs, pcb);
 			pcb2 = pcb;
 			pcb = pcb->next;
 			memp_free(MEMP_TCP_PCB, pcb2);
@@ -1765,6 +1776,80 @@ void tcp_pcb_purge(struct tcp_pcb *pcb)
 	}
 }
 
+#if LWIP_TCP_PCB_HASH
+/**
+ * Bucket index of a connection in tcp_active_hash and tcp_tw_hash. The local
+ * address is left out: there are only a few of them.
+ */
+u16_t tcp_pcb_hash(u16_t local_port, const ip_addr_t *remote_ip, u16_t remote_port)
+{
+	u32_t h = ((u32_t)local_port << 16) | remote_port;
+
+#if LWIP_IPV6
+	if (IP_IS_V6(remote_ip)) {
+		const ip6_addr_t *ip6 = ip_2_ip6(remote_ip);
+		h ^= ip6->addr[0] ^ ip6->addr[1] ^ ip6->addr[2] ^ ip6->addr[3];
+	}
+#endif							/* LWIP_IPV6 */
+#if LWIP_IPV4
+	if (!IP_IS_V6(remote_ip)) {
+		h ^= ip4_addr_get_u32(ip_2_ip4(remote_ip));
+	}
+#endif							/* LWIP_IPV4 */
+	h ^= h >> 16;
+	h *= 0x45d9f3bUL;
+	h ^= h >> 16;
+	return (u16_t)(h % TCP_PCB_HASH_SIZE);
+}
+
+/** Hash chain of the table mirroring pcbs that pcb belongs to */
+static struct tcp_pcb **tcp_pcb_hash_bucket(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+	if (pcbs == &tcp_active_pcbs) {
+		return &tcp_active_hash[tcp_pcb_hash(pcb->local_port, &pcb->remote_ip, pcb->remote_port)];
+	} else if (pcbs == &tcp_tw_pcbs) {
+		return &tcp_tw_hash[tcp_pcb_hash(pcb->local_port, &pcb->remote_ip, pcb->remote_port)];
+	} else if (pcbs == &tcp_listen_pcbs.pcbs) {
+		return &tcp_listen_hash[TCP_PCB_HASH_PORT(pcb->local_port)].pcbs;
+	}
+	return NULL;
+}
+
+/**
+ * Called by TCP_REG after pcb was put on one of the pcb lists: add it to
+ * the matching demux table, if any.
+ */
+void tcp_pcb_hash_add(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+	struct tcp_pcb **bucket = tcp_pcb_hash_bucket(pcbs, pcb);
+
+	if (bucket != NULL) {
+		pcb->hash_next = *bucket;
+		*bucket = pcb;
+	}
+}
+
+/**
+ * Called by TCP_RMV after pcb was taken off one of the pcb lists: remove it
+ * from the matching demux table, if any.
+ */
+void tcp_pcb_hash_remove(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+	struct tcp_pcb **bucket = tcp_pcb_hash_bucket(pcbs, pcb);
+
+	if (bucket == NULL) {
+		return;
+	}
+	for (; *bucket != NULL; bucket = &(*bucket)->hash_next) {
+		if (*bucket == pcb) {
+			*bucket = pcb->hash_next;
+			pcb->hash_next = NULL;
+			return;
+		}
+	}
+}
+#endif							/* LWIP_TCP_PCB_HASH */
+
 /**
  * Purges the PCB and removes it from a PCB list. Any delayed ACKs are sent first.
  *
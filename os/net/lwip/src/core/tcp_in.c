@@ -99,12 +99,22 @@ static u8_t flags;
 static u8_t recv_flags;
 static struct pbuf *recv_data;
 
+#if LWIP_TCP_SACK
+/* SACK blocks of the incoming segment, set by tcp_parseopt() */
+static u32_t sack_left[LWIP_TCP_SACK_BLOCKS_MAX];
+static u32_t sack_right[LWIP_TCP_SACK_BLOCKS_MAX];
+static u8_t sack_num;
+#endif							/* LWIP_TCP_SACK */
+
 struct tcp_pcb *tcp_input_pcb;
 
 /* Forward declarations. */
 static err_t tcp_process(struct tcp_pcb *pcb);
 static void tcp_receive(struct tcp_pcb *pcb);
 static void tcp_parseopt(struct tcp_pcb *pcb);
+#if LWIP_TCP_SACK
+static void tcp_sack_update(struct tcp_pcb *pcb);
+#endif
 
 static void tcp_listen_input(struct tcp_pcb_listen *pcb);
 static void tcp_timewait_input(struct tcp_pcb *pcb);
@@ -126,6 +136,9 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 	struct tcp_pcb *lpcb_prev = NULL;
 	struct tcp_pcb_listen *lpcb_any = NULL;
 #endif							/* SO_REUSE */
+#if LWIP_TCP_PCB_HASH
+	u16_t hash;
+#endif							/* LWIP_TCP_PCB_HASH */
 	u8_t hdrlen_bytes;
 	err_t err;
 
@@ -236,6 +249,21 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 	   for an active connection. */
 	prev = NULL;
 
+#if LWIP_TCP_PCB_HASH
+	hash = tcp_pcb_hash(tcphdr->dest, ip_current_src_addr(), tcphdr->src);
+	for (pcb = tcp_active_hash[hash]; pcb != NULL; pcb = pcb->hash_next) {
+		LWIP_ASSERT("tcp_input: active pcb->state != CLOSED", pcb->state != CLOSED);
+		LWIP_ASSERT("tcp_input: active pcb->state != TIME-WAIT", pcb->state != TIME_WAIT);
+		LWIP_ASSERT("tcp_input: active pcb->state != LISTEN", pcb->state != LISTEN);
+		if (pcb->remote_port == tcphdr->src && pcb->local_port == tcphdr->dest && ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()) && ip_addr_cmp(&pcb->local_ip, ip_current_dest_addr())) {
+			if (prev == NULL) {
+				TCP_STATS_INC(tcp.cachehit);
+			}
+			break;
+		}
+		prev = pcb;
+	}
+#else							/* LWIP_TCP_PCB_HASH */
 	for (pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next) {
 		LWIP_ASSERT("tcp_input: active pcb->state != CLOSED", pcb->state != CLOSED);
 		LWIP_ASSERT("tcp_input: active pcb->state != TIME-WAIT", pcb->state != TIME_WAIT);
@@ -257,11 +285,16 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 		}
 		prev = pcb;
 	}
+#endif							/* LWIP_TCP_PCB_HASH */
 
 	if (pcb == NULL) {
 		/* If it did not go to an active connection, we check the connections
 		   in the TIME-WAIT state. */
+#if LWIP_TCP_PCB_HASH
+		for (pcb = tcp_tw_hash[hash]; pcb != NULL; pcb = pcb->hash_next) {
+#else
 		for (pcb = tcp_tw_pcbs; pcb != NULL; pcb = pcb->next) {
+#endif
 			LWIP_ASSERT("tcp_input: TIME-WAIT pcb->state == TIME-WAIT", pcb->state == TIME_WAIT);
 			if (pcb->remote_port == tcphdr->src && pcb->local_port == tcphdr->dest && ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()) && ip_addr_cmp(&pcb->local_ip, ip_current_dest_addr())) {
 				/* We don't really care enough to move this PCB to the front
@@ -277,7 +310,11 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 		/* Finally, if we still did not get a match, we check all PCBs that
 		   are LISTENing for incoming connections. */
 		prev = NULL;
+#if LWIP_TCP_PCB_HASH
+		for (lpcb = tcp_listen_hash[TCP_PCB_HASH_PORT(tcphdr->dest)].listen_pcbs; lpcb != NULL; lpcb = lpcb->hash_next) {
+#else
 		for (lpcb = tcp_listen_pcbs.listen_pcbs; lpcb != NULL; lpcb = lpcb->next) {
+#endif
 			if (lpcb->local_port == tcphdr->dest) {
 				if (IP_IS_ANY_TYPE_VAL(lpcb->local_ip)) {
 					/* found an ANY TYPE (IPv4/IPv6) match */
@@ -313,6 +350,11 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 		}
 #endif							/* SO_REUSE */
 		if (lpcb != NULL) {
+#if LWIP_TCP_PCB_HASH
+			if (prev == NULL) {
+				TCP_STATS_INC(tcp.cachehit);
+			}
+#else
 			/* Move this PCB to the front of the list so that subsequent
 			   lookups will be faster (we exploit locality in TCP segment
 			   arrivals). */
@@ -325,6 +367,7 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 			} else {
 				TCP_STATS_INC(tcp.cachehit);
 			}
+#endif							/* LWIP_TCP_PCB_HASH */
 
 			LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: packed for LISTENing connection.\n"));
 			tcp_listen_input(lpcb);
@@ -988,6 +1031,7 @@ static void tcp_receive(struct tcp_pcb *pcb)
 	u32_t right_wnd_edge;
 	u16_t new_tot_len;
 	int found_dupack = 0;
+	u8_t sack_partial = 0;
 #if TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS
 	u32_t ooseq_blen;
 	u16_t ooseq_qlen;
@@ -1027,6 +1071,12 @@ static void tcp_receive(struct tcp_pcb *pcb)
 #endif							/* TCP_WND_DEBUG */
 		}
 
+#if LWIP_TCP_SACK
+		if (pcb->flags & TF_SACK) {
+			tcp_sack_update(pcb);
+		}
+#endif							/* LWIP_TCP_SACK */
+
 		/* (From Stevens TCP/IP Illustrated Vol II, p970.) Its only a
 		 * duplicate ack if:
 		 * 1) It doesn't ACK new data
@@ -1071,6 +1121,12 @@ static void tcp_receive(struct tcp_pcb *pcb)
 								/* Do fast retransmit */
 								tcp_rexmit_fast(pcb);
 							}
+#if LWIP_TCP_SACK
+							if ((pcb->flags & (TF_SACK | TF_INFR)) == (TF_SACK | TF_INFR)) {
+								/* a segment has left the network, send the next hole */
+								tcp_rexmit_sack(pcb);
+							}
+#endif							/* LWIP_TCP_SACK */
 						}
 					}
 				}
@@ -1087,8 +1143,23 @@ static void tcp_receive(struct tcp_pcb *pcb)
 			   in fast retransmit. Also reset the congestion window to the
 			   slow start threshold. */
 			if (pcb->flags & TF_INFR) {
-				pcb->flags &= ~TF_INFR;
-				pcb->cwnd = pcb->ssthresh;
+#if LWIP_TCP_SACK
+				if ((pcb->flags & TF_SACK) && TCP_SEQ_LT(ackno, pcb->sack_recover)) {
+					/* Partial ACK: more holes are left, stay in fast recovery
+					   and deflate the window by the amount acked (RFC 6582) */
+					sack_partial = 1;
+					if (pcb->cwnd > (tcpwnd_size_t)(ackno - pcb->lastack)) {
+						pcb->cwnd -= (tcpwnd_size_t)(ackno - pcb->lastack);
+					} else {
+						pcb->cwnd = 0;
+					}
+					pcb->cwnd += pcb->mss;
+				} else
+#endif							/* LWIP_TCP_SACK */
+				{
+					pcb->flags &= ~TF_INFR;
+					pcb->cwnd = pcb->ssthresh;
+				}
 			}
 
 			/* Reset the number of retransmissions. */
@@ -1103,7 +1174,7 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			/* Update the congestion control variables (cwnd and
 			   ssthresh). */
-			if (pcb->state >= ESTABLISHED) {
+			if (pcb->state >= ESTABLISHED && !sack_partial) {
 				if (pcb->cwnd < pcb->ssthresh) {
 					if ((tcpwnd_size_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
 						pcb->cwnd += pcb->mss;
@@ -1147,6 +1218,12 @@ static void tcp_receive(struct tcp_pcb *pcb)
 			} else {
 				pcb->rtime = 0;
 			}
+#if LWIP_TCP_SACK
+			if (sack_partial) {
+				/* the new first unacked segment is the next hole */
+				tcp_rexmit_sack(pcb);
+			}
+#endif							/* LWIP_TCP_SACK */
 
 			pcb->polltmr = 0;
 
@@ -1463,8 +1540,18 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			} else {
 				/* We get here if the incoming segment is out-of-sequence. */
-				tcp_send_empty_ack(pcb);
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+				/* with SACK, the ACK is sent once the segment is queued so
+				   that it is reported */
+				if (!(pcb->flags & TF_SACK))
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
+				{
+					tcp_send_empty_ack(pcb);
+				}
 #if TCP_QUEUE_OOSEQ
+#if LWIP_TCP_SACK
+				pcb->rcv_sack_recent = seqno;
+#endif							/* LWIP_TCP_SACK */
 				/* We queue the segment on the ->ooseq queue. */
 				if (pcb->ooseq == NULL) {
 					pcb->ooseq = tcp_seg_copy(&inseg);
@@ -1604,6 +1691,11 @@ static void tcp_receive(struct tcp_pcb *pcb)
 					}
 				}
 #endif							/* TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS */
+#if LWIP_TCP_SACK
+				if (pcb->flags & TF_SACK) {
+					tcp_send_empty_ack(pcb);
+				}
+#endif							/* LWIP_TCP_SACK */
 #endif							/* TCP_QUEUE_OOSEQ */
 			}
 		} else {
@@ -1630,6 +1722,58 @@ static u8_t tcp_getoptbyte(void)
 	}
 }
 
+#if LWIP_TCP_SACK
+/* Read a 32 bit option field in network byte order */
+static u32_t tcp_getopt32(void)
+{
+	u32_t val;
+
+	val = (u32_t) tcp_getoptbyte() << 24;
+	val |= (u32_t) tcp_getoptbyte() << 16;
+	val |= (u32_t) tcp_getoptbyte() << 8;
+	val |= tcp_getoptbyte();
+	return val;
+}
+
+/**
+ * Marks the unacked segments covered by the SACK blocks of the incoming
+ * segment. Blocks below the cumulative ACK (D-SACK) or beyond snd_nxt are
+ * ignored.
+ *
+ * Called from tcp_receive() on connections that negotiated SACK.
+ *
+ * @param pcb the tcp_pcb for which a segment arrived
+ */
+static void tcp_sack_update(struct tcp_pcb *pcb)
+{
+	struct tcp_seg *seg;
+	u32_t seg_seqno;
+	u8_t i;
+
+	if (TCP_SEQ_LT(pcb->sack_high, pcb->lastack)) {
+		pcb->sack_high = pcb->lastack;
+	}
+
+	for (i = 0; i < sack_num; i++) {
+		if (!TCP_SEQ_LT(sack_left[i], sack_right[i]) || TCP_SEQ_LT(sack_left[i], pcb->lastack) || TCP_SEQ_GT(sack_right[i], pcb->snd_nxt)) {
+			continue;
+		}
+		for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+			seg_seqno = lwip_ntohl(seg->tcphdr->seqno);
+			if (!TCP_SEQ_LT(seg_seqno, sack_right[i])) {
+				break;
+			}
+			if (TCP_SEQ_GEQ(seg_seqno, sack_left[i]) && TCP_SEQ_LEQ(seg_seqno + TCP_TCPLEN(seg), sack_right[i])) {
+				seg->flags |= TF_SEG_SACKED;
+			}
+		}
+		if (TCP_SEQ_GT(sack_right[i], pcb->sack_high)) {
+			pcb->sack_high = sack_right[i];
+		}
+	}
+}
+#endif							/* LWIP_TCP_SACK */
+
 /**
  * Parses the options contained in the incoming segment.
  *
@@ -1645,6 +1789,12 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 #if LWIP_TCP_TIMESTAMPS
 	u32_t tsval;
 #endif
+#if LWIP_TCP_SACK
+	u32_t left, right;
+	u8_t i;
+
+	sack_num = 0;
+#endif
 
 	/* Parse the TCP MSS option, if present. */
 	if (tcphdr_optlen != 0) {
@@ -1722,6 +1872,39 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 				/* Advance to next option (6 bytes already read) */
 				tcp_optidx += LWIP_TCP_OPT_LEN_TS - 6;
 				break;
+#endif
+#if LWIP_TCP_SACK
+			case LWIP_TCP_OPT_SACK_PERM:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK_PERM\n"));
+				if (tcp_getoptbyte() != LWIP_TCP_OPT_LEN_SACK_PERM || (tcp_optidx - 2 + LWIP_TCP_OPT_LEN_SACK_PERM) > tcphdr_optlen) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				/* Only valid in a SYN, enable SACK for this connection */
+				if (flags & TCP_SYN) {
+					pcb->flags |= TF_SACK;
+				}
+				break;
+			case LWIP_TCP_OPT_SACK:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK\n"));
+				data = tcp_getoptbyte();
+				if (data < 2 + LWIP_TCP_OPT_LEN_SACK_BLOCK || ((data - 2) % LWIP_TCP_OPT_LEN_SACK_BLOCK) != 0 || (tcp_optidx - 2 + data) > tcphdr_optlen) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				for (i = 0; i < (data - 2) / LWIP_TCP_OPT_LEN_SACK_BLOCK; i++) {
+					left = tcp_getopt32();
+					right = tcp_getopt32();
+					/* ignore SACK blocks on connections that didn't negotiate it */
+					if ((pcb->flags & TF_SACK) && sack_num < LWIP_TCP_SACK_BLOCKS_MAX) {
+						sack_left[sack_num] = left;
+						sack_right[sack_num] = right;
+						sack_num++;
+					}
+				}
+				break;
 #endif
 			default:
 				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: other\n"));
@@ -743,6 +743,188 @@ memerr:
 	return ERR_MEM;
 }
 
+#if LWIP_SENDFILE
+#if !LWIP_NETIF_TX_SINGLE_PBUF
+/** Free-callback of the pbufs created by tcp_write_ref(), drops the
+ * reference on the pbuf that holds the data. */
+static void tcp_free_pbuf_custom_ref(struct pbuf *p)
+{
+	struct pbuf_custom_ref *pcr = (struct pbuf_custom_ref *)p;
+	LWIP_ASSERT("pcr != NULL", pcr != NULL);
+	LWIP_ASSERT("pcr == p", (void *)pcr == (void *)p);
+	if (pcr->original != NULL) {
+		pbuf_free(pcr->original);
+	}
+	memp_free(MEMP_TCP_PBUF_REF, pcr);
+}
+#endif							/* !LWIP_NETIF_TX_SINGLE_PBUF */
+
+/**
+ * Write data for sending by reference to the pbuf that holds it.
+ *
+ * Like tcp_write() without TCP_WRITE_FLAG_COPY, but every new segment holds
+ * a reference on 'ref', so the caller may pbuf_free() it as soon as this
+ * returns: the data stays valid until the last segment carrying it has been
+ * acknowledged or dropped. The data is always put into new segments, it is
+ * never appended to the last unsent one.
+ *
+ * @param pcb Protocol control block for the TCP connection to enqueue data for.
+ * @param ref the pbuf that holds the data (its memory must not be reused)
+ * @param arg Pointer to the data to be enqueued, inside ref
+ * @param len Data length in bytes
+ * @param apiflags TCP_WRITE_FLAG_MORE, TCP_WRITE_FLAG_COPY is ignored
+ * @return ERR_OK if enqueued, another err_t on error
+ */
+err_t tcp_write_ref(struct tcp_pcb *pcb, struct pbuf *ref, const void *arg, u16_t len, u8_t apiflags)
+{
+#if LWIP_NETIF_TX_SINGLE_PBUF
+	LWIP_UNUSED_ARG(ref);
+	return tcp_write(pcb, arg, len, apiflags | TCP_WRITE_FLAG_COPY);
+#else							/* LWIP_NETIF_TX_SINGLE_PBUF */
+	struct tcp_seg *last_unsent = NULL, *seg = NULL, *prev_seg = NULL, *queue = NULL;
+	u16_t pos = 0;				/* position in 'arg' data */
+	u16_t queuelen;
+	u8_t optlen = 0;
+	u8_t optflags = 0;
+	err_t err;
+	/* don't allocate segments bigger than half the maximum window we ever received */
+	u16_t mss_local = LWIP_MIN(pcb->mss, TCPWND_MIN16(pcb->snd_wnd_max / 2));
+	mss_local = mss_local ? mss_local : pcb->mss;
+
+	LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_write_ref(pcb=%p, ref=%p, data=%p, len=%" U16_F ", apiflags=%" U16_F ")\n", (void *)pcb, (void *)ref, arg, len, (u16_t) apiflags));
+	LWIP_ERROR("tcp_write_ref: ref == NULL (programmer violates API)", ref != NULL, return ERR_ARG;);
+	LWIP_ERROR("tcp_write_ref: data not in ref (programmer violates API)",
+			   ((const u8_t *)arg >= (const u8_t *)ref->payload) && ((const u8_t *)arg + len <= (const u8_t *)ref->payload + ref->len), return ERR_ARG;);
+
+	err = tcp_write_checks(pcb, len);
+	if (err != ERR_OK) {
+		return err;
+	}
+	queuelen = pcb->snd_queuelen;
+
+#if LWIP_TCP_TIMESTAMPS
+	if ((pcb->flags & TF_TIMESTAMP)) {
+		optflags = TF_SEG_OPTS_TS;
+		optlen = LWIP_TCP_OPT_LENGTH(TF_SEG_OPTS_TS);
+		mss_local = LWIP_MAX(mss_local, LWIP_TCP_OPT_LEN_TS + 1);
+	}
+#endif							/* LWIP_TCP_TIMESTAMPS */
+
+	if (pcb->unsent != NULL) {
+		for (last_unsent = pcb->unsent; last_unsent->next != NULL; last_unsent = last_unsent->next) ;
+	}
+
+	while (pos < len) {
+		struct pbuf *p, *p2;
+		struct pbuf_custom_ref *pcr;
+		u16_t left = len - pos;
+		u16_t max_len = mss_local - optlen;
+		u16_t seglen = LWIP_MIN(left, max_len);
+
+		/* Reference the data, the custom pbuf keeps ref alive */
+		pcr = (struct pbuf_custom_ref *)memp_malloc(MEMP_TCP_PBUF_REF);
+		if (pcr == NULL) {
+			LWIP_DEBUGF(TCP_OUTPUT_DEBUG | LWIP_DBG_LEVEL_SERIOUS, ("tcp_write_ref: could not allocate memory for reference pbuf\n"));
+			goto memerr;
+		}
+		pcr->pc.custom_free_function = tcp_free_pbuf_custom_ref;
+		pcr->original = NULL;
+		p2 = pbuf_alloced_custom(PBUF_RAW, seglen, PBUF_REF, &pcr->pc, (u8_t *)arg + pos, seglen);
+		if (p2 == NULL) {
+			memp_free(MEMP_TCP_PBUF_REF, pcr);
+			goto memerr;
+		}
+		pbuf_ref(ref);
+		pcr->original = ref;
+
+		/* Allocate a pbuf for the headers */
+		if ((p = pbuf_alloc(PBUF_TRANSPORT, optlen, PBUF_RAM)) == NULL) {
+			pbuf_free(p2);
+			LWIP_DEBUGF(TCP_OUTPUT_DEBUG | LWIP_DBG_LEVEL_SERIOUS, ("tcp_write_ref: could not allocate memory for header pbuf\n"));
+			goto memerr;
+		}
+		pbuf_cat(p /*header */ , p2 /*data */);
+
+		queuelen += pbuf_clen(p);
+		if ((queuelen > TCP_SND_QUEUELEN) || (queuelen > TCP_SNDQUEUELEN_OVERFLOW)) {
+			LWIP_DEBUGF(TCP_OUTPUT_DEBUG | LWIP_DBG_LEVEL_SERIOUS, ("tcp_write_ref: queue too long %" U16_F " (%d)\n", queuelen, (int)TCP_SND_QUEUELEN));
+			pbuf_free(p);
+			goto memerr;
+		}
+
+		if ((seg = tcp_create_segment(pcb, p, 0, pcb->snd_lbb + pos, optflags)) == NULL) {
+			goto memerr;
+		}
+#if TCP_CHECKSUM_ON_COPY
+		seg->chksum = ~inet_chksum((const u8_t *)arg + pos, seglen);
+		seg->chksum_swapped = 0;
+		if (seglen & 1) {
+			seg->chksum_swapped = 1;
+			seg->chksum = SWAP_BYTES_IN_WORD(seg->chksum);
+		}
+		seg->flags |= TF_SEG_DATA_CHECKSUMMED;
+#endif							/* TCP_CHECKSUM_ON_COPY */
+
+		if (queue == NULL) {
+			queue = seg;
+		} else {
+			LWIP_ASSERT("prev_seg != NULL", prev_seg != NULL);
+			prev_seg->next = seg;
+		}
+		prev_seg = seg;
+
+		LWIP_DEBUGF(TCP_OUTPUT_DEBUG | LWIP_DBG_TRACE, ("tcp_write_ref: queueing %" U32_F ":%" U32_F "\n", lwip_ntohl(seg->tcphdr->seqno), lwip_ntohl(seg->tcphdr->seqno) + TCP_TCPLEN(seg)));
+
+		pos += seglen;
+	}
+
+	/* The new segments follow last_unsent, so its preallocated tail must not
+	 * be filled by a later tcp_write() anymore. */
+#if TCP_OVERSIZE
+	if (queue != NULL) {
+		pcb->unsent_oversize = 0;
+#if TCP_OVERSIZE_DBGCHECK
+		if (last_unsent != NULL) {
+			last_unsent->oversize_left = 0;
+		}
+#endif							/* TCP_OVERSIZE_DBGCHECK */
+	}
+#endif							/* TCP_OVERSIZE */
+
+	if (last_unsent == NULL) {
+		pcb->unsent = queue;
+	} else {
+		last_unsent->next = queue;
+	}
+
+	pcb->snd_lbb += len;
+	pcb->snd_buf -= len;
+	pcb->snd_queuelen = queuelen;
+
+	LWIP_DEBUGF(TCP_QLEN_DEBUG, ("tcp_write_ref: %" S16_F " (after enqueued)\n", pcb->snd_queuelen));
+	if (pcb->snd_queuelen != 0) {
+		LWIP_ASSERT("tcp_write_ref: valid queue length", pcb->unacked != NULL || pcb->unsent != NULL);
+	}
+
+	/* Set the PSH flag in the last segment that we enqueued. */
+	if (seg != NULL && seg->tcphdr != NULL && ((apiflags & TCP_WRITE_FLAG_MORE) == 0)) {
+		TCPH_SET_FLAG(seg->tcphdr, TCP_PSH);
+	}
+
+	return ERR_OK;
+memerr:
+	pcb->flags |= TF_NAGLEMEMERR;
+	TCP_STATS_INC(tcp.memerr);
+
+	if (queue != NULL) {
+		tcp_segs_free(queue);
+	}
+	LWIP_DEBUGF(TCP_QLEN_DEBUG | LWIP_DBG_STATE, ("tcp_write_ref: %" S16_F " (with mem err)\n", pcb->snd_queuelen));
+	return ERR_MEM;
+#endif							/* LWIP_NETIF_TX_SINGLE_PBUF */
+}
+#endif							/* LWIP_SENDFILE */
+
 /**
  * Enqueue TCP options for transmission.
  *
@@ -781,6 +963,12 @@ err_t tcp_enqueue_flags(struct tcp_pcb *pcb, u8_t flags)
 			optflags |= TF_SEG_OPTS_WND_SCALE;
 		}
 #endif							/* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+		if ((pcb->state != SYN_RCVD) || (pcb->flags & TF_SACK)) {
+			/* Same for SACK permitted: only answer the one we received. */
+			optflags |= TF_SEG_OPTS_SACK_PERM;
+		}
+#endif							/* LWIP_TCP_SACK */
 	}
 #if LWIP_TCP_TIMESTAMPS
 	if ((pcb->flags & TF_TIMESTAMP)) {
@@ -869,6 +1057,82 @@ static void tcp_build_wnd_scale_option(u32_t *opts)
 }
 #endif
 
+#if LWIP_TCP_SACK
+/** Build a SACK permitted option (2 bytes long) at the specified options pointer
+ *
+ * @param opts option pointer where to store the SACK permitted option
+ */
+static void tcp_build_sack_perm_option(u32_t *opts)
+{
+	/* Pad with two NOP options to make everything nicely aligned */
+	opts[0] = PP_HTONL(0x01010402);
+}
+
+#if TCP_QUEUE_OOSEQ
+/**
+ * Collect the SACK blocks to report from the ooseq queue. Adjacent segments
+ * are merged into one block and the block holding the most recently queued
+ * segment is put first (RFC 2018, section 4).
+ *
+ * @param pcb tcp_pcb
+ * @param left left edges of the blocks (host byte order)
+ * @param right right edges of the blocks (host byte order)
+ * @param max size of left and right
+ * @return number of blocks stored
+ */
+static u8_t tcp_collect_sack_blocks(struct tcp_pcb *pcb, u32_t *left, u32_t *right, u8_t max)
+{
+	struct tcp_seg *seg = pcb->ooseq;
+	u8_t num = 0;
+	u8_t i;
+
+	while (seg != NULL) {
+		u32_t start = seg->tcphdr->seqno;
+		u32_t end = start + TCP_TCPLEN(seg);
+
+		for (seg = seg->next; seg != NULL && TCP_SEQ_LEQ(seg->tcphdr->seqno, end); seg = seg->next) {
+			if (TCP_SEQ_GT(seg->tcphdr->seqno + TCP_TCPLEN(seg), end)) {
+				end = seg->tcphdr->seqno + TCP_TCPLEN(seg);
+			}
+		}
+
+		if (TCP_SEQ_BETWEEN(pcb->rcv_sack_recent, start, end - 1)) {
+			for (i = LWIP_MIN(num, max - 1); i > 0; i--) {
+				left[i] = left[i - 1];
+				right[i] = right[i - 1];
+			}
+			left[0] = start;
+			right[0] = end;
+			if (num < max) {
+				num++;
+			}
+		} else if (num < max) {
+			left[num] = start;
+			right[num] = end;
+			num++;
+		}
+	}
+	return num;
+}
+
+/** Build a SACK option with num blocks at the specified options pointer
+ *
+ * @param opts option pointer where to store the SACK option
+ */
+static void tcp_build_sack_option(u32_t *opts, const u32_t *left, const u32_t *right, u8_t num)
+{
+	u8_t i;
+
+	/* Pad with two NOP options to make everything nicely aligned */
+	opts[0] = lwip_htonl(0x01010500 | (2 + num * LWIP_TCP_OPT_LEN_SACK_BLOCK));
+	for (i = 0; i < num; i++) {
+		opts[1 + 2 * i] = lwip_htonl(left[i]);
+		opts[2 + 2 * i] = lwip_htonl(right[i]);
+	}
+}
+#endif							/* TCP_QUEUE_OOSEQ */
+#endif							/* LWIP_TCP_SACK */
+
 /**
  * Send an ACK without data.
  *
@@ -880,15 +1144,33 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 	struct pbuf *p;
 	u8_t optlen = 0;
 	struct netif *netif;
-#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP
+#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK
 	struct tcp_hdr *tcphdr;
-#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP */
+#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK */
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	u32_t sack_left[LWIP_TCP_SACK_BLOCKS_MAX];
+	u32_t sack_right[LWIP_TCP_SACK_BLOCKS_MAX];
+	u8_t sack_num = 0;
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
 
 #if LWIP_TCP_TIMESTAMPS
 	if (pcb->flags & TF_TIMESTAMP) {
 		optlen = LWIP_TCP_OPT_LENGTH(TF_SEG_OPTS_TS);
 	}
 #endif
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	if ((pcb->flags & TF_SACK) && pcb->ooseq != NULL) {
+		u8_t max = LWIP_MIN(TCP_SACK_MAX_BLOCKS, LWIP_TCP_SACK_BLOCKS_MAX);
+		if (optlen + LWIP_TCP_OPT_LEN_SACK_OUT(max) > 40) {
+			/* only 40 bytes of options fit in the header */
+			max = (40 - optlen - LWIP_TCP_OPT_LEN_SACK_OUT(0)) / LWIP_TCP_OPT_LEN_SACK_BLOCK;
+		}
+		sack_num = tcp_collect_sack_blocks(pcb, sack_left, sack_right, max);
+		if (sack_num > 0) {
+			optlen += LWIP_TCP_OPT_LEN_SACK_OUT(sack_num);
+		}
+	}
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
 
 	p = tcp_output_alloc_header(pcb, optlen, 0, lwip_htonl(pcb->snd_nxt));
 	if (p == NULL) {
@@ -897,9 +1179,9 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 		LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_output: (ACK) could not allocate pbuf\n"));
 		return ERR_BUF;
 	}
-#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP
+#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK
 	tcphdr = (struct tcp_hdr *)p->payload;
-#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP */
+#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK */
 	LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_output: sending ACK for %" U32_F "\n", pcb->rcv_nxt));
 
 	/* NB. MSS option is only sent on SYNs, so ignore it here */
@@ -910,6 +1192,12 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 		tcp_build_timestamp_option(pcb, (u32_t *)(tcphdr + 1));
 	}
 #endif
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	if (sack_num > 0) {
+		/* the SACK option goes behind the timestamp option, if any */
+		tcp_build_sack_option((u32_t *)(void *)((u8_t *)(tcphdr + 1) + optlen - LWIP_TCP_OPT_LEN_SACK_OUT(sack_num)), sack_left, sack_right, sack_num);
+	}
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
 
 	netif = ip_route(&pcb->local_ip, &pcb->remote_ip);
 	if (netif == NULL) {
@@ -1173,6 +1461,12 @@ static err_t tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb, struct
 		opts += 1;
 	}
 #endif
+#if LWIP_TCP_SACK
+	if (seg->flags & TF_SEG_OPTS_SACK_PERM) {
+		tcp_build_sack_perm_option(opts);
+		opts += 1;
+	}
+#endif
 
 	/* Set retransmission timer running if it is not currently enabled
 	   This must be set before checking the route. */
@@ -1303,6 +1597,85 @@ void tcp_rst(u32_t seqno, u32_t ackno, ip_addr_t *local_ip, const ip_addr_t *rem
 	LWIP_DEBUGF(TCP_RST_DEBUG, ("tcp_rst: seqno %" U32_F " ackno %" U32_F ".\n", seqno, ackno));
 }
 
+/**
+ * Insert a segment taken off the unacked queue into the unsent queue,
+ * keeping the unsent queue sorted.
+ */
+static void tcp_requeue_unsent(struct tcp_pcb *pcb, struct tcp_seg *seg)
+{
+	struct tcp_seg **cur_seg;
+
+	cur_seg = &(pcb->unsent);
+	while (*cur_seg && TCP_SEQ_LT(lwip_ntohl((*cur_seg)->tcphdr->seqno), lwip_ntohl(seg->tcphdr->seqno))) {
+		cur_seg = &((*cur_seg)->next);
+	}
+	seg->next = *cur_seg;
+	*cur_seg = seg;
+#if TCP_OVERSIZE
+	if (seg->next == NULL) {
+		/* the retransmitted segment is last in unsent, so reset unsent_oversize */
+		pcb->unsent_oversize = 0;
+	}
+#endif							/* TCP_OVERSIZE */
+}
+
+#if LWIP_TCP_SACK
+/**
+ * RTO variant of tcp_rexmit_rto() for SACK connections: requeue only the
+ * unacked segments the peer has not SACKed, the others stay on ->unacked.
+ *
+ * @return 1 if the scoreboard had SACKed segments and the holes have been
+ *         requeued, 0 if all unacked segments have to be retransmitted
+ */
+static u8_t tcp_rexmit_rto_holes(struct tcp_pcb *pcb)
+{
+	struct tcp_seg **pseg;
+	struct tcp_seg *seg;
+	struct tcp_seg *holes = NULL;
+	struct tcp_seg **holes_tail = &holes;
+
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		if (seg->flags & TF_SEG_SACKED) {
+			break;
+		}
+	}
+	if (seg == NULL) {
+		return 0;
+	}
+
+	pseg = &pcb->unacked;
+	while (*pseg != NULL) {
+		seg = *pseg;
+		if (seg->flags & TF_SEG_SACKED) {
+			pseg = &seg->next;
+		} else {
+			*pseg = seg->next;
+			seg->next = NULL;
+			*holes_tail = seg;
+			holes_tail = &seg->next;
+		}
+	}
+	/* the first unacked segment is never SACKed here, so holes != NULL */
+#if TCP_OVERSIZE_DBGCHECK
+	if (pcb->unsent == NULL) {
+		for (seg = holes; seg->next != NULL; seg = seg->next) ;
+		pcb->unsent_oversize = seg->oversize_left;
+	}
+#endif							/* TCP_OVERSIZE_DBGCHECK */
+	/* the holes precede the unsent queue like in the plain RTO case */
+	*holes_tail = pcb->unsent;
+	pcb->unsent = holes;
+	pcb->sack_rexmit = pcb->snd_nxt;
+
+	if (pcb->nrtx < 0xFF) {
+		++pcb->nrtx;
+	}
+	pcb->rttest = 0;
+	tcp_output(pcb);
+	return 1;
+}
+#endif							/* LWIP_TCP_SACK */
+
 /**
  * Requeue all unacked segments for retransmission
  *
@@ -1318,6 +1691,22 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
 		return;
 	}
 
+#if LWIP_TCP_SACK
+	if (pcb->flags & TF_SACK) {
+		if (pcb->unacked->flags & TF_SEG_SACKED) {
+			/* The peer has dropped data it SACKed before (it is allowed to),
+			   so the scoreboard can't be trusted any more. */
+			for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+				seg->flags &= ~TF_SEG_SACKED;
+			}
+			pcb->sack_high = pcb->lastack;
+		}
+		if (tcp_rexmit_rto_holes(pcb)) {
+			return;
+		}
+	}
+#endif							/* LWIP_TCP_SACK */
+
 	/* Move all unacked segments to the head of the unsent queue */
 	for (seg = pcb->unacked; seg->next != NULL; seg = seg->next) ;
 	/* concatenate unsent queue after unacked queue */
@@ -1355,7 +1744,6 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
 void tcp_rexmit(struct tcp_pcb *pcb)
 {
 	struct tcp_seg *seg;
-	struct tcp_seg **cur_seg;
 
 	if (pcb->unacked == NULL) {
 		return;
@@ -1365,19 +1753,7 @@ void tcp_rexmit(struct tcp_pcb *pcb)
 	/* Keep the unsent queue sorted. */
 	seg = pcb->unacked;
 	pcb->unacked = seg->next;
-
-	cur_seg = &(pcb->unsent);
-	while (*cur_seg && TCP_SEQ_LT(lwip_ntohl((*cur_seg)->tcphdr->seqno), lwip_ntohl(seg->tcphdr->seqno))) {
-		cur_seg = &((*cur_seg)->next);
-	}
-	seg->next = *cur_seg;
-	*cur_seg = seg;
-#if TCP_OVERSIZE
-	if (seg->next == NULL) {
-		/* the retransmitted segment is last in unsent, so reset unsent_oversize */
-		pcb->unsent_oversize = 0;
-	}
-#endif							/* TCP_OVERSIZE */
+	tcp_requeue_unsent(pcb, seg);
 
 	if (pcb->nrtx < 0xFF) {
 		++pcb->nrtx;
@@ -1402,6 +1778,12 @@ void tcp_rexmit_fast(struct tcp_pcb *pcb)
 	if (pcb->unacked != NULL && !(pcb->flags & TF_INFR)) {
 		/* This is fast retransmit. Retransmit the first unacked segment. */
 		LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_receive: dupacks %" U16_F " (%" U32_F "), fast retransmit %" U32_F "\n", (u16_t) pcb->dupacks, pcb->lastack, lwip_ntohl(pcb->unacked->tcphdr->seqno)));
+#if LWIP_TCP_SACK
+		/* Recovery lasts until everything sent so far is acked, the first
+		   unacked segment is the first hole */
+		pcb->sack_recover = pcb->snd_nxt;
+		pcb->sack_rexmit = lwip_ntohl(pcb->unacked->tcphdr->seqno) + TCP_TCPLEN(pcb->unacked);
+#endif							/* LWIP_TCP_SACK */
 		tcp_rexmit(pcb);
 
 		/* Set ssthresh to half of the minimum of the current
@@ -1422,6 +1804,50 @@ void tcp_rexmit_fast(struct tcp_pcb *pcb)
 	}
 }
 
+#if LWIP_TCP_SACK
+/**
+ * Requeue the next hole in the SACK scoreboard for retransmission: the
+ * first unacked segment below the highest SACKed sequence number that is
+ * neither SACKed nor retransmitted yet in this recovery.
+ *
+ * Called by tcp_receive() during fast recovery on SACK connections.
+ *
+ * @param pcb the tcp_pcb for which to retransmit the next hole
+ */
+void tcp_rexmit_sack(struct tcp_pcb *pcb)
+{
+	struct tcp_seg **pseg;
+	struct tcp_seg *seg;
+	u32_t seqno;
+
+	for (pseg = &pcb->unacked; *pseg != NULL; pseg = &(*pseg)->next) {
+		seqno = lwip_ntohl((*pseg)->tcphdr->seqno);
+		if (!TCP_SEQ_LT(seqno, pcb->sack_high)) {
+			/* nothing above is known to be lost */
+			return;
+		}
+		if (!((*pseg)->flags & TF_SEG_SACKED) && TCP_SEQ_GEQ(seqno, pcb->sack_rexmit)) {
+			break;
+		}
+	}
+	if (*pseg == NULL) {
+		return;
+	}
+
+	seg = *pseg;
+	*pseg = seg->next;
+	tcp_requeue_unsent(pcb, seg);
+	pcb->sack_rexmit = seqno + TCP_TCPLEN(seg);
+
+	LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_rexmit_sack: hole %" U32_F ":%" U32_F "\n", seqno, pcb->sack_rexmit));
+
+	/* Don't take any rtt measurements after retransmitting. */
+	pcb->rttest = 0;
+	MIB2_STATS_INC(mib2.tcpretranssegs);
+	/* called from tcp_input(), tcp_output() is done on return */
+}
+#endif							/* LWIP_TCP_SACK */
+
 /**
  * Send keepalive packets to keep a connection active although
  * no data is sent over it.
@@ -97,6 +97,40 @@ static u16_t udp_port = UDP_LOCAL_PORT_RANGE_START;
 /* exported in udp.h (was static) */
 struct udp_pcb *udp_pcbs = NULL;
 
+#if LWIP_UDP_PCB_HASH
+#define UDP_PCB_HASH_PORT(port) ((port) % UDP_PCB_HASH_SIZE)
+
+/* The pcbs of udp_pcbs by local port, chained through hash_next */
+static struct udp_pcb *udp_pcb_hash[UDP_PCB_HASH_SIZE];
+
+static void udp_pcb_hash_add(struct udp_pcb *pcb)
+{
+	struct udp_pcb **bucket = &udp_pcb_hash[UDP_PCB_HASH_PORT(pcb->local_port)];
+
+	pcb->hash_next = *bucket;
+	*bucket = pcb;
+}
+
+static void udp_pcb_hash_remove(struct udp_pcb *pcb)
+{
+	struct udp_pcb **bucket;
+
+	for (bucket = &udp_pcb_hash[UDP_PCB_HASH_PORT(pcb->local_port)]; *bucket != NULL; bucket = &(*bucket)->hash_next) {
+		if (*bucket == pcb) {
+			*bucket = pcb->hash_next;
+			pcb->hash_next = NULL;
+			return;
+		}
+	}
+}
+
+#define UDP_HASH_ADD(pcb) udp_pcb_hash_add(pcb)
+#define UDP_HASH_RMV(pcb) udp_pcb_hash_remove(pcb)
+#else
+#define UDP_HASH_ADD(pcb)
+#define UDP_HASH_RMV(pcb)
+#endif							/* LWIP_UDP_PCB_HASH */
+
 /**
  * Initialize this module.
  */
@@ -122,7 +156,11 @@ again:
 		udp_port = UDP_LOCAL_PORT_RANGE_START;
 	}
 	/* Check all PCBs. */
+#if LWIP_UDP_PCB_HASH
+	for (pcb = udp_pcb_hash[UDP_PCB_HASH_PORT(udp_port)]; pcb != NULL; pcb = pcb->hash_next) {
+#else
 	for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+#endif
 		if (pcb->local_port == udp_port) {
 			if (++n > (UDP_LOCAL_PORT_RANGE_END - UDP_LOCAL_PORT_RANGE_START)) {
 				return 0;
@@ -246,7 +284,11 @@ void udp_input(struct pbuf *p, struct netif *inp)
 	 * 'Perfect match' pcbs (connected to the remote port & ip address) are
 	 * preferred. If no perfect match is found, the first unconnected pcb that
 	 * matches the local port and ip address gets the datagram. */
+#if LWIP_UDP_PCB_HASH
+	for (pcb = udp_pcb_hash[UDP_PCB_HASH_PORT(dest)]; pcb != NULL; pcb = pcb->hash_next) {
+#else
 	for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+#endif
 		/* print the PCB local and remote address */
 		LWIP_DEBUGF(UDP_DEBUG, ("pcb ("));
 		ip_addr_debug_print(UDP_DEBUG, &pcb->local_ip);
@@ -269,6 +311,11 @@ void udp_input(struct pbuf *p, struct netif *inp)
 			/* compare PCB remote addr+port to UDP source addr+port */
 			if ((pcb->remote_port == src) && (ip_addr_isany_val(pcb->remote_ip) || ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()))) {
 				/* the first fully matching PCB */
+#if LWIP_UDP_PCB_HASH
+				if (prev == NULL) {
+					UDP_STATS_INC(udp.cachehit);
+				}
+#else
 				if (prev != NULL) {
 					/* move the pcb to the front of udp_pcbs so that is
 					   found faster next time */
@@ -278,6 +325,7 @@ void udp_input(struct pbuf *p, struct netif *inp)
 				} else {
 					UDP_STATS_INC(udp.cachehit);
 				}
+#endif							/* LWIP_UDP_PCB_HASH */
 				break;
 			}
 		}
@@ -908,6 +956,10 @@ err_t udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 
 	ip_addr_set_ipaddr(&pcb->local_ip, ipaddr);
 
+	if (rebind) {
+		/* the port may change: move to the new bucket */
+		UDP_HASH_RMV(pcb);
+	}
 	pcb->local_port = port;
 	mib2_udp_bind(pcb);
 	/* pcb not active yet? */
@@ -916,6 +968,7 @@ err_t udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 		pcb->next = udp_pcbs;
 		udp_pcbs = pcb;
 	}
+	UDP_HASH_ADD(pcb);
 	LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("udp_bind: bound to "));
 	ip_addr_debug_print(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, &pcb->local_ip);
 	LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, (", port %" U16_F ")\n", pcb->local_port));
@@ -972,6 +1025,7 @@ err_t udp_connect(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 	/* PCB not yet on the list, add PCB now */
 	pcb->next = udp_pcbs;
 	udp_pcbs = pcb;
+	UDP_HASH_ADD(pcb);
 	return ERR_OK;
 }
 
@@ -1041,6 +1095,7 @@ void udp_remove(struct udp_pcb *pcb)
 			}
 		}
 	}
+	UDP_HASH_RMV(pcb);
 	memp_free(MEMP_UDP_PCB, pcb);
 }
 
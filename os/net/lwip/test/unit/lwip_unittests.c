@@ -21,6 +21,8 @@
 #include "udp/test_udp.h"
 #include "tcp/test_tcp.h"
 #include "tcp/test_tcp_oos.h"
+#include "tcp/test_tcp_sack.h"
+#include "tcp/test_tcp_demux.h"
 #include "core/test_mem.h"
 #include "etharp/test_etharp.h"
 
@@ -35,6 +37,8 @@ int main()
 		udp_suite,
 		tcp_suite,
 		tcp_oos_suite,
+		tcp_sack_suite,
+		tcp_demux_suite,
 		mem_suite,
 		etharp_suite
 	};
@@ -56,12 +56,21 @@
 #define LWIP_SOCKET                     0
 
 /* Minimal changes to opt.h required for tcp unit tests: */
-#define MEM_SIZE                        16000
+#define MEM_SIZE                        64000
 #define TCP_SND_QUEUELEN                40
-#define MEMP_NUM_TCP_SEG                TCP_SND_QUEUELEN
+#define MEMP_NUM_TCP_SEG                (2 * TCP_SND_QUEUELEN)
 #define TCP_SND_BUF                     (12 * TCP_MSS)
 #define TCP_WND                         (10 * TCP_MSS)
 
+/* Minimal changes to opt.h required for tcp sack unit tests: */
+#define LWIP_TCP_SACK                   1
+
+/* Minimal changes to opt.h required for pcb demux unit tests: */
+#define MEMP_NUM_TCP_PCB                260
+#define MEMP_NUM_UDP_PCB                64
+#define LWIP_TCP_PCB_HASH               1
+#define LWIP_UDP_PCB_HASH               1
+
 /* Minimal changes to opt.h required for etharp unit tests: */
 #define ETHARP_SUPPORT_STATIC_ENTRIES   1
 
@@ -142,23 +142,24 @@ void tcp_set_state(struct tcp_pcb *pcb, enum tcp_state state, ip_addr_t *local_i
 {
 	/* @todo: are these all states? */
 	/* @todo: remove from previous list */
+	/* addresses first: TCP_REG hashes them */
 	pcb->state = state;
 	if (state == ESTABLISHED) {
-		TCP_REG(&tcp_active_pcbs, pcb);
 		pcb->local_ip.addr = local_ip->addr;
 		pcb->local_port = local_port;
 		pcb->remote_ip.addr = remote_ip->addr;
 		pcb->remote_port = remote_port;
+		TCP_REG(&tcp_active_pcbs, pcb);
 	} else if (state == LISTEN) {
-		TCP_REG(&tcp_listen_pcbs.pcbs, pcb);
 		pcb->local_ip.addr = local_ip->addr;
 		pcb->local_port = local_port;
+		TCP_REG(&tcp_listen_pcbs.pcbs, pcb);
 	} else if (state == TIME_WAIT) {
-		TCP_REG(&tcp_tw_pcbs, pcb);
 		pcb->local_ip.addr = local_ip->addr;
 		pcb->local_port = local_port;
 		pcb->remote_ip.addr = remote_ip->addr;
 		pcb->remote_port = remote_port;
+		TCP_REG(&tcp_tw_pcbs, pcb);
 	} else {
 		fail();
 	}
@@ -0,0 +1,380 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_tcp_demux.h"
+
+#include <string.h>
+#include <time.h>
+#include <net/lwip/priv/tcp_priv.h>
+#include <net/lwip/stats.h>
+#include <net/lwip/ip.h>
+#include <net/lwip/inet_chksum.h>
+#include <net/lwip/prot/ip4.h>
+
+#if !LWIP_STATS || !TCP_STATS || !MEMP_STATS
+#error "This tests needs TCP- and MEMP-statistics enabled"
+#endif
+
+#define DEMUX_SERVER_PORT   0x101
+#define DEMUX_CLIENT_PORT   0x4000
+#define DEMUX_CLIENT_ISS    0x10000
+#define DEMUX_MAX_CONNS     256
+#define DEMUX_BATCH         64
+#define DEMUX_BENCH_SEGS    (16 * 1024)
+
+#if MEMP_NUM_TCP_PCB < DEMUX_MAX_CONNS
+#error "This tests needs MEMP_NUM_TCP_PCB >= DEMUX_MAX_CONNS"
+#endif
+
+/* the last segment sent by the stack */
+struct demux_tx {
+	u32_t count;
+	u16_t dest;
+	u32_t seqno;
+	u32_t ackno;
+	u8_t flags;
+};
+
+static struct netif demux_netif;
+static struct demux_tx demux_tx;
+static struct tcp_pcb *demux_listener;
+static struct tcp_pcb *demux_conns[DEMUX_MAX_CONNS];
+static u32_t demux_rx_bytes[DEMUX_MAX_CONNS];
+static u16_t demux_num_conns;
+
+static err_t demux_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+	struct ip_hdr *iphdr = (struct ip_hdr *)p->payload;
+	struct tcp_hdr *tcphdr = (struct tcp_hdr *)((u8_t *)p->payload + IPH_HL(iphdr) * 4);
+	LWIP_UNUSED_ARG(netif);
+	LWIP_UNUSED_ARG(ipaddr);
+
+	demux_tx.count++;
+	demux_tx.dest = lwip_ntohs(tcphdr->dest);
+	demux_tx.seqno = lwip_ntohl(tcphdr->seqno);
+	demux_tx.ackno = lwip_ntohl(tcphdr->ackno);
+	demux_tx.flags = TCPH_FLAGS(tcphdr);
+	return ERR_OK;
+}
+
+/* Connection i comes from one of 8 hosts, each using its own port */
+static void demux_remote(u16_t i, ip_addr_t *ip, u16_t *port)
+{
+	IP_ADDR4(ip, 10, 0, 0, 1 + (i % 8));
+	*port = DEMUX_CLIENT_PORT + i;
+}
+
+/** Create an IPv4 packet from the remote end of connection i to the server */
+static struct pbuf *demux_segment(u16_t i, u32_t seqno, u32_t ackno, u8_t flags, const void *data, u16_t len)
+{
+	struct pbuf *p;
+	struct ip_hdr *iphdr;
+	struct tcp_hdr *tcphdr;
+	ip_addr_t src;
+	u16_t sport;
+
+	p = pbuf_alloc(PBUF_RAW, IP_HLEN + TCP_HLEN + len, PBUF_RAM);
+	EXPECT_RETNULL(p != NULL);
+	EXPECT(p->next == NULL);
+	memset(p->payload, 0, IP_HLEN + TCP_HLEN);
+	demux_remote(i, &src, &sport);
+
+	iphdr = (struct ip_hdr *)p->payload;
+	IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+	IPH_LEN_SET(iphdr, lwip_htons(p->tot_len));
+	IPH_TTL_SET(iphdr, 64);
+	IPH_PROTO_SET(iphdr, IP_PROTO_TCP);
+	ip4_addr_copy(iphdr->src, *ip_2_ip4(&src));
+	ip4_addr_copy(iphdr->dest, *ip_2_ip4(&demux_netif.ip_addr));
+	IPH_CHKSUM_SET(iphdr, inet_chksum(iphdr, IP_HLEN));
+
+	tcphdr = (struct tcp_hdr *)((u8_t *)p->payload + IP_HLEN);
+	tcphdr->src = lwip_htons(sport);
+	tcphdr->dest = lwip_htons(DEMUX_SERVER_PORT);
+	tcphdr->seqno = lwip_htonl(seqno);
+	tcphdr->ackno = lwip_htonl(ackno);
+	TCPH_HDRLEN_FLAGS_SET(tcphdr, TCP_HLEN / 4, flags);
+	tcphdr->wnd = lwip_htons(TCP_WND);
+	if (len > 0) {
+		memcpy((u8_t *)tcphdr + TCP_HLEN, data, len);
+	}
+
+	pbuf_header(p, -IP_HLEN);
+	tcphdr->chksum = inet_chksum_pseudo(p, IP_PROTO_TCP, p->tot_len, ip_2_ip4(&src), ip_2_ip4(&demux_netif.ip_addr));
+	pbuf_header(p, IP_HLEN);
+	return p;
+}
+
+static err_t demux_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	u32_t *rx_bytes = (u32_t *)arg;
+	LWIP_UNUSED_ARG(err);
+
+	if (p != NULL) {
+		*rx_bytes += p->tot_len;
+		tcp_recved(pcb, p->tot_len);
+		pbuf_free(p);
+	}
+	return ERR_OK;
+}
+
+static err_t demux_accept(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(err);
+
+	EXPECT_RETX(demux_num_conns < DEMUX_MAX_CONNS, ERR_MEM);
+	demux_conns[demux_num_conns] = pcb;
+	tcp_arg(pcb, &demux_rx_bytes[demux_num_conns]);
+	tcp_recv(pcb, demux_recv);
+	demux_num_conns++;
+	return ERR_OK;
+}
+
+/** Open the next connection with a handshake through the listener */
+static struct tcp_pcb *demux_connect(void)
+{
+	u16_t i = demux_num_conns;
+	struct pbuf *p;
+
+	p = demux_segment(i, DEMUX_CLIENT_ISS, 0, TCP_SYN, NULL, 0);
+	EXPECT_RETNULL(p != NULL);
+	ip_input(p, &demux_netif);
+	EXPECT_RETNULL(demux_tx.flags == (TCP_SYN | TCP_ACK));
+	EXPECT_RETNULL(demux_tx.dest == DEMUX_CLIENT_PORT + i);
+
+	p = demux_segment(i, DEMUX_CLIENT_ISS + 1, demux_tx.seqno + 1, TCP_ACK, NULL, 0);
+	EXPECT_RETNULL(p != NULL);
+	ip_input(p, &demux_netif);
+	EXPECT_RETNULL(demux_num_conns == i + 1);
+	EXPECT_RETNULL(demux_conns[i]->state == ESTABLISHED);
+	return demux_conns[i];
+}
+
+/** Deliver one data byte to connection i */
+static void demux_send_byte(u16_t i)
+{
+	struct tcp_pcb *pcb = demux_conns[i];
+	struct pbuf *p;
+	u8_t data = (u8_t)i;
+
+	p = demux_segment(i, DEMUX_CLIENT_ISS + 1 + demux_rx_bytes[i], pcb->snd_nxt, TCP_ACK | TCP_PSH, &data, 1);
+	EXPECT_RET(p != NULL);
+	ip_input(p, &demux_netif);
+}
+
+static u32_t demux_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+/* Setups/teardown functions */
+
+static void tcp_demux_setup(void)
+{
+	struct tcp_pcb *pcb;
+	err_t err;
+
+	memset(&demux_netif, 0, sizeof(demux_netif));
+	memset(&demux_tx, 0, sizeof(demux_tx));
+	memset(demux_conns, 0, sizeof(demux_conns));
+	memset(demux_rx_bytes, 0, sizeof(demux_rx_bytes));
+	demux_num_conns = 0;
+
+	demux_netif.output = demux_output;
+	demux_netif.flags = NETIF_FLAG_UP | NETIF_FLAG_LINK_UP;
+	demux_netif.mtu = 1500;
+	IP_ADDR4(&demux_netif.ip_addr, 192, 168, 1, 1);
+	IP_ADDR4(&demux_netif.netmask, 255, 255, 255, 0);
+	IP_ADDR4(&demux_netif.gw, 192, 168, 1, 254);
+	netif_list = &demux_netif;
+	netif_default = &demux_netif;
+
+	pcb = tcp_new();
+	EXPECT_RET(pcb != NULL);
+	err = tcp_bind(pcb, &demux_netif.ip_addr, DEMUX_SERVER_PORT);
+	EXPECT_RET(err == ERR_OK);
+	demux_listener = tcp_listen(pcb);
+	EXPECT_RET(demux_listener != NULL);
+	tcp_accept(demux_listener, demux_accept);
+}
+
+static void tcp_demux_teardown(void)
+{
+	while (tcp_active_pcbs != NULL) {
+		tcp_abort(tcp_active_pcbs);
+	}
+	while (tcp_tw_pcbs != NULL) {
+		tcp_abort(tcp_tw_pcbs);
+	}
+	if (demux_listener != NULL) {
+		tcp_close(demux_listener);
+		demux_listener = NULL;
+	}
+	netif_list = NULL;
+	netif_default = NULL;
+	fail_unless(MEMP_STATS_GET(used, MEMP_TCP_PCB) == 0);
+	fail_unless(MEMP_STATS_GET(used, MEMP_TCP_PCB_LISTEN) == 0);
+}
+
+/* Test functions */
+
+/** Segments reach the right connection, also after others were removed */
+START_TEST(test_tcp_demux_lookup)
+{
+	struct tcp_pcb *pcb;
+	u32_t tx_count;
+	u16_t num = 64;
+	u16_t i;
+	LWIP_UNUSED_ARG(_i);
+
+	for (i = 0; i < num; i++) {
+		pcb = demux_connect();
+		EXPECT_RET(pcb != NULL);
+	}
+
+	/* in the reverse order of setup */
+	for (i = num; i-- > 0;) {
+		demux_send_byte(i);
+	}
+	for (i = 0; i < num; i++) {
+		EXPECT(demux_rx_bytes[i] == 1);
+	}
+
+	/* remove every other connection: the peer gets reset, the others still
+	   receive */
+	for (i = 0; i < num; i += 2) {
+		tcp_abort(demux_conns[i]);
+	}
+	for (i = 0; i < num; i++) {
+		tx_count = demux_tx.count;
+		if (i % 2 == 0) {
+			u8_t data = 0;
+			struct pbuf *p = demux_segment(i, DEMUX_CLIENT_ISS + 2, 0, TCP_ACK, &data, 1);
+			EXPECT_RET(p != NULL);
+			ip_input(p, &demux_netif);
+			EXPECT(demux_tx.count == tx_count + 1);
+			EXPECT(demux_tx.flags & TCP_RST);
+			EXPECT(demux_tx.dest == DEMUX_CLIENT_PORT + i);
+		} else {
+			demux_send_byte(i);
+			EXPECT(demux_rx_bytes[i] == 2);
+		}
+	}
+}
+
+END_TEST
+/** A retransmitted FIN reaches the connection in TIME-WAIT and is acked */
+START_TEST(test_tcp_demux_timewait)
+{
+	struct tcp_pcb *pcb;
+	struct pbuf *p;
+	u32_t fin_seqno;
+	err_t err;
+	LWIP_UNUSED_ARG(_i);
+
+	pcb = demux_connect();
+	EXPECT_RET(pcb != NULL);
+
+	err = tcp_close(pcb);
+	EXPECT_RET(err == ERR_OK);
+	EXPECT_RET(demux_tx.flags & TCP_FIN);
+	fin_seqno = demux_tx.seqno;
+
+	/* FIN|ACK from the peer: FIN_WAIT_1 -> TIME_WAIT */
+	p = demux_segment(0, DEMUX_CLIENT_ISS + 1, fin_seqno + 1, TCP_FIN | TCP_ACK, NULL, 0);
+	EXPECT_RET(p != NULL);
+	ip_input(p, &demux_netif);
+	EXPECT_RET(tcp_tw_pcbs == pcb);
+	EXPECT(pcb->state == TIME_WAIT);
+	EXPECT(tcp_active_pcbs == NULL);
+
+	/* the peer did not get our ACK and sends its FIN again */
+	memset(&demux_tx, 0, sizeof(demux_tx));
+	p = demux_segment(0, DEMUX_CLIENT_ISS + 1, fin_seqno + 1, TCP_FIN | TCP_ACK, NULL, 0);
+	EXPECT_RET(p != NULL);
+	ip_input(p, &demux_netif);
+	EXPECT(demux_tx.count == 1);
+	EXPECT(demux_tx.flags == TCP_ACK);
+	EXPECT(demux_tx.ackno == DEMUX_CLIENT_ISS + 2);
+	EXPECT(tcp_tw_pcbs == pcb);
+}
+
+END_TEST
+/** Cost of tcp input for an ACK as the number of connections grows. The
+ * ACKs go round robin over all connections like with many busy peers. */
+START_TEST(test_tcp_demux_bench)
+{
+	static const u16_t counts[] = { 1, 16, 64, DEMUX_MAX_CONNS };
+	struct pbuf *batch[DEMUX_BATCH];
+	struct tcp_pcb *pcb;
+	u32_t tx_count;
+	u32_t elapsed;
+	u32_t start;
+	u32_t sent;
+	u16_t next = 0;
+	u16_t num;
+	u16_t n;
+	u16_t c;
+	u16_t i;
+	LWIP_UNUSED_ARG(_i);
+
+	for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+		while (demux_num_conns < counts[c]) {
+			pcb = demux_connect();
+			EXPECT_RET(pcb != NULL);
+		}
+
+		tx_count = demux_tx.count;
+		elapsed = 0;
+		for (sent = 0; sent < DEMUX_BENCH_SEGS; sent += n) {
+			for (n = 0; n < DEMUX_BATCH; n++) {
+				i = next;
+				next = (next + 1) % demux_num_conns;
+				batch[n] = demux_segment(i, DEMUX_CLIENT_ISS + 1, demux_conns[i]->snd_nxt, TCP_ACK, NULL, 0);
+				EXPECT_RET(batch[n] != NULL);
+			}
+			start = demux_now_ns();
+			for (n = 0; n < DEMUX_BATCH; n++) {
+				ip_input(batch[n], &demux_netif);
+			}
+			elapsed += demux_now_ns() - start;
+		}
+		num = demux_num_conns;
+
+		/* a pure ACK for a known connection sends nothing, a lookup miss
+		   would have sent a reset */
+		EXPECT(demux_tx.count == tx_count);
+		LWIP_PLATFORM_DIAG(("tcp demux (%s): %3" U16_F " connections, %5" U32_F " ns per segment\n", LWIP_TCP_PCB_HASH ? "hash" : "list", num, elapsed / sent));
+	}
+}
+
+END_TEST
+/** Create the suite including all tests for this module */
+Suite *tcp_demux_suite(void)
+{
+	TFun tests[] = {
+		test_tcp_demux_lookup,
+		test_tcp_demux_timewait,
+		test_tcp_demux_bench
+	};
+	return create_suite("TCP_DEMUX", tests, sizeof(tests) / sizeof(TFun), tcp_demux_setup, tcp_demux_teardown);
+}
@@ -0,0 +1,434 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_tcp_sack.h"
+
+#include <string.h>
+#include <net/lwip/priv/tcp_priv.h>
+#include <net/lwip/stats.h>
+#include <net/lwip/ip.h>
+#include <net/lwip/prot/ip4.h>
+
+#if !LWIP_STATS || !TCP_STATS || !MEMP_STATS
+#error "This tests needs TCP- and MEMP-statistics enabled"
+#endif
+#if !LWIP_TCP_SACK || !TCP_QUEUE_OOSEQ
+#error "This tests needs LWIP_TCP_SACK and TCP_QUEUE_OOSEQ enabled"
+#endif
+
+#define TEST_LINK_QUEUE_LEN  64
+#define TEST_SERVER_PORT     0x101
+#define TEST_TRANSFER_LEN    (256 * 1024)
+#define TEST_MAX_ROUNDS      20000
+
+/* Point-to-point link that loops the packets of both ends back into the
+   stack. One call to test_link_deliver() is one round trip. Data segments
+   the client sends for the first time are dropped when their index matches
+   the loss pattern, retransmissions always get through. */
+struct test_link {
+	struct pbuf *queue[TEST_LINK_QUEUE_LEN];
+	u16_t queued;
+	u16_t client_port;
+	u32_t next_seqno;			/* end of the highest data sent by the client */
+	u32_t segs;					/* data segments sent for the first time */
+	u8_t loss_period;			/* 0: no loss */
+	u8_t loss[2];				/* indexes dropped in each period */
+	u32_t lost_bytes;
+	u32_t data_bytes;			/* data sent by the client, retransmissions included */
+};
+
+static struct netif test_netif;
+static struct test_link test_link;
+static struct tcp_pcb *server_pcb;
+static u32_t server_rx_bytes;
+static u8_t client_connected;
+static char tx_data[4 * TCP_MSS];
+
+static struct tcp_hdr *test_link_tcphdr(struct pbuf *p, u16_t *datalen)
+{
+	struct ip_hdr *iphdr = (struct ip_hdr *)p->payload;
+	u16_t iphlen = IPH_HL(iphdr) * 4;
+	struct tcp_hdr *tcphdr = (struct tcp_hdr *)((u8_t *)p->payload + iphlen);
+
+	*datalen = lwip_ntohs(IPH_LEN(iphdr)) - iphlen - TCPH_HDRLEN(tcphdr) * 4;
+	return tcphdr;
+}
+
+static err_t test_link_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+	struct pbuf *q;
+	struct tcp_hdr *tcphdr;
+	u16_t datalen;
+	u32_t seqno;
+	u32_t idx;
+	LWIP_UNUSED_ARG(netif);
+	LWIP_UNUSED_ARG(ipaddr);
+
+	q = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_RAM);
+	EXPECT_RETX(q != NULL, ERR_MEM);
+	if (pbuf_copy(q, p) != ERR_OK) {
+		pbuf_free(q);
+		fail();
+		return ERR_MEM;
+	}
+
+	tcphdr = test_link_tcphdr(q, &datalen);
+	if (lwip_ntohs(tcphdr->src) == test_link.client_port && datalen > 0) {
+		seqno = lwip_ntohl(tcphdr->seqno);
+		test_link.data_bytes += datalen;
+		if (TCP_SEQ_GEQ(seqno, test_link.next_seqno)) {
+			idx = test_link.segs++;
+			test_link.next_seqno = seqno + datalen;
+			if (test_link.loss_period != 0 && (idx % test_link.loss_period == test_link.loss[0] || idx % test_link.loss_period == test_link.loss[1])) {
+				test_link.lost_bytes += datalen;
+				pbuf_free(q);
+				return ERR_OK;
+			}
+		}
+	}
+
+	if (test_link.queued >= TEST_LINK_QUEUE_LEN) {
+		pbuf_free(q);
+		fail();
+		return ERR_MEM;
+	}
+	test_link.queue[test_link.queued++] = q;
+	return ERR_OK;
+}
+
+static void test_link_deliver(void)
+{
+	struct pbuf *queue[TEST_LINK_QUEUE_LEN];
+	u16_t num = test_link.queued;
+	u16_t i;
+
+	/* packets sent in response go out with the next round */
+	memcpy(queue, test_link.queue, num * sizeof(queue[0]));
+	test_link.queued = 0;
+	for (i = 0; i < num; i++) {
+		ip_input(queue[i], &test_netif);
+	}
+}
+
+static void test_link_drop_all(void)
+{
+	while (test_link.queued > 0) {
+		pbuf_free(test_link.queue[--test_link.queued]);
+	}
+}
+
+static err_t server_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(err);
+
+	if (p != NULL) {
+		server_rx_bytes += p->tot_len;
+		tcp_recved(pcb, p->tot_len);
+		pbuf_free(p);
+	}
+	return ERR_OK;
+}
+
+static err_t server_accept(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(err);
+
+	server_pcb = pcb;
+	tcp_recv(pcb, server_recv);
+	return ERR_OK;
+}
+
+static err_t client_connected_cb(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(err);
+
+	client_connected = 1;
+	return ERR_OK;
+}
+
+/** Connect a new client to a new listener over the test link */
+static struct tcp_pcb *sack_connect(struct tcp_pcb **listener)
+{
+	struct tcp_pcb *lpcb;
+	struct tcp_pcb *client;
+	err_t err;
+	int i;
+
+	lpcb = tcp_new();
+	EXPECT_RETNULL(lpcb != NULL);
+	err = tcp_bind(lpcb, &test_netif.ip_addr, TEST_SERVER_PORT);
+	EXPECT_RETNULL(err == ERR_OK);
+	lpcb = tcp_listen(lpcb);
+	EXPECT_RETNULL(lpcb != NULL);
+	tcp_accept(lpcb, server_accept);
+	*listener = lpcb;
+
+	client = tcp_new();
+	EXPECT_RETNULL(client != NULL);
+	err = tcp_bind(client, &test_netif.ip_addr, 0);
+	EXPECT_RETNULL(err == ERR_OK);
+	err = tcp_connect(client, &test_netif.ip_addr, TEST_SERVER_PORT, client_connected_cb);
+	EXPECT_RETNULL(err == ERR_OK);
+	test_link.client_port = client->local_port;
+	test_link.next_seqno = client->snd_lbb;
+
+	/* SYN, SYN|ACK, ACK */
+	for (i = 0; i < 3; i++) {
+		test_link_deliver();
+	}
+	EXPECT_RETNULL(client_connected && server_pcb != NULL);
+	return client;
+}
+
+static void sack_disconnect(struct tcp_pcb *client, struct tcp_pcb *listener)
+{
+	tcp_abort(client);
+	if (server_pcb != NULL) {
+		tcp_abort(server_pcb);
+		server_pcb = NULL;
+	}
+	tcp_close(listener);
+	test_link_drop_all();
+}
+
+/**
+ * Send len bytes from the client to the server and return the number of
+ * rounds it took. A round is one round trip plus one call to tcp_tmr().
+ */
+static u32_t sack_transfer(struct tcp_pcb *client, u32_t len)
+{
+	u32_t written = 0;
+	u32_t rounds = 0;
+	u32_t n;
+
+	while (server_rx_bytes < len && rounds < TEST_MAX_ROUNDS) {
+		while (written < len) {
+			n = LWIP_MIN(LWIP_MIN(tcp_sndbuf(client), sizeof(tx_data)), len - written);
+			if (n == 0 || tcp_write(client, tx_data, (u16_t) n, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+				break;
+			}
+			written += n;
+		}
+		tcp_output(client);
+		test_link_deliver();
+		tcp_tmr();
+		rounds++;
+	}
+	return rounds;
+}
+
+/* Find the SACK option of a segment, returns the number of blocks */
+static u8_t sack_find_blocks(struct tcp_hdr *tcphdr, u32_t *left, u32_t *right)
+{
+	u8_t *opts = (u8_t *)(tcphdr + 1);
+	u16_t optlen = TCPH_HDRLEN(tcphdr) * 4 - TCP_HLEN;
+	u16_t i = 0;
+	u8_t num;
+	u8_t n;
+
+	while (i < optlen) {
+		if (opts[i] == LWIP_TCP_OPT_EOL) {
+			break;
+		}
+		if (opts[i] == LWIP_TCP_OPT_NOP) {
+			i++;
+			continue;
+		}
+		if (opts[i] == LWIP_TCP_OPT_SACK) {
+			num = (opts[i + 1] - 2) / LWIP_TCP_OPT_LEN_SACK_BLOCK;
+			for (n = 0; n < num; n++) {
+				u8_t *b = &opts[i + 2 + n * LWIP_TCP_OPT_LEN_SACK_BLOCK];
+				left[n] = ((u32_t) b[0] << 24) | ((u32_t) b[1] << 16) | ((u32_t) b[2] << 8) | b[3];
+				right[n] = ((u32_t) b[4] << 24) | ((u32_t) b[5] << 16) | ((u32_t) b[6] << 8) | b[7];
+			}
+			return num;
+		}
+		i += opts[i + 1];
+	}
+	return 0;
+}
+
+/* Setups/teardown functions */
+
+static void tcp_sack_setup(void)
+{
+	memset(&test_netif, 0, sizeof(test_netif));
+	memset(&test_link, 0, sizeof(test_link));
+	test_netif.output = test_link_output;
+	test_netif.flags = NETIF_FLAG_UP | NETIF_FLAG_LINK_UP;
+	test_netif.mtu = 1500;
+	IP_ADDR4(&test_netif.ip_addr, 192, 168, 1, 1);
+	IP_ADDR4(&test_netif.netmask, 255, 255, 255, 0);
+	netif_list = &test_netif;
+
+	server_pcb = NULL;
+	server_rx_bytes = 0;
+	client_connected = 0;
+}
+
+static void tcp_sack_teardown(void)
+{
+	test_link_drop_all();
+	netif_list = NULL;
+	fail_unless(MEMP_STATS_GET(used, MEMP_TCP_PCB) == 0);
+	fail_unless(MEMP_STATS_GET(used, MEMP_TCP_SEG) == 0);
+}
+
+/* Test functions */
+
+/** Both ends send SACK permitted in their SYN and enable SACK */
+START_TEST(test_tcp_sack_negotiate)
+{
+	struct tcp_pcb *client;
+	struct tcp_pcb *listener;
+	LWIP_UNUSED_ARG(_i);
+
+	client = sack_connect(&listener);
+	EXPECT_RET(client != NULL);
+	EXPECT((client->flags & TF_SACK) != 0);
+	EXPECT((server_pcb->flags & TF_SACK) != 0);
+
+	sack_disconnect(client, listener);
+}
+
+END_TEST
+/** Lose the first of four segments: the receiver reports the other three
+ * in one SACK block, the sender marks them and retransmits only the hole */
+START_TEST(test_tcp_sack_scoreboard)
+{
+	struct tcp_pcb *client;
+	struct tcp_pcb *listener;
+	struct tcp_seg *seg;
+	struct tcp_hdr *tcphdr;
+	u32_t left[LWIP_TCP_SACK_BLOCKS_MAX];
+	u32_t right[LWIP_TCP_SACK_BLOCKS_MAX];
+	u32_t start;
+	u16_t datalen;
+	u16_t i;
+	err_t err;
+	LWIP_UNUSED_ARG(_i);
+
+	client = sack_connect(&listener);
+	EXPECT_RET(client != NULL);
+
+	/* one clean segment first: the first ACK after the handshake is taken
+	   as a window update and would not count as a duplicate */
+	sack_transfer(client, TCP_MSS);
+	test_link_deliver();
+	EXPECT_RET(client->unacked == NULL);
+
+	/* cwnd allows four segments, drop the first of them only */
+	test_link.loss_period = 255;
+	test_link.loss[0] = test_link.loss[1] = (u8_t)(test_link.segs % 255);
+	start = client->snd_nxt;
+	err = tcp_write(client, tx_data, 4 * TCP_MSS, TCP_WRITE_FLAG_COPY);
+	EXPECT_RET(err == ERR_OK);
+	err = tcp_output(client);
+	EXPECT_RET(err == ERR_OK);
+	EXPECT_RET(test_link.queued == 3);
+
+	/* one ACK per out-of-order segment, the last one covers all three */
+	test_link_deliver();
+	EXPECT_RET(test_link.queued == 3);
+	tcphdr = test_link_tcphdr(test_link.queue[2], &datalen);
+	EXPECT(lwip_ntohl(tcphdr->ackno) == start);
+	EXPECT_RET(sack_find_blocks(tcphdr, left, right) == 1);
+	EXPECT(left[0] == start + TCP_MSS);
+	EXPECT(right[0] == start + 4 * TCP_MSS);
+
+	/* three dupacks: only the hole is retransmitted */
+	test_link_deliver();
+	EXPECT((client->flags & TF_INFR) != 0);
+	EXPECT(client->sack_high == start + 4 * TCP_MSS);
+	for (seg = client->unacked; seg != NULL; seg = seg->next) {
+		if (lwip_ntohl(seg->tcphdr->seqno) == start) {
+			EXPECT((seg->flags & TF_SEG_SACKED) == 0);
+		} else {
+			EXPECT((seg->flags & TF_SEG_SACKED) != 0);
+		}
+	}
+	EXPECT_RET(test_link.queued == 1);
+	tcphdr = test_link_tcphdr(test_link.queue[0], &datalen);
+	EXPECT(lwip_ntohl(tcphdr->seqno) == start);
+	EXPECT(datalen == TCP_MSS);
+
+	/* the retransmission fills the hole and everything is acked */
+	for (i = 0; i < 2; i++) {
+		test_link_deliver();
+	}
+	EXPECT(server_rx_bytes == 5 * TCP_MSS);
+	EXPECT(client->unacked == NULL);
+	EXPECT((client->flags & TF_INFR) == 0);
+
+	sack_disconnect(client, listener);
+}
+
+END_TEST
+/** Transfer over a link losing two close segments out of every 32, once
+ * without and once with SACK, and report the goodput of both */
+START_TEST(test_tcp_sack_lossy_goodput)
+{
+	struct tcp_pcb *client;
+	struct tcp_pcb *listener;
+	u32_t rounds[2];
+	u32_t rexmit[2];
+	int sack;
+	LWIP_UNUSED_ARG(_i);
+
+	for (sack = 0; sack < 2; sack++) {
+		tcp_sack_setup();
+		test_link.loss_period = 32;
+		test_link.loss[0] = 4;
+		test_link.loss[1] = 6;
+
+		client = sack_connect(&listener);
+		EXPECT_RET(client != NULL);
+		if (!sack) {
+			client->flags &= ~TF_SACK;
+			server_pcb->flags &= ~TF_SACK;
+		}
+		rounds[sack] = sack_transfer(client, TEST_TRANSFER_LEN);
+		rexmit[sack] = test_link.data_bytes - TEST_TRANSFER_LEN;
+		EXPECT(server_rx_bytes == TEST_TRANSFER_LEN);
+		LWIP_PLATFORM_DIAG(("%s: %" U32_F " bytes in %" U32_F " rounds of %d ms, goodput %" U32_F " bytes/s\n", sack ? "SACK" : "no SACK", server_rx_bytes, rounds[sack], TCP_TMR_INTERVAL, server_rx_bytes / rounds[sack] * 1000 / TCP_TMR_INTERVAL));
+		LWIP_PLATFORM_DIAG(("%s: %" U32_F " bytes lost, %" U32_F " bytes retransmitted\n", sack ? "SACK" : "no SACK", test_link.lost_bytes, rexmit[sack]));
+
+		sack_disconnect(client, listener);
+	}
+
+	/* SACK repairs both losses of a window in one recovery instead of
+	   waiting for the retransmission timeout */
+	EXPECT(rounds[1] < rounds[0]);
+	EXPECT(rexmit[1] <= rexmit[0]);
+}
+
+END_TEST
+/** Create the suite including all tests for this module */
+Suite *tcp_sack_suite(void)
+{
+	TFun tests[] = {
+		test_tcp_sack_negotiate,
+		test_tcp_sack_scoreboard,
+		test_tcp_sack_lossy_goodput
+	};
+	return create_suite("TCP_SACK", tests, sizeof(tests) / sizeof(TFun), tcp_sack_setup, tcp_sack_teardown);
+}
@@ -18,13 +18,32 @@
 
 #include "test_udp.h"
 
+#include <string.h>
+#include <time.h>
 #include <net/lwip/udp.h>
 #include <net/lwip/stats.h>
+#include <net/lwip/ip.h>
+#include <net/lwip/inet_chksum.h>
+#include <net/lwip/prot/ip4.h>
 
 #if !LWIP_STATS || !UDP_STATS || !MEMP_STATS
 #error "This tests needs UDP- and MEMP-statistics enabled"
 #endif
 
+#define UDP_DEMUX_PORT        0x6000
+#define UDP_DEMUX_REMOTE_PORT 0x5000
+#define UDP_DEMUX_PCBS        32
+#define UDP_DEMUX_BATCH       64
+#define UDP_DEMUX_BENCH_DGRAMS (16 * 1024)
+
+#if MEMP_NUM_UDP_PCB <= UDP_DEMUX_PCBS
+#error "This tests needs MEMP_NUM_UDP_PCB > UDP_DEMUX_PCBS"
+#endif
+
+static struct netif udp_demux_netif;
+static u32_t udp_demux_tx_count;
+static u32_t udp_demux_rx[MEMP_NUM_UDP_PCB];
+
 /* Helper functions */
 static void udp_remove_all(void)
 {
@@ -39,6 +58,112 @@ static void udp_remove_all(void)
 	fail_unless(lwip_stats.memp[MEMP_UDP_PCB].used == 0);
 }
 
+static err_t udp_demux_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+	LWIP_UNUSED_ARG(netif);
+	LWIP_UNUSED_ARG(p);
+	LWIP_UNUSED_ARG(ipaddr);
+
+	/* ICMP port unreachable for a datagram no pcb took */
+	udp_demux_tx_count++;
+	return ERR_OK;
+}
+
+static void udp_demux_netif_init(void)
+{
+	memset(&udp_demux_netif, 0, sizeof(udp_demux_netif));
+	memset(udp_demux_rx, 0, sizeof(udp_demux_rx));
+	udp_demux_tx_count = 0;
+	udp_demux_netif.output = udp_demux_output;
+	udp_demux_netif.flags = NETIF_FLAG_UP | NETIF_FLAG_LINK_UP;
+	udp_demux_netif.mtu = 1500;
+	IP_ADDR4(&udp_demux_netif.ip_addr, 192, 168, 1, 1);
+	IP_ADDR4(&udp_demux_netif.netmask, 255, 255, 255, 0);
+	IP_ADDR4(&udp_demux_netif.gw, 192, 168, 1, 254);
+	netif_list = &udp_demux_netif;
+	netif_default = &udp_demux_netif;
+}
+
+static void udp_demux_netif_deinit(void)
+{
+	netif_list = NULL;
+	netif_default = NULL;
+}
+
+/** Create an IPv4 datagram from remote host/port i to a local port */
+static struct pbuf *udp_demux_datagram(u16_t i, u16_t dport)
+{
+	struct pbuf *p;
+	struct ip_hdr *iphdr;
+	struct udp_hdr *udphdr;
+	ip4_addr_t src;
+
+	p = pbuf_alloc(PBUF_RAW, IP_HLEN + UDP_HLEN + 4, PBUF_RAM);
+	EXPECT_RETNULL(p != NULL);
+	EXPECT(p->next == NULL);
+	memset(p->payload, 0, p->tot_len);
+	IP4_ADDR(&src, 10, 0, 0, 1 + (i % 8));
+
+	iphdr = (struct ip_hdr *)p->payload;
+	IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+	IPH_LEN_SET(iphdr, lwip_htons(p->tot_len));
+	IPH_TTL_SET(iphdr, 64);
+	IPH_PROTO_SET(iphdr, IP_PROTO_UDP);
+	ip4_addr_copy(iphdr->src, src);
+	ip4_addr_copy(iphdr->dest, *ip_2_ip4(&udp_demux_netif.ip_addr));
+	IPH_CHKSUM_SET(iphdr, inet_chksum(iphdr, IP_HLEN));
+
+	/* no checksum */
+	udphdr = (struct udp_hdr *)((u8_t *)p->payload + IP_HLEN);
+	udphdr->src = lwip_htons(UDP_DEMUX_REMOTE_PORT + i);
+	udphdr->dest = lwip_htons(dport);
+	udphdr->len = lwip_htons(UDP_HLEN + 4);
+	return p;
+}
+
+/** Deliver a datagram, returns 1 if a pcb received it */
+static int udp_demux_deliver(u16_t i, u16_t dport)
+{
+	struct pbuf *p = udp_demux_datagram(i, dport);
+	u32_t tx_count = udp_demux_tx_count;
+
+	EXPECT_RETX(p != NULL, 0);
+	ip_input(p, &udp_demux_netif);
+	return udp_demux_tx_count == tx_count;
+}
+
+static void udp_demux_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+	u32_t *rx = (u32_t *)arg;
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(addr);
+	LWIP_UNUSED_ARG(port);
+
+	(*rx)++;
+	pbuf_free(p);
+}
+
+static struct udp_pcb *udp_demux_bind(u16_t n, u16_t port)
+{
+	struct udp_pcb *pcb;
+	err_t err;
+
+	pcb = udp_new();
+	EXPECT_RETNULL(pcb != NULL);
+	err = udp_bind(pcb, IP_ADDR_ANY, port);
+	EXPECT_RETNULL(err == ERR_OK);
+	udp_recv(pcb, udp_demux_recv, &udp_demux_rx[n]);
+	return pcb;
+}
+
+static u32_t udp_demux_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
 /* Setups/teardown functions */
 
 static void udp_setup(void)
@@ -69,12 +194,108 @@ START_TEST(test_udp_new_remove)
 	}
 }
 
+END_TEST
+/** Datagrams reach the pcb bound to their port, also after rebinding and
+ * removing pcbs; a connected pcb only takes datagrams from its peer */
+START_TEST(test_udp_demux)
+{
+	struct udp_pcb *pcbs[UDP_DEMUX_PCBS];
+	struct udp_pcb *conn;
+	ip_addr_t remote;
+	err_t err;
+	u16_t i;
+	LWIP_UNUSED_ARG(_i);
+
+	udp_demux_netif_init();
+	for (i = 0; i < UDP_DEMUX_PCBS; i++) {
+		pcbs[i] = udp_demux_bind(i, UDP_DEMUX_PORT + i);
+		EXPECT_RET(pcbs[i] != NULL);
+	}
+	conn = udp_demux_bind(UDP_DEMUX_PCBS, UDP_DEMUX_PORT + UDP_DEMUX_PCBS);
+	EXPECT_RET(conn != NULL);
+	IP_ADDR4(&remote, 10, 0, 0, 1);
+	err = udp_connect(conn, &remote, UDP_DEMUX_REMOTE_PORT);
+	EXPECT_RET(err == ERR_OK);
+
+	for (i = UDP_DEMUX_PCBS; i-- > 0;) {
+		EXPECT(udp_demux_deliver(i, UDP_DEMUX_PORT + i));
+		EXPECT(udp_demux_rx[i] == 1);
+	}
+	EXPECT(udp_demux_deliver(0, UDP_DEMUX_PORT + UDP_DEMUX_PCBS));
+	EXPECT(!udp_demux_deliver(1, UDP_DEMUX_PORT + UDP_DEMUX_PCBS));
+	EXPECT(udp_demux_rx[UDP_DEMUX_PCBS] == 1);
+
+	/* rebinding moves the pcb to its new port */
+	err = udp_bind(pcbs[0], IP_ADDR_ANY, UDP_DEMUX_PORT + 0x100);
+	EXPECT_RET(err == ERR_OK);
+	EXPECT(!udp_demux_deliver(0, UDP_DEMUX_PORT));
+	EXPECT(udp_demux_deliver(0, UDP_DEMUX_PORT + 0x100));
+	EXPECT(udp_demux_rx[0] == 2);
+
+	udp_remove(pcbs[1]);
+	EXPECT(!udp_demux_deliver(1, UDP_DEMUX_PORT + 1));
+	EXPECT(udp_demux_deliver(2, UDP_DEMUX_PORT + 2));
+	EXPECT(udp_demux_rx[2] == 2);
+
+	udp_demux_netif_deinit();
+}
+
+END_TEST
+/** Cost of udp input for a datagram as the number of bound pcbs grows */
+START_TEST(test_udp_demux_bench)
+{
+	static const u16_t counts[] = { 1, 16, MEMP_NUM_UDP_PCB };
+	struct pbuf *batch[UDP_DEMUX_BATCH];
+	struct udp_pcb *pcb;
+	u32_t elapsed;
+	u32_t start;
+	u32_t sent;
+	u32_t rx;
+	u16_t num = 0;
+	u16_t next = 0;
+	u16_t n;
+	u16_t c;
+	LWIP_UNUSED_ARG(_i);
+
+	udp_demux_netif_init();
+	for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+		for (; num < counts[c]; num++) {
+			pcb = udp_demux_bind(num, UDP_DEMUX_PORT + num);
+			EXPECT_RET(pcb != NULL);
+		}
+
+		elapsed = 0;
+		for (sent = 0; sent < UDP_DEMUX_BENCH_DGRAMS; sent += n) {
+			for (n = 0; n < UDP_DEMUX_BATCH; n++) {
+				batch[n] = udp_demux_datagram(next, UDP_DEMUX_PORT + next);
+				EXPECT_RET(batch[n] != NULL);
+				next = (next + 1) % num;
+			}
+			start = udp_demux_now_ns();
+			for (n = 0; n < UDP_DEMUX_BATCH; n++) {
+				ip_input(batch[n], &udp_demux_netif);
+			}
+			elapsed += udp_demux_now_ns() - start;
+		}
+
+		for (rx = 0, n = 0; n < num; n++) {
+			rx += udp_demux_rx[n];
+			udp_demux_rx[n] = 0;
+		}
+		EXPECT(rx == sent);
+		LWIP_PLATFORM_DIAG(("udp demux (%s): %3" U16_F " pcbs, %5" U32_F " ns per datagram\n", LWIP_UDP_PCB_HASH ? "hash" : "list", num, elapsed / sent));
+	}
+	udp_demux_netif_deinit();
+}
+
 END_TEST
 /** Create the suite including all tests for this module */
 Suite *udp_suite(void)
 {
 	TFun tests[] = {
 		test_udp_new_remove,
+		test_udp_demux,
+		test_udp_demux_bench
 	};
 	return create_suite("UDP", tests, sizeof(tests) / sizeof(TFun), udp_setup, udp_teardown);
 }
@@ -32,7 +32,9 @@
 #include <net/lwip/debug.h>
 #include <net/lwip/def.h>
 #include <net/lwip/mem.h>
+#include <net/lwip/memp.h>
 #include <net/lwip/pbuf.h>
+#include <net/lwip/sys.h>
 #include <net/lwip/stats.h>
 #include <net/lwip/ip_addr.h>
 #include <net/lwip/snmp.h>
@@ -72,6 +74,20 @@ struct ethernetif {
 	/* Add whatever per-interface state that is needed here. */
 };
 
+#ifdef CONFIG_NET_ETHERNET_RXLOAN
+/* A driver buffer on loan to lwIP */
+
+struct ethernetif_rxloan {
+	struct pbuf_custom pc;		/* Must be first */
+	ethernetif_rxrelease_t release;
+	void *arg;
+};
+
+LWIP_MEMPOOL_DECLARE(ETH_RXLOAN, CONFIG_NET_ETHERNET_RXLOAN_MAX, sizeof(struct ethernetif_rxloan), "ETH_RXLOAN")
+
+static bool g_rxloan_initialized;
+#endif
+
 #ifdef LWIP_NETIF_STATUS_CALLBACK
 void ethernetif_status_callback(struct netif *netif)
 {
@@ -127,33 +143,12 @@ static err_t ethernetif_output(struct netif *netif, struct pbuf *p)
 	return ERR_OK;
 }
 
-/**
- * This function should be called when a packet is ready to be read
- * from the interface. It uses the function enc_pktif() that
- * handles the actual reception of bytes from the network
- * interface. Then the received pkt is sent to LWIP layer for processing.
- *
- * Should allocate a pbuf and transfer the bytes of the incoming
- * packet from the interface into the pbuf.
- *
- * @param netif the lwip network interface structure for this ethernetif
- * @return a pbuf filled with the received packet (including MAC header)
- *         NULL on memory error
- */
-int ethernetif_input(struct netif *netif)
-{
+/* Copy a received frame into a PBUF_POOL chain and pass it up */
 
-	LWIP_DEBUGF(NETIF_DEBUG, ("passing to LWIP layer, packet len %d \n", netif->d_len));
+static int ethernetif_input_copy(struct netif *netif, u8_t *frame_ptr, u16_t len)
+{
 	struct pbuf *p, *q;
-	u16_t len = 0;
-	u8_t *frame_ptr;
-	/* Receive the complete packet */
-	frame_ptr = &(netif->d_buf[0]);
-	/* Obtain the size of the packet and put it into the "len" variable. */
-	len = netif->d_len;
-	if (0 == len) {
-		return 0;
-	}
+
 	/* We allocate a pbuf chain of pbufs from the pool. */
 	p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
 
@@ -183,6 +178,102 @@ int ethernetif_input(struct netif *netif)
 	return 0;
 }
 
+/**
+ * This function should be called when a packet is ready to be read
+ * from the interface. It uses the function enc_pktif() that
+ * handles the actual reception of bytes from the network
+ * interface. Then the received pkt is sent to LWIP layer for processing.
+ *
+ * Should allocate a pbuf and transfer the bytes of the incoming
+ * packet from the interface into the pbuf.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @return a pbuf filled with the received packet (including MAC header)
+ *         NULL on memory error
+ */
+int ethernetif_input(struct netif *netif)
+{
+	LWIP_DEBUGF(NETIF_DEBUG, ("passing to LWIP layer, packet len %d \n", netif->d_len));
+	/* The complete packet is in d_buf, its size in d_len */
+	if (0 == netif->d_len) {
+		return 0;
+	}
+	return ethernetif_input_copy(netif, &(netif->d_buf[0]), netif->d_len);
+}
+
+#ifdef CONFIG_NET_ETHERNET_RXLOAN
+/* Called by pbuf_free() when lwIP drops the last reference on a loaned frame */
+
+static void ethernetif_rxloan_free(struct pbuf *p)
+{
+	struct ethernetif_rxloan *loan = (struct ethernetif_rxloan *)p;
+	ethernetif_rxrelease_t release = loan->release;
+	void *arg = loan->arg;
+
+	LWIP_MEMPOOL_FREE(ETH_RXLOAN, loan);
+	release(arg);
+}
+
+/**
+ * Pass a frame to lwIP in the driver's own buffer. See
+ * include/tinyara/net/ethernet.h.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param frame the received frame, including the MAC header
+ * @param len the length of the frame
+ * @param release called with arg once lwIP no longer uses the buffer
+ * @param arg driver argument for release
+ * @return 0 if the frame was passed up, -1 if it was dropped
+ */
+int ethernetif_input_loan(struct netif *netif, u8_t *frame, u16_t len, ethernetif_rxrelease_t release, void *arg)
+{
+	struct ethernetif_rxloan *loan;
+	struct pbuf *p;
+	int ret;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	if (0 == len) {
+		release(arg);
+		return 0;
+	}
+
+	/* Drivers may not go through ethernetif_init(), so set up the pool on first use */
+	if (!g_rxloan_initialized) {
+		SYS_ARCH_PROTECT(lev);
+		if (!g_rxloan_initialized) {
+			LWIP_MEMPOOL_INIT(ETH_RXLOAN);
+			g_rxloan_initialized = true;
+		}
+		SYS_ARCH_UNPROTECT(lev);
+	}
+
+	loan = (struct ethernetif_rxloan *)LWIP_MEMPOOL_ALLOC(ETH_RXLOAN);
+	if (loan == NULL) {
+		/* Enough buffers on loan already: copy so the driver gets this one back */
+		ret = ethernetif_input_copy(netif, frame, len);
+		release(arg);
+		return ret;
+	}
+
+	loan->pc.custom_free_function = ethernetif_rxloan_free;
+	loan->release = release;
+	loan->arg = arg;
+	p = pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &loan->pc, frame, len);
+	LWIP_ASSERT("pbuf_alloced_custom failed", p != NULL);
+
+	/* full packet send to tcpip_thread to process */
+	if (netif->input(p, netif) != ERR_OK) {
+		LWIP_DEBUGF(NETIF_DEBUG, ("input processing error\n"));
+		LINK_STATS_INC(link.err);
+		/* Gives the buffer back to the driver */
+		pbuf_free(p);
+	} else {
+		LINK_STATS_INC(link.recv);
+	}
+	return 0;
+}
+#endif							/* CONFIG_NET_ETHERNET_RXLOAN */
+
 /**
  * Should be called at the beginning of the program to set up the
  * network interface. It calls the function low_level_init() to do the
@@ -189,6 +189,26 @@ ssize_t sendto(int s, const void *data, size_t size, int flags, const struct soc
 	return result;
 }
 
+#ifdef CONFIG_NET_SOCKET_MMSG
+int recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int result = lwip_recvmmsg(s, msgvec, vlen, flags, timeout);
+	leave_cancellation_point();
+	return result;
+}
+
+int sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int result = lwip_sendmmsg(s, msgvec, vlen, flags);
+	leave_cancellation_point();
+	return result;
+}
+#endif
+
 static int socket_argument_validation(int domain, int type, int protocol)
 {
 	if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC) {
@@ -239,6 +259,27 @@ int socket(int domain, int type, int protocol)
 	return -1;
 }
 
+#ifdef CONFIG_NET_SOCKET_EPOLL
+int epoll_create(int size)
+{
+	return lwip_epoll_create(size);
+}
+
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event)
+{
+	return lwip_epoll_ctl(epfd, op, fd, event);
+}
+
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int result = lwip_epoll_wait(epfd, events, maxevents, timeout);
+	leave_cancellation_point();
+	return result;
+}
+#endif
+
 #ifdef CONFIG_DISABLE_POLL
 int select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptset, struct timeval *timeout)
 {
@@ -0,0 +1,174 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * net/socket/net_sendfile.c
+ *
+ * Kernel side of sendfile() for TCP sockets. The file is read into pbufs
+ * which are handed to lwIP by reference, so file data is copied once (from
+ * the file system) instead of twice. A buffer is released by lwIP when the
+ * last segment carrying it is acknowledged, which lets the next read go on
+ * while the previous buffers are still in flight.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_SENDFILE) && CONFIG_NFILE_DESCRIPTORS > 0
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/net/net.h>
+#include <net/lwip/api.h>
+#include <net/lwip/pbuf.h>
+#include <net/lwip/sockets.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: net_sendfile
+ *
+ * Description:
+ *   Send 'count' bytes of 'infile' on the TCP socket 'outfd' without
+ *   copying the data into the stack. Called by sendfile() when the output
+ *   descriptor is a socket.
+ *
+ * Parameters:
+ *   outfd    Socket descriptor of a connected TCP socket
+ *   infile   File to read from
+ *   offset   As for sendfile(): if not NULL, read from *offset without
+ *            moving the file position and update *offset
+ *   count    Number of bytes to send
+ *
+ * Returned Value:
+ *   The number of bytes sent; -1 on error with errno set appropriately.
+ *   errno is ENOSYS if the socket is not a TCP socket, in which case the
+ *   caller falls back to the copying implementation.
+ *
+ ****************************************************************************/
+
+ssize_t net_sendfile(int outfd, FAR struct file *infile, FAR off_t *offset, size_t count)
+{
+	FAR struct socket *sock;
+	FAR struct pbuf *p;
+	off_t startpos = 0;
+	size_t ntransferred = 0;
+	size_t written;
+	ssize_t nread;
+	err_t err;
+	int errcode = 0;
+
+	sock = get_socket(outfd);
+	if (sock == NULL) {
+		/* get_socket() has set errno */
+		return ERROR;
+	}
+	if (sock->conn == NULL || NETCONNTYPE_GROUP(netconn_type(sock->conn)) != NETCONN_TCP) {
+		set_errno(ENOSYS);
+		return ERROR;
+	}
+
+	if (offset) {
+		startpos = file_seek(infile, 0, SEEK_CUR);
+		if (startpos == (off_t)-1) {
+			return ERROR;
+		}
+		if (file_seek(infile, *offset, SEEK_SET) == (off_t)-1) {
+			return ERROR;
+		}
+	}
+
+	while (ntransferred < count) {
+		size_t chunk = count - ntransferred;
+		if (chunk > LWIP_SENDFILE_BUFSIZE) {
+			chunk = LWIP_SENDFILE_BUFSIZE;
+		}
+
+		/* Read straight into the buffer that lwIP will send from */
+
+		p = pbuf_alloc(PBUF_RAW, (u16_t)chunk, PBUF_RAM);
+		if (p == NULL) {
+			errcode = ENOMEM;
+			break;
+		}
+
+		nread = file_read(infile, p->payload, chunk);
+		if (nread <= 0) {
+			if (nread < 0) {
+				errcode = get_errno();
+			}
+			pbuf_free(p);
+			break;
+		}
+
+		/* This returns once the data is queued, not when it is acknowledged:
+		 * the queued segments hold their own references on p.
+		 */
+
+		written = 0;
+		err = netconn_write_ref(sock->conn, p, p->payload, (size_t)nread, (ntransferred + nread < count) ? NETCONN_MORE : 0, &written);
+		pbuf_free(p);
+
+		ntransferred += written;
+		if (err != ERR_OK) {
+			errcode = err_to_errno(err);
+			break;
+		}
+		if (written < (size_t)nread) {
+			/* Partial write on a non-blocking socket, leave the file position
+			 * just after the data that was sent.
+			 */
+
+			file_seek(infile, (off_t)written - nread, SEEK_CUR);
+			break;
+		}
+		if ((size_t)nread < chunk) {
+			/* End of file */
+
+			break;
+		}
+	}
+
+	if (offset) {
+		off_t curpos = file_seek(infile, 0, SEEK_CUR);
+		if (curpos == (off_t)-1) {
+			return ERROR;
+		}
+		*offset = curpos;
+		if (file_seek(infile, startpos, SEEK_SET) == (off_t)-1) {
+			return ERROR;
+		}
+	}
+
+	if (ntransferred == 0 && errcode != 0) {
+		ndbg("sendfile on %d failed: %d\n", outfd, errcode);
+		set_errno(errcode);
+		return ERROR;
+	}
+	return (ssize_t)ntransferred;
+}
+
+#endif							/* CONFIG_NET && CONFIG_NET_SENDFILE && CONFIG_NFILE_DESCRIPTORS > 0 */
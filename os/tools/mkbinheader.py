@@ -40,7 +40,7 @@ import struct
 # parameter information :
 #
 # argv[1] is file path of binary file.
-# argv[2] is file type.
+# argv[2] is file type. (bin, elf or xip)
 # argv[3] is kernel version.
 # argv[4] is binary name.
 # argv[5] is binary version.
@@ -85,6 +85,7 @@ header_size = SIZE_OF_HEADERSIZE + SIZE_OF_BINTYPE + SIZE_OF_COMFLAG + SIZE_OF_M
 
 ELF = 1
 BIN = 2
+XIP = 3
 
 COMP_NONE = 0
 COMP_LZMA = 1
@@ -112,6 +113,8 @@ with open(file_path, 'rb') as fp:
         bin_type = BIN
     elif binary_type == 'elf' or binary_type == 'ELF' :
         bin_type = ELF
+    elif binary_type == 'xip' or binary_type == 'XIP' :
+        bin_type = XIP
     else : # Not supported.
         bin_type = 0
         print "Error : Not supported Binary Type"
@@ -122,7 +125,7 @@ with open(file_path, 'rb') as fp:
     # Static RAM size : Extract from size command in linux(ONLY for elf)
     if bin_type == BIN :
         os.system('size ' + elf_path_for_bin_type + ' > ' + STATIC_RAM_ESTIMATION)
-    elif bin_type == ELF :
+    elif bin_type == ELF or bin_type == XIP :
         os.system('size ' + file_path + ' > ' + STATIC_RAM_ESTIMATION)
     else : #Not supported.
         print "Error : Not supported Binary Type"
@@ -148,7 +151,10 @@ with open(file_path, 'rb') as fp:
     # based on comp_enabled, check if we need to compress binary.
     # If yes, assign to bin_comp value for compression algorithm to use.
     # Else, assign 0 to bin_comp to represent no compression
-    if 0 < int(comp_enabled) <= COMP_MAX :
+    # Execute-in-place binary runs its text from flash, so it is never compressed.
+    if bin_type == XIP :
+        bin_comp = 0
+    elif 0 < int(comp_enabled) <= COMP_MAX :
         bin_comp = int(comp_enabled)
     else :
         bin_comp = 0
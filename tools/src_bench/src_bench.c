@@ -0,0 +1,240 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * tools/src_bench/src_bench.c
+ *
+ * Runs the media sample rate converter on a stereo sine tone for every
+ * quality level and common ratio, and reports the CPU cost as cycles per
+ * second of audio together with the SNR of the converted tones. The left
+ * channel carries a 1 kHz tone, the right one a tone at 80% of the lower
+ * Nyquist frequency, where the images and aliases that the longer filter
+ * of the high quality removes fall close to the passband. The SNR of the
+ * 1 kHz tone is bounded by the Q15 filter coefficients at about 85 dB.
+ *
+ * Cycles are read from the TSC on x86. On other hosts pass the CPU clock
+ * with -m and the cycles are derived from the elapsed time.
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "audio/resample/samplerate.h"
+
+#define BENCH_CHANNELS      2
+#define BENCH_TONE_HZ       1000.0
+#define BENCH_HIGH_TONE     0.8
+#define BENCH_AMPLITUDE     16000.0
+#define BENCH_IN_FRAMES     1024
+#define BENCH_OUT_FRAMES    4096
+#define BENCH_SETTLE_FRAMES 256
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+struct bench_ratio_s {
+	int in_rate;
+	int out_rate;
+};
+
+static const struct bench_ratio_s g_ratios[] = {
+	{44100, 48000},
+	{48000, 44100},
+	{16000, 48000},
+	{48000, 16000},
+	{22050, 44100},
+};
+
+static const char *g_quality_name[] = {"low", "medium", "high"};
+
+static double g_mhz;
+
+static uint64_t now_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	if (g_mhz == 0) {
+		return __rdtsc();
+	}
+#endif
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)((ts.tv_sec * 1e9 + ts.tv_nsec) * g_mhz / 1000);
+}
+
+/* Least squares fit of the tone at the output rate, the residual is noise */
+static double tone_snr(const int16_t *out, int frames, int channel, double hz, int rate)
+{
+	double ss = 0, sc = 0, cc = 0, xs = 0, xc = 0;
+	double a, b, signal = 0, noise = 0;
+	double w = 2 * M_PI * hz / rate;
+	int i;
+
+	for (i = BENCH_SETTLE_FRAMES; i < frames; i++) {
+		double s = sin(w * i);
+		double c = cos(w * i);
+		double x = out[i * BENCH_CHANNELS + channel];
+		ss += s * s;
+		sc += s * c;
+		cc += c * c;
+		xs += x * s;
+		xc += x * c;
+	}
+	a = (xs * cc - xc * sc) / (ss * cc - sc * sc);
+	b = (xc * ss - xs * sc) / (ss * cc - sc * sc);
+
+	for (i = BENCH_SETTLE_FRAMES; i < frames; i++) {
+		double y = a * sin(w * i) + b * cos(w * i);
+		double e = out[i * BENCH_CHANNELS + channel] - y;
+		signal += y * y;
+		noise += e * e;
+	}
+	if (noise == 0) {
+		return INFINITY;
+	}
+	return 10 * log10(signal / noise);
+}
+
+static int run(const struct bench_ratio_s *ratio, src_quality_t quality, int seconds)
+{
+	int total_in = ratio->in_rate * seconds;
+	int total_out = (int)((int64_t)total_in * ratio->out_rate / ratio->in_rate) + BENCH_OUT_FRAMES;
+	double high_hz = BENCH_HIGH_TONE * (ratio->in_rate < ratio->out_rate ? ratio->in_rate : ratio->out_rate) / 2;
+	int16_t *in = malloc(total_in * BENCH_CHANNELS * sizeof(int16_t));
+	int16_t *out = malloc(total_out * BENCH_CHANNELS * sizeof(int16_t));
+	src_handle_t handle = src_init(BENCH_IN_FRAMES * BENCH_CHANNELS * sizeof(int16_t));
+	int in_pos = 0;
+	int out_pos = 0;
+	uint64_t cycles = 0;
+	int ret = -1;
+	int i;
+
+	if (!in || !out || !handle) {
+		fprintf(stderr, "out of memory\n");
+		goto errout;
+	}
+	if (src_set_quality(handle, quality) != SRC_ERR_NO_ERROR) {
+		fprintf(stderr, "src_set_quality failed\n");
+		goto errout;
+	}
+
+	for (i = 0; i < total_in; i++) {
+		in[i * BENCH_CHANNELS] = (int16_t)lrint(BENCH_AMPLITUDE * sin(2 * M_PI * BENCH_TONE_HZ * i / ratio->in_rate));
+		in[i * BENCH_CHANNELS + 1] = (int16_t)lrint(BENCH_AMPLITUDE * sin(2 * M_PI * high_hz * i / ratio->in_rate));
+	}
+
+	while (in_pos < total_in && out_pos + BENCH_OUT_FRAMES <= total_out) {
+		src_data_t data;
+		uint64_t start;
+
+		memset(&data, 0, sizeof(data));
+		data.data_in = in + in_pos * BENCH_CHANNELS;
+		data.input_frames = total_in - in_pos < BENCH_IN_FRAMES ? total_in - in_pos : BENCH_IN_FRAMES;
+		data.origin_sample_rate = ratio->in_rate;
+		data.origin_sample_width = SAMPLE_WIDTH_16BITS;
+		data.origin_channel_num = BENCH_CHANNELS;
+		data.data_out = out + out_pos * BENCH_CHANNELS;
+		data.out_buf_length = BENCH_OUT_FRAMES * BENCH_CHANNELS * sizeof(int16_t);
+		data.desired_sample_rate = ratio->out_rate;
+		data.desired_sample_width = SAMPLE_WIDTH_16BITS;
+		data.desired_channel_num = BENCH_CHANNELS;
+
+		start = now_cycles();
+		if (src_simple(handle, &data) != SRC_ERR_NO_ERROR) {
+			fprintf(stderr, "src_simple failed\n");
+			goto errout;
+		}
+		cycles += now_cycles() - start;
+
+		if (data.output_frames_gen == 0 && data.input_frames_used == 0) {
+			fprintf(stderr, "converter stalled\n");
+			goto errout;
+		}
+		in_pos += data.input_frames_used;
+		out_pos += data.output_frames_gen;
+	}
+
+	printf("%6d -> %6d  %-6s  %10.2f Mcycles/s  %6.1f dB  %6.1f dB at %5.0f Hz\n", ratio->in_rate, ratio->out_rate, g_quality_name[quality], (double)cycles / seconds / 1e6, \
+		   tone_snr(out, out_pos, 0, BENCH_TONE_HZ, ratio->out_rate), tone_snr(out, out_pos, 1, high_hz, ratio->out_rate), high_hz);
+	ret = 0;
+
+errout:
+	if (handle) {
+		src_destroy(handle);
+	}
+	free(in);
+	free(out);
+	return ret;
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-m <cpu MHz>] [-s <seconds of audio>]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+	int seconds = 10;
+	unsigned int r;
+	int q;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "m:s:h")) != -1) {
+		switch (opt) {
+		case 'm':
+			g_mhz = atof(optarg);
+			break;
+		case 's':
+			seconds = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+#if !defined(__x86_64__) && !defined(__i386__)
+	if (g_mhz <= 0) {
+		usage(argv[0]);
+		fprintf(stderr, "-m is required on this host\n");
+		return EXIT_FAILURE;
+	}
+#endif
+	if (seconds <= 0) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	printf("%d s of stereo 16 bit audio, %d frames per call\n", seconds, BENCH_IN_FRAMES);
+	for (r = 0; r < sizeof(g_ratios) / sizeof(g_ratios[0]); r++) {
+		for (q = SRC_QUALITY_LOW; q <= SRC_QUALITY_HIGH; q++) {
+			if (run(&g_ratios[r], (src_quality_t)q, seconds) < 0) {
+				return EXIT_FAILURE;
+			}
+		}
+	}
+	return EXIT_SUCCESS;
+}